@@ -11,8 +11,11 @@
 #include "applock.h"
 
 #include <QtScript>
+#include <QHash>
 #include <QMessageBox>
+#include <QSet>
 #include <QSqlError>
+#include <QStringList>
 #include <QVariant>
 #include <QWidget>
 
@@ -28,98 +31,213 @@ class AppLockPrivate
         _otherLock(false),
         _parent(parent)
     {
-      if (_mobilizedDb.isNull()) {
-        XSqlQuery q("SELECT EXISTS(SELECT 1"
-                    "  FROM pg_class c"
-                    "  JOIN pg_namespace n ON (relnamespace = n.oid)"
-                    " WHERE relname = 'lock'"
-                    "   AND nspname = 'xt') AS mobilized;");
-        if (q.first())
-          _mobilizedDb = q.value("mobilized");
-        else
-          (void)ErrorReporter::error(QtCriticalMsg,
-                                     qobject_cast<QWidget*>(parent->parent()),
-                                     parent->tr("Locking Error"),
-                                     q, __FILE__, __LINE__);
+    }
+
+    QWidget *parentWidget() const
+    {
+      return qobject_cast<QWidget*>(_parent->parent());
+    }
+
+    QList<int> ids() const
+    {
+      return _ids.isEmpty() ? QList<int>() << _id : _ids;
+    }
+
+    /* Whether the database is mobilized and which server version it runs
+       cannot change during a session, so check them once for every AppLock.
+     */
+    static bool initSession(QWidget *parent)
+    {
+      if (! _actPidCol.isEmpty())
+        return true;
+
+      XSqlQuery q("SELECT EXISTS(SELECT 1"
+                  "  FROM pg_class c"
+                  "  JOIN pg_namespace n ON (relnamespace = n.oid)"
+                  " WHERE relname = 'lock'"
+                  "   AND nspname = 'xt') AS mobilized,"
+                  "       compareversion('9.2.0') <= 0 AS isNew;");
+      if (q.first()) {
+        _mobilizedDb = q.value("mobilized");
+        _actPidCol   = q.value("isNew").toBool() ? "pid" : "procpid";
+        return true;
       }
-      XSqlQuery vq("SELECT compareversion('9.2.0') <= 0 AS isNew;");
-      if (vq.first()) {
-        _actPidCol = vq.value("isNew").toBool() ? "pid" : "procpid";
-      } else {
-        (void)ErrorReporter::error(QtCriticalMsg,
-                                   qobject_cast<QWidget*>(parent->parent()),
-                                   parent->tr("Locking Error"),
-                                   vq, __FILE__, __LINE__);
+
+      (void)ErrorReporter::error(QtCriticalMsg, parent,
+                                 AppLock::tr("Locking Error"),
+                                 q, __FILE__, __LINE__);
+      return false;
+    }
+
+    /* Return the oid used as the first key of advisory locks on @a table,
+       or -1 if the table cannot be found. Table oids are cached for the
+       session.
+     */
+    int tableOid(const QString &table)
+    {
+      QHash<QString, int>::const_iterator it = _tableOids.constFind(table);
+      if (it != _tableOids.constEnd())
+        return it.value();
+
+      XSqlQuery q;
+      q.prepare("SELECT CAST(oid AS INTEGER) AS tableoid"
+                "  FROM pg_class"
+                " WHERE relname=:table;");
+      q.bindValue(":table", table);
+      q.exec();
+      if (q.first()) {
+        int oid = q.value("tableoid").toInt();
+        _tableOids.insert(table, oid);
+        return oid;
       }
-      updateLockStatus();
+      else if (ErrorReporter::error(QtCriticalMsg, parentWidget(),
+                                    AppLock::tr("Locking Error"),
+                                    q, __FILE__, __LINE__))
+        _error = q.lastError().databaseText();
+      else
+        _error = AppLock::tr("Cannot lock records in %1 because the table "
+                             "could not be found.").arg(table);
+      return -1;
     }
 
-    void updateLockStatus() {
+    static QString idArray(const QList<int> &ids)
+    {
+      QStringList idlist;
+      foreach (int id, ids)
+        idlist << QString::number(id);
+      return "{" + idlist.join(",") + "}";
+    }
+
+    /* Find out who holds the locks on @a ids. This is only needed after a
+       lock could not be acquired or released, so it is not run until then.
+     */
+    bool lockStatus(int oid, const QList<int> &ids,
+                    QHash<int, QString> &others, QSet<int> &mine)
+    {
+      if (! initSession(parentWidget()))
+        return false;
+
       XSqlQuery q;
       if (_mobilizedDb.toBool()) {
-        q.prepare("SELECT lock_pid = pg_backend_pid() AS mylock, lock_username"
+        q.prepare("SELECT lock_record_id AS id,"
+                  "       lock_pid = pg_backend_pid() AS mylock,"
+                  "       lock_username AS username"
                   "  FROM xt.lock"
-                  "  JOIN pg_class c ON lock_table_oid = c.oid"
-                  " WHERE relname = :table"
-                  "   AND lock_record_id = :id;");
-        q.bindValue(":table", _table);
-        q.bindValue(":id",    _id);
+                  " WHERE lock_table_oid = CAST(:oid AS OID)"
+                  "   AND lock_record_id = ANY(CAST(:ids AS INTEGER[]));");
+        q.bindValue(":oid", oid);
+        q.bindValue(":ids", idArray(ids));
         q.exec();
-        if (q.first()) {
-          _myLock    = q.value("mylock").toBool();
-          _otherLock = ! _myLock;
-          _username  = q.value("lock_username").toString();
-          return;
+        while (q.next()) {
+          if (q.value("mylock").toBool())
+            mine.insert(q.value("id").toInt());
+          else
+            others.insert(q.value("id").toInt(), q.value("username").toString());
         }
-        else if (ErrorReporter::error(QtCriticalMsg,
-                                      qobject_cast<QWidget*>(_parent->parent()),
-                                      _parent->tr("Locking Error"),
-                                      q, __FILE__, __LINE__))
-          return;
+        if (ErrorReporter::error(QtCriticalMsg, parentWidget(),
+                                 AppLock::tr("Locking Error"),
+                                 q, __FILE__, __LINE__))
+          return false;
       }
 
-      q.prepare("SELECT l.pid = pg_backend_pid() AS mylock, usename"
+      q.prepare("SELECT CAST(objid AS INTEGER) AS id,"
+                "       l.pid = pg_backend_pid() AS mylock, usename"
                 "  FROM pg_locks l"
-                "  JOIN pg_class c    on classid = c.oid"
                 "  JOIN pg_database d on database = d.oid"
                 "  JOIN pg_stat_activity a ON l.pid = a." + _actPidCol +
                 " WHERE d.datname = current_database()"
-                "   AND relname = :table"
-                "   AND objid   = :id"
+                "   AND classid = CAST(:oid AS OID)"
+                "   AND objid   = ANY(CAST(:ids AS OID[]))"
                 "   AND locktype = 'advisory';");
-      q.bindValue(":table", _table);
-      q.bindValue(":id",    _id);
+      q.bindValue(":oid", oid);
+      q.bindValue(":ids", idArray(ids));
       q.exec();
-      if (q.first()) {
-        _myLock    = q.value("mylock").toBool();
-        _otherLock = ! _myLock;
-        _username  = q.value("usename").toString();
-        return;
+      while (q.next()) {
+        int id = q.value("id").toInt();
+        if (mine.contains(id) || others.contains(id))
+          continue;
+        if (q.value("mylock").toBool())
+          mine.insert(id);
+        else
+          others.insert(id, q.value("usename").toString());
       }
-      else if (ErrorReporter::error(QtCriticalMsg,
-                                    qobject_cast<QWidget*>(_parent->parent()),
-                                    _parent->tr("Locking Error"),
-                                    q, __FILE__, __LINE__))
+      return ! ErrorReporter::error(QtCriticalMsg, parentWidget(),
+                                    AppLock::tr("Locking Error"),
+                                    q, __FILE__, __LINE__);
+    }
+
+    void updateLockStatus() {
+      if (_table.isEmpty() || (_id < 0 && _ids.isEmpty()))
         return;
-      else {
-        _myLock = _otherLock = false;
-        _username.clear();
-      }
+
+      int oid = tableOid(_table);
+      if (oid < 0)
+        return;
+
+      QList<int>          requested = ids();
+      QHash<int, QString> others;
+      QSet<int>           mine;
+      if (! lockStatus(oid, requested, others, mine))
+        return;
+
+      QStringList users;
+      foreach (QString username, others)
+        if (! users.contains(username))
+          users << username;
+
+      _myLock    = (mine.size() == requested.toSet().size());
+      _otherLock = ! others.isEmpty();
+      _holders   = others;
+      _username  = users.join(", ");
     }
 
-    QString  _actPidCol;
-    QString  _error;
-    int      _id;
-    bool     _myLock;
-    bool     _otherLock;
-    AppLock *_parent;
-    QString  _table;
-    QString  _username;
+    /* Release this session's locks on @a ids in a single statement. */
+    bool unlock(int oid, const QList<int> &ids)
+    {
+      XSqlQuery q;
+      q.prepare("SELECT bool_and(pg_advisory_unlock(:oid, id)) AS released"
+                "  FROM unnest(CAST(:ids AS INTEGER[])) AS id;");
+      q.bindValue(":oid", oid);
+      q.bindValue(":ids", idArray(ids));
+      q.exec();
+      if (q.first())
+        return q.value("released").toBool();
+      else if (ErrorReporter::error(QtCriticalMsg, parentWidget(),
+                                    AppLock::tr("Unlocking Error"),
+                                    q, __FILE__, __LINE__))
+        _error = q.lastError().text();
+      return false;
+    }
 
-    static QVariant _mobilizedDb;
+    QString             _error;
+    QHash<int, QString> _holders;
+    int                 _id;
+    QList<int>          _ids;
+    bool                _myLock;
+    bool                _otherLock;
+    AppLock            *_parent;
+    QString             _table;
+    QString             _username;
+
+    static QString             _actPidCol;
+    static QVariant            _mobilizedDb;
+    static QHash<QString, int> _tableOids;
 };
 
-QVariant AppLockPrivate::_mobilizedDb;
+QString             AppLockPrivate::_actPidCol;
+QVariant            AppLockPrivate::_mobilizedDb;
+QHash<QString, int> AppLockPrivate::_tableOids;
+
+/** @class AppLock
+
+    @brief Holds application-level locks on database records so two users
+           cannot edit the same record at the same time.
+
+    The locks are PostgreSQL advisory locks keyed by the oid of the table
+    and the record id. Creating an AppLock costs nothing on the server.
+    Who holds a lock is only looked up when a lock cannot be acquired or
+    released, or when isLockedOut() is called.
+ */
 
 AppLock::AppLock(QObject *parent)
   : QObject(parent)
@@ -153,6 +271,9 @@ AppLock::~AppLock()
  */
 bool AppLock::acquire(AppLock::AcquireMode mode)
 {
+  if (_p->_id < 0 && ! _p->_ids.isEmpty())
+    return acquireMany(_p->_table, _p->_ids, mode);
+
   if (_p->_id < 0 || _p->_table.isEmpty()) {
     _p->_error = tr("Cannot acquire a lock without a table and record id.");
     if (mode == Interactive) {
@@ -163,12 +284,16 @@ bool AppLock::acquire(AppLock::AcquireMode mode)
 
   bool result = false;
   _p->_error.clear();
+  _p->_holders.clear();
+
+  int oid = _p->tableOid(_p->_table);
+  if (oid < 0)
+    return false;
+
   XSqlQuery q;
-  q.prepare("SELECT tryLock(CAST(oid AS INTEGER), :id) AS locked"
-            "  FROM pg_class"
-            " WHERE relname=:table;");
-  q.bindValue(":id",    _p->_id);
-  q.bindValue(":table", _p->_table);
+  q.prepare("SELECT tryLock(:oid, :id) AS locked;");
+  q.bindValue(":oid", oid);
+  q.bindValue(":id",  _p->_id);
   q.exec();
   if (q.first())
   {
@@ -210,10 +335,109 @@ bool AppLock::acquire(QString table, int id, AppLock::AcquireMode mode)
   }
   _p->_table = table;
   _p->_id    = id;
+  _p->_ids.clear();
 
   return acquire(mode);
 }
 
+/** Try to acquire application-level locks on several records of one table
+    with a single statement, for example before working on the records
+    selected in a list.
+
+    Either every lock is acquired or none is. If other users hold any of
+    the records, the locks this call did get are released again and
+    lockHolders() reports which records are held and by whom. release()
+    releases all of the locks at once.
+
+   @return true if this AppLock instance holds the locks on all of @a ids
+ */
+bool AppLock::acquireMany(QString table, QList<int> ids, AppLock::AcquireMode mode)
+{
+  if (_p->_myLock && (table != _p->_table || ids != _p->ids()))
+  {
+    _p->_error = tr("Cannot change the description of a locked object.");
+    return false;
+  }
+  if (table.isEmpty() || ids.isEmpty()) {
+    _p->_error = tr("Cannot acquire a lock without a table and record id.");
+    if (mode == Interactive) {
+      QMessageBox::critical(0, tr("Cannot Acquire Lock"), _p->_error);
+    }
+    return false;
+  }
+
+  _p->_table = table;
+  _p->_id    = -1;
+  _p->_ids   = ids;
+  _p->_error.clear();
+  _p->_holders.clear();
+  if (_p->_myLock)
+    return true;
+
+  int oid = _p->tableOid(table);
+  if (oid < 0)
+    return false;
+
+  XSqlQuery q;
+  q.prepare("SELECT id, tryLock(:oid, id) AS locked"
+            "  FROM unnest(CAST(:ids AS INTEGER[])) AS id;");
+  q.bindValue(":oid", oid);
+  q.bindValue(":ids", AppLockPrivate::idArray(ids));
+  q.exec();
+
+  QList<int> locked;
+  QList<int> failed;
+  while (q.next())
+  {
+    if (q.value("locked").toBool())
+      locked << q.value("id").toInt();
+    else
+      failed << q.value("id").toInt();
+  }
+  if (ErrorReporter::error(QtCriticalMsg, qobject_cast<QWidget*>(parent()),
+                           tr("Locking Error"),
+                           q, __FILE__, __LINE__))
+  {
+    _p->_error = q.lastError().databaseText();
+    if (! locked.isEmpty())
+      (void)_p->unlock(oid, locked);
+    return false;
+  }
+
+  if (failed.isEmpty())
+  {
+    _p->_myLock    = true;
+    _p->_otherLock = false;
+    _p->_username.clear();
+    return true;
+  }
+
+  if (! locked.isEmpty())
+    (void)_p->unlock(oid, locked);
+
+  QHash<int, QString> others;
+  QSet<int>           mine;
+  (void)_p->lockStatus(oid, failed, others, mine);
+
+  QStringList users;
+  foreach (QString username, others)
+    if (! users.contains(username))
+      users << username;
+
+  _p->_myLock    = false;
+  _p->_otherLock = ! others.isEmpty();
+  _p->_holders   = others;
+  _p->_username  = users.join(", ");
+  _p->_error = tr("%1 of the records you are trying to edit are currently "
+                  "being edited by other users (%2).")
+                 .arg(failed.size()).arg(_p->_username);
+  if (mode == Interactive) {
+    QMessageBox::critical(0, tr("Cannot Acquire Lock"), _p->_error);
+  }
+
+  return false;
+}
+
 /** @return true if _this_ instance of AppLock holds the lock */
 bool AppLock::holdsLock() const
 {
@@ -227,34 +451,37 @@ bool AppLock::isLockedOut() const
   return _p->_otherLock;
 }
 
+/** @return the records that the last acquire(), acquireMany() or
+            isLockedOut() found locked by other users, as a map from
+            record id to user name
+ */
+QVariantMap AppLock::lockHolders() const
+{
+  QVariantMap result;
+  QHashIterator<int, QString> it(_p->_holders);
+  while (it.hasNext())
+  {
+    it.next();
+    result.insert(QString::number(it.key()), it.value());
+  }
+  return result;
+}
+
 bool AppLock::release()
 {
-  if (_p->_id < 0 || _p->_table.isEmpty())
+  if (_p->_table.isEmpty() || (_p->_id < 0 && _p->_ids.isEmpty()))
     return true;
 
   bool released = false;
   _p->_error.clear();
   if (_p->_myLock) {
-    XSqlQuery q;
-    q.prepare("SELECT pg_advisory_unlock(CAST(oid AS INTEGER), :id) AS released"
-              "  FROM pg_class"
-              " WHERE relname = :table;");
-    q.bindValue(":id",    _p->_id);
-    q.bindValue(":table", _p->_table);
-    q.exec();
-    if (q.first())
+    int oid = _p->tableOid(_p->_table);
+    if (oid >= 0 && _p->unlock(oid, _p->ids()))
     {
-      released = q.value("released").toBool();
-      if (released)
-      {
-        _p->_myLock    = false;
-        _p->_otherLock = false;
-      }
+      released       = true;
+      _p->_myLock    = false;
+      _p->_otherLock = false;
     }
-    else if (ErrorReporter::error(QtCriticalMsg, qobject_cast<QWidget*>(parent()),
-                                  tr("Unlocking Error"),
-                                  q, __FILE__, __LINE__))
-      _p->_error = q.lastError().text();
   }
   if (! released)
   {
@@ -276,7 +503,9 @@ QString AppLock::lastError() const
 QString AppLock::toString()  const
 {
   QString result("AppLock[%1, %2 (%3)]");
-  return result.arg(_p->_table).arg(_p->_id).arg(_p->_error);
+  QString ids = _p->_ids.isEmpty() ? QString::number(_p->_id)
+                                   : AppLockPrivate::idArray(_p->_ids);
+  return result.arg(_p->_table).arg(ids).arg(_p->_error);
 }
 
 // script exposure /////////////////////////////////////////////////////////////
@@ -350,6 +579,19 @@ bool AppLockProto::acquire(QString table, int id, enum AppLock::AcquireMode mode
   return false;
 }
 
+bool AppLockProto::acquireMany(QString table, QVariantList ids, enum AppLock::AcquireMode mode)
+{
+  AppLock *lock = qscriptvalue_cast<AppLock*>(thisObject());
+  if (lock)
+  {
+    QList<int> idlist;
+    foreach (QVariant id, ids)
+      idlist << id.toInt();
+    return lock->acquireMany(table, idlist, mode);
+  }
+  return false;
+}
+
 bool AppLockProto::holdsLock() const
 {
   AppLock *lock = qscriptvalue_cast<AppLock*>(thisObject());
@@ -366,6 +608,14 @@ bool AppLockProto::isLockedOut() const
   return false;
 }
 
+QVariantMap AppLockProto::lockHolders() const
+{
+  AppLock *lock = qscriptvalue_cast<AppLock*>(thisObject());
+  if (lock)
+    return lock->lockHolders();
+  return QVariantMap();
+}
+
 QString AppLockProto::lastError() const
 {
   AppLock *lock = qscriptvalue_cast<AppLock*>(thisObject());
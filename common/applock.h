@@ -11,6 +11,7 @@
 #ifndef __APPLOCK_H__
 #define __APPLOCK_H__
 
+#include <QList>
 #include <QMetaType>
 #include <QObject>
 #include <QtScript>
@@ -33,8 +34,10 @@ class AppLock : public QObject
 
     Q_INVOKABLE bool    acquire(AcquireMode mode = Silent);
     Q_INVOKABLE bool    acquire(QString table, int id, AcquireMode mode = Silent);
+                bool    acquireMany(QString table, QList<int> ids, AcquireMode mode = Silent);
     Q_INVOKABLE bool    holdsLock()   const;
     Q_INVOKABLE bool    isLockedOut() const;
+    Q_INVOKABLE QVariantMap lockHolders() const;
     Q_INVOKABLE QString lastError()   const;
     Q_INVOKABLE bool    release();
     Q_INVOKABLE QString toString()    const;
@@ -57,8 +60,10 @@ class AppLockProto : public QObject, public QScriptable
 
     Q_INVOKABLE bool    acquire(AppLock::AcquireMode mode);
     Q_INVOKABLE bool    acquire(QString table, int id, AppLock::AcquireMode mode);
+    Q_INVOKABLE bool    acquireMany(QString table, QVariantList ids, AppLock::AcquireMode mode);
     Q_INVOKABLE bool    holdsLock()   const;
     Q_INVOKABLE bool    isLockedOut() const;
+    Q_INVOKABLE QVariantMap lockHolders() const;
     Q_INVOKABLE QString lastError()   const;
     Q_INVOKABLE bool    release();
     Q_INVOKABLE QString toString()    const;
@@ -40,15 +40,20 @@ SOURCES = applock.cpp              \
           graphicstextbuttonitem.cpp \
           gunzip.cpp \
           login2.cpp \
+          metasqlcache.cpp \
           metrics.cpp \
           metricsenc.cpp \
           qbase64encode.cpp \
           qmd5.cpp \
+          querybatch.cpp \
+          queryprofiler.cpp \
           shortcuts.cpp \
+          sqltext.cpp \
           storedProcErrorLookup.cpp \
           tarfile.cpp \
           xabstractmessagehandler.cpp \
           xbase32.cpp \
+          xslttransformer.cpp \
           xtupleproductkey.cpp \
           xtNetworkRequestManager.cpp \
           xtsettings.cpp
@@ -65,18 +70,24 @@ HEADERS = applock.h              \
           guimessagehandler.h \
           gunzip.h \
           login2.h \
+          metasqlcache.h \
           metrics.h \
           metricsenc.h \
           qbase64encode.h \
           qmd5.h \
+          querybatch.h \
+          queryprofiler.h \
           shortcuts.h \
+          sqltext.h \
           storedProcErrorLookup.h \
           tarfile.h \
           xabstractmessagehandler.h \
           xbase32.h \
+          xslttransformer.h \
           xtupleproductkey.h \
           xtNetworkRequestManager.h \
-          xtsettings.h
+          xtsettings.h \
+          xtsettingsprivate.h
 
 FORMS = login2.ui checkForUpdates.ui
 
@@ -10,9 +10,11 @@
 
 #include "exporthelper.h"
 
+#include <QCoreApplication>
 #include <QDir>
 #include <QDomDocument>
 #include <QFileInfo>
+#include <QHash>
 #include <QMessageBox>
 #include <QProcess>
 #include <QScriptEngine>
@@ -24,8 +26,11 @@
 #include <QTextDocument>
 
 #include "metasql.h"
+#include "metasqlcache.h"
 #include "mqlutil.h"
+#include "queryprofiler.h"
 #include "xsqlquery.h"
+#include "xslttransformer.h"
 
 #define DEBUG false
 
@@ -203,6 +208,8 @@ QString ExportHelper::generateDelimited(QString qtext, ParameterList &params, QS
   if (qtext.isEmpty())
     return QString::null;
 
+  QueryProfilerTimer timer("ExportHelper::generateDelimited");
+
   if (DEBUG)
   {
     QStringList plist;
@@ -226,8 +233,8 @@ QString ExportHelper::generateDelimited(QString qtext, ParameterList &params, QS
            includeheader, valid);
 
   QStringList line;
-  MetaSQLQuery mql(qtext);
-  XSqlQuery qry = mql.toQuery(params);
+  MetaSQLCacheEntry mql = MetaSQLCache::instance()->parse(qtext);
+  XSqlQuery qry = mql.query->toQuery(params);
   if (qry.first())
   {
     QStringList field;
@@ -324,8 +331,8 @@ QString ExportHelper::generateHTML(QString qtext, ParameterList &params, QString
     qDebug("generateHTML(qtest, params, errmsg) includeheader = %d, valid = %d",
            includeheader, valid);
 
-  MetaSQLQuery mql(qtext);
-  XSqlQuery qry = mql.toQuery(params);
+  MetaSQLCacheEntry mql = MetaSQLCache::instance()->parse(qtext);
+  XSqlQuery qry = mql.query->toQuery(params);
   if (qry.first())
   {
     int cols = qry.record().count();
@@ -408,8 +415,8 @@ QString ExportHelper::generateXML(const int qryheadid, ParameterList &params, QS
 
     if (! qtext.isEmpty())
     {
-      MetaSQLQuery mql(qtext);
-      XSqlQuery qry = mql.toQuery(params);
+      MetaSQLCacheEntry mql = MetaSQLCache::instance()->parse(qtext);
+      XSqlQuery qry = mql.query->toQuery(params);
       if (qry.first())
       {
         do {
@@ -464,8 +471,8 @@ QString ExportHelper::generateXML(QString qtext, QString tableElemName, Paramete
 
   if (! qtext.isEmpty())
   {
-    MetaSQLQuery mql(qtext);
-    XSqlQuery qry = mql.toQuery(params);
+    MetaSQLCacheEntry mql = MetaSQLCache::instance()->parse(qtext);
+    XSqlQuery qry = mql.query->toQuery(params);
     if (qry.first())
     {
       do {
@@ -495,12 +502,109 @@ QString ExportHelper::generateXML(QString qtext, QString tableElemName, Paramete
     return XSLTConvertString(xmldoc.toString(), xsltmapid, errmsg);
 }
 
+// XSLT settings and map file names are read once and kept until
+// XSLTClearCache() is called, which the client does whenever the
+// metrics are reloaded
+static bool             _xsltLoaded = false;
+static QString          _xsltDir;
+static QString          _xsltCmd;
+static bool             _xsltInternal = false;
+static QHash<int, QString> _xsltExportFiles;
+static ExportHelper    *_xsltWatcher = 0;
+
+/** @brief Forget the cached XSLT metrics, map file names and compiled
+           stylesheets. Call this after changing the XSLT configuration.
+ */
+void ExportHelper::XSLTClearCache()
+{
+  _xsltLoaded = false;
+  _xsltExportFiles.clear();
+  XSLTTransformer::instance()->clearCache();
+}
+
+/** @brief Call XSLTClearCache() whenever @a sender emits @a signal,
+           for example when the metrics are reloaded after another client
+           changed them.
+ */
+void ExportHelper::XSLTClearCacheOn(QObject *sender, const char *signal)
+{
+  if (! _xsltWatcher)
+  {
+    _xsltWatcher = new ExportHelper();
+    _xsltWatcher->setParent(QCoreApplication::instance());
+  }
+  connect(sender, signal, _xsltWatcher, SLOT(sXSLTClearCache()));
+}
+
+void ExportHelper::sXSLTClearCache()
+{
+  XSLTClearCache();
+}
+
+bool ExportHelper::XSLTSettings(QString &dir, QString &cmd, bool &internal, QString &errmsg)
+{
+  if (! _xsltLoaded)
+  {
+    XSqlQuery q;
+    q.prepare("SELECT fetchMetricText(:xsltdir) AS dir,"
+              "       fetchMetricText(:xsltcmd) AS cmd,"
+              "       fetchMetricBool('XSLTLibrary') AS internal;");
+#if defined Q_OS_MAC
+    q.bindValue(":xsltdir", "XSLTDefaultDirMac");
+    q.bindValue(":xsltcmd", "XSLTProcessorMac");
+#elif defined Q_OS_WIN
+    q.bindValue(":xsltdir", "XSLTDefaultDirWindows");
+    q.bindValue(":xsltcmd", "XSLTProcessorWindows");
+#elif defined Q_OS_LINUX
+    q.bindValue(":xsltdir", "XSLTDefaultDirLinux");
+    q.bindValue(":xsltcmd", "XSLTProcessorLinux");
+#endif
+    q.exec();
+    if (q.first())
+    {
+      _xsltDir      = q.value("dir").toString();
+      _xsltCmd      = q.value("cmd").toString();
+      _xsltInternal = q.value("internal").toBool();
+      _xsltLoaded   = true;
+    }
+    else if (q.lastError().type() != QSqlError::NoError)
+    {
+      errmsg = q.lastError().text();
+      return false;
+    }
+    else
+    {
+      errmsg = tr("Could not find the XSLT directory and command metrics.");
+      return false;
+    }
+  }
+
+  dir      = _xsltDir;
+  cmd      = _xsltCmd;
+  internal = _xsltInternal;
+  return true;
+}
+
 bool ExportHelper::XSLTConvertFile(QString inputfilename, QString outputfilename, int xsltmapid, QString &errmsg)
 {
   if (DEBUG)
     qDebug("ExportHelper::XSLTConvertFile(%s, %s, %d, errmsg) entered",
            qPrintable(inputfilename), qPrintable(outputfilename), xsltmapid);
-  bool returnVal = false;
+
+  QString xsltfile = XSLTExportFile(xsltmapid, errmsg);
+  if (xsltfile.isEmpty())
+    return false;
+
+  return XSLTConvertFile(inputfilename, outputfilename, xsltfile, errmsg);
+}
+
+/** @brief Return the export stylesheet file name for an xsltmap,
+           or an empty string and an error message if there is none.
+ */
+QString ExportHelper::XSLTExportFile(int xsltmapid, QString &errmsg)
+{
+  if (_xsltExportFiles.contains(xsltmapid))
+    return _xsltExportFiles.value(xsltmapid);
 
   XSqlQuery xsltq;
   xsltq.prepare("SELECT xsltmap_export"
@@ -510,67 +614,201 @@ bool ExportHelper::XSLTConvertFile(QString inputfilename, QString outputfilename
   xsltq.bindValue(":id", xsltmapid);
   xsltq.exec();
   if (xsltq.first())
-    return XSLTConvertFile(inputfilename, outputfilename,
-                           xsltq.value("xsltmap_export").toString(), errmsg);
+  {
+    QString xsltfile = xsltq.value("xsltmap_export").toString();
+    _xsltExportFiles.insert(xsltmapid, xsltfile);
+    return xsltfile;
+  }
   else  if (xsltq.lastError().type() != QSqlError::NoError)
     errmsg = xsltq.lastError().text();
   else
     errmsg = tr("Could not find XSLT mapping with internal id %1.")
                .arg(xsltmapid);
 
-  return returnVal;
+  return QString();
 }
 
 bool ExportHelper::XSLTConvertFile(QString inputfilename, QString outputfilename, QString xsltfilename, QString &errmsg)
 {
   QString xsltdir;
   QString xsltcmd;
+  bool    internal = false;
+  if (! XSLTSettings(xsltdir, xsltcmd, internal, errmsg))
+    return false;
 
-  XSqlQuery q;
-  q.prepare("SELECT fetchMetricText(:xsltdir) AS dir,"
-            "       fetchMetricText(:xsltcmd) AS cmd;");
-#if defined Q_OS_MAC
-  q.bindValue(":xsltdir", "XSLTDefaultDirMac");
-  q.bindValue(":xsltcmd", "XSLTProcessorMac");
-#elif defined Q_OS_WIN
-  q.bindValue(":xsltdir", "XSLTDefaultDirWindows");
-  q.bindValue(":xsltcmd", "XSLTProcessorWindows");
-#elif defined Q_OS_LINUX
-  q.bindValue(":xsltdir", "XSLTDefaultDirLinux");
-  q.bindValue(":xsltcmd", "XSLTProcessorLinux");
-#endif
-  q.exec();
-  if (q.first())
+  if (internal)
   {
-    xsltdir = q.value("dir").toString();
-    xsltcmd = q.value("cmd").toString();
+    QFile inputfile(inputfilename);
+    if (! inputfile.open(QIODevice::ReadOnly))
+    {
+      errmsg = tr("Could not open %1: %2.")
+                 .arg(inputfilename, inputfile.errorString());
+      return false;
+    }
+
+    QByteArray output;
+    if (! XSLTConvert(inputfile.readAll(), output, xsltfilename, errmsg))
+      return false;
+
+    QFile outputfile(outputfilename);
+    if (! outputfile.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+        outputfile.write(output) < 0)
+    {
+      errmsg = tr("Error writing to %1: %2")
+                 .arg(outputfilename, outputfile.errorString());
+      return false;
+    }
+    return true;
   }
-  else if (q.lastError().type() != QSqlError::NoError)
+
+  return XSLTConvertExternal(inputfilename, outputfilename, xsltfilename,
+                             xsltdir, xsltcmd, errmsg);
+}
+
+QString ExportHelper::XSLTResolve(const QString &xsltfilename, const QString &xsltdir)
+{
+  if (QFile::exists(xsltfilename))
+    return xsltfilename;
+  else if (QFile::exists(xsltdir + QDir::separator() + xsltfilename))
+    return xsltdir + QDir::separator() + xsltfilename;
+
+  return QString();
+}
+
+/** @brief Transform @a input with the stylesheet @a xsltfilename, in memory.
+
+    The internal XSLT processor is used if it is enabled. If it is not
+    enabled, or it cannot handle the stylesheet and an external processor
+    command is configured, the external processor is run on temporary
+    files instead.
+
+    @param cachekey Names the compiled stylesheet, for example
+                    "import:" or "export:" followed by the xsltmap id.
+                    Defaults to the stylesheet file name.
+ */
+bool ExportHelper::XSLTConvert(const QByteArray &input, QByteArray &output,
+                               const QString &xsltfilename, QString &errmsg,
+                               const QString &cachekey)
+{
+  QString xsltdir;
+  QString xsltcmd;
+  bool    internal = false;
+  if (! XSLTSettings(xsltdir, xsltcmd, internal, errmsg))
+    return false;
+
+  if (internal)
   {
-    errmsg = q.lastError().text();
+    QString stylesheet = XSLTResolve(xsltfilename, xsltdir);
+    if (stylesheet.isEmpty())
+    {
+      errmsg = tr("Cannot find the XSLT file as either %1 or %2")
+                  .arg(xsltfilename, xsltdir + QDir::separator() + xsltfilename);
+      return false;
+    }
+
+    QString internalerr;
+    if (XSLTTransformer::instance()->transform(cachekey.isEmpty() ? stylesheet : cachekey,
+                                               stylesheet, input, output,
+                                               internalerr))
+      return true;
+
+    if (xsltcmd.trimmed().isEmpty())
+    {
+      errmsg = internalerr;
+      return false;
+    }
+
+    if (DEBUG)
+      qDebug("ExportHelper::XSLTConvert falling back to %s: %s",
+             qPrintable(xsltcmd), qPrintable(internalerr));
+  }
+
+  /* tempfile handling is messy because windows doesn't handle them as you
+     might expect.
+     TODO: find a simpler way
+   */
+  QString basename = QFileInfo(xsltfilename).baseName();
+  QTemporaryFile *inputfile = new QTemporaryFile(QDir::tempPath()
+                                                 + QDir::separator()
+                                                 + basename
+                                                 + "Input.XXXXXX.xml");
+  inputfile->setAutoRemove(false);
+  if (! inputfile->open())
+  {
+    errmsg = tr("Could not open temporary input file (%1).")
+                .arg(inputfile->error());
+    delete inputfile;
     return false;
   }
-  else
+
+  QString inputfileName = inputfile->fileName();
+  inputfile->write(input);
+  inputfile->close();
+  delete inputfile;
+  inputfile = 0;
+
+  QTemporaryFile *outputfile = new QTemporaryFile(QDir::tempPath()
+                                                  + QDir::separator()
+                                                  + basename
+                                                  + "Output.XXXXXX.xml");
+  outputfile->setAutoRemove(false);
+  if (! outputfile->open())
   {
-    errmsg = tr("Could not find the XSLT directory and command metrics.");
+    errmsg = tr("Could not open temporary output file (%1).")
+              .arg(outputfile->error());
+    delete outputfile;
     return false;
   }
 
+  QString outputfileName = outputfile->fileName();
+
+  if (DEBUG)
+    qDebug("ExportHelper::XSLTConvert writing from %s to %s",
+           qPrintable(inputfileName), qPrintable(outputfileName));
+
+  bool result = XSLTConvertExternal(inputfileName, outputfileName, xsltfilename,
+                                    xsltdir, xsltcmd, errmsg);
+  if (result)
+    output = outputfile->readAll();
+
+  outputfile->close();
+  delete outputfile;
+  outputfile = 0;
+
+  if (errmsg.isEmpty())
+  {
+    QFile::remove(outputfileName);
+    QFile::remove(inputfileName);
+  }
+
+  return result;
+}
+
+bool ExportHelper::XSLTConvertExternal(const QString &inputfilename,
+                                       const QString &outputfilename,
+                                       const QString &xsltfilename,
+                                       const QString &xsltdir,
+                                       const QString &xsltcmd,
+                                       QString &errmsg)
+{
   QStringList args = xsltcmd.split(" ", QString::SkipEmptyParts);
+  if (args.isEmpty())
+  {
+    errmsg = tr("No external XSLT processor is configured.");
+    return false;
+  }
   QString command = args[0];
   args.removeFirst();
   args.replaceInStrings("%f", inputfilename);
 
-  if (QFile::exists(xsltfilename))
-    args.replaceInStrings("%x", xsltfilename);
-  else if (QFile::exists(xsltdir + QDir::separator() + xsltfilename))
-    args.replaceInStrings("%x", xsltdir + QDir::separator() + xsltfilename);
-  else
+  QString stylesheet = XSLTResolve(xsltfilename, xsltdir);
+  if (stylesheet.isEmpty())
   {
     errmsg = tr("Cannot find the XSLT file as either %1 or %2")
                 .arg(xsltfilename, xsltdir + QDir::separator() + xsltfilename);
     return false;
   }
+  args.replaceInStrings("%x", stylesheet);
 
   QProcess xslt;
   xslt.setStandardOutputFile(outputfilename);
@@ -610,73 +848,14 @@ QString ExportHelper::XSLTConvertString(QString input, int xsltmapid, QString &e
            qPrintable(input.left(200)), xsltmapid);
   QString returnVal;
 
-  XSqlQuery xsltq;
-  xsltq.prepare("SELECT xsltmap_name, xsltmap_export"
-                "  FROM xsltmap"
-                " WHERE xsltmap_id=:id;");
-
-  xsltq.bindValue(":id", xsltmapid);
-  xsltq.exec();
-  if (xsltq.first())
+  QString xsltfile = XSLTExportFile(xsltmapid, errmsg);
+  if (! xsltfile.isEmpty())
   {
-    /* tempfile handling is messy because windows doesn't handle them as you
-       might expect.
-       TODO: find a simpler way
-     */
-    QString xsltmap = xsltq.value("xsltmap_name").toString();
-    QTemporaryFile *inputfile = new QTemporaryFile(QDir::tempPath()
-                                                   + QDir::separator()
-                                                   + xsltmap
-                                                   + "Input.XXXXXX.xml");
-    inputfile->setAutoRemove(false);
-    if (! inputfile->open())
-      errmsg = tr("Could not open temporary input file (%1).")
-                  .arg(inputfile->error());
-    else
-    {
-      QString inputfileName = inputfile->fileName();
-      inputfile->write(input.toUtf8());
-      inputfile->close();
-      delete inputfile;
-      inputfile = 0;
-
-      QTemporaryFile *outputfile = new QTemporaryFile(QDir::tempPath()
-                                                      + QDir::separator()
-                                                      + xsltmap
-                                                      + "Output.XXXXXX.xml");
-      outputfile->setAutoRemove(false);
-      if (! outputfile->open())
-        errmsg = tr("Could not open temporary output file (%1).")
-                  .arg(outputfile->error());
-      else
-      {
-        QString outputfileName = outputfile->fileName();
-
-        if (DEBUG)
-          qDebug("ExportHelper::XSLTConvertString writing from %s to %s",
-                 qPrintable(inputfileName), qPrintable(outputfileName));
-
-        if (XSLTConvertFile(inputfileName, outputfileName,
-                            xsltq.value("xsltmap_export").toString(), errmsg))
-          returnVal = outputfile->readAll();
-
-        outputfile->close();
-        delete outputfile;
-        outputfile = 0;
-
-        if (errmsg.isEmpty())
-        {
-          QFile::remove(outputfileName);
-          QFile::remove(inputfileName);
-        }
-      }
-    }
+    QByteArray output;
+    if (XSLTConvert(input.toUtf8(), output, xsltfile, errmsg,
+                    QString("export:%1").arg(xsltmapid)))
+      returnVal = QString::fromUtf8(output);
   }
-  else  if (xsltq.lastError().type() != QSqlError::NoError)
-    errmsg = xsltq.lastError().text();
-  else
-    errmsg = tr("Could not find XSLT mapping with internal id %1.")
-               .arg(xsltmapid);
 
   if (! errmsg.isEmpty())
     qWarning("%s", qPrintable(errmsg));
@@ -37,6 +37,18 @@ class ExportHelper : public QObject
     static bool    XSLTConvertFile(QString inputfilename, QString outputfilename, QString xsltfilename, QString &errmsg);
     static bool    XSLTConvertFile(QString inputfilename, QString outputfilename, int xsltmapid, QString &errmsg);
     static QString XSLTConvertString(QString input, int xsltmapid, QString &errmsg);
+    static bool    XSLTConvert(const QByteArray &input, QByteArray &output, const QString &xsltfilename, QString &errmsg, const QString &cachekey = QString());
+    static QString XSLTExportFile(int xsltmapid, QString &errmsg);
+    static void    XSLTClearCache();
+    static void    XSLTClearCacheOn(QObject *sender, const char *signal);
+
+  protected slots:
+    void sXSLTClearCache();
+
+  protected:
+    static bool    XSLTSettings(QString &dir, QString &cmd, bool &internal, QString &errmsg);
+    static QString XSLTResolve(const QString &xsltfilename, const QString &xsltdir);
+    static bool    XSLTConvertExternal(const QString &inputfilename, const QString &outputfilename, const QString &xsltfilename, const QString &xsltdir, const QString &xsltcmd, QString &errmsg);
 };
 
 void setupExportHelper(QScriptEngine *engine);
@@ -27,6 +27,7 @@
 #include <xsqlquery.h>
 
 #include "exporthelper.h"
+#include "queryprofiler.h"
 
 #define MAXCSVFIRSTLINE     2048
 #define DEFAULT_SAVE_DIR    "done"
@@ -363,52 +364,22 @@ bool ImportHelper::importXML(const QString &pFileName, QString &errmsg, QString
   if (DEBUG)
     qDebug("ImportHelper::importXML(%s, errmsg)", qPrintable(pFileName));
 
-  QString xmldir;
-  QString xsltdir;
-  QString xsltcmd;
+  QueryProfilerTimer timer("ImportHelper::importXML");
   QStringList errors;
   QStringList warnings;
   bool        saveErrorXML = false;
 
+  // the XSLT directory and processor are looked up by ExportHelper
   XSqlQuery q;
-  q.prepare("SELECT fetchMetricText(:xmldir)  AS xmldir,"
-            "       fetchMetricText(:xsltdir) AS xsltdir,"
-            "       fetchMetricText(:xsltcmd) AS xsltcmd,"
-            "       fetchMetricBool('ImportXMLCreateErrorFile') AS createerr;");
-#if defined Q_OS_MAC
-  q.bindValue(":xmldir",  "XMLDefaultDirMac");
-  q.bindValue(":xsltdir", "XSLTDefaultDirMac");
-  q.bindValue(":xsltcmd", "XSLTProcessorMac");
-#elif defined Q_OS_WIN
-  q.bindValue(":xmldir",  "XMLDefaultDirWindows");
-  q.bindValue(":xsltdir", "XSLTDefaultDirWindows");
-  q.bindValue(":xsltcmd", "XSLTProcessorWindows");
-#elif defined Q_OS_LINUX
-  q.bindValue(":xmldir",  "XMLDefaultDirLinux");
-  q.bindValue(":xsltdir", "XSLTDefaultDirLinux");
-  q.bindValue(":xsltcmd", "XSLTProcessorLinux");
-#endif
+  q.prepare("SELECT fetchMetricBool('ImportXMLCreateErrorFile') AS createerr;");
   q.exec();
   if (q.first())
-  {
-    xmldir  = q.value("xmldir").toString();
-    xsltdir = q.value("xsltdir").toString();
-    xsltcmd = q.value("xsltcmd").toString();
     saveErrorXML = q.value("createerr").toBool();
-  }
   else if (q.lastError().type() != QSqlError::NoError)
   {
     errmsg = q.lastError().text();
     return false;
   }
-  else
-  {
-    errmsg = tr("Could not find the XSLT directory and command metrics.");
-    return false;
-  }
-
-  if (xmldir.isEmpty())
-    xmldir = ".";
 
   QDomDocument doc(pFileName);
   if (!openDomDocument(pFileName, doc, errmsg))
@@ -422,12 +393,11 @@ bool ImportHelper::importXML(const QString &pFileName, QString &errmsg, QString
     if (DEBUG) qDebug("changed doctype to %s", qPrintable(doctype));
   }
 
-  QString tmpfileName;
   if (doctype != "xtupleimport")
   {
     QString xsltfile;
     XSqlQuery q;
-    q.prepare("SELECT xsltmap_import FROM xsltmap "
+    q.prepare("SELECT xsltmap_id, xsltmap_import FROM xsltmap "
               "WHERE ((xsltmap_doctype=:doctype OR xsltmap_doctype='')"
               "   AND (xsltmap_system=:system   OR xsltmap_system=''));");
     q.bindValue(":doctype", doctype);
@@ -449,15 +419,29 @@ bool ImportHelper::importXML(const QString &pFileName, QString &errmsg, QString
       return false;
     }
 
-    tmpfileName = xmldir + QDir::separator() + doctype + "TOxtupleimport";
+    QFile inputfile(pFileName);
+    if (! inputfile.open(QIODevice::ReadOnly))
+    {
+      errmsg = tr("<p>Could not open file %1 (error %2)")
+                 .arg(pFileName, inputfile.errorString());
+      return false;
+    }
 
-    if (! ExportHelper::XSLTConvertFile(pFileName, tmpfileName,
-                                        q.value("xsltmap_import").toString(),
-                                        errmsg))
+    QByteArray converted;
+    if (! ExportHelper::XSLTConvert(inputfile.readAll(), converted, xsltfile, errmsg,
+                                    QString("import:%1").arg(q.value("xsltmap_id").toInt())))
       return false;
 
-    if (! openDomDocument(tmpfileName, doc, errmsg))
+    int errline = 0;
+    int errcol  = 0;
+    doc = QDomDocument(pFileName);
+    if (! doc.setContent(converted, &errmsg, &errline, &errcol))
+    {
+      errmsg = tr("<p>Problem reading the result of converting %1 to "
+                  "xtupleimport, line %2 column %3:<br>%4")
+                 .arg(pFileName).arg(errline).arg(errcol).arg(errmsg);
       return false;
+    }
   }
 
   /* xtupleimport format is very straightforward:
@@ -647,8 +631,6 @@ bool ImportHelper::importXML(const QString &pFileName, QString &errmsg, QString
     return false;
   }
 
-  if (! tmpfileName.isEmpty())
-    QFile::remove(tmpfileName);
 
   if (warnings.size() > 0)
     warnmsg = warnings.join("\n");
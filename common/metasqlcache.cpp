@@ -0,0 +1,187 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2014 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#include "metasqlcache.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QHash>
+
+#include <metasql.h>
+#include <mqledit.h>
+
+#include "xsqlquery.h"
+
+#define DEBUG false
+
+// the number of parsed statements kept
+#define METASQLCACHE_SIZE 200
+
+/** @class MetaSQLCache
+
+    @brief Keeps parsed MetaSQL statements and their parameter lists for
+           the life of the process.
+
+    Entries are keyed by MetaSQL group, name, grade and the md5 of the
+    statement text, so a statement is parsed again only when its text
+    changes. Editing or regrading a metasql row changes the key and the old
+    entry simply ages out of the cache; nothing needs to be told about the
+    change. Custom query text is cached by its md5 alone.
+
+    loadQuerySet() reads every MetaSQL item of a query set in one query. The
+    server returns the md5 of each statement and sends the text only for
+    statements the cache does not already hold.
+ */
+
+MetaSQLCache *MetaSQLCache::_instance = 0;
+
+MetaSQLCache::MetaSQLCache()
+  : _cache(METASQLCACHE_SIZE)
+{
+}
+
+MetaSQLCache *MetaSQLCache::instance()
+{
+  if (! _instance)
+    _instance = new MetaSQLCache();
+
+  return _instance;
+}
+
+void MetaSQLCache::clear()
+{
+  _cache.clear();
+}
+
+QString MetaSQLCache::key(const QString &group, const QString &name,
+                          int grade, const QString &hash)
+{
+  return QString("%1\t%2\t%3\t%4").arg(group, name).arg(grade).arg(hash);
+}
+
+/* Return the cached entry for the key, parsing @a text if there is none. */
+MetaSQLCacheEntry MetaSQLCache::entry(const QString &group, const QString &name,
+                                      int grade, const QString &hash,
+                                      const QString &text)
+{
+  QString k = key(group, name, grade, hash);
+  if (_cache.contains(k))
+    return *_cache.object(k);
+
+  MetaSQLCacheEntry *result = new MetaSQLCacheEntry();
+  result->group = group;
+  result->name  = name;
+  result->grade = grade;
+  result->hash  = hash;
+  result->text  = text;
+
+  result->query  = QSharedPointer<MetaSQLQuery>(new MetaSQLQuery(result->text));
+  result->valid  = result->query->isValid();
+  result->params = MQLEdit::getParamsFromMetaSQLText(result->text);
+  if (! result->valid)
+    result->errmsg = QCoreApplication::translate("MetaSQLCache",
+                                                 "Could not parse the MetaSQL statement %1-%2")
+                                                 .arg(group, name);
+
+  if (DEBUG)
+    qDebug("MetaSQLCache parsed %s-%s grade %d (%d params)", qPrintable(group),
+           qPrintable(name), grade, result->params.size());
+
+  MetaSQLCacheEntry copy = *result;
+  _cache.insert(k, result);
+  return copy;
+}
+
+/** @brief Return the parsed form of a custom MetaSQL statement. */
+MetaSQLCacheEntry MetaSQLCache::parse(const QString &text)
+{
+  QString hash = QCryptographicHash::hash(text.toUtf8(),
+                                          QCryptographicHash::Md5).toHex();
+  return entry(QString(), QString(), 0, hash, text);
+}
+
+/** @brief Return the parsed MetaSQL and custom query items of a query set,
+           in the order they are run.
+
+    Items that are whole tables or views are skipped. An MQL item naming a
+    statement that does not exist is returned with valid set to false.
+
+    @param qryheadid The qryhead_id of the query set
+    @param error     Receives the database error, if the query failed
+ */
+QList<MetaSQLCacheEntry> MetaSQLCache::loadQuerySet(int qryheadid, QSqlError &error)
+{
+  QList<MetaSQLCacheEntry> result;
+
+  // the text of statements already cached, possibly under another name
+  QHash<QString, QString> known;
+  foreach (QString k, _cache.keys())
+    known.insert(k.section('\t', 3), _cache.object(k)->text);
+
+  XSqlQuery itemq;
+  itemq.prepare("SELECT qryitem_id, qryitem_src, qryitem_group, qryitem_detail,"
+                "       COALESCE(metasql_grade, 0) AS grade, md5(src_text) AS hash,"
+                "       CASE WHEN md5(src_text) = ANY(CAST(:known AS TEXT[])) THEN NULL"
+                "            ELSE src_text END AS text"
+                "  FROM (SELECT qryitem_id, qryitem_order, qryitem_src,"
+                "               qryitem_group, qryitem_detail, metasql_grade,"
+                "               CASE qryitem_src WHEN 'MQL' THEN metasql_query"
+                "                                ELSE qryitem_detail END AS src_text"
+                "          FROM qryitem"
+                "          LEFT OUTER JOIN"
+                "               (SELECT DISTINCT ON (metasql_group, metasql_name)"
+                "                       metasql_group, metasql_name,"
+                "                       metasql_grade, metasql_query"
+                "                  FROM metasql"
+                "                  JOIN qryitem ON (metasql_group=qryitem_group"
+                "                               AND metasql_name=qryitem_detail)"
+                "                 WHERE ((qryitem_qryhead_id=:id)"
+                "                    AND (qryitem_src='MQL'))"
+                "                 ORDER BY metasql_group, metasql_name,"
+                "                          metasql_grade DESC) AS mql"
+                "            ON ((qryitem_src='MQL')"
+                "            AND (metasql_group=qryitem_group)"
+                "            AND (metasql_name=qryitem_detail))"
+                "         WHERE ((qryitem_qryhead_id=:id)"
+                "            AND (qryitem_src IN ('MQL', 'CUSTOM')))) AS items"
+                " ORDER BY qryitem_order;");
+  itemq.bindValue(":id",    qryheadid);
+  itemq.bindValue(":known", "{" + QStringList(known.keys()).join(",") + "}");
+  itemq.exec();
+  while (itemq.next())
+  {
+    QString src  = itemq.value("qryitem_src").toString();
+    QString hash = itemq.value("hash").toString();
+    QString text = itemq.value("text").isNull() ? known.value(hash)
+                                                : itemq.value("text").toString();
+    MetaSQLCacheEntry item;
+    if (itemq.value("hash").isNull())
+    {
+      item.group  = itemq.value("qryitem_group").toString();
+      item.name   = itemq.value("qryitem_detail").toString();
+      item.errmsg = QCoreApplication::translate("MetaSQLCache",
+                                                "Could not find the MetaSQL statement %1-%2")
+                                                .arg(item.group, item.name);
+    }
+    else if (src == "MQL")
+      item = entry(itemq.value("qryitem_group").toString(),
+                   itemq.value("qryitem_detail").toString(),
+                   itemq.value("grade").toInt(), hash, text);
+    else
+      item = entry(QString(), QString(), 0, hash, text);
+
+    item.qryitemid = itemq.value("qryitem_id").toInt();
+    item.src       = src;
+    result.append(item);
+  }
+  error = itemq.lastError();
+
+  return result;
+}
@@ -0,0 +1,64 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2014 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#ifndef __METASQLCACHE_H__
+#define __METASQLCACHE_H__
+
+#include <QCache>
+#include <QList>
+#include <QSharedPointer>
+#include <QSqlError>
+#include <QString>
+#include <QStringList>
+
+class MetaSQLQuery;
+
+/** @brief A MetaSQL statement parsed by MetaSQLCache. */
+struct MetaSQLCacheEntry
+{
+  MetaSQLCacheEntry() : qryitemid(-1), grade(-1), valid(false) {}
+
+  int     qryitemid;    //!< the query set item this entry was loaded for, if any
+  QString src;          //!< the qryitem_src of that item: MQL or CUSTOM
+  QString group;
+  QString name;
+  int     grade;
+  QString hash;         //!< md5 of the MetaSQL text
+  QString text;
+  QStringList params;   //!< the parameter names used by the text
+  QSharedPointer<MetaSQLQuery> query;
+  bool    valid;
+  QString errmsg;
+};
+
+class MetaSQLCache
+{
+  public:
+    static MetaSQLCache *instance();
+
+    MetaSQLCacheEntry        parse(const QString &text);
+    QList<MetaSQLCacheEntry> loadQuerySet(int qryheadid, QSqlError &error);
+    void                     clear();
+
+  protected:
+    MetaSQLCache();
+
+    static QString key(const QString &group, const QString &name,
+                       int grade, const QString &hash);
+
+    MetaSQLCacheEntry  entry(const QString &group, const QString &name,
+                             int grade, const QString &hash,
+                             const QString &text);
+
+    QCache<QString, MetaSQLCacheEntry> _cache;
+    static MetaSQLCache *_instance;
+};
+
+#endif
@@ -10,21 +10,72 @@
 
 
 #include "metrics.h"
+#include <QCoreApplication>
+#include <QMutex>
 #include <QSqlError>
 #include <QSqlDatabase>
 #include <QSqlDriver>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QThread>
+#include <QTimerEvent>
 #include <QVariant>
+#include <QWaitCondition>
 #include "xsqlquery.h"
 #include <QMessageBox>
 
+#include "errorReporter.h"
+
+// how long preference changes wait to be written with the changes after them
+#define PREFERENCES_FLUSHDELAY 500
+
+/* Format a list of strings as a PostgreSQL text array literal. */
+static QString textArray(const QStringList &list)
+{
+  QStringList quoted;
+  foreach (QString elem, list)
+    quoted << "\"" + QString(elem).replace("\\", "\\\\").replace("\"", "\\\"") + "\"";
+  return "{" + quoted.join(",") + "}";
+}
+
+/** @class Parameters
+
+    @brief A name/value table read into memory, such as the metrics or the
+           current user's preferences.
+
+    set() updates the in-memory map at once and queues the database write.
+    Writes are sent when the batch is committed, or, when no batch is open,
+    straight away or after a short delay for subclasses that set
+    _flushDelay. Queued values are written with a single statement that
+    calls the usual set function once per value, so saving a setup screen
+    or closing a window costs one round trip instead of one per value.
+
+    Wrap code that sets many values in beginBatch() and commitBatch().
+    Batches nest; the values are written when the outermost batch is
+    committed. load() and the application's aboutToQuit() signal write any
+    values still queued. Values that could not be written stay queued and
+    are tried again on the next flush; the first failure is reported.
+ */
 Parameters::Parameters(QObject * parent)
   : QObject(parent)
 {
-  _dirty = false;
+  _dirty       = false;
+  _batchDepth  = 0;
+  _flushDelay  = 0;
+  _flushFailed = false;
+
+  if (QCoreApplication::instance())
+    connect(QCoreApplication::instance(), SIGNAL(aboutToQuit()), this, SLOT(flush()));
+}
+
+Parameters::~Parameters()
+{
+  flush();
 }
 
 void Parameters::load()
 {
+  flush();
   _values.clear();
 
   XSqlQuery q;
@@ -39,6 +90,10 @@ void Parameters::load()
     return;
   }
 
+  // values that failed to save are still the ones in effect here
+  for (MetricMap::const_iterator it = _pending.constBegin(); it != _pending.constEnd(); it++)
+    _values[it.key()] = it.value();
+
   _dirty = false;
 
   emit loaded();
@@ -57,6 +112,7 @@ QString Parameters::value(const char *pName)
 
 QString Parameters::value(const QString &pName)
 {
+  waitForValues();
   MetricMap::iterator it = _values.find(pName);
   if (it == _values.end())
     return QString::null;
@@ -71,6 +127,7 @@ bool Parameters::boolean(const char *pName)
 
 bool Parameters::boolean(const QString &pName)
 {
+  waitForValues();
   MetricMap::iterator it = _values.find(pName);
   if (it == _values.end())
     return false;
@@ -123,18 +180,136 @@ void Parameters::set(const QString &pName, const QString &pValue)
 
 void Parameters::_set(const QString &pName, QVariant pValue)
 {
+  _pending.insert(pName, pValue.toString());
+
+  if (_batchDepth > 0)
+    return;
+  else if (_flushDelay <= 0 || ! QCoreApplication::instance())
+    flush();
+  else if (! _timer.isActive())
+    _timer.start(_flushDelay, this);
+}
+
+/** @brief Queue the values set from now on until the matching commitBatch(). */
+void Parameters::beginBatch()
+{
+  _batchDepth++;
+}
+
+/** @brief Close a batch opened with beginBatch(), writing the queued values
+           if this was the outermost batch.
+
+    @return false if the values could not be written
+ */
+bool Parameters::commitBatch()
+{
+  if (_batchDepth > 0)
+    _batchDepth--;
+
+  return _batchDepth > 0 ? true : flush();
+}
+
+/** @brief Write every queued value to the database now.
+
+    @return false if some values could not be written. They stay queued.
+ */
+bool Parameters::flush()
+{
+  _timer.stop();
+  if (_pending.isEmpty())
+    return true;
+
+  if (! QSqlDatabase::database(QSqlDatabase::defaultConnection, false).isOpen())
+  {
+    reportFlushError(tr("Not connected to the database."));
+    return false;
+  }
+
   XSqlQuery q;
-  q.prepare(_setSql);
-  q.bindValue(":username", _username);
-  q.bindValue(":name", pName);
-  q.bindValue(":value", pValue);
-  q.exec();
+  QString   err;
+  if (_pending.size() == 1 || _setBatchSql.isEmpty())
+  {
+    // one bad value must not hold back the ones after it
+    q.prepare(_setSql);
+    MetricMap::iterator it = _pending.begin();
+    while (it != _pending.end())
+    {
+      q.bindValue(":username", _username);
+      q.bindValue(":name",     it.key());
+      q.bindValue(":value",    it.value());
+      if (q.exec())
+      {
+        it = _pending.erase(it);
+        _dirty = true;
+      }
+      else
+      {
+        err = q.lastError().text();
+        it++;
+      }
+    }
+  }
+  else
+  {
+    q.prepare(_setBatchSql);
+    q.bindValue(":username", _username);
+    q.bindValue(":names",    textArray(_pending.keys()));
+    q.bindValue(":values",   textArray(_pending.values()));
+    if (q.exec())
+    {
+      _pending.clear();
+      _dirty = true;
+    }
+    else
+      err = q.lastError().text();
+  }
 
-  _dirty = true;
+  if (! _pending.isEmpty())
+  {
+    reportFlushError(err);
+    return false;
+  }
+
+  _flushFailed = false;
+  return true;
+}
+
+/* Tell the user once that values could not be saved, rather than on every
+   retry while the problem lasts.
+ */
+void Parameters::reportFlushError(const QString &err)
+{
+  if (_flushFailed)
+    return;
+  _flushFailed = true;
+
+  QString title = tr("Error Saving %1").arg(metaObject()->className());
+  QString msg   = tr("%n value(s) could not be saved. They will be tried "
+                     "again the next time settings are saved.", 0, _pending.size());
+  if (QCoreApplication::instance())
+    ErrorReporter::error(QtWarningMsg, 0, title, msg, err, __FILE__, __LINE__);
+  else
+    qWarning("%s: %s %s", qPrintable(title), qPrintable(msg), qPrintable(err));
+}
+
+/** @brief Called before every read of the values. Subclasses that fill
+           _values asynchronously make sure the values are there.
+ */
+void Parameters::waitForValues()
+{
+}
+
+void Parameters::timerEvent(QTimerEvent *event)
+{
+  if (event->timerId() == _timer.timerId())
+    flush();
+  else
+    QObject::timerEvent(event);
 }
 
 QString Parameters::parent(const QString &pValue)
 {
+  waitForValues();
   for (MetricMap::iterator it = _values.begin(); it != _values.end(); it++)
     if (it.value() == pValue)
       return it.key();
@@ -148,6 +323,9 @@ Metrics::Metrics()
   _notifyName = "metricsUpdated";
   _readSql = "SELECT metric_name AS key, metric_value AS value FROM metric;";
   _setSql  = "SELECT setMetric(:name, :value);";
+  _setBatchSql = "SELECT setMetric((CAST(:names AS TEXT[]))[i],"
+                 "                 (CAST(:values AS TEXT[]))[i])"
+                 "  FROM generate_subscripts(CAST(:names AS TEXT[]), 1) AS i;";
 
   load();
 }
@@ -160,13 +338,21 @@ Preferences::Preferences(const QString &pUsername)
               "FROM usrpref "
               "WHERE (usrpref_username=:username);";
   _setSql   = "SELECT setUserPreference(:username, :name, :value);";
-  _username = pUsername;
+  _setBatchSql = "SELECT setUserPreference(:username,"
+                 "                         (CAST(:names AS TEXT[]))[i],"
+                 "                         (CAST(:values AS TEXT[]))[i])"
+                 "  FROM generate_subscripts(CAST(:names AS TEXT[]), 1) AS i;";
+  _username   = pUsername;
+  _flushDelay = PREFERENCES_FLUSHDELAY;
 
   load();
 }
 
 void Preferences::remove(const QString &pPrefName)
 {
+  _pending.remove(pPrefName);
+  _values.remove(pPrefName);
+
   XSqlQuery q;
   q.prepare("SELECT deleteUserPreference(:prefname);");
   q.bindValue(":prefname", pPrefName);
@@ -176,64 +362,392 @@ void Preferences::remove(const QString &pPrefName)
 }
 
 
+/* Read the privileges granted to @a username, directly or through a role,
+   using @a db. Used on the loader thread's connection and, if that cannot
+   connect, on the application's own connection.
+ */
+static MetricMap readPrivileges(QSqlDatabase db, const QString &sql,
+                                const QString &username, QString &errmsg)
+{
+  MetricMap result;
+
+  QSqlQuery q(db);
+  q.setForwardOnly(true);
+  q.prepare(sql);
+  q.bindValue(":username", username);
+  if (! q.exec())
+  {
+    errmsg = q.lastError().text();
+    return result;
+  }
+
+  while (q.next())
+    result.insert(q.value(0).toString(), q.value(1).toString());
+
+  return result;
+}
+
+/* Reads the privileges on a thread of its own. The thread opens its
+   database connection on the first request and keeps it for later ones,
+   reconnecting only after an error. The connection settings are set
+   before start(). request() and takeResult() are called on the GUI
+   thread; the receiver's sLoaderFinished() is invoked through the event
+   loop when each result is ready.
+ */
+class PrivilegeLoader : public QThread
+{
+  public:
+    PrivilegeLoader(QObject *receiver)
+      : QThread(receiver), port(-1),
+        _receiver(receiver), _requested(false), _stopping(false), _hasResult(false)
+    {
+    }
+
+    QString   driver;
+    QString   database;
+    QString   host;
+    int       port;
+    QString   user;
+    QString   password;
+    QString   options;
+
+    void request(const QString &sql, const QString &username)
+    {
+      QMutexLocker lock(&_mutex);
+      _sql       = sql;
+      _username  = username;
+      _hasResult = false;
+      _requested = true;
+      _wake.wakeAll();
+    }
+
+    /* Block until the last request has been answered. */
+    void waitForResult()
+    {
+      QMutexLocker lock(&_mutex);
+      while (! _hasResult && isRunning())
+        _done.wait(&_mutex, 100);
+    }
+
+    bool takeResult(MetricMap &result, QString &errmsg)
+    {
+      QMutexLocker lock(&_mutex);
+      if (! _hasResult)
+        return false;
+      result     = _result;
+      errmsg     = _errmsg;
+      _hasResult = false;
+      _result.clear();
+      return true;
+    }
+
+    void stop()
+    {
+      QMutexLocker lock(&_mutex);
+      _stopping = true;
+      _wake.wakeAll();
+    }
+
+  protected:
+    void run()
+    {
+      QString name = QString("xtprivileges%1").arg(quintptr(this));
+      {
+        QSqlDatabase db = QSqlDatabase::addDatabase(driver, name);
+        db.setDatabaseName(database);
+        db.setHostName(host);
+        db.setPort(port);
+        db.setUserName(user);
+        db.setPassword(password);
+        db.setConnectOptions(options);
+
+        QMutexLocker lock(&_mutex);
+        forever
+        {
+          while (! _requested && ! _stopping)
+            _wake.wait(&_mutex);
+          if (_stopping)
+            break;
+          _requested = false;
+          QString sql      = _sql;
+          QString username = _username;
+          lock.unlock();
+
+          MetricMap result;
+          QString   errmsg;
+          if (db.isOpen() || db.open())
+            result = readPrivileges(db, sql, username, errmsg);
+          else
+            errmsg = db.lastError().text();
+          if (! errmsg.isEmpty())
+            db.close();   // start with a fresh connection next time
+
+          lock.relock();
+          _result    = result;
+          _errmsg    = errmsg;
+          _hasResult = true;
+          _done.wakeAll();
+          QMetaObject::invokeMethod(_receiver, "sLoaderFinished", Qt::QueuedConnection);
+        }
+        db.close();
+      }
+      QSqlDatabase::removeDatabase(name);
+    }
+
+  private:
+    QObject        *_receiver;
+    QMutex          _mutex;
+    QWaitCondition  _wake;
+    QWaitCondition  _done;
+    bool            _requested;
+    bool            _stopping;
+    bool            _hasResult;
+    QString         _sql;
+    QString         _username;
+    MetricMap       _result;
+    QString         _errmsg;
+};
+
+/** @class Privileges
+
+    @brief The privileges granted to the current user, directly or through
+           a role.
+
+    check() accepts the compound expressions used for menu items, where
+    spaces separate alternatives and @c + joins privileges that are all
+    required. Each distinct expression is compiled the first time it is
+    seen into a list of bit masks, one per alternative. Every privilege
+    name gets a permanent bit, and load() rebuilds the bit set of granted
+    privileges, so later checks of the same expression are a few bitwise
+    tests rather than string splitting and map lookups.
+
+    The privileges are read on a background thread that keeps one
+    database connection of its own for every load. The complete set
+    replaces the previous one in a single step on the GUI thread, so a
+    check never sees a partly loaded set and a reload does not freeze the
+    application. ready() is emitted through the event loop after the first
+    set arrives; code that can wait for it should test isReady() and
+    connect to ready(). Every read made before then, whether through
+    check(), value(), boolean() or parent(), waits for the loader.
+    Later loads, including those triggered by the usrprivUpdated
+    notification, keep answering from the current set until the new one
+    arrives and then emit loaded().
+ */
 Privileges::Privileges()
 {
-  _notifyName = "usrprivUpdated";
-  QString user;
+  _notifyName    = "usrprivUpdated";
+  _dba           = -1;
+  _loading       = false;
+  _ready         = false;
+  _reloadPending = false;
+
   XSqlQuery userq("SELECT getEffectiveXtUser() AS user;");
   if (userq.lastError().type() != QSqlError::NoError)
     userq.exec("SELECT CURRENT_USER AS user;");
   if (userq.first())
-    user = userq.value("user").toString();
+    _username = userq.value("user").toString();
 
-  _readSql = QString("SELECT priv_name AS key, TEXT('t') AS value "
+  _readSql = "SELECT priv_name AS key, TEXT('t') AS value "
              "  FROM usrpriv, priv "
              " WHERE((usrpriv_priv_id=priv_id)"
-             "   AND (usrpriv_username='%1')) "
+             "   AND (usrpriv_username=:username)) "
              " UNION "
              "SELECT priv_name AS key, TEXT('t') AS value "
              "  FROM priv, grppriv, usrgrp"
              " WHERE((usrgrp_grp_id=grppriv_grp_id)"
              "   AND (grppriv_priv_id=priv_id)"
-             "   AND (usrgrp_username='%1'));").arg(user);
+             "   AND (usrgrp_username=:username));";
+
+  QSqlDatabase db = QSqlDatabase::database();
+  _loader = new PrivilegeLoader(this);
+  _loader->driver   = db.driverName();
+  _loader->database = db.databaseName();
+  _loader->host     = db.hostName();
+  _loader->port     = db.port();
+  _loader->user     = db.userName();
+  _loader->password = db.password();
+  _loader->options  = db.connectOptions();
+  _loader->start();
 
   QSqlDatabase::database().driver()->subscribeToNotification("usrprivUpdated");
   QObject::connect(QSqlDatabase::database().driver(), SIGNAL(notification(const QString&)),
            this, SLOT(sSetDirty(const QString &)));
+  QObject::connect(this, SIGNAL(loaded()), this, SLOT(sLoaded()));
 
   load();
 }
 
-bool Privileges::check(const QString &pName)
+Privileges::~Privileges()
 {
-    if (pName == "#superuser")
-      return isDba();
+  _loader->stop();
+  _loader->wait();
+}
 
-    if(_dirty)
-      load();
+/** @brief Start reading the privileges again in the background. */
+void Privileges::load()
+{
+  if (_loading)
+  {
+    _reloadPending = true;
+    return;
+  }
 
-    MetricMap::iterator it = _values.find(pName);
-    if (it != _values.end())
-      return true;
+  _dirty         = false;
+  _reloadPending = false;
+  _loading       = true;
+  _loader->request(_readSql, _username);
+}
 
-    if (pName.contains(" ")) {
-      QStringList privlist = pName.split(' ', QString::SkipEmptyParts);
-      foreach (QString priv, privlist) {
-        if (check(priv))
-          return true;
-      }
+bool Privileges::isReady() const
+{
+  return _ready;
+}
+
+/** @brief Block until the first set of privileges has been loaded. */
+void Privileges::waitForReady()
+{
+  if (_ready)
+    return;
+
+  if (! _loading)
+    load();
+  _loader->waitForResult();
+  sLoaderFinished();
+}
+
+/* The gate every read of the privileges goes through. */
+void Privileges::waitForValues()
+{
+  if (! _ready)
+    waitForReady();
+  else if (_dirty && ! _loading)
+    load();
+}
+
+void Privileges::sLoaderFinished()
+{
+  // waitForReady() may have handled this load before the call arrived
+  MetricMap result;
+  QString   loaderErr;
+  if (! _loading || ! _loader->takeResult(result, loaderErr))
+    return;
+  _loading = false;
+
+  if (loaderErr.isEmpty())
+    swap(result);
+  else if (! _ready)
+  {
+    qWarning("Privileges could not be read in the background: %s",
+             qPrintable(loaderErr));
+
+    QString   errmsg;
+    MetricMap privs = readPrivileges(QSqlDatabase::database(), _readSql,
+                                     _username, errmsg);
+    if (! errmsg.isEmpty())
+      QMessageBox::critical(0, tr("Error loading %1").arg(metaObject()->className()),
+                            errmsg);
+    swap(privs);
+  }
+  else
+    qWarning("Privileges could not be reloaded: %s", qPrintable(loaderErr));
+
+  if (_reloadPending || _dirty)
+    load();
+}
+
+void Privileges::swap(const MetricMap &privs)
+{
+  _values = privs;
+
+  if (_ready)
+    emit loaded();
+  else
+  {
+    sLoaded();
+    _ready = true;
+    // swap() can run inside a check() that had to wait for the loader, so
+    // let the caller finish before slots connected to ready() run
+    QMetaObject::invokeMethod(this, "ready", Qt::QueuedConnection);
+  }
+}
+
+void Privileges::sLoaded()
+{
+  for (MetricMap::iterator it = _values.begin(); it != _values.end(); it++)
+    bit(it.key());
+
+  _granted = QBitArray(_bits.size());
+  for (MetricMap::iterator it = _values.begin(); it != _values.end(); it++)
+    _granted.setBit(_bits.value(it.key()));
+
+  _dba = -1;
+}
+
+int Privileges::bit(const QString &pName)
+{
+  QHash<QString, int>::const_iterator it = _bits.constFind(pName);
+  if (it != _bits.constEnd())
+    return it.value();
+
+  int result = _bits.size();
+  _bits.insert(pName, result);
+  _granted.resize(_bits.size());
+  return result;
+}
+
+QList<Privileges::Term> Privileges::compile(const QString &pName)
+{
+  QList<Term> result;
+  foreach (QString alternative, pName.split(' ', QString::SkipEmptyParts))
+  {
+    QList<int> bits;
+    Term       term;
+    term.superuser = false;
+    foreach (QString priv, alternative.split('+', QString::SkipEmptyParts))
+    {
+      if (priv == "#superuser")
+        term.superuser = true;
+      else
+        bits.append(bit(priv));
     }
 
-    if (pName.contains("+")) {
-      bool anded = true;
-      QStringList privlist = pName.split('+', QString::SkipEmptyParts);
-      foreach (QString priv, privlist) {
-        anded = anded && check(priv);
+    term.required = QBitArray(_bits.size());
+    foreach (int b, bits)
+      term.required.setBit(b);
+    result.append(term);
+  }
+  return result;
+}
+
+bool Privileges::check(const QString &pName)
+{
+    waitForValues();
+
+    QHash<QString, QList<Term> >::iterator it = _compiled.find(pName);
+    if (it == _compiled.end())
+      it = _compiled.insert(pName, compile(pName));
+
+    QList<Term> &terms = it.value();
+    for (int i = 0; i < terms.size(); i++)
+    {
+      Term &term = terms[i];
+      if (term.superuser)
+      {
+        if (_dba < 0)
+          _dba = isDba() ? 1 : 0;
+        if (! _dba)
+          continue;
       }
-      return anded;
+
+      // names seen since this expression was compiled only add zero bits
+      if (term.required.size() != _granted.size())
+        term.required.resize(_granted.size());
+
+      if ((term.required & _granted) == term.required)
+        return true;
     }
 
- return false;
+    return false;
 }
 
 bool Privileges::isDba()
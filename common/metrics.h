@@ -12,6 +12,10 @@
 #ifndef metrics_h
 #define metrics_h
 
+#include <QBasicTimer>
+#include <QBitArray>
+#include <QHash>
+#include <QList>
 #include <QObject>
 #include <QString>
 #include <QMap>
@@ -29,12 +33,21 @@ class Parameters : public QObject
     QString   _username;
     bool      _dirty;
     QString   _notifyName;
+    QString   _setBatchSql;
+    MetricMap _pending;
+    int       _batchDepth;
+    int       _flushDelay;
+    bool      _flushFailed;
+    QBasicTimer _timer;
 
   public:
     Parameters(QObject * parent = 0);
-    virtual ~Parameters() {};
+    virtual ~Parameters();
 
-    void load();
+    virtual void load();
+
+    Q_INVOKABLE void beginBatch();
+    Q_INVOKABLE bool commitBatch();
 
     QString value(const char *);
     bool    boolean(const char *);
@@ -52,9 +65,13 @@ class Parameters : public QObject
     QString value(const QString &);
     bool    boolean(const QString &);
     void    sSetDirty(const QString &);
+    bool    flush();
 
   protected:
     void _set(const QString &, QVariant);
+    void reportFlushError(const QString &);
+    virtual void waitForValues();
+    void timerEvent(QTimerEvent *);
 
   signals:
     void loaded();
@@ -80,16 +97,54 @@ class Preferences : public Parameters
     void remove(const QString &);
 };
 
+class PrivilegeLoader;
+
 class Privileges : public Parameters
 {
   Q_OBJECT
 
   public:
     Privileges();
+    virtual ~Privileges();
+
+    virtual void load();
+    bool         isReady() const;
+    void         waitForReady();
 
   public slots:
     bool check(const QString &);
     bool isDba();
+
+  signals:
+    void ready();
+
+  protected:
+    virtual void waitForValues();
+
+  protected slots:
+    void sLoaded();
+    void sLoaderFinished();
+
+  private:
+    struct Term
+    {
+      QBitArray required;
+      bool      superuser;
+    };
+
+    QList<Term> compile(const QString &);
+    int         bit(const QString &);
+
+    QHash<QString, int>          _bits;
+    QHash<QString, QList<Term> > _compiled;
+    QBitArray                    _granted;
+    int                          _dba;
+    PrivilegeLoader             *_loader;
+    bool                         _loading;
+    bool                         _ready;
+    bool                         _reloadPending;
+
+    void swap(const MetricMap &);
 };
 
 #endif
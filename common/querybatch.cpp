@@ -0,0 +1,461 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2014 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#include "querybatch.h"
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QSqlRecord>
+
+#include <climits>
+
+#include "queryprofiler.h"
+#include "sqltext.h"
+#include "xsqlquery.h"
+
+#define DEBUG false
+
+QueryBatchResult::QueryBatchResult()
+  : _at(-1),
+    _active(false)
+{
+}
+
+/** @brief Return true if the statement ran, whether or not it returned rows. */
+bool QueryBatchResult::isActive() const
+{
+  return _active;
+}
+
+QSqlError QueryBatchResult::lastError() const
+{
+  return _error;
+}
+
+int QueryBatchResult::size() const
+{
+  return _active ? _rows.size() : -1;
+}
+
+int QueryBatchResult::at() const
+{
+  return _at;
+}
+
+bool QueryBatchResult::first()
+{
+  return seek(0);
+}
+
+bool QueryBatchResult::next()
+{
+  return seek(_at + 1);
+}
+
+bool QueryBatchResult::seek(int index)
+{
+  if (index < 0 || index >= _rows.size())
+  {
+    _at = _rows.isEmpty() ? -1 : _rows.size();
+    return false;
+  }
+
+  _at = index;
+  return true;
+}
+
+QVariant QueryBatchResult::value(const QString &name) const
+{
+  if (_at < 0 || _at >= _rows.size())
+    return QVariant();
+
+  return _rows.at(_at).value(name);
+}
+
+bool QueryBatchResult::isNull(const QString &name) const
+{
+  return value(name).isNull();
+}
+
+/** @class QueryBatch
+
+    @brief Runs several independent read-only queries in one round trip to
+           the database server.
+
+    Windows often fill their header fields with a handful of small SELECT
+    statements that do not depend on each other, each costing a full round
+    trip. Queue them in a QueryBatch instead and read the results back in
+    the order they were added:
+
+    @code
+    QueryBatch batch;
+    int totals  = batch.add("SELECT SUM(coitem_qtyord) AS qty"
+                            "  FROM coitem WHERE (coitem_cohead_id=:head_id);");
+    batch.bindValue(totals, ":head_id", _soheadid);
+    int weights = batch.add(weightQuery);   // an XSqlQuery already prepared and bound
+    batch.exec();
+
+    QueryBatchResult &r = batch.result(totals);
+    if (r.first())
+      _qty->setDouble(r.value("qty").toDouble());
+    else if (ErrorReporter::error(QtCriticalMsg, this, tr("Error"),
+                                  r.lastError(), __FILE__, __LINE__))
+      return;
+    @endcode
+
+    The Qt PostgreSQL driver sends one statement at a time and cannot use
+    libpq's pipeline mode, so the batch wraps the SELECT statements in a
+    single query with one column per statement. Each column holds that
+    statement's rows as JSON, in the order the statement returned them,
+    with every value sent as text so NUMERIC columns keep their exact
+    digits. This has some consequences for callers:
+    - whole numbers come back as integers, other numbers as their exact
+      text, which QVariant::toDouble() converts
+    - dates and timestamps come back as ISO 8601 strings, which
+      QVariant::toDate() and toDateTime() convert back
+    - a row holds only one value per column name, so statements must not
+      return two columns with the same name
+    - the statements all see the same snapshot of the database, so a
+      statement must not depend on the side effects of an earlier one
+
+    Statements that are not SELECT or WITH queries run on their own. If
+    the combined query fails, each statement is run again on its own so
+    the error is reported against the statement that caused it and the
+    other results are still available.
+ */
+
+QueryBatch::QueryBatch()
+  : _roundTrips(0)
+{
+}
+
+/** @brief Queue @a sql and return its index. Bind values with bindValue(). */
+int QueryBatch::add(const QString &sql)
+{
+  Statement stmt;
+  stmt.sql = sql.trimmed();
+  while (stmt.sql.endsWith(';'))
+    stmt.sql = stmt.sql.left(stmt.sql.length() - 1).trimmed();
+
+  _statements.append(stmt);
+  _results.append(QueryBatchResult());
+  return _statements.size() - 1;
+}
+
+/** @brief Queue a query that has been prepared and bound but not executed. */
+int QueryBatch::add(const XSqlQuery &prepared)
+{
+  int statement = add(prepared.lastQuery());
+
+  QMapIterator<QString, QVariant> it(prepared.boundValues());
+  while (it.hasNext())
+  {
+    it.next();
+    bindValue(statement, it.key(), it.value());
+  }
+
+  return statement;
+}
+
+void QueryBatch::bindValue(int statement, const QString &placeholder,
+                           const QVariant &value)
+{
+  if (statement < 0 || statement >= _statements.size())
+    return;
+
+  QString name = placeholder.startsWith(':') ? placeholder : ":" + placeholder;
+  _statements[statement].binds.insert(name, value);
+}
+
+void QueryBatch::clear()
+{
+  _statements.clear();
+  _results.clear();
+  _roundTrips = 0;
+}
+
+int QueryBatch::count() const
+{
+  return _statements.size();
+}
+
+/** @brief Return the number of queries sent to the server by the last exec(). */
+int QueryBatch::roundTrips() const
+{
+  return _roundTrips;
+}
+
+QueryBatchResult &QueryBatch::result(int statement)
+{
+  static QueryBatchResult invalid;
+  if (statement < 0 || statement >= _results.size())
+  {
+    invalid = QueryBatchResult();
+    return invalid;
+  }
+
+  return _results[statement];
+}
+
+/** @brief Run every queued statement.
+
+    @return false if any statement failed. The results of the statements
+            that succeeded are still available.
+ */
+bool QueryBatch::exec()
+{
+  _roundTrips = 0;
+
+  QList<int> combined;
+  for (int i = 0; i < _statements.size(); i++)
+  {
+    _results[i] = QueryBatchResult();
+    if (isBatchable(_statements.at(i).sql))
+      combined.append(i);
+    else
+      execSingle(i);
+  }
+
+  if (combined.size() == 1)
+    execSingle(combined.first());
+  else if (combined.size() > 1 && ! execCombined(combined))
+  {
+    foreach (int i, combined)
+      execSingle(i);
+  }
+
+  bool ok = true;
+  for (int i = 0; i < _results.size(); i++)
+    if (_results.at(i).lastError().type() != QSqlError::NoError)
+      ok = false;
+
+  return ok;
+}
+
+bool QueryBatch::isBatchable(const QString &sql)
+{
+  QString lower = sql.left(8).toLower();
+  if (! lower.startsWith("select") && ! lower.startsWith("with"))
+    return false;
+
+  // more than one statement cannot be nested in a subquery
+  int i = 0;
+  while (i < sql.length())
+  {
+    int end = skipSqlQuoted(sql, i);
+    if (end > i)
+      i = end;
+    else if (sql.at(i) == ';')
+      return false;
+    else
+      i++;
+  }
+
+  return true;
+}
+
+/* Give each statement's placeholders a unique prefix so statements that use
+   the same name, such as :head_id, with different values can share one
+   query. Quoted text, comments and :: casts are left alone.
+ */
+QString QueryBatch::renamePlaceholders(const QString &sql, const QStringList &names,
+                                       const QString &prefix)
+{
+  QString result;
+  result.reserve(sql.length() + names.size() * prefix.length());
+
+  int i = 0;
+  while (i < sql.length())
+  {
+    int skip = skipSqlQuoted(sql, i);
+    if (skip > i)
+    {
+      result.append(sql.mid(i, skip - i));
+      i = skip;
+      continue;
+    }
+
+    QChar c = sql.at(i);
+    if (c != ':' ||
+        (i > 0 && sql.at(i - 1) == ':') ||
+        (i + 1 < sql.length() && sql.at(i + 1) == ':'))
+    {
+      result.append(c);
+      i++;
+      continue;
+    }
+
+    int end = i + 1;
+    while (end < sql.length() && (sql.at(end).isLetterOrNumber() || sql.at(end) == '_'))
+      end++;
+
+    QString name = sql.mid(i, end - i);
+    if (names.contains(name))
+      result.append(":" + prefix + name.mid(1));
+    else
+      result.append(name);
+    i = end;
+  }
+
+  return result;
+}
+
+bool QueryBatch::execCombined(const QList<int> &statements)
+{
+  QStringList columns;
+  QMap<QString, QVariant> binds;
+  foreach (int i, statements)
+  {
+    const Statement &stmt = _statements.at(i);
+    QString prefix = QString("_b%1_").arg(i);
+    QString sql    = renamePlaceholders(stmt.sql, stmt.binds.keys(), prefix);
+    // number the rows as the statement returns them and send every value
+    // as [json type, text] so NUMERIC keeps its digits
+    columns << QString("(SELECT COALESCE(json_agg(_b%1_r ORDER BY _b%1_o), '[]')::text"
+                       "   FROM (SELECT _b%1_o,"
+                       "                (SELECT COALESCE(json_object_agg(_b%1_e.key,"
+                       "                          CASE json_typeof(_b%1_e.value) WHEN 'null' THEN NULL"
+                       "                               ELSE json_build_array(json_typeof(_b%1_e.value),"
+                       "                                                     _b%1_e.value #>> '{}')"
+                       "                          END), '{}')"
+                       "                   FROM json_each(_b%1_j) _b%1_e) AS _b%1_r"
+                       "           FROM (SELECT row_number() OVER () AS _b%1_o,"
+                       "                        row_to_json(_b%1) AS _b%1_j"
+                       "                   FROM (%2\n) _b%1) _b%1_s) _b%1_t) AS _r%1")
+                 .arg(i).arg(sql);
+
+    QMapIterator<QString, QVariant> it(stmt.binds);
+    while (it.hasNext())
+    {
+      it.next();
+      binds.insert(":" + prefix + it.key().mid(1), it.value());
+    }
+  }
+
+  QString sql = "SELECT " + columns.join(",\n       ") + ";";
+
+  XSqlQuery query;
+  query.prepare(sql);
+  QMapIterator<QString, QVariant> it(binds);
+  while (it.hasNext())
+  {
+    it.next();
+    query.bindValue(it.key(), it.value());
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+  bool ok = query.exec() && query.first();
+  _roundTrips++;
+
+  QueryProfiler *profiler = QueryProfiler::instance();
+  if (profiler->isEnabled())
+    profiler->record(query, timer.nsecsElapsed() / 1000);
+
+  if (! ok)
+  {
+    if (DEBUG)
+      qDebug("QueryBatch::execCombined() failed, running %d statements separately: %s",
+             statements.size(), qPrintable(query.lastError().text()));
+    return false;
+  }
+
+  foreach (int i, statements)
+  {
+    QJsonParseError error;
+    QJsonDocument   doc = QJsonDocument::fromJson(query.value(QString("_r%1").arg(i))
+                                                       .toString().toUtf8(), &error);
+    if (error.error != QJsonParseError::NoError || ! doc.isArray())
+      return false;
+
+    QueryBatchResult &result = _results[i];
+    result._rows.clear();
+    foreach (QJsonValue row, doc.array())
+      result._rows.append(fromJson(row.toObject()));
+    result._active = true;
+  }
+
+  if (DEBUG)
+    qDebug("QueryBatch::execCombined() ran %d statements in %lld usec",
+           statements.size(), timer.nsecsElapsed() / 1000);
+  return true;
+}
+
+/* Turn a row sent by execCombined() back into column values. Whole numbers
+   become integers and other numbers stay as their exact text.
+ */
+QVariantMap QueryBatch::fromJson(const QJsonObject &row)
+{
+  QVariantMap result;
+  for (QJsonObject::const_iterator it = row.constBegin(); it != row.constEnd(); ++it)
+  {
+    QJsonArray cell = it.value().toArray();
+    QString    type = cell.at(0).toString();
+    QString    text = cell.at(1).toString();
+
+    QVariant value;
+    if (it.value().isNull() || cell.size() != 2)
+      value = QVariant();
+    else if (type == "boolean")
+      value = (text == "true");
+    else if (type == "number")
+    {
+      bool      isInt = false;
+      qlonglong whole = text.toLongLong(&isInt);
+      if (! isInt)
+        value = text;
+      else if (whole >= INT_MIN && whole <= INT_MAX)
+        value = int(whole);
+      else
+        value = whole;
+    }
+    else
+      value = text;
+
+    result.insert(it.key(), value);
+  }
+  return result;
+}
+
+void QueryBatch::execSingle(int statement)
+{
+  const Statement  &stmt   = _statements.at(statement);
+  QueryBatchResult &result = _results[statement];
+
+  XSqlQuery query;
+  query.prepare(stmt.sql);
+  QMapIterator<QString, QVariant> it(stmt.binds);
+  while (it.hasNext())
+  {
+    it.next();
+    query.bindValue(it.key(), it.value());
+  }
+
+  QueryProfiler::instance()->exec(query);
+  _roundTrips++;
+
+  result = QueryBatchResult();
+  result._error = query.lastError();
+  if (result._error.type() != QSqlError::NoError)
+    return;
+
+  result._active = true;
+  QSqlRecord record = query.record();
+  while (query.next())
+  {
+    QVariantMap row;
+    for (int c = 0; c < record.count(); c++)
+      row.insert(record.fieldName(c), query.value(c));
+    result._rows.append(row);
+  }
+}
@@ -0,0 +1,93 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2014 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#ifndef __QUERYBATCH_H__
+#define __QUERYBATCH_H__
+
+#include <QList>
+#include <QMap>
+#include <QSqlError>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+
+class QJsonObject;
+class XSqlQuery;
+
+/** @brief The rows returned by one statement of a QueryBatch.
+
+  QueryBatchResult is navigated like an XSqlQuery, with first(), next()
+  and value(), so code that read a single query can read its part of a
+  batch with few changes. lastError() carries the error for this statement
+  alone and can be passed to ErrorReporter.
+ */
+class QueryBatchResult
+{
+  public:
+    QueryBatchResult();
+
+    bool      isActive() const;
+    QSqlError lastError() const;
+
+    int       size() const;
+    int       at()   const;
+    bool      first();
+    bool      next();
+    bool      seek(int index);
+
+    QVariant  value(const QString &name) const;
+    bool      isNull(const QString &name) const;
+
+  protected:
+    friend class QueryBatch;
+
+    QList<QVariantMap> _rows;
+    QSqlError          _error;
+    int                _at;
+    bool               _active;
+};
+
+class QueryBatch
+{
+  public:
+    QueryBatch();
+
+    int  add(const QString &sql);
+    int  add(const XSqlQuery &prepared);
+    void bindValue(int statement, const QString &placeholder, const QVariant &value);
+
+    bool exec();
+    void clear();
+
+    int               count() const;
+    int               roundTrips() const;
+    QueryBatchResult &result(int statement);
+
+  protected:
+    struct Statement
+    {
+      QString                 sql;
+      QMap<QString, QVariant> binds;
+    };
+
+    static bool    isBatchable(const QString &sql);
+    static QString renamePlaceholders(const QString &sql, const QStringList &names,
+                                      const QString &prefix);
+    static QVariantMap fromJson(const QJsonObject &row);
+
+    bool execCombined(const QList<int> &statements);
+    void execSingle(int statement);
+
+    QList<Statement>        _statements;
+    QList<QueryBatchResult> _results;
+    int                     _roundTrips;
+};
+
+#endif
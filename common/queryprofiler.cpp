@@ -0,0 +1,570 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#include "queryprofiler.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMdiSubWindow>
+#include <QSet>
+#include <QVariant>
+#include <QWidget>
+
+#include "xsqlquery.h"
+
+#if defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+#define DEBUG false
+
+// keep the trace from growing without bound during a long session
+#define MAXEVENTS 50000
+
+class QueryProfilerPrivate
+{
+  public:
+    struct Statement
+    {
+      Statement() : calls(0), usec(0), rows(0) {}
+      int         calls;
+      qint64      usec;
+      qint64      rows;
+      QSet<uint>  binds;
+    };
+
+    struct Context
+    {
+      Context() : roundTrips(0), usec(0), rows(0) {}
+      int       roundTrips;
+      qint64    usec;
+      qint64    rows;
+      QHash<QString, Statement> statements;
+    };
+
+    struct Operation
+    {
+      Operation() : calls(0), items(0), usec(0) {}
+      int       calls;
+      qint64    items;
+      qint64    usec;
+    };
+
+    struct Event
+    {
+      QString context;
+      QString sql;
+      qint64  start;
+      qint64  usec;
+      int     rows;
+    };
+
+    QueryProfilerPrivate()
+      : enabled(false),
+        threshold(5),
+        updatePending(false)
+    {
+      clock.start();
+    }
+
+    static QString bindString(const XSqlQuery &query)
+    {
+      QStringList result;
+      QMapIterator<QString, QVariant> it(query.boundValues());
+      while (it.hasNext())
+      {
+        it.next();
+        result << it.key() + "=" + it.value().toString();
+      }
+      return result.join(";");
+    }
+
+    bool            enabled;
+    int             threshold;
+    bool            updatePending;
+    QElapsedTimer   clock;
+    QStringList     stack;
+    QStringList     order;
+    QHash<QString, Context> contexts;
+    QStringList     operationOrder;
+    QHash<QString, Operation> operations;
+    QList<Event>    events;
+};
+
+QueryProfiler *QueryProfiler::_singleton = 0;
+
+QueryProfiler::QueryProfiler(QObject *parent)
+  : QObject(parent)
+{
+  _private = new QueryProfilerPrivate();
+}
+
+QueryProfiler::~QueryProfiler()
+{
+  if (_private)
+    delete _private;
+  _private = 0;
+  if (_singleton == this)
+    _singleton = 0;
+}
+
+QueryProfiler *QueryProfiler::instance()
+{
+  if (! _singleton)
+    _singleton = new QueryProfiler(qApp);
+
+  return _singleton;
+}
+
+bool QueryProfiler::isEnabled() const
+{
+  return _private->enabled;
+}
+
+void QueryProfiler::setEnabled(bool enabled)
+{
+  if (_private->enabled == enabled)
+    return;
+
+  _private->enabled = enabled;
+  if (enabled)
+    _private->clock.restart();
+  emit updated();
+}
+
+int QueryProfiler::nPlusOneThreshold() const
+{
+  return _private->threshold;
+}
+
+void QueryProfiler::setNPlusOneThreshold(int calls)
+{
+  _private->threshold = qMax(2, calls);
+  emit updated();
+}
+
+/** @brief Execute a prepared query and record it if profiling is enabled.
+ */
+bool QueryProfiler::exec(XSqlQuery &query)
+{
+  if (! _private->enabled)
+    return query.exec();
+
+  QElapsedTimer timer;
+  timer.start();
+  bool result = query.exec();
+  record(query, timer.nsecsElapsed() / 1000);
+  return result;
+}
+
+/** @brief Execute the given statement and record it if profiling is enabled.
+ */
+bool QueryProfiler::exec(XSqlQuery &query, const QString &sql)
+{
+  if (! _private->enabled)
+    return query.exec(sql);
+
+  QElapsedTimer timer;
+  timer.start();
+  bool result = query.exec(sql);
+  record(query, timer.nsecsElapsed() / 1000);
+  return result;
+}
+
+/** @brief Record a query that has already been executed.
+
+  @param query The executed query, used for its statement text, bind values
+               and row count.
+  @param usec  The round-trip time measured by the caller in microseconds.
+ */
+void QueryProfiler::record(const XSqlQuery &query, qint64 usec)
+{
+  if (! _private->enabled)
+    return;
+
+  int rows = query.isSelect() ? query.size() : query.numRowsAffected();
+  record(currentContext(), query.lastQuery(),
+         QueryProfilerPrivate::bindString(query), usec, qMax(rows, 0));
+}
+
+void QueryProfiler::record(const QString &context, const QString &sql,
+                           const QString &binds, qint64 usec, int rows)
+{
+  if (! _private->enabled)
+    return;
+
+  QString key = sql.simplified();
+  if (! _private->contexts.contains(context))
+    _private->order.append(context);
+
+  QueryProfilerPrivate::Context &ctx = _private->contexts[context];
+  ctx.roundTrips++;
+  ctx.usec  += usec;
+  ctx.rows  += rows;
+
+  QueryProfilerPrivate::Statement &stmt = ctx.statements[key];
+  stmt.calls++;
+  stmt.usec += usec;
+  stmt.rows += rows;
+  stmt.binds.insert(qHash(binds));
+
+  QueryProfilerPrivate::Event event;
+  event.context = context;
+  event.sql     = key;
+  event.usec    = usec;
+  event.start   = _private->clock.nsecsElapsed() / 1000 - usec;
+  event.rows    = rows;
+  if (_private->events.size() >= MAXEVENTS)
+    _private->events.removeFirst();
+  _private->events.append(event);
+
+  if (DEBUG)
+    qDebug("QueryProfiler::record(%s, %lld usec, %d rows) %s",
+           qPrintable(context), usec, rows, qPrintable(key.left(60)));
+
+  if (! _private->updatePending)
+  {
+    _private->updatePending = true;
+    QMetaObject::invokeMethod(this, "sEmitUpdated", Qt::QueuedConnection);
+  }
+}
+
+/** @brief Record client-side work that did not involve a query.
+
+  @param name  What was done, usually the class and method name
+  @param usec  How long it took in microseconds
+  @param items How many rows or records it handled, if that is meaningful
+ */
+void QueryProfiler::recordOperation(const QString &name, qint64 usec, qint64 items)
+{
+  if (! _private->enabled)
+    return;
+
+  if (! _private->operations.contains(name))
+    _private->operationOrder.append(name);
+
+  QueryProfilerPrivate::Operation &op = _private->operations[name];
+  op.calls++;
+  op.items += items;
+  op.usec  += usec;
+
+  QueryProfilerPrivate::Event event;
+  event.context = currentContext();
+  event.sql     = name;
+  event.usec    = usec;
+  event.start   = _private->clock.nsecsElapsed() / 1000 - usec;
+  event.rows    = int(items);
+  if (_private->events.size() >= MAXEVENTS)
+    _private->events.removeFirst();
+  _private->events.append(event);
+}
+
+void QueryProfiler::sEmitUpdated()
+{
+  _private->updatePending = false;
+  emit updated();
+}
+
+void QueryProfiler::pushContext(const QString &context)
+{
+  _private->stack.append(context);
+}
+
+void QueryProfiler::popContext()
+{
+  if (! _private->stack.isEmpty())
+    _private->stack.removeLast();
+}
+
+/** @brief Return the name queries are currently attributed to.
+
+  This is the innermost pushed context if there is one. Otherwise it is the
+  objectName of the window or MDI subwindow containing the focus widget.
+ */
+QString QueryProfiler::currentContext() const
+{
+  if (! _private->stack.isEmpty())
+    return _private->stack.last();
+
+  QWidget *w = QApplication::focusWidget();
+  if (! w)
+    w = QApplication::activeWindow();
+
+  for (; w; w = w->parentWidget())
+  {
+    if (w->isWindow() || qobject_cast<QMdiSubWindow*>(w->parentWidget()))
+      return w->objectName().isEmpty() ? QString(w->metaObject()->className())
+                                       : w->objectName();
+  }
+
+  return tr("(no window)");
+}
+
+QList<QueryProfiler::ContextStats> QueryProfiler::contexts() const
+{
+  QList<ContextStats> result;
+  foreach (QString name, _private->order)
+  {
+    const QueryProfilerPrivate::Context &ctx = _private->contexts[name];
+    ContextStats stats;
+    stats.context    = name;
+    stats.roundTrips = ctx.roundTrips;
+    stats.usec       = ctx.usec;
+    stats.rows       = ctx.rows;
+
+    QHashIterator<QString, QueryProfilerPrivate::Statement> it(ctx.statements);
+    while (it.hasNext())
+    {
+      it.next();
+      StatementStats stmt;
+      stmt.sql           = it.key();
+      stmt.calls         = it.value().calls;
+      stmt.distinctBinds = it.value().binds.size();
+      stmt.usec          = it.value().usec;
+      stmt.rows          = it.value().rows;
+      stats.statements.append(stmt);
+    }
+    result.append(stats);
+  }
+  return result;
+}
+
+/** @brief Return the statements in @a context that were executed at least
+           nPlusOneThreshold() times with as many different bind values.
+ */
+QList<QueryProfiler::StatementStats> QueryProfiler::nPlusOne(const QString &context) const
+{
+  QList<StatementStats> result;
+  if (! _private->contexts.contains(context))
+    return result;
+
+  QHashIterator<QString, QueryProfilerPrivate::Statement> it(_private->contexts[context].statements);
+  while (it.hasNext())
+  {
+    it.next();
+    if (it.value().binds.size() >= _private->threshold)
+    {
+      StatementStats stmt;
+      stmt.sql           = it.key();
+      stmt.calls         = it.value().calls;
+      stmt.distinctBinds = it.value().binds.size();
+      stmt.usec          = it.value().usec;
+      stmt.rows          = it.value().rows;
+      result.append(stmt);
+    }
+  }
+  return result;
+}
+
+QStringList QueryProfiler::nPlusOneContexts() const
+{
+  QStringList result;
+  foreach (QString name, _private->order)
+    if (! nPlusOne(name).isEmpty())
+      result.append(name);
+  return result;
+}
+
+QList<QueryProfiler::OperationStats> QueryProfiler::operations() const
+{
+  QList<OperationStats> result;
+  foreach (QString name, _private->operationOrder)
+  {
+    const QueryProfilerPrivate::Operation &op = _private->operations[name];
+    OperationStats stats;
+    stats.name  = name;
+    stats.calls = op.calls;
+    stats.items = op.items;
+    stats.usec  = op.usec;
+    result.append(stats);
+  }
+  return result;
+}
+
+/** @brief Return the most memory the process has used, in bytes, or -1 if
+           this cannot be determined on this platform.
+ */
+qint64 QueryProfiler::peakMemory()
+{
+#if defined(Q_OS_UNIX)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+#if defined(Q_OS_MAC)
+    return usage.ru_maxrss;
+#else
+    return qint64(usage.ru_maxrss) * 1024;
+#endif
+#endif
+  return -1;
+}
+
+/** @brief Write a summary of the recorded operations and queries as JSON.
+
+  Unlike exportTrace(), which lists every event, this writes one entry per
+  operation and per context with totals and rates, plus the peak memory
+  used by the process. Files written by runs of different builds against
+  the same database and workload can be compared directly.
+ */
+bool QueryProfiler::exportBenchmark(const QString &filename, QString *errmsg) const
+{
+  QFile file(filename);
+  if (! file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    if (errmsg)
+      *errmsg = tr("Could not open %1: %2").arg(filename, file.errorString());
+    return false;
+  }
+
+  QJsonArray operations;
+  foreach (OperationStats op, this->operations())
+  {
+    double seconds = op.usec / 1000000.0;
+    QJsonObject obj;
+    obj.insert("name",        op.name);
+    obj.insert("calls",       op.calls);
+    obj.insert("items",       double(op.items));
+    obj.insert("usec",        double(op.usec));
+    obj.insert("callsPerSec", seconds > 0 ? op.calls / seconds : 0.0);
+    obj.insert("itemsPerSec", seconds > 0 ? op.items / seconds : 0.0);
+    operations.append(obj);
+  }
+
+  QJsonArray contexts;
+  foreach (ContextStats ctx, this->contexts())
+  {
+    QJsonObject obj;
+    obj.insert("context",    ctx.context);
+    obj.insert("roundTrips", ctx.roundTrips);
+    obj.insert("usec",       double(ctx.usec));
+    obj.insert("rows",       double(ctx.rows));
+    contexts.append(obj);
+  }
+
+  QJsonObject root;
+  root.insert("application", QCoreApplication::applicationName());
+  root.insert("version",     QCoreApplication::applicationVersion());
+  root.insert("elapsedUsec", double(_private->clock.nsecsElapsed() / 1000));
+  root.insert("peakMemory",  double(peakMemory()));
+  root.insert("operations",  operations);
+  root.insert("contexts",    contexts);
+  if (file.write(QJsonDocument(root).toJson()) < 0)
+  {
+    if (errmsg)
+      *errmsg = tr("Could not write %1: %2").arg(filename, file.errorString());
+    return false;
+  }
+
+  return true;
+}
+
+/** @brief Write the recorded queries as a Chrome trace-event JSON file.
+
+  Each query becomes one complete event on a track named for its context,
+  so the file can be loaded in chrome://tracing or a compatible viewer.
+ */
+bool QueryProfiler::exportTrace(const QString &filename, QString *errmsg) const
+{
+  QFile file(filename);
+  if (! file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    if (errmsg)
+      *errmsg = tr("Could not open %1: %2").arg(filename, file.errorString());
+    return false;
+  }
+
+  QJsonArray events;
+  foreach (QueryProfilerPrivate::Event event, _private->events)
+  {
+    QJsonObject args;
+    args.insert("rows",  event.rows);
+
+    QJsonObject obj;
+    obj.insert("name", event.sql.left(200));
+    obj.insert("cat",  event.context);
+    obj.insert("ph",   QString("X"));
+    obj.insert("ts",   double(event.start));
+    obj.insert("dur",  double(event.usec));
+    obj.insert("pid",  1);
+    obj.insert("tid",  _private->order.indexOf(event.context) + 1);
+    obj.insert("args", args);
+    events.append(obj);
+  }
+
+  // name each track after its context
+  for (int i = 0; i < _private->order.size(); i++)
+  {
+    QJsonObject args;
+    args.insert("name", _private->order.at(i));
+
+    QJsonObject obj;
+    obj.insert("name", QString("thread_name"));
+    obj.insert("ph",   QString("M"));
+    obj.insert("pid",  1);
+    obj.insert("tid",  i + 1);
+    obj.insert("args", args);
+    events.append(obj);
+  }
+
+  QJsonObject root;
+  root.insert("traceEvents", events);
+  if (file.write(QJsonDocument(root).toJson()) < 0)
+  {
+    if (errmsg)
+      *errmsg = tr("Could not write %1: %2").arg(filename, file.errorString());
+    return false;
+  }
+
+  return true;
+}
+
+void QueryProfiler::reset()
+{
+  _private->order.clear();
+  _private->contexts.clear();
+  _private->operationOrder.clear();
+  _private->operations.clear();
+  _private->events.clear();
+  _private->clock.restart();
+  emit updated();
+}
+
+QueryProfilerScope::QueryProfilerScope(const QString &context)
+  : _pushed(QueryProfiler::instance()->isEnabled())
+{
+  if (_pushed)
+    QueryProfiler::instance()->pushContext(context);
+}
+
+QueryProfilerScope::~QueryProfilerScope()
+{
+  if (_pushed)
+    QueryProfiler::instance()->popContext();
+}
+
+QueryProfilerTimer::QueryProfilerTimer(const char *name, const int *items)
+  : _name(name),
+    _items(items),
+    _enabled(QueryProfiler::instance()->isEnabled())
+{
+  if (_enabled)
+    _timer.start();
+}
+
+QueryProfilerTimer::~QueryProfilerTimer()
+{
+  if (_enabled)
+    QueryProfiler::instance()->recordOperation(_name, _timer.nsecsElapsed() / 1000,
+                                               _items ? *_items : 0);
+}
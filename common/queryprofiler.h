@@ -0,0 +1,169 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#ifndef __QUERYPROFILER_H__
+#define __QUERYPROFILER_H__
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+class QueryProfilerPrivate;
+class XSqlQuery;
+
+/** @brief Collect round-trip statistics for queries, grouped by the window
+           or script that ran them.
+
+  The profiler is off by default. When enabled, queries executed through
+  QueryProfiler::exec() or reported with QueryProfiler::record() are
+  attributed to the current context: the innermost context pushed with
+  pushContext() (or a QueryProfilerScope), otherwise the objectName of the
+  active window.
+
+  Each context keeps its round-trip count, total elapsed time and rows.
+  Result sets are not inspected, so profiling adds no per-row work.
+  Statements are tracked by their prepared text so repeated executions
+  with different bind values can be reported as N+1 patterns.
+
+  Coverage is limited to the call sites that report here. XSqlQuery has no
+  hook that sees every exec(), so a query run any other way is invisible
+  to the profiler and to its N+1 detection. Today that means:
+  - display::sFillList(), which covers the list windows built on display
+  - salesOrder::sFillItemList() and salesOrder::sCalculateTax()
+  - the ScriptToolbox executeQuery(), executeDbQuery() and related calls
+  - statements sent through QueryBatch
+  Absence from the statistics does not mean a window is free of N+1
+  queries, only that it runs them somewhere not listed above.
+
+  All times are measured on the client around exec(), so they include
+  network latency and driver overhead as well as execution on the server.
+ */
+class QueryProfiler : public QObject
+{
+  Q_OBJECT
+
+  public:
+    struct StatementStats
+    {
+      QString sql;
+      int     calls;
+      int     distinctBinds;
+      qint64  usec;
+      qint64  rows;
+    };
+
+    struct OperationStats
+    {
+      QString name;
+      int     calls;
+      qint64  items;
+      qint64  usec;
+    };
+
+    struct ContextStats
+    {
+      QString context;
+      int     roundTrips;
+      qint64  usec;
+      qint64  rows;
+      QList<StatementStats> statements;
+    };
+
+    static QueryProfiler *instance();
+
+    bool isEnabled() const;
+    int  nPlusOneThreshold() const;
+
+    bool exec(XSqlQuery &query);
+    bool exec(XSqlQuery &query, const QString &sql);
+    void record(const XSqlQuery &query, qint64 usec);
+    void record(const QString &context, const QString &sql,
+                const QString &binds, qint64 usec, int rows = 0);
+    void recordOperation(const QString &name, qint64 usec, qint64 items = 0);
+
+    void    pushContext(const QString &context);
+    void    popContext();
+    QString currentContext() const;
+
+    QList<ContextStats>   contexts()  const;
+    QList<StatementStats> nPlusOne(const QString &context) const;
+    QStringList           nPlusOneContexts() const;
+    QList<OperationStats> operations() const;
+
+    bool exportTrace(const QString &filename, QString *errmsg = 0) const;
+    bool exportBenchmark(const QString &filename, QString *errmsg = 0) const;
+
+    static qint64 peakMemory();
+
+  public slots:
+    void reset();
+    void setEnabled(bool enabled);
+    void setNPlusOneThreshold(int calls);
+
+  signals:
+    void updated();
+
+  protected slots:
+    void sEmitUpdated();
+
+  protected:
+    QueryProfiler(QObject *parent = 0);
+    ~QueryProfiler();
+
+    QueryProfilerPrivate  *_private;
+    static QueryProfiler  *_singleton;
+};
+
+/** @brief Attribute every query run during the lifetime of this object to
+           the given context.
+
+  Create one on the stack at the top of a method that runs several queries:
+  @code
+    QueryProfilerScope profile("salesOrder.sFillItemList");
+  @endcode
+  Nothing is pushed unless the profiler is enabled when the scope starts.
+ */
+class QueryProfilerScope
+{
+  public:
+    QueryProfilerScope(const QString &context);
+    ~QueryProfilerScope();
+
+  private:
+    bool _pushed;
+};
+
+/** @brief Time client-side work, such as filling a list or parsing a file,
+           and record it with QueryProfiler::recordOperation().
+
+  Nothing is measured unless the profiler is enabled. If @a items is given,
+  the value it points to when the timer is destroyed is recorded as the
+  number of rows or records handled, so the profiler can report a rate:
+  @code
+    int rows = 0;
+    QueryProfilerTimer timer("XTreeWidget::populate", &rows);
+  @endcode
+ */
+class QueryProfilerTimer
+{
+  public:
+    QueryProfilerTimer(const char *name, const int *items = 0);
+    ~QueryProfilerTimer();
+
+  private:
+    const char    *_name;
+    const int     *_items;
+    bool           _enabled;
+    QElapsedTimer  _timer;
+};
+
+#endif
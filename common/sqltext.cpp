@@ -0,0 +1,91 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#include "sqltext.h"
+
+/** @brief Return the index just past the string constant, quoted
+           identifier, dollar-quoted string or comment that starts at
+           sql[i], or i if none starts there.
+
+  Code that looks for placeholders or statement separators in SQL text
+  uses this to step over the parts where they mean nothing.
+ */
+int skipSqlQuoted(const QString &sql, int i)
+{
+  int   len = sql.length();
+  QChar c   = sql.at(i);
+
+  if (c == '-' && i + 1 < len && sql.at(i + 1) == '-')
+  {
+    int end = sql.indexOf('\n', i);
+    return end < 0 ? len : end + 1;
+  }
+
+  if (c == '/' && i + 1 < len && sql.at(i + 1) == '*')
+  {
+    int depth = 0;      // block comments nest
+    int j     = i;
+    while (j < len)
+    {
+      if (sql.mid(j, 2) == "/*")
+      {
+        depth++;
+        j += 2;
+      }
+      else if (sql.mid(j, 2) == "*/")
+      {
+        j += 2;
+        if (--depth == 0)
+          return j;
+      }
+      else
+        j++;
+    }
+    return len;
+  }
+
+  if (c == '\'' || c == '"')
+  {
+    // E'...' strings allow backslash escapes
+    bool escapes = c == '\'' && i > 0 && sql.at(i - 1).toLower() == 'e' &&
+                   (i < 2 || ! (sql.at(i - 2).isLetterOrNumber() || sql.at(i - 2) == '_'));
+    int j = i + 1;
+    while (j < len)
+    {
+      if (escapes && sql.at(j) == '\\')
+        j += 2;
+      else if (sql.at(j) == c && j + 1 < len && sql.at(j + 1) == c)
+        j += 2;         // a doubled quote stands for itself
+      else if (sql.at(j) == c)
+        return j + 1;
+      else
+        j++;
+    }
+    return len;
+  }
+
+  if (c == '$')
+  {
+    // $$...$$ or $tag$...$tag$, but not $1 or the $ inside an identifier
+    if (i > 0 && (sql.at(i - 1).isLetterOrNumber() || sql.at(i - 1) == '_'))
+      return i;
+    int j = i + 1;
+    while (j < len && (sql.at(j).isLetterOrNumber() || sql.at(j) == '_'))
+      j++;
+    if (j >= len || sql.at(j) != '$' || (j > i + 1 && sql.at(i + 1).isDigit()))
+      return i;
+
+    QString tag = sql.mid(i, j - i + 1);
+    int     end = sql.indexOf(tag, j + 1);
+    return end < 0 ? len : end + tag.length();
+  }
+
+  return i;
+}
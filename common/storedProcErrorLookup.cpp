@@ -15,6 +15,8 @@
 #include <QString>
 #include <QCoreApplication>
 
+#include "queryprofiler.h"
+
 /*	try to address bug 4218
   This code assumes that stored procedures
   return zero or positive integers on success
@@ -1771,7 +1773,10 @@ QString storedProcErrorLookup(const QString procName, const int retVal)
   QString returnStr = "";
 
   if (ErrorLookupHash.isEmpty())
+  {
+    QueryProfilerTimer timer("storedProcErrorLookup init");
     initErrorLookupHash();
+  }
 
   QList<QPair<int, QString> > list = ErrorLookupHash.values(procName.toUpper());
 
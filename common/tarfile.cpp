@@ -13,6 +13,8 @@
 #include <qtextstream.h>
 #include <qbuffer.h>
 
+#include "queryprofiler.h"
+
 struct tarHeaderBlock {
     char name[100];     // name of file
     char mode[8];       // file mode
@@ -54,6 +56,8 @@ TarFile::TarFile(const QByteArray & bytes)
   Q_UNUSED(TYPE_CONTIGUOS);
   _valid = false;
 
+  QueryProfilerTimer timer("TarFile::TarFile");
+
   QByteArray localBytes(bytes);
   QBuffer fin(&localBytes);
   if(!fin.open(QIODevice::ReadOnly))
@@ -0,0 +1,256 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2014 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#include "xslttransformer.h"
+
+#include <QAbstractMessageHandler>
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSourceLocation>
+#include <QStringList>
+#include <QUrl>
+#include <QXmlQuery>
+
+#define DEBUG false
+
+class XSLTMessageHandler : public QAbstractMessageHandler
+{
+  public:
+    XSLTMessageHandler(QObject *p = 0) : QAbstractMessageHandler(p)
+    {
+    }
+
+    QStringList errors;
+
+  protected:
+    virtual void handleMessage(QtMsgType type, const QString &description,
+                               const QUrl &identifier,
+                               const QSourceLocation &sourceLocation)
+    {
+      Q_UNUSED(identifier);
+      if (type == QtDebugMsg || type == QtWarningMsg)
+        return;
+      errors << XSLTTransformer::tr("line %1 column %2: %3")
+                  .arg(sourceLocation.line())
+                  .arg(sourceLocation.column())
+                  .arg(description);
+    }
+};
+
+class XSLTTransformer::Stylesheet
+{
+  public:
+    Stylesheet() : query(QXmlQuery::XSLT20), valid(false)
+    {
+      query.setMessageHandler(&handler);
+    }
+
+    QString            path;
+    QDateTime          modified;
+    XSLTMessageHandler handler;
+    QXmlQuery          query;
+    bool               valid;
+};
+
+/** @class XSLTTransformer
+
+    @brief Applies XSLT stylesheets in-process on a worker thread.
+
+    Each stylesheet is read and compiled once and kept under a key chosen by
+    the caller, usually the xsltmap id and direction. It is compiled again
+    only if the file name or its modification time changes, or after
+    clearCache(). Input and output are passed as memory buffers, so no
+    temporary files are needed.
+
+    transform() blocks the calling thread until the worker has finished,
+    without running an event loop, so callers see it as a synchronous call
+    and no other GUI code can run in the middle of an import or export.
+    A stylesheet that Qt's XSLT engine cannot compile stays marked
+    invalid in the cache, so callers can fall back to an external processor
+    without compiling it again for every file.
+ */
+
+XSLTTransformer *XSLTTransformer::_instance = 0;
+
+XSLTTransformer::XSLTTransformer(QObject *parent)
+  : QThread(parent),
+    _clear(false),
+    _stopping(false)
+{
+}
+
+XSLTTransformer::~XSLTTransformer()
+{
+  _mutex.lock();
+  _stopping = true;
+  _wake.wakeAll();
+  _mutex.unlock();
+  wait();
+
+  if (_instance == this)
+    _instance = 0;
+}
+
+XSLTTransformer *XSLTTransformer::instance()
+{
+  if (! _instance)
+    _instance = new XSLTTransformer(QCoreApplication::instance());
+
+  return _instance;
+}
+
+/** @brief Forget every compiled stylesheet, for example after the XSLT
+           directory or map changes.
+ */
+void XSLTTransformer::clearCache()
+{
+  QMutexLocker locker(&_mutex);
+  _clear = true;
+}
+
+/** @brief Transform @a input with the stylesheet file @a stylesheet.
+
+    @param key        Names the compiled stylesheet in the cache
+    @param stylesheet The full path to the stylesheet file
+    @param input      The XML document to transform
+    @param output     Receives the result
+    @param errmsg     Receives a description of any failure
+    @return true if the transformation succeeded
+ */
+bool XSLTTransformer::transform(const QString &key, const QString &stylesheet,
+                                const QByteArray &input, QByteArray &output,
+                                QString &errmsg)
+{
+  Job job;
+  job.key        = key;
+  job.stylesheet = stylesheet;
+  job.input      = input;
+  job.ok         = false;
+  job.done       = false;
+
+  if (! isRunning())
+    start();
+
+  _mutex.lock();
+  _jobs.enqueue(&job);
+  _wake.wakeOne();
+  _mutex.unlock();
+
+  {
+    QMutexLocker locker(&_mutex);
+    while (! job.done)
+      _finished.wait(&_mutex);
+  }
+
+  output = job.output;
+  errmsg = job.errmsg;
+  return job.ok;
+}
+
+void XSLTTransformer::run()
+{
+  forever
+  {
+    Job *job = 0;
+
+    _mutex.lock();
+    while (_jobs.isEmpty() && ! _stopping)
+      _wake.wait(&_mutex);
+    if (_stopping)
+    {
+      _mutex.unlock();
+      break;
+    }
+    job = _jobs.dequeue();
+    bool clear = _clear;
+    _clear = false;
+    _mutex.unlock();
+
+    if (clear)
+    {
+      qDeleteAll(_cache);
+      _cache.clear();
+    }
+
+    process(job);
+
+    _mutex.lock();
+    job->done = true;
+    _finished.wakeAll();
+    _mutex.unlock();
+  }
+
+  qDeleteAll(_cache);
+  _cache.clear();
+}
+
+void XSLTTransformer::process(Job *job)
+{
+  QFileInfo   info(job->stylesheet);
+  Stylesheet *sheet = _cache.value(job->key);
+  if (sheet && (sheet->path != info.absoluteFilePath() ||
+                sheet->modified != info.lastModified()))
+  {
+    delete sheet;
+    _cache.remove(job->key);
+    sheet = 0;
+  }
+
+  if (! sheet)
+  {
+    QFile file(job->stylesheet);
+    if (! file.open(QIODevice::ReadOnly))
+    {
+      job->errmsg = tr("Could not open %1: %2")
+                      .arg(job->stylesheet, file.errorString());
+      return;
+    }
+
+    sheet = new Stylesheet();
+    sheet->path     = info.absoluteFilePath();
+    sheet->modified = info.lastModified();
+    sheet->query.setQuery(QString::fromUtf8(file.readAll()),
+                          QUrl::fromLocalFile(sheet->path));
+    sheet->valid = sheet->query.isValid();
+    _cache.insert(job->key, sheet);
+
+    if (DEBUG)
+      qDebug("XSLTTransformer compiled %s: %s", qPrintable(sheet->path),
+             sheet->valid ? "valid" : "invalid");
+  }
+
+  if (! sheet->valid)
+  {
+    job->errmsg = tr("The internal XSLT processor cannot use %1: %2")
+                    .arg(sheet->path, sheet->handler.errors.join("\n"));
+    return;
+  }
+
+  sheet->handler.errors.clear();
+
+  QBuffer input(&job->input);
+  input.open(QIODevice::ReadOnly);
+  if (! sheet->query.setFocus(&input))
+  {
+    job->errmsg = tr("Could not read the XML to transform: %1")
+                    .arg(sheet->handler.errors.join("\n"));
+    return;
+  }
+
+  QBuffer output(&job->output);
+  output.open(QIODevice::WriteOnly);
+  job->ok = sheet->query.evaluateTo(&output);
+  if (! job->ok)
+    job->errmsg = tr("The internal XSLT processor failed with %1: %2")
+                    .arg(sheet->path, sheet->handler.errors.join("\n"));
+}
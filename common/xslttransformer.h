@@ -0,0 +1,67 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2014 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#ifndef __XSLTTRANSFORMER_H__
+#define __XSLTTRANSFORMER_H__
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QQueue>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+
+class XSLTTransformer : public QThread
+{
+  Q_OBJECT
+
+  public:
+    static XSLTTransformer *instance();
+
+    bool transform(const QString &key, const QString &stylesheet,
+                   const QByteArray &input, QByteArray &output,
+                   QString &errmsg);
+    void clearCache();
+
+  protected:
+    XSLTTransformer(QObject *parent = 0);
+    ~XSLTTransformer();
+
+    virtual void run();
+
+  private:
+    struct Job
+    {
+      QString    key;
+      QString    stylesheet;
+      QByteArray input;
+      QByteArray output;
+      QString    errmsg;
+      bool       ok;
+      bool       done;
+    };
+
+    class Stylesheet;
+
+    void process(Job *job);
+
+    QMutex                      _mutex;
+    QWaitCondition              _wake;
+    QWaitCondition              _finished;
+    QQueue<Job*>                _jobs;
+    bool                        _clear;
+    bool                        _stopping;
+    QHash<QString, Stylesheet*> _cache;     // only used by the worker thread
+
+    static XSLTTransformer     *_instance;
+};
+
+#endif
@@ -9,33 +9,186 @@
  */
 
 #include "xtsettings.h"
+#include "xtsettingsprivate.h"
 
-#include <QSettings>
+#include <QCoreApplication>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QThread>
+#include <QTimerEvent>
 
-QVariant xtsettingsValue(const QString & key, const QVariant & defaultValue)
+#define DEBUG false
+
+// how long to collect changes before writing them to disk
+#define FLUSHDELAY 2000
+
+/* The user's settings are read from disk once and kept in memory. Changes
+   are written back in one batch a short time after the last one, when
+   xtsettingsSync() is called, or when the application exits. Settings
+   saved by the old OpenMFG client are copied over the first time the
+   store is loaded.
+
+   The store may be used from any thread. Its data are guarded by _mutex,
+   and the flush timer only ever runs on the application's main thread.
+   Values another process writes to the settings file are not seen until
+   the next flush, which writes this process's changes and then re-reads
+   the whole file.
+ */
+
+static QMutex __instanceLock;
+
+XtSettingsStore *XtSettingsStore::_instance = 0;
+
+XtSettingsStore::XtSettingsStore()
+  : _settings(QSettings::UserScope, "xTuple.com", "xTuple")
 {
-  QSettings settings(QSettings::UserScope, "xTuple.com", "xTuple");
-  QString key2 = key;
-  if(key.startsWith("/xTuple/"))
-    key2 = key2.replace(0, 8, QString("/OpenMFG/"));
-  if(settings.contains(key))
-    return settings.value(key, defaultValue);
-  else
+  foreach (QString key, _settings.allKeys())
+    _values.insert(key, _settings.value(key));
+
+  migrateLegacy();
+
+  if (DEBUG)
+    qDebug("XtSettingsStore loaded %d settings", _values.size());
+}
+
+XtSettingsStore::~XtSettingsStore()
+{
+  flush();
+
+  QMutexLocker lock(&__instanceLock);
+  if (_instance == this)
+    _instance = 0;
+}
+
+XtSettingsStore *XtSettingsStore::instance()
+{
+  QMutexLocker lock(&__instanceLock);
+  if (! _instance)
+    _instance = new XtSettingsStore();
+
+  // write any pending changes when the application shuts down
+  QCoreApplication *app = QCoreApplication::instance();
+  if (! _instance->parent() && app)
+  {
+    if (_instance->thread() != app->thread())
+      _instance->moveToThread(app->thread());
+    _instance->setParent(app);
+  }
+
+  return _instance;
+}
+
+/* Settings keys are used with and without leading slashes, so put them in
+   the form QSettings::allKeys() returns.
+ */
+QString XtSettingsStore::normalize(const QString &key)
+{
+  if (! key.startsWith('/') && ! key.endsWith('/') && ! key.contains("//"))
+    return key;
+
+  return key.split('/', QString::SkipEmptyParts).join("/");
+}
+
+void XtSettingsStore::migrateLegacy()
+{
+  if (_values.contains("xTuple/legacySettingsMigrated"))
+    return;
+
+  QSettings oldsettings(QSettings::UserScope, "OpenMFG.com", "OpenMFG");
+  foreach (QString oldkey, oldsettings.allKeys())
   {
-    QSettings oldsettings(QSettings::UserScope, "OpenMFG.com", "OpenMFG");
-    if(oldsettings.contains(key2))
+    QString key = oldkey;
+    if (key.startsWith("OpenMFG/"))
+      key.replace(0, 7, QString("xTuple"));
+    if (! _values.contains(key))
     {
-      QVariant val = oldsettings.value(key2, defaultValue);
-      xtsettingsSetValue(key, val);
-      return val;
+      _values.insert(key, oldsettings.value(oldkey));
+      _dirty.insert(key);
     }
   }
-  return defaultValue;
+
+  _values.insert("xTuple/legacySettingsMigrated", true);
+  _dirty.insert("xTuple/legacySettingsMigrated");
+  flush();
+}
+
+QVariant XtSettingsStore::value(const QString &key, const QVariant &defaultValue) const
+{
+  QString nkey = normalize(key);
+  QMutexLocker lock(&_mutex);
+  QHash<QString, QVariant>::const_iterator it = _values.constFind(nkey);
+  return it == _values.constEnd() ? defaultValue : it.value();
+}
+
+void XtSettingsStore::setValue(const QString &key, const QVariant &value)
+{
+  QString nkey = normalize(key);
+  {
+    QMutexLocker lock(&_mutex);
+    QHash<QString, QVariant>::iterator it = _values.find(nkey);
+    if (it != _values.end() && it.value() == value && it.value().type() == value.type())
+      return;
+
+    _values.insert(nkey, value);
+    _dirty.insert(nkey);
+  }
+
+  if (! QCoreApplication::instance())
+    flush();
+  else if (QThread::currentThread() == thread())
+    sStartTimer();
+  else
+    QMetaObject::invokeMethod(this, "sStartTimer", Qt::QueuedConnection);
+}
+
+/* Write the changed settings, then pick up whatever other processes have
+   written to the file since it was last read.
+ */
+void XtSettingsStore::flush()
+{
+  if (QThread::currentThread() == thread())
+    _timer.stop();
+
+  QMutexLocker lock(&_mutex);
+  int written = _dirty.size();
+  foreach (QString key, _dirty)
+    _settings.setValue(key, _values.value(key));
+  _dirty.clear();
+  _settings.sync();
+
+  foreach (QString key, _settings.allKeys())
+    _values.insert(key, _settings.value(key));
+
+  if (DEBUG)
+    qDebug("XtSettingsStore wrote %d settings", written);
+}
+
+void XtSettingsStore::sStartTimer()
+{
+  if (! _timer.isActive())
+    _timer.start(FLUSHDELAY, this);
+}
+
+void XtSettingsStore::timerEvent(QTimerEvent *event)
+{
+  if (event->timerId() == _timer.timerId())
+    flush();
+  else
+    QObject::timerEvent(event);
+}
+
+QVariant xtsettingsValue(const QString & key, const QVariant & defaultValue)
+{
+  return XtSettingsStore::instance()->value(key, defaultValue);
 }
 
 void xtsettingsSetValue(const QString & key, const QVariant & value)
 {
-  QSettings settings(QSettings::UserScope, "xTuple.com", "xTuple");
-  settings.setValue(key, value);
+  XtSettingsStore::instance()->setValue(key, value);
 }
 
+/** @brief Write any changed settings to disk now instead of waiting. */
+void xtsettingsSync()
+{
+  XtSettingsStore::instance()->flush();
+}
@@ -17,6 +17,7 @@
 
 QVariant xtsettingsValue(const QString & key, const QVariant & defaultValue = QVariant());
 void xtsettingsSetValue(const QString & key, const QVariant & value);
+void xtsettingsSync();
 
 #endif
 
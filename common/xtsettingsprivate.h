@@ -0,0 +1,57 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#ifndef __XTSETTINGSPRIVATE_H__
+#define __XTSETTINGSPRIVATE_H__
+
+#include <QBasicTimer>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QSettings>
+#include <QVariant>
+
+class QTimerEvent;
+
+class XtSettingsStore : public QObject
+{
+  Q_OBJECT
+
+  public:
+    XtSettingsStore();
+    ~XtSettingsStore();
+
+    static XtSettingsStore *instance();
+    static QString          normalize(const QString &key);
+
+    QVariant value(const QString &key, const QVariant &defaultValue) const;
+    void     setValue(const QString &key, const QVariant &value);
+    void     flush();
+
+  protected:
+    void timerEvent(QTimerEvent *event);
+
+  private slots:
+    void sStartTimer();
+
+  private:
+    void migrateLegacy();
+
+    mutable QMutex           _mutex;
+    QSettings                _settings;
+    QHash<QString, QVariant> _values;
+    QSet<QString>            _dirty;
+    QBasicTimer              _timer;
+
+    static XtSettingsStore  *_instance;
+};
+
+#endif
@@ -19,6 +19,7 @@
 #include <openreports.h>
 
 #include "accountNumber.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 #include "errorReporter.h"
 
@@ -40,7 +41,7 @@ accountNumbers::accountNumbers(QWidget* parent, const char* name, Qt::WindowFlag
   connect(_type, SIGNAL(activated(int)), this, SLOT(populateSubTypes()));
   connect(_subType, SIGNAL(newID(int)), this, SLOT(sFillList()));
 
-  connect(omfgThis, SIGNAL(configureGLUpdated()), this, SLOT(sBuildList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(configureGLUpdated()), this, SLOT(sBuildList()));
 
   _type->setAllowNull(true);
   QString qryType = QString( "SELECT  1, '%1' UNION "
@@ -33,6 +33,7 @@ addresses::addresses(QWidget* parent, const char*, Qt::WindowFlags fl)
   setMetaSQLOptions("addresses", "detail");
   setNewVisible(true);
   setQueryOnStartEnabled(true);
+  setCursorPageSize(500);
   setParameterWidgetVisible(true);
 
   parameterWidget()->append(tr("Show Inactive"), "showInactive", ParameterWidget::Exists);
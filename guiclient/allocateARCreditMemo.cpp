@@ -16,6 +16,7 @@
 #include "metasql.h"
 #include "mqlutil.h"
 #include "errorReporter.h"
+#include "refreshscheduler.h"
 
 allocateARCreditMemo::allocateARCreditMemo(QWidget* parent, const char* name, bool modal, Qt::WindowFlags fl)
     : XDialog(parent, name, modal, fl)
@@ -33,7 +34,7 @@ allocateARCreditMemo::allocateARCreditMemo(QWidget* parent, const char* name, bo
   _aropen->addColumn(tr("This Alloc."),       _moneyColumn, Qt::AlignRight,  true,  "allocated");
   _aropen->addColumn(tr("Total Alloc."),      _moneyColumn, Qt::AlignRight,  true,  "totalallocated");
 
-  connect(omfgThis, SIGNAL(creditMemosUpdated()), this, SLOT(sPopulate()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(creditMemosUpdated()), this, SLOT(sPopulate()));
 
   connect(_aropen,      SIGNAL(valid(bool)),    this,           SLOT(sHandleButton()));
   connect(_allocate,	SIGNAL(clicked()),	this,           SLOT(sAllocate()));
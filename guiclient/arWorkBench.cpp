@@ -21,6 +21,7 @@
 #include "cashReceipt.h"
 #include "errorReporter.h"
 #include "getGLDistDate.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 #include "xtreewidget.h"
 
@@ -118,7 +119,7 @@ arWorkBench::arWorkBench(QWidget* parent, const char* name, Qt::WindowFlags fl)
   
   if(_privileges->check("PostCashReceipts"))
     connect(_cashrcpt, SIGNAL(itemSelected(int)), _editCashrcpt, SLOT(animateClick()));
-  connect(omfgThis, SIGNAL(cashReceiptsUpdated(int, bool)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(cashReceiptsUpdated(int, bool)), this, SLOT(sFillList()));
 
   if (!_metrics->boolean("CCAccept") || !_privileges->check("ProcessCreditCards"))
     _tab->removeTab(_tab->indexOf(_creditCardTab));
@@ -22,6 +22,7 @@
 #include "errorReporter.h"
 #include "guiclient.h"
 #include "bankAdjustment.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 
 bankAdjustmentEditList::bankAdjustmentEditList(QWidget* parent, const char* name, Qt::WindowFlags fl)
@@ -62,7 +63,7 @@ bankAdjustmentEditList::bankAdjustmentEditList(QWidget* parent, const char* name
     connect(_adjustments, SIGNAL(itemSelected(int)), _view, SLOT(animateClick()));
   }
   
-  connect(omfgThis, SIGNAL(bankAdjustmentsUpdated(int, bool)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(bankAdjustmentsUpdated(int, bool)), this, SLOT(sFillList()));
   
   sFillList();
 }
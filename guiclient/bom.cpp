@@ -25,6 +25,7 @@
 
 #include "bomItem.h"
 #include "errorReporter.h"
+#include "refreshscheduler.h"
 
 BOM::BOM(QWidget* parent, const char* name, Qt::WindowFlags fl)
     : XWidget(parent, name, fl)
@@ -90,7 +91,11 @@ BOM::BOM(QWidget* parent, const char* name, Qt::WindowFlags fl)
     _maxCost->hide();
   }
   
-  connect(omfgThis, SIGNAL(bomsUpdated(int, bool)), SLOT(sFillList(int, bool)));
+  // only the bill for the selected item matters to this window
+  RefreshScheduler *refresh = RefreshScheduler::connect(omfgThis, SIGNAL(bomsUpdated(int, bool)),
+                                                        this, SLOT(sFillList()));
+  refresh->setIds(_item->id());
+  connect(_item, SIGNAL(newId(int)), refresh, SLOT(setIds(int)));
   _revision->setMode(RevisionLineEdit::Maintain);
   _revision->setType("BOM");
   _bomheadid = -1;
@@ -449,7 +454,6 @@ void BOM::sMoveDown()
 
 void BOM::sFillList()
 {
-  XSqlQuery BFillList;
   sFillList(_item->id(), true);
 }
 
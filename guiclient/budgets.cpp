@@ -20,6 +20,7 @@
 #include "copyBudget.h"
 #include "guiclient.h"
 #include "maintainBudget.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 #include "errorReporter.h"
 
@@ -53,7 +54,7 @@ budgets::budgets(QWidget* parent, const char* name, Qt::WindowFlags fl)
     _new->setEnabled(false);
   }
 
-  connect(omfgThis, SIGNAL(budgetsUpdated(int, bool)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(budgetsUpdated(int, bool)), this, SLOT(sFillList()));
 
    sFillList();
 }
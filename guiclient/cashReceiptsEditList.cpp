@@ -24,6 +24,7 @@
 #include "cashReceipt.h"
 #include "errorReporter.h"
 #include "getGLDistDate.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 
 cashReceiptsEditList::cashReceiptsEditList(QWidget* parent, const char* name, Qt::WindowFlags fl)
@@ -64,7 +65,7 @@ cashReceiptsEditList::cashReceiptsEditList(QWidget* parent, const char* name, Qt
     connect(_cashrcpt, SIGNAL(itemSelected(int)), _view, SLOT(animateClick()));
   }
 
-  connect(omfgThis, SIGNAL(cashReceiptsUpdated(int, bool)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(cashReceiptsUpdated(int, bool)), this, SLOT(sFillList()));
 
   sFillList();
 }
@@ -0,0 +1,465 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2016 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#include "cchttpclient.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QNetworkAccessManager>
+#include <QThread>
+#include <QTimer>
+#include <QtDebug>
+
+#include <climits>
+
+#define DEBUG false
+
+/** @class CCHttpClient
+
+    @brief The CCHttpClient sends credit card transactions to the
+           processing service over one shared QNetworkAccessManager.
+
+    Every CreditCardProcessor shares this client, so consecutive
+    transactions reuse the same keep-alive connections and TLS sessions
+    instead of negotiating a new connection each time.
+
+    The network objects live on a thread of their own. post() returns
+    immediately with a request id. Callers either listen for finished(),
+    which is delivered on the thread that created the client, or block in
+    wait(), then collect the reply with takeResult(). wait() does not run
+    an event loop, so nothing else in the application can run while a
+    caller is waiting on a transaction.
+
+    Requests are queued and at most maxConcurrent() are on the wire at
+    once. A request that fails before the service could have seen it
+    (connection refused, host not found, a temporary network failure or
+    an HTTP 503) is retried up to maxRetries() times with exponential
+    backoff. Requests that time out or fail after being delivered are
+    never resent, since that could charge a card twice.
+
+    SSL errors are ignored for requests posted with @c pignoreSslErrors.
+    Otherwise wait() emits sslErrors() on the waiting thread so the caller
+    can ask the user. A request nobody waits on is treated as if the
+    errors were not accepted once timeout() has passed.
+ */
+
+CCHttpClient *CCHttpClient::_shared = 0;
+
+CCHttpWorker::CCHttpWorker(CCHttpClient *client)
+  : QObject(0),
+    _client(client),
+    _manager(0)
+{
+}
+
+/* Call with the client's mutex held. */
+void CCHttpWorker::send(int pid)
+{
+  CCHttpClient::Request *req = _client->_requests.value(pid);
+  req->attempts++;
+  req->reply = _manager->post(req->request, req->body);
+  _client->_replies.insert(req->reply, req->id);
+  _client->_active++;
+
+  if (_client->_timeout > 0)
+  {
+    if (! req->timer)
+    {
+      req->timer = new QTimer(this);
+      req->timer->setSingleShot(true);
+      req->timer->setProperty("ccid", req->id);
+      connect(req->timer, SIGNAL(timeout()), this, SLOT(sTimeout()));
+    }
+    req->timer->start(_client->_timeout);
+  }
+}
+
+void CCHttpWorker::sStartNext()
+{
+  QMutexLocker lock(&_client->_mutex);
+
+  if (! _manager)
+  {
+    _manager = new QNetworkAccessManager(this);
+    connect(_manager, SIGNAL(finished(QNetworkReply*)),
+            this,     SLOT(sFinished(QNetworkReply*)));
+    connect(_manager, SIGNAL(sslErrors(QNetworkReply*, const QList<QSslError> &)),
+            this,     SLOT(sSslErrors(QNetworkReply*, const QList<QSslError> &)));
+  }
+  if (_manager->proxy() != _client->_proxy)
+    _manager->setProxy(_client->_proxy);
+
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+  for (int n = _client->_queue.size();
+       n > 0 && _client->_active < _client->_maxConcurrent; n--)
+  {
+    int                    id  = _client->_queue.dequeue();
+    CCHttpClient::Request *req = _client->_requests.value(id);
+    if (! req || req->done || req->reply)
+      continue;
+    if (req->notBefore > now)   // still backing off after a failure
+      _client->_queue.enqueue(id);
+    else
+      send(id);
+  }
+}
+
+void CCHttpWorker::sAbort(int pid)
+{
+  QNetworkReply *reply = 0;
+  {
+    QMutexLocker lock(&_client->_mutex);
+    CCHttpClient::Request *req = _client->_requests.value(pid);
+    if (req && ! req->done)
+      reply = req->reply;
+  }
+  // abort() finishes the reply, and sFinished() takes the lock itself
+  if (reply)
+    reply->abort();
+}
+
+void CCHttpWorker::sFinished(QNetworkReply *reply)
+{
+  int id = 0;
+  {
+    QMutexLocker lock(&_client->_mutex);
+    if (! _client->_replies.contains(reply))
+      return;
+
+    id = _client->_replies.take(reply);
+    CCHttpClient::Request *req = _client->_requests.value(id);
+    _client->_active--;
+    reply->deleteLater();
+
+    if (! req)
+    {
+      lock.unlock();
+      sStartNext();
+      return;
+    }
+
+    bool timedOut = req->timer && ! req->timer->isActive() && _client->_timeout > 0;
+    if (req->timer)
+      req->timer->stop();
+    req->reply = 0;
+
+    if (! timedOut && _client->isRetryable(reply) &&
+        req->attempts <= _client->_maxRetries)
+    {
+      int delay = 500 * (1 << (req->attempts - 1));
+      if (DEBUG)
+        qDebug() << "CCHttpClient retrying" << id << "in" << delay << "msec after"
+                 << reply->errorString();
+      req->notBefore = QDateTime::currentMSecsSinceEpoch() + delay;
+      _client->_queue.enqueue(id);
+      lock.unlock();
+      QTimer::singleShot(delay, this, SLOT(sStartNext()));
+      sStartNext();
+      return;
+    }
+
+    req->done        = true;
+    req->response    = reply->readAll();
+    req->error       = reply->error();
+    req->errorString = timedOut ? CCHttpClient::tr("No response after %1 seconds")
+                                                   .arg(_client->_timeout / 1000)
+                                : reply->errorString();
+    _client->_changed.wakeAll();
+
+    if (DEBUG)
+      qDebug() << "CCHttpClient::sFinished()" << id << req->error << req->errorString;
+  }
+
+  emit finished(id);
+  sStartNext();
+}
+
+/* The decision has to be made before this slot returns, so block until
+   the caller in wait() has answered or the request would have timed out.
+ */
+void CCHttpWorker::sSslErrors(QNetworkReply *reply, const QList<QSslError> &errors)
+{
+  QMutexLocker lock(&_client->_mutex);
+  CCHttpClient::Request *req = _client->_requests.value(_client->_replies.value(reply));
+  if (! req)
+    return;
+
+  if (req->ignoreSslErrors)
+  {
+    reply->ignoreSslErrors(errors);
+    return;
+  }
+
+  req->sslErrors = errors;
+  req->sslState  = CCHttpClient::SslAsked;
+  _client->_changed.wakeAll();
+
+  unsigned long limit = _client->_timeout > 0 ? _client->_timeout : ULONG_MAX;
+  while (req->sslState == CCHttpClient::SslAsked)
+    if (! _client->_changed.wait(&_client->_mutex, limit))
+      break;
+
+  bool ignore = req->sslState == CCHttpClient::SslAnswered && req->sslIgnore;
+  req->sslState = CCHttpClient::SslNone;
+  req->sslErrors.clear();
+  if (ignore)
+    reply->ignoreSslErrors(errors);
+}
+
+void CCHttpWorker::sTimeout()
+{
+  int pid = sender() ? sender()->property("ccid").toInt() : 0;
+  sAbort(pid);
+}
+
+CCHttpClient::CCHttpClient(QObject *parent)
+  : QObject(parent),
+    _active(0),
+    _lastId(0),
+    _maxConcurrent(4),
+    _maxRetries(2),
+    _timeout(60000)
+{
+  _thread = new QThread(this);
+  _worker = new CCHttpWorker(this);
+  _worker->moveToThread(_thread);
+  connect(_worker, SIGNAL(finished(int)), this, SIGNAL(finished(int)));
+  _thread->start();
+}
+
+CCHttpClient::~CCHttpClient()
+{
+  _thread->quit();
+  _thread->wait();
+  delete _worker;
+  _worker = 0;
+
+  foreach (Request *req, _requests)
+    delete req;
+  _requests.clear();
+  if (_shared == this)
+    _shared = 0;
+}
+
+/** @brief Return the client shared by all CreditCardProcessors.
+
+    Call this from the GUI thread the first time.
+ */
+CCHttpClient *CCHttpClient::shared()
+{
+  if (! _shared)
+    _shared = new CCHttpClient(QCoreApplication::instance());
+  return _shared;
+}
+
+int CCHttpClient::maxConcurrent() const
+{
+  QMutexLocker lock(&_mutex);
+  return _maxConcurrent;
+}
+
+int CCHttpClient::maxRetries() const
+{
+  QMutexLocker lock(&_mutex);
+  return _maxRetries;
+}
+
+int CCHttpClient::timeout() const
+{
+  QMutexLocker lock(&_mutex);
+  return _timeout;
+}
+
+void CCHttpClient::setMaxConcurrent(int pmax)
+{
+  {
+    QMutexLocker lock(&_mutex);
+    _maxConcurrent = qMax(1, pmax);
+  }
+  QMetaObject::invokeMethod(_worker, "sStartNext", Qt::QueuedConnection);
+}
+
+void CCHttpClient::setMaxRetries(int pmax)
+{
+  QMutexLocker lock(&_mutex);
+  _maxRetries = qMax(0, pmax);
+}
+
+/** @brief Set how long to wait for each response, in milliseconds. */
+void CCHttpClient::setTimeout(int pmsec)
+{
+  QMutexLocker lock(&_mutex);
+  _timeout = pmsec;
+}
+
+/** @brief Set the proxy used by requests started from now on. */
+void CCHttpClient::setProxy(const QNetworkProxy &pproxy)
+{
+  QMutexLocker lock(&_mutex);
+  _proxy = pproxy;
+}
+
+/** @brief Queue an HTTP POST and return an id to track it with.
+
+    @param prequest         The request to post
+    @param pbody            The body of the request
+    @param pignoreSslErrors Accept the connection even if SSL errors are
+                            reported, without emitting sslErrors()
+ */
+int CCHttpClient::post(const QNetworkRequest &prequest, const QByteArray &pbody,
+                       bool pignoreSslErrors)
+{
+  Request *req = new Request;
+  req->request         = prequest;
+  req->body            = pbody;
+  req->attempts        = 0;
+  req->reply           = 0;
+  req->timer           = 0;
+  req->done            = false;
+  req->notBefore       = 0;
+  req->error           = QNetworkReply::NoError;
+  req->ignoreSslErrors = pignoreSslErrors;
+  req->sslState        = SslNone;
+  req->sslIgnore       = false;
+
+  {
+    QMutexLocker lock(&_mutex);
+    req->id = ++_lastId;
+    _requests.insert(req->id, req);
+    _queue.enqueue(req->id);
+  }
+
+  if (DEBUG)
+    qDebug() << "CCHttpClient::post()" << req->id << prequest.url();
+
+  QMetaObject::invokeMethod(_worker, "sStartNext", Qt::QueuedConnection);
+  return req->id;
+}
+
+/** @brief Cancel a queued or running request.
+
+    The request still finishes and reports QNetworkReply::OperationCanceledError.
+ */
+void CCHttpClient::abort(int pid)
+{
+  QMutexLocker lock(&_mutex);
+  Request *req = _requests.value(pid);
+  if (! req || req->done)
+    return;
+
+  if (req->reply)
+  {
+    lock.unlock();
+    QMetaObject::invokeMethod(_worker, "sAbort", Qt::QueuedConnection,
+                              Q_ARG(int, pid));
+  }
+  else
+  {
+    _queue.removeAll(pid);
+    req->done        = true;
+    req->error       = QNetworkReply::OperationCanceledError;
+    req->errorString = tr("Request cancelled");
+    _changed.wakeAll();
+    lock.unlock();
+    emit finished(pid);
+  }
+}
+
+bool CCHttpClient::isFinished(int pid) const
+{
+  QMutexLocker lock(&_mutex);
+  Request *req = _requests.value(pid);
+  return req && req->done;
+}
+
+/** @brief Return the number of requests queued or on the wire. */
+int CCHttpClient::pending() const
+{
+  QMutexLocker lock(&_mutex);
+  return _queue.size() + _active;
+}
+
+/** @brief Block until the given request has finished.
+
+    No events are processed while waiting. If the service's certificate
+    reports SSL errors and the request was not posted to ignore them,
+    sslErrors() is emitted from here, on the waiting thread; a slot
+    connected to it sets @c *pignore to accept the connection anyway.
+
+    @return false if the request id is unknown
+ */
+bool CCHttpClient::wait(int pid)
+{
+  QMutexLocker lock(&_mutex);
+  Request *req = _requests.value(pid);
+  if (! req)
+    return false;
+
+  while (! req->done)
+  {
+    if (req->sslState == SslAsked)
+    {
+      QList<QSslError> errors = req->sslErrors;
+      bool             ignore = false;
+      lock.unlock();
+      emit sslErrors(pid, errors, &ignore);
+      lock.relock();
+      req->sslIgnore = ignore;
+      req->sslState  = SslAnswered;
+      _changed.wakeAll();
+    }
+    else
+      _changed.wait(&_mutex);
+  }
+
+  return true;
+}
+
+/** @brief Retrieve the result of a finished request and forget it.
+
+    @return false if the request is unknown or has not finished yet
+ */
+bool CCHttpClient::takeResult(int pid, QByteArray &presponse,
+                              QNetworkReply::NetworkError &perror,
+                              QString &perrorString)
+{
+  QMutexLocker lock(&_mutex);
+  Request *req = _requests.value(pid);
+  if (! req || ! req->done)
+    return false;
+
+  _requests.remove(pid);
+  presponse    = req->response;
+  perror       = req->error;
+  perrorString = req->errorString;
+  if (req->timer)
+    req->timer->deleteLater();
+  delete req;
+  return true;
+}
+
+bool CCHttpClient::isRetryable(QNetworkReply *reply) const
+{
+  switch (reply->error())
+  {
+    case QNetworkReply::ConnectionRefusedError:
+    case QNetworkReply::HostNotFoundError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::ProxyConnectionRefusedError:
+    case QNetworkReply::ProxyNotFoundError:
+      return true;
+    default:
+      break;
+  }
+
+  return reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 503;
+}
@@ -0,0 +1,135 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2016 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#ifndef CCHTTPCLIENT_H
+#define CCHTTPCLIENT_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QNetworkProxy>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QObject>
+#include <QQueue>
+#include <QSslError>
+#include <QWaitCondition>
+
+class QNetworkAccessManager;
+class QThread;
+class QTimer;
+class CCHttpClient;
+
+/* Owns the network objects of a CCHttpClient and lives on its thread.
+   Everything it shares with the client is guarded by the client's mutex.
+ */
+class CCHttpWorker : public QObject
+{
+  Q_OBJECT
+
+  public:
+    CCHttpWorker(CCHttpClient *client);
+
+  signals:
+    void finished(int pid);
+
+  public slots:
+    void sAbort(int pid);
+    void sStartNext();
+
+  private slots:
+    void sFinished(QNetworkReply *reply);
+    void sSslErrors(QNetworkReply *reply, const QList<QSslError> &errors);
+    void sTimeout();
+
+  private:
+    void send(int pid);
+
+    CCHttpClient           *_client;
+    QNetworkAccessManager  *_manager;
+};
+
+class CCHttpClient : public QObject
+{
+  Q_OBJECT
+
+  public:
+    static CCHttpClient *shared();
+
+    int  maxConcurrent() const;
+    int  maxRetries()    const;
+    int  timeout()       const;
+    void setMaxConcurrent(int pmax);
+    void setMaxRetries(int pmax);
+    void setTimeout(int pmsec);
+    void setProxy(const QNetworkProxy &pproxy);
+
+    int  post(const QNetworkRequest &prequest, const QByteArray &pbody,
+              bool pignoreSslErrors = false);
+    void abort(int pid);
+    bool isFinished(int pid) const;
+    int  pending() const;
+    bool wait(int pid);
+    bool takeResult(int pid, QByteArray &presponse,
+                    QNetworkReply::NetworkError &perror, QString &perrorString);
+
+  signals:
+    void finished(int pid);
+    void sslErrors(int pid, const QList<QSslError> &errors, bool *pignore);
+
+  protected:
+    CCHttpClient(QObject *parent = 0);
+    ~CCHttpClient();
+
+  private:
+    friend class CCHttpWorker;
+
+    enum SslState { SslNone, SslAsked, SslAnswered };
+
+    struct Request
+    {
+      int                         id;
+      QNetworkRequest             request;
+      QByteArray                  body;
+      int                         attempts;
+      QNetworkReply              *reply;
+      QTimer                     *timer;
+      bool                        done;
+      qint64                      notBefore;
+      QByteArray                  response;
+      QNetworkReply::NetworkError error;
+      QString                     errorString;
+      bool                        ignoreSslErrors;
+      SslState                    sslState;
+      QList<QSslError>            sslErrors;
+      bool                        sslIgnore;
+    };
+
+    bool isRetryable(QNetworkReply *reply) const;
+
+    mutable QMutex          _mutex;
+    QWaitCondition          _changed;
+    QThread                *_thread;
+    CCHttpWorker           *_worker;
+    QNetworkProxy           _proxy;
+    QHash<int, Request*>    _requests;
+    QHash<QNetworkReply*, int> _replies;
+    QQueue<int>             _queue;
+    int                     _active;
+    int                     _lastId;
+    int                     _maxConcurrent;
+    int                     _maxRetries;
+    int                     _timeout;
+
+    static CCHttpClient    *_shared;
+};
+
+#endif // CCHTTPCLIENT_H
@@ -19,6 +19,7 @@
 #include "atlasMap.h"
 #include "xsltMap.h"
 #include "errorReporter.h"
+#include "exporthelper.h"
 
 bool configureIE::userHasPriv()
 {
@@ -56,11 +57,6 @@ configureIE::configureIE(QWidget* parent, const char* name, bool /*modal*/, Qt::
   _atlasMap->addColumn(tr("Atlas File"), -1, Qt::AlignLeft, true, "atlasmap_atlas");
   _atlasMap->addColumn(tr("CSV Map"),    -1, Qt::AlignLeft, true, "atlasmap_map");
 
-  // TODO: fix these when support for an internal XSLT processor is enabled
-  _internal->setEnabled(false);
-  _internal->setVisible(false);
-  _external->setVisible(false);
-
 #ifdef Q_OS_WIN
   _os->setCurrentIndex(1);
 #endif
@@ -156,6 +152,8 @@ bool configureIE::sSave()
   _metrics->set("XMLExportDefaultDirMac",      _exportMacDir->text());
   _metrics->set("XMLExportDefaultDirWindows",  _exportWindowsDir->text());
 
+  ExportHelper::XSLTClearCache();
+
   return true;
 }
 
@@ -165,8 +163,11 @@ void configureIE::sPopulate()
   _xsltMacDir->setText(_metrics->value("XSLTDefaultDirMac"));
   _xsltWindowsDir->setText(_metrics->value("XSLTDefaultDirWindows"));
 
-  //  TODO: start using Qt's XSLT processor
-  _external->setChecked(true);
+  // the internal processor falls back to the external command if it fails
+  if (_metrics->boolean("XSLTLibrary"))
+    _internal->setChecked(true);
+  else
+    _external->setChecked(true);
 
   _linuxCmd->setText(_metrics->value("XSLTProcessorLinux"));
   _macCmd->setText(_metrics->value("XSLTProcessorMac"));
@@ -235,6 +236,7 @@ void configureIE::sDeleteAtlasMap()
       return;
     }
 
+    ExportHelper::XSLTClearCache();
     sFillList();
   }
 }
@@ -27,6 +27,7 @@
 #include "opportunity.h"
 #include "prospect.h"
 #include "purchaseOrder.h"
+#include "refreshscheduler.h"
 #include "salesOrder.h"
 #include "shipTo.h"
 #include "storedProcErrorLookup.h"
@@ -219,16 +220,16 @@ contact::contact(QWidget* parent, const char* name, bool modal, Qt::WindowFlags
   connect(_uses,               SIGNAL(valid(bool)), this, SLOT(sHandleValidUse(bool)));
   connect(_uses, SIGNAL(populateMenu(QMenu*, XTreeWidgetItem*)), this, SLOT(sPopulateUsesMenu(QMenu*)));
   connect(_viewUse,                       SIGNAL(clicked()), this, SLOT(sViewUse()));
-  connect(omfgThis,         SIGNAL(crmAccountsUpdated(int)), this, SLOT(sFillList()));
-  connect(omfgThis,      SIGNAL(customersUpdated(int,bool)), this, SLOT(sFillList()));
-  connect(omfgThis,            SIGNAL(employeeUpdated(int)), this, SLOT(sFillList()));
-  connect(omfgThis,              SIGNAL(prospectsUpdated()), this, SLOT(sFillList()));
-  connect(omfgThis, SIGNAL(purchaseOrdersUpdated(int,bool)), this, SLOT(sFillList()));
-  connect(omfgThis,         SIGNAL(quotesUpdated(int,bool)), this, SLOT(sFillList()));
-  connect(omfgThis,    SIGNAL(salesOrdersUpdated(int,bool)), this, SLOT(sFillList()));
-  connect(omfgThis,      SIGNAL(transferOrdersUpdated(int)), this, SLOT(sFillList()));
-  connect(omfgThis,                SIGNAL(vendorsUpdated()), this, SLOT(sFillList()));
-  connect(omfgThis,             SIGNAL(warehousesUpdated()), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(crmAccountsUpdated(int)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(customersUpdated(int,bool)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(employeeUpdated(int)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(prospectsUpdated()), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(purchaseOrdersUpdated(int,bool)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(quotesUpdated(int,bool)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(salesOrdersUpdated(int,bool)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(transferOrdersUpdated(int)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(vendorsUpdated()), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(warehousesUpdated()), this, SLOT(sFillList()));
 
   _charass->setType("CNTCT");
 
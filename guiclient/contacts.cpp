@@ -33,6 +33,7 @@ contacts::contacts(QWidget* parent, const char*, Qt::WindowFlags fl)
   setNewVisible(true);
   setSearchVisible(true);
   setQueryOnStartEnabled(true);
+  setCursorPageSize(500);
 
   _crmacctid = -1;
   _attachAct = 0;
@@ -21,6 +21,7 @@
 #include "guiclient.h"
 #include "parameterwidget.h"
 #include "errorReporter.h"
+#include "refreshscheduler.h"
 
 contracts::contracts(QWidget* parent, const char*, Qt::WindowFlags fl)
   : display(parent, "contracts", fl)
@@ -48,7 +49,7 @@ contracts::contracts(QWidget* parent, const char*, Qt::WindowFlags fl)
   list()->addColumn(tr("Expires"),            _dateColumn, Qt::AlignLeft,   true,  "contrct_expires"   );
   list()->addColumn(tr("Item Count"),         _itemColumn, Qt::AlignLeft,   true,  "item_count"   );
 
-  connect(omfgThis, SIGNAL(contractsUpdated(int, bool)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(contractsUpdated(int, bool)), this, SLOT(sFillList()));
 
   if (_privileges->check("MaintainItemSources"))
     connect(list(), SIGNAL(itemSelected(int)), this, SLOT(sEdit()));
@@ -19,6 +19,7 @@
 #include <openreports.h>
 #include <metasql.h>
 
+#include "refreshscheduler.h"
 #include "selectOrderForBilling.h"
 #include "selectBillingQty.h"
 #include "printInvoices.h"
@@ -45,7 +46,7 @@ creditMemoEditList::creditMemoEditList(QWidget* parent, const char* name, Qt::Wi
   _cmhead->addColumn(tr("Ext. Price"),  _moneyColumn, Qt::AlignRight, true, "extprice");
   _cmhead->addColumn(tr("Currency"), _currencyColumn, Qt::AlignLeft,  true, "currabbr");
 
-  connect(omfgThis, SIGNAL(creditMemosUpdated()), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(creditMemosUpdated()), this, SLOT(sFillList()));
 
   sFillList();
 }
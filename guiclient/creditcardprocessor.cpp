@@ -13,12 +13,12 @@
 #include <QFile>
 #include <QMessageBox>
 #include <QProcess>
+#include <QProgressDialog>
 #include <QSqlError>
 #if QT_VERSION < 0x050000
 #include <QHttp>
 #else
 #include <QtNetwork>
-#include <QNetworkAccessManager>
 #endif
 #include <QSslSocket>
 #include <QSslCertificate>
@@ -34,6 +34,7 @@
 
 #include "guiclient.h"
 #include "creditcardprocessor.h"
+#include "cchttpclient.h"
 #include "storedProcErrorLookup.h"
 
 #include "authorizedotnetprocessor.h"
@@ -310,15 +311,16 @@ bool CreditCardProcessor::certificateIsValid(const QSslCertificate *cert)
 
  */
 CreditCardProcessor::CreditCardProcessor()
-  : _company(tr("The Credit Card Processing Company")),
+  : _batchConfirmed(false),
+    _company(tr("The Credit Card Processing Company")),
     _defaultLiveServer("live.creditcardprocessor.com"),
     _defaultTestServer("test.creditcardprocessor.com"),
     _defaultLivePort(0),
-    _defaultTestPort(0),
-#if QT_VERSION >= 0x050000
-    _manager(0)
+    _defaultTestPort(0)
+#if QT_VERSION < 0x050000
+    , _http(0)
 #else
-    _http(0)
+    , _requestid(0)
 #endif
 {
   if (DEBUG)
@@ -327,6 +329,20 @@ CreditCardProcessor::CreditCardProcessor()
   _errorMsg = "";
   _ignoreSslErrors    = _metrics->boolean("CCIgnoreSSLErrors");
 
+#if QT_VERSION >= 0x050000
+  CCHttpClient *client = CCHttpClient::shared();
+  if(_metrics->boolean("CCUseProxyServer"))
+    client->setProxy(QNetworkProxy(QNetworkProxy::HttpProxy,
+                                   _metrics->value("CCProxyServer"),
+                                   _metrics->value("CCProxyPort").toInt(),
+                                   _metricsenc->value("CCProxyLogin"),
+                                   _metricsenc->value("CCPassword")));
+  else
+    client->setProxy(QNetworkProxy());
+  connect(client, SIGNAL(sslErrors(int, const QList<QSslError> &, bool *)),
+          this,   SLOT(sslErrors(int, const QList<QSslError> &, bool *)));
+#endif
+
   for (unsigned int i = 0; i < sizeof(messages) / sizeof(messages[0]); i++)
     _msgHash.insert(messages[i].code, tr(messages[i].text));
 
@@ -899,7 +915,7 @@ int CreditCardProcessor::chargePreauthorized(const QString &pcvv, const double p
       return returnVal;
   }
 
-  if (_metrics->boolean("CCConfirmChargePreauth") &&
+  if (_metrics->boolean("CCConfirmChargePreauth") && ! _batchConfirmed &&
       QMessageBox::question(0,
 	      tr("Confirm Post-authorization of Credit Card Purchase"),
               tr("Are you sure that you want to charge a pre-authorized "
@@ -961,6 +977,101 @@ int CreditCardProcessor::chargePreauthorized(const QString &pcvv, const double p
   return returnVal;
 }
 
+/** @brief Capture a list of pre-authorized credit card transactions.
+
+    Each ccpay record is charged for its full pre-authorized amount by
+    calling chargePreauthorized(). The transactions are sent one after
+    the other through the shared CCHttpClient, so the whole batch reuses
+    one connection to the service. A progress dialog lets the user stop
+    the batch between transactions.
+
+    If @c CCConfirmChargePreauth is set, the user is asked to confirm
+    the batch once instead of confirming each transaction.
+
+    @param      pccpayids The ccpay_id values of the pre-authorizations
+    @param[out] perrors   One message for each transaction that failed
+                          or returned a warning
+    @param      pparent   The widget to show the progress dialog over
+
+    @return The number of transactions captured successfully
+ */
+int CreditCardProcessor::capturePreauthorized(const QList<int> &pccpayids, QStringList &perrors, QWidget *pparent)
+{
+  if (DEBUG)
+    qDebug("CCP:capturePreauthorized(%d ids)", pccpayids.size());
+
+  if (pccpayids.isEmpty())
+    return 0;
+
+  QStringList idlist;
+  foreach (int id, pccpayids)
+    idlist << QString::number(id);
+
+  XSqlQuery ccq;
+  ccq.prepare("SELECT ccpay_id, ccpay_amount, ccpay_curr_id,"
+              "       ccpay_order_number, ccpay_r_ordernum"
+              "  FROM ccpay"
+              " WHERE ((ccpay_status = 'A')"
+              "   AND  (ccpay_id = ANY(CAST(:ccpayids AS INTEGER[]))))"
+              " ORDER BY ccpay_id;");
+  ccq.bindValue(":ccpayids", "{" + idlist.join(",") + "}");
+  ccq.exec();
+  if (ccq.lastError().type() != QSqlError::NoError)
+  {
+    _errorMsg = ccq.lastError().databaseText();
+    perrors << _errorMsg;
+    return 0;
+  }
+
+  int total = ccq.size();
+  if (total <= 0)
+    return 0;
+
+  if (_metrics->boolean("CCConfirmChargePreauth") &&
+      QMessageBox::question(pparent,
+                            tr("Confirm Post-authorization of Credit Card Purchases"),
+                            tr("Are you sure that you want to charge %n "
+                               "pre-authorized transaction(s)?", 0, total),
+                            QMessageBox::Yes | QMessageBox::No,
+                            QMessageBox::Yes) == QMessageBox::No)
+  {
+    _errorMsg = errorMsg(-71);
+    return 0;
+  }
+
+  QProgressDialog progress(tr("Capturing pre-authorized transactions..."),
+                           tr("Stop"), 0, total, pparent);
+  progress.setWindowModality(Qt::WindowModal);
+  progress.setMinimumDuration(0);
+
+  _batchConfirmed = true;
+  int captured = 0;
+  int done     = 0;
+  while (ccq.next() && ! progress.wasCanceled())
+  {
+    progress.setValue(done++);
+
+    int     ccpayid  = ccq.value("ccpay_id").toInt();
+    QString neworder = ccq.value("ccpay_order_number").toString();
+    QString reforder = ccq.value("ccpay_r_ordernum").toString();
+    int returnVal = chargePreauthorized("-2",
+                                        ccq.value("ccpay_amount").toDouble(),
+                                        ccq.value("ccpay_curr_id").toInt(),
+                                        neworder, reforder, ccpayid);
+    if (returnVal >= 0)
+      captured++;
+    if (returnVal != 0 || ! _errorMsg.isEmpty())
+      perrors << tr("%1: %2").arg(neworder, _errorMsg);
+  }
+  _batchConfirmed = false;
+
+  if (progress.wasCanceled() && done < total)
+    perrors << tr("Stopped after %1 of %2 transactions.").arg(done).arg(total);
+  progress.setValue(total);
+
+  return captured;
+}
+
 /** @brief Test whether common credit card processing configuration options
            are consistent.
 
@@ -1858,38 +1969,28 @@ int CreditCardProcessor::sendViaHTTP(const QString &prequest,
     if(ccurl.scheme().compare("https", Qt::CaseInsensitive) == 0)
        request.setSslConfiguration(QSslConfiguration::defaultConfiguration());
 
-    _manager = new QNetworkAccessManager(this);
-    connect(_manager, SIGNAL(sslErrors(QNetworkReply*, const QList<QSslError> &)),
-            this,  SLOT(sslErrors(QNetworkReply*, const QList<QSslError> &)));
-
-    if(_metrics->boolean("CCUseProxyServer"))
-    {
-      _manager->setProxy(QNetworkProxy(QNetworkProxy::HttpProxy,
-                                       _metrics->value("CCProxyServer"),
-                                       _metrics->value("CCProxyPort").toInt(),
-                                       _metricsenc->value("CCProxyLogin"),
-                                       _metricsenc->value("CCPassword")));
-    }
-
-    QApplication::setOverrideCursor( QCursor(Qt::WaitCursor) );
-    QNetworkReply *reply;
-    reply =_manager->post(request, prequest.toUtf8());
+    // the proxy and sslErrors() connection are set up once in the constructor
+    CCHttpClient *client = CCHttpClient::shared();
 
-    if (!waitForHTTP())
-    {
-      //TODO? handle waitForHTTP returning false => timeout
-    }
+    QApplication::setOverrideCursor( QCursor(Qt::BusyCursor) );
+    _requestid = client->post(request, prequest.toUtf8(), _ignoreSslErrors);
+    client->wait(_requestid);
     QApplication::restoreOverrideCursor();
 
-    if(reply->error() != QNetworkReply::NoError)
+    QByteArray                  response;
+    QNetworkReply::NetworkError error;
+    QString                     errorString;
+    client->takeResult(_requestid, response, error, errorString);
+    _requestid = 0;
+    if(error != QNetworkReply::NoError)
     {
       _errorMsg = errorMsg(-18)
                         .arg(ccurl.toString())
-                        .arg(reply->error())
-                        .arg(reply->errorString());
+                        .arg(error)
+                        .arg(errorString);
       return -18;
     }
-    presponse = reply->readAll();
+    presponse = response;
 #endif
   }
   else
@@ -2013,23 +2114,6 @@ int CreditCardProcessor::sendViaHTTP(const QString &prequest,
   return 0;
 }
 
-/** @brief Wait for the HTTP request sent by _manager to finish.
-           Added for Qt5.
-
-    @todo Add a timeout parameter and return false if it is exceeded.
-  */
-bool CreditCardProcessor::waitForHTTP()
-{
-#if QT_VERSION >= 0x050000
-  QEventLoop loop;
-
-  connect(_manager, SIGNAL(finished(QNetworkReply *)),
-          &loop, SLOT(quit()));
-  loop.exec();
-#endif
-  return true;
-}
-
 /** @brief Insert into or update the ccpay table based on parameters extracted
            from the credit card processing service' response to a transaction
            request.
@@ -3154,12 +3238,18 @@ CreditCardProcessor::FraudCheckResult *CreditCardProcessor::cvvCodeLookup(QChar
   return 0;
 }
 #if QT_VERSION >= 0x050000
-void CreditCardProcessor::sslErrors(QNetworkReply *reply, const QList<QSslError> &errors)
+/* The shared client emits this from CCHttpClient::wait() for every
+   processor, so only answer for the request this processor is waiting on.
+ */
+void CreditCardProcessor::sslErrors(int pid, const QList<QSslError> &errors, bool *pignore)
 {
   if (DEBUG)
-    qDebug() << "CreditCardProcessor::sslErrors(" << errors << ")";
+    qDebug() << "CreditCardProcessor::sslErrors(" << pid << errors << ")";
+
+  if (pid != _requestid || ! pignore)
+    return;
 
-  if (errors.size() > 0 && reply)
+  if (errors.size() > 0)
   {
     QString errlist;
     for (int i = 0; i < errors.size(); i++)
@@ -3174,7 +3264,7 @@ void CreditCardProcessor::sslErrors(QNetworkReply *reply, const QList<QSslError>
                               .arg(errlist),
                               QMessageBox::Yes | QMessageBox::No,
                               QMessageBox::No) == QMessageBox::Yes)
-        reply->ignoreSslErrors(errors);
+        *pignore = true;
   }
 }
 #else
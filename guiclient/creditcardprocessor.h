@@ -12,8 +12,10 @@
 #define CREDITCARDPROCESSOR_H
 
 #include <QHash>
+#include <QList>
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #if QT_VERSION < 0x050000
 #include <QHttp>
 #else
@@ -22,6 +24,7 @@
 #include <parameter.h>
 
 class QSslCertificate;
+class QWidget;
 
 class CreditCardProcessor : public QObject
 {
@@ -62,6 +65,7 @@ class CreditCardProcessor : public QObject
     virtual int authorize(const int pccardid, const QString &pcvv, const double pamount, double ptax, bool ptaxexempt, double pfreight, double pduty, const int pcurrid, QString &pneworder, QString &preforder, int &pccpayid, QString preftype, int &prefid);
     virtual int charge(const int pccardid, const QString &pcvv, const double pamount, const double ptax, const bool ptaxexempt, const double pfreight, const double pduty, const int pcurrid, QString &pneworder, QString &preforder, int &pccpayid, QString preftype, int &prefid);
     virtual int chargePreauthorized(const QString &pcvv, const double pamount, const int pcurrid, QString &pneworder, QString &preforder, int &pccpayid);
+    virtual int capturePreauthorized(const QList<int> &pccpayids, QStringList &perrors, QWidget *pparent = 0);
     virtual int credit(const int pccardid, const QString &pcvv, const double pamount, const double ptax, const bool ptaxexempt, const double pfreight, const double pduty, const int pcurrid, QString &pneworder, QString &preforder, int &pccpayid, QString preftype, int &prefid);
     virtual int reversePreauthorized(const double pamount, const int pcurrid, QString &pneworder, QString &preforder, int &pccpayid, QString preftype, int prefid);
     virtual int voidPrevious(int &);
@@ -109,9 +113,9 @@ class CreditCardProcessor : public QObject
     virtual int     fraudChecks();
     virtual int     sendViaHTTP(const QString&, QString&);
     virtual int     updateCCPay(int &, ParameterList &);
-    virtual bool    waitForHTTP();
 
     QList<FraudCheckResult*> _avsCodes;
+    bool                _batchConfirmed;
     QList<FraudCheckResult*> _cvvCodes;
     QString             _company;
     QString		_defaultLiveServer;
@@ -131,7 +135,7 @@ class CreditCardProcessor : public QObject
     #if QT_VERSION < 0x050000
     QHttp             * _http;
     #else
-    QNetworkAccessManager *_manager;
+    int                 _requestid;
     #endif
     QList<QPair<QString, QString> > _extraHeaders;
 
@@ -139,7 +143,7 @@ class CreditCardProcessor : public QObject
     #if QT_VERSION < 0x050000
       void sslErrors(const QList<QSslError> &errors);
     #else
-      void sslErrors(QNetworkReply *reply, const QList<QSslError> &errors);
+      void sslErrors(int pid, const QList<QSslError> &errors, bool *pignore);
     #endif
 
 };
@@ -18,6 +18,7 @@
 
 #include "crmaccount.h"
 #include "errorReporter.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 #include "parameterwidget.h"
 
@@ -31,6 +32,7 @@ crmaccounts::crmaccounts(QWidget* parent, const char*, Qt::WindowFlags fl)
   setNewVisible(true);
   setSearchVisible(true);
   setQueryOnStartEnabled(true);
+  setCursorPageSize(500);
 
   QString qryStatus = QString( "SELECT  1, '%1' UNION "
                                "SELECT  2, '%2' UNION "
@@ -71,14 +73,14 @@ crmaccounts::crmaccounts(QWidget* parent, const char*, Qt::WindowFlags fl)
   parameterWidget()->append(tr("Create Date on or After"), "startCreateDate", ParameterWidget::Date);
   parameterWidget()->append(tr("Create Date on or Before"),   "endCreateDate",   ParameterWidget::Date);
 
-  connect(omfgThis, SIGNAL(crmAccountsUpdated(int)),     this, SLOT(sFillList()));
-  connect(omfgThis, SIGNAL(customersUpdated(int, bool)), this, SLOT(sFillList()));
-  connect(omfgThis, SIGNAL(employeeUpdated(int)),        this, SLOT(sFillList()));
-  connect(omfgThis, SIGNAL(prospectsUpdated()),          this, SLOT(sFillList()));
-  connect(omfgThis, SIGNAL(salesRepUpdated(int)),        this, SLOT(sFillList()));
-  connect(omfgThis, SIGNAL(taxAuthsUpdated(int)),        this, SLOT(sFillList()));
-  connect(omfgThis, SIGNAL(userUpdated(QString)),        this, SLOT(sFillList()));
-  connect(omfgThis, SIGNAL(vendorsUpdated()),            this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(crmAccountsUpdated(int)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(customersUpdated(int, bool)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(employeeUpdated(int)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(prospectsUpdated()), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(salesRepUpdated(int)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(taxAuthsUpdated(int)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(userUpdated(QString)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(vendorsUpdated()), this, SLOT(sFillList()));
 
   list()->addColumn(tr("Number"),         80, Qt::AlignLeft,    true, "crmacct_number");
   list()->addColumn(tr("Active"),  _ynColumn,  Qt::AlignCenter,false, "crmacct_active");
@@ -17,6 +17,7 @@
 #include "customer.h"
 #include "customerTypeList.h"
 #include "errorReporter.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 #include "parameterwidget.h"
 
@@ -31,6 +32,7 @@ customers::customers(QWidget* parent, const char*, Qt::WindowFlags fl)
   setNewVisible(true);
   setSearchVisible(true);
   setQueryOnStartEnabled(true);
+  setCursorPageSize(500);
 
   QString holdSql = QString("SELECT 0 AS code, '%1' AS desc "
                             " UNION SELECT 1, '%2' "
@@ -96,7 +98,7 @@ customers::customers(QWidget* parent, const char*, Qt::WindowFlags fl)
 
   setupCharacteristics("C");
 
-  connect(omfgThis, SIGNAL(customersUpdated(int, bool)), SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(customersUpdated(int, bool)), this, SLOT(sFillList()));
 }
 
 void customers::sNew()
@@ -12,12 +12,18 @@
 #include "display.h"
 #include "ui_display.h"
 
+#include <QElapsedTimer>
+#include <QHeaderView>
+#include <QSqlDatabase>
 #include <QSqlError>
+#include <QMenu>
 #include <QMessageBox>
 #include <QPrinter>
 #include <QPrintDialog>
+#include <QRegExp>
 #include <QShortcut>
 #include <QToolButton>
+#include <QtAlgorithms>
 
 #include <metasql.h>
 #include <mqlutil.h>
@@ -29,6 +35,7 @@
 
 #include "parameterlistsetup.h"
 #include "errorReporter.h"
+#include "queryprofiler.h"
 #include "displayprivate.h"
 
 displayPrivate::displayPrivate(::display *parent)
@@ -37,7 +44,11 @@ displayPrivate::displayPrivate(::display *parent)
       _queryOnStartEnabled(false),
       _autoUpdateEnabled(false),
       _filterChanged(false),
-      _parent(parent)
+      _cursorPageSize(0),
+      _parent(parent),
+      _haveServerResult(false),
+      _localOrder(0),
+      _menuColumn(-1)
 {
   setupUi(_parent);
 
@@ -135,6 +146,13 @@ displayPrivate::displayPrivate(::display *parent)
 
   _parent->layout()->setContentsMargins(0,0,0,0);
   _parent->layout()->setSpacing(0);
+
+  connect(_list, SIGNAL(cleared()), this, SLOT(sListCleared()));
+}
+
+displayPrivate::~displayPrivate()
+{
+  qDeleteAll(_localHeld);
 }
 
 void displayPrivate::sFilterChanged()
@@ -142,6 +160,334 @@ void displayPrivate::sFilterChanged()
   _filterChanged = true;
 }
 
+/* The rows in the list no longer come from the last server query, so
+   forget it along with the rows the local filters were holding back.
+ */
+void displayPrivate::sListCleared()
+{
+  qDeleteAll(_localHeld);
+  _localHeld.clear();
+  _paramFilters.clear();
+  _menuFilters.clear();
+  _localOrder       = 0;
+  _haveServerResult = false;
+}
+
+void displayPrivate::setServerResult(const ParameterList &params)
+{
+  _serverParams     = params;
+  _haveServerResult = true;
+}
+
+static bool sameValue(const ParameterList &params, const QString &name, const QVariant &value)
+{
+  bool found = false;
+  QVariant other = params.value(name, &found);
+  return found && other == value;
+}
+
+// mirror the MetaSQL conventions: lists are IN, text is a ~* pattern
+static bool localMatch(const QVariant &raw, const QVariant &filter)
+{
+  if (filter.type() == QVariant::List || filter.type() == QVariant::StringList)
+  {
+    foreach (QVariant value, filter.toList())
+      if (localMatch(raw, value))
+        return true;
+    return false;
+  }
+  else if (filter.type() == QVariant::String)
+    return raw.toString().contains(QRegExp(filter.toString(), Qt::CaseInsensitive));
+
+  return raw == filter;
+}
+
+/* Try to answer a query from the rows already loaded in the list.
+
+   Only parameters a window has declared with display::setLocalFilter() are
+   applied locally. Every other parameter the server saw must be unchanged,
+   and so must any declared parameter the server query already used, since
+   changing either could widen the result. A declared parameter the server
+   query did not use can only narrow it. Asking for the same rows again
+   goes back to the database so Query still means refresh.
+
+   Returns true if the list now shows the refined result.
+ */
+bool displayPrivate::refineLocally(const ParameterList &params)
+{
+  if (! _haveServerResult || _localFilterParams.isEmpty() || _list->cursorOpen())
+    return false;
+
+  for (int i = 0; i < _serverParams.count(); i++)
+  {
+    if (_serverParams.name(i) != "filter" &&
+        ! sameValue(params, _serverParams.name(i), _serverParams.value(i)))
+      return false;
+  }
+
+  QMap<int, QVariant> filters;
+  for (int i = 0; i < params.count(); i++)
+  {
+    bool found = false;
+    _serverParams.value(params.name(i), &found);
+    if (found || params.name(i) == "filter")
+      continue;
+
+    if (! _localFilterParams.contains(params.name(i)))
+      return false;
+
+    int col = _list->column(_localFilterParams.value(params.name(i)));
+    if (col < 0)
+      return false;
+    filters.insert(col, params.value(i));
+  }
+
+  if (filters == _paramFilters)
+    return false;
+
+  _paramFilters = filters;
+  applyLocalFilters();
+  return true;
+}
+
+static bool localOrderLessThan(XTreeWidgetItem *a, XTreeWidgetItem *b)
+{
+  return a->data(0, Xt::LocalOrderRole).toInt() < b->data(0, Xt::LocalOrderRole).toInt();
+}
+
+/* Show the rows of the last server result that pass every local filter.
+
+   Rows that fail are taken out of the list rather than hidden, so the
+   list's search, export, sorting and total rows only see the rows shown.
+   Each row remembers its place in the server's result, so rows put back
+   when a filter is relaxed return to where they were.
+ */
+void displayPrivate::applyLocalFilters()
+{
+  int previd = _list->id();
+
+  QList<XTreeWidgetItem *> rows;
+  foreach (QTreeWidgetItem *child, _list->invisibleRootItem()->takeChildren())
+  {
+    XTreeWidgetItem *item = dynamic_cast<XTreeWidgetItem *>(child);
+    if (! item || item->data(0, Qt::UserRole).toString() == "totalrole")
+    {
+      delete child;
+      continue;
+    }
+    if (! item->data(0, Xt::LocalOrderRole).isValid())
+      item->setData(0, Xt::LocalOrderRole, _localOrder++);
+    rows.append(item);
+  }
+  rows += _localHeld;
+  _localHeld.clear();
+  qStableSort(rows.begin(), rows.end(), localOrderLessThan);
+
+  QList<QTreeWidgetItem *> shown;
+  foreach (XTreeWidgetItem *item, rows)
+  {
+    bool keep = true;
+    for (QMap<int, QVariant>::const_iterator f = _paramFilters.constBegin();
+         keep && f != _paramFilters.constEnd(); ++f)
+      keep = localMatch(item->data(f.key(), Xt::RawRole), f.value());
+    for (QMap<int, QVariant>::const_iterator f = _menuFilters.constBegin();
+         keep && f != _menuFilters.constEnd(); ++f)
+      keep = (item->data(f.key(), Xt::RawRole) == f.value());
+
+    if (keep)
+      shown.append(item);
+    else
+      _localHeld.append(item);
+  }
+  _list->addTopLevelItems(shown);
+
+  if (_list->header()->isSortIndicatorShown() && _list->sortColumn() >= 0)
+    _list->sortItems(_list->sortColumn(), _list->header()->sortIndicatorOrder());
+  else
+    _list->populateCalculatedColumns();
+  _list->setId(previd);
+}
+
+/* Collect the numeric values of a column from the rows currently shown,
+   in one contiguous array so the aggregate loops stay tight.
+ */
+QVector<double> displayPrivate::columnValues(int col) const
+{
+  QVector<double> values;
+  values.reserve(_list->topLevelItemCount());
+  for (int i = 0; i < _list->topLevelItemCount(); i++)
+  {
+    XTreeWidgetItem *item = _list->topLevelItem(i);
+    if (item->isHidden() ||
+        item->data(0, Qt::UserRole).toString() == "totalrole")
+      continue;
+
+    QVariant raw = item->data(col, Xt::RawRole);
+    if (! raw.isNull())
+      values.append(raw.toDouble());
+  }
+  return values;
+}
+
+QVariantMap displayPrivate::aggregate(int col) const
+{
+  QVector<double> values = columnValues(col);
+  const double *v   = values.constData();
+  const int     n   = values.size();
+  double        sum = 0.0;
+  double        min = n ? v[0] : 0.0;
+  double        max = min;
+  for (int i = 0; i < n; i++)
+  {
+    sum += v[i];
+    min  = v[i] < min ? v[i] : min;
+    max  = v[i] > max ? v[i] : max;
+  }
+
+  QVariantMap result;
+  result.insert("count", n);
+  result.insert("sum",   sum);
+  result.insert("min",   n ? QVariant(min) : QVariant());
+  result.insert("max",   n ? QVariant(max) : QVariant());
+  return result;
+}
+
+/* Group the rows currently shown by the text of groupCol and total
+   valueCol for each group. Returns group => { count, sum }.
+ */
+QVariantMap displayPrivate::subtotals(int groupCol, int valueCol) const
+{
+  QMap<QString, int>    counts;
+  QMap<QString, double> sums;
+  for (int i = 0; i < _list->topLevelItemCount(); i++)
+  {
+    XTreeWidgetItem *item = _list->topLevelItem(i);
+    if (item->isHidden() ||
+        item->data(0, Qt::UserRole).toString() == "totalrole")
+      continue;
+
+    QString group = item->text(groupCol);
+    counts[group] += 1;
+    sums[group]   += item->data(valueCol, Xt::RawRole).toDouble();
+  }
+
+  QVariantMap result;
+  QMapIterator<QString, int> it(counts);
+  while (it.hasNext())
+  {
+    it.next();
+    QVariantMap group;
+    group.insert("count", it.value());
+    group.insert("sum",   sums.value(it.key()));
+    result.insert(it.key(), group);
+  }
+  return result;
+}
+
+void displayPrivate::sPopulateLocalMenu(QMenu *menu, QTreeWidgetItem *item, int col)
+{
+  // a cursor-paged list only holds part of the result
+  if (! _haveServerResult || _list->cursorOpen() || col < 0)
+    return;
+
+  _menuColumn = col;
+  menu->addSeparator();
+  menu->addAction(::display::tr("Summarize Column..."), this, SLOT(sShowAggregate()));
+  menu->addAction(::display::tr("Subtotal by Column..."), this, SLOT(sShowSubtotals()));
+
+  if (item && item->data(0, Qt::UserRole).toString() != "totalrole")
+  {
+    _menuValue = item->data(col, Xt::RawRole);
+    menu->addAction(::display::tr("Show Only This Value"), this, SLOT(sFilterToValue()));
+  }
+  if (! _menuFilters.isEmpty())
+    menu->addAction(::display::tr("Clear Column Filters"), this, SLOT(sClearColumnFilters()));
+}
+
+void displayPrivate::sFilterToValue()
+{
+  _menuFilters.insert(_menuColumn, _menuValue);
+  applyLocalFilters();
+}
+
+void displayPrivate::sClearColumnFilters()
+{
+  _menuFilters.clear();
+  applyLocalFilters();
+}
+
+static QString escapeHtml(const QString &text)
+{
+  return QString(text).replace("&", "&amp;").replace("<", "&lt;").replace(">", "&gt;");
+}
+
+void displayPrivate::sShowAggregate()
+{
+  QVariantMap agg   = aggregate(_menuColumn);
+  int         scale = decimalPlaces("");
+  QMessageBox::information(_parent, ::display::tr("Column Summary"),
+                           ::display::tr("<p>%1</p><table>"
+                                         "<tr><td>Count:</td><td align=right>%2</td></tr>"
+                                         "<tr><td>Sum:</td><td align=right>%3</td></tr>"
+                                         "<tr><td>Minimum:</td><td align=right>%4</td></tr>"
+                                         "<tr><td>Maximum:</td><td align=right>%5</td></tr>"
+                                         "</table>")
+                           .arg(escapeHtml(_list->headerItem()->text(_menuColumn)))
+                           .arg(QLocale().toString(agg.value("count").toInt()))
+                           .arg(QLocale().toString(agg.value("sum").toDouble(), 'f', scale))
+                           .arg(QLocale().toString(agg.value("min").toDouble(), 'f', scale))
+                           .arg(QLocale().toString(agg.value("max").toDouble(), 'f', scale)));
+}
+
+void displayPrivate::sShowSubtotals()
+{
+  // subtotal every column that holds numbers in the first visible row
+  QList<int> valueCols;
+  for (int i = 0; i < _list->topLevelItemCount() && valueCols.isEmpty(); i++)
+  {
+    XTreeWidgetItem *item = _list->topLevelItem(i);
+    if (item->isHidden())
+      continue;
+    for (int col = 0; col < _list->columnCount(); col++)
+    {
+      QVariant::Type type = item->data(col, Xt::RawRole).type();
+      if (col != _menuColumn && ! _list->isColumnHidden(col) &&
+          (type == QVariant::Double || type == QVariant::Int ||
+           type == QVariant::LongLong))
+        valueCols.append(col);
+    }
+    break;
+  }
+
+  int     scale = decimalPlaces("");
+  QString html  = "<table><tr><th>" + escapeHtml(_list->headerItem()->text(_menuColumn)) +
+                  "</th><th>" + ::display::tr("Count") + "</th>";
+  QList<QVariantMap> sets;
+  for (int i = 0; i < valueCols.size(); i++)
+  {
+    html += "<th>" + escapeHtml(_list->headerItem()->text(valueCols.at(i))) + "</th>";
+    sets.append(subtotals(_menuColumn, valueCols.at(i)));
+  }
+  html += "</tr>";
+
+  QVariantMap groups = sets.isEmpty() ? subtotals(_menuColumn, _menuColumn) : sets.at(0);
+  QMapIterator<QString, QVariant> it(groups);
+  while (it.hasNext())
+  {
+    it.next();
+    html += "<tr><td>" + escapeHtml(it.key()) + "</td><td align=right>" +
+            QLocale().toString(it.value().toMap().value("count").toInt()) + "</td>";
+    for (int i = 0; i < sets.size(); i++)
+      html += "<td align=right>" +
+              QLocale().toString(sets.at(i).value(it.key()).toMap().value("sum").toDouble(), 'f', scale) +
+              "</td>";
+    html += "</tr>";
+  }
+  html += "</table>";
+
+  QMessageBox::information(_parent, ::display::tr("Subtotals"), html);
+}
+
 void displayPrivate::print(ParameterList pParams, bool showPreview, bool forceSetParams)
 {
   int numCopies = 1;
@@ -393,6 +739,7 @@ display::display(QWidget* parent, const char* name, Qt::WindowFlags flags)
   connect(_data->_searchAct, SIGNAL(triggered()), this, SLOT(sFillList()));
   connect(this, SIGNAL(fillList()), this, SLOT(sFillList()));
   connect(_data->_list, SIGNAL(populateMenu(QMenu*,QTreeWidgetItem*,int)), this, SLOT(sPopulateMenu(QMenu*,QTreeWidgetItem*,int)));
+  connect(_data->_list, SIGNAL(populateMenu(QMenu*,QTreeWidgetItem*,int)), _data, SLOT(sPopulateLocalMenu(QMenu*,QTreeWidgetItem*,int)));
   connect(_data->_autoupdate, SIGNAL(toggled(bool)), this, SLOT(sAutoUpdateToggled()));
   connect(filterButton, SIGNAL(toggled(bool)), _data->_moreBtn, SLOT(setChecked(bool)));
 }
@@ -702,6 +1049,59 @@ bool display::autoUpdateEnabled() const
   return _data->_autoUpdateEnabled;
 }
 
+/** When @a rows is greater than zero, sFillList() runs its query through a
+    server-side cursor and reads @a rows rows at a time as the user scrolls,
+    instead of reading the whole result at once. The list keeps only a few
+    pages around the rows shown. Use this for displays that can return very
+    many rows.
+ */
+void display::setCursorPageSize(int rows)
+{
+  _data->_cursorPageSize = qMax(0, rows);
+}
+
+int display::cursorPageSize() const
+{
+  return _data->_cursorPageSize;
+}
+
+/** Let parameter @a param narrow the rows already loaded instead of
+    requerying, by matching its value against @a column the way MetaSQL
+    would: a list as IN, text as a case-insensitive pattern, anything else
+    as equality. Only declare parameters whose query clause is exactly
+    that test on that column. An empty @a column removes the declaration.
+ */
+void display::setLocalFilter(const QString &param, const QString &column)
+{
+  if (column.isEmpty())
+    _data->_localFilterParams.remove(param);
+  else
+    _data->_localFilterParams.insert(param, column);
+}
+
+/** Return the count, sum, min and max of the named column over the rows
+    currently shown in the list.
+ */
+QVariantMap display::columnSummary(const QString &column)
+{
+  int col = _data->_list->column(column);
+  if (col < 0)
+    return QVariantMap();
+  return _data->aggregate(col);
+}
+
+/** Group the rows currently shown by one column and total another,
+    returning a map of group value to { count, sum }.
+ */
+QVariantMap display::columnSubtotals(const QString &groupColumn, const QString &valueColumn)
+{
+  int groupCol = _data->_list->column(groupColumn);
+  int valueCol = _data->_list->column(valueColumn);
+  if (groupCol < 0 || valueCol < 0)
+    return QVariantMap();
+  return _data->subtotals(groupCol, valueCol);
+}
+
 void display::sNew()
 {
 }
@@ -752,6 +1152,12 @@ void display::sFillList(ParameterList pParams, bool forceSetParams)
     if (!setParams(pParams))
       return;
   }
+  if (_data->refineLocally(pParams))
+  {
+    emit fillListAfter();
+    return;
+  }
+
   int itemid = _data->_list->id();
   bool ok = true;
   QString errorString;
@@ -762,14 +1168,41 @@ void display::sFillList(ParameterList pParams, bool forceSetParams)
                          errorString, __FILE__, __LINE__);
     return;
   }
+  QueryProfilerScope profile(objectName());
+  QElapsedTimer timer;
+  timer.start();
+
+  if (_data->_cursorPageSize > 0)
+  {
+    XSqlQuery prepared = mql.toQuery(pParams, QSqlDatabase(), false);
+    bool opened = _data->_list->populateCursor(prepared, itemid, _data->_useAltId,
+                                               _data->_cursorPageSize);
+    QueryProfiler::instance()->record(objectName(), prepared.lastQuery(), QString(),
+                                      timer.nsecsElapsed() / 1000,
+                                      _data->_list->topLevelItemCount());
+    if (! opened)
+    {
+      _data->sListCleared();
+      ErrorReporter::error(QtCriticalMsg, this, tr("Error Retrieving Information"),
+                           _data->_list->cursorError(), __FILE__, __LINE__);
+      return;
+    }
+    _data->setServerResult(pParams);
+    emit fillListAfter();
+    return;
+  }
+
   XSqlQuery xq = mql.toQuery(pParams);
+  QueryProfiler::instance()->record(xq, timer.nsecsElapsed() / 1000);
   _data->_list->populate(xq, itemid, _data->_useAltId);
   if (xq.lastError().type() != QSqlError::NoError)
   {
+    _data->sListCleared();
     ErrorReporter::error(QtCriticalMsg, this, tr("Error Retrieving Information"),
                            xq, __FILE__, __LINE__);
     return;
   }
+  _data->setServerResult(pParams);
   emit fillListAfter();
 }
 
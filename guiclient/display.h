@@ -61,6 +61,12 @@ public:
     Q_INVOKABLE void setAutoUpdateEnabled(bool);
     Q_INVOKABLE bool autoUpdateEnabled() const;
 
+    Q_INVOKABLE void setCursorPageSize(int);
+    Q_INVOKABLE int  cursorPageSize() const;
+    Q_INVOKABLE void setLocalFilter(const QString &, const QString &);
+    Q_INVOKABLE QVariantMap columnSummary(const QString &);
+    Q_INVOKABLE QVariantMap columnSubtotals(const QString &, const QString &);
+
     Q_INVOKABLE XTreeWidget * list();
     Q_INVOKABLE ParameterWidget * parameterWidget();
     Q_INVOKABLE QWidget * optionsWidget();
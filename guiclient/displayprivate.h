@@ -13,11 +13,19 @@
 
 #include "ui_display.h"
 
+#include <QList>
+#include <QMap>
+#include <QVariantMap>
+#include <QVector>
+
 #include <parameter.h>
 
 #include "parameterlistsetup.h"
 
+class QMenu;
 class QToolButton;
+class QTreeWidgetItem;
+class XTreeWidgetItem;
 class display;
 
 class displayPrivate : public QObject, public Ui::display
@@ -26,11 +34,20 @@ class displayPrivate : public QObject, public Ui::display
 
   public:
     displayPrivate(::display *parent);
+    ~displayPrivate();
 
     bool setParams(ParameterList &params);
     void setupCharacteristics(QStringList uses);
     void print(ParameterList pParams, bool showPreview, bool forceSetParams);
 
+    bool refineLocally(const ParameterList &params);
+    void setServerResult(const ParameterList &params);
+    void applyLocalFilters();
+
+    QVector<double> columnValues(int col) const;
+    QVariantMap     aggregate(int col) const;
+    QVariantMap     subtotals(int groupCol, int valueCol) const;
+
     QString reportName;
     QString metasqlName;
     QString metasqlGroup;
@@ -39,6 +56,7 @@ class displayPrivate : public QObject, public Ui::display
     bool _queryOnStartEnabled;
     bool _autoUpdateEnabled;
     bool _filterChanged;
+    int  _cursorPageSize;
 
     QAction *_newAct;
     QAction *_closeAct;
@@ -72,11 +90,28 @@ class displayPrivate : public QObject, public Ui::display
     QList<QVariant> _charidslist;
     QList<QVariant> _charidsdate;
 
+    QMap<QString, QString> _localFilterParams; // parameter => column it narrows
+
   public slots:
     void sFilterChanged();
+    void sListCleared();
+    void sPopulateLocalMenu(QMenu *, QTreeWidgetItem *, int);
+    void sShowAggregate();
+    void sShowSubtotals();
+    void sFilterToValue();
+    void sClearColumnFilters();
 
   private:
     ::display *_parent;
+
+    bool                     _haveServerResult;
+    ParameterList            _serverParams;
+    QMap<int, QVariant>      _paramFilters;  // column => value of a local filter parameter
+    QMap<int, QVariant>      _menuFilters;   // column => value picked from the list's menu
+    QList<XTreeWidgetItem *> _localHeld;     // rows the local filters took out of the list
+    int                      _localOrder;
+    int                      _menuColumn;
+    QVariant                 _menuValue;
 };
 
 #endif
@@ -14,6 +14,7 @@
 #include <QMessageBox>
 
 #include "item.h"
+#include "refreshscheduler.h"
 
 dspBOMBase::dspBOMBase(QWidget* parent, const char* name, Qt::WindowFlags fl)
     : display(parent, name, fl)
@@ -23,7 +24,13 @@ dspBOMBase::dspBOMBase(QWidget* parent, const char* name, Qt::WindowFlags fl)
   setMetaSQLOptions("bom", "detail");
 
   connect(_item, SIGNAL(valid(bool)), _revision, SLOT(setEnabled(bool)));
-  connect(omfgThis, SIGNAL(bomsUpdated(int, bool)), this, SLOT(sFillList()));
+
+  // refresh for the selected bill or one of the components it shows
+  RefreshScheduler *refresh = RefreshScheduler::connect(omfgThis, SIGNAL(bomsUpdated(int, bool)),
+                                                        this, SLOT(sFillList()));
+  refresh->setIds(_item->id());
+  refresh->setIdList(list());
+  connect(_item, SIGNAL(newId(int)), refresh, SLOT(setIds(int)));
 
   _item->setType(ItemLineEdit::cHasBom);
 
@@ -21,6 +21,7 @@
 
 #include "dspItemCostSummary.h"
 #include "maintainItemCosts.h"
+#include "refreshscheduler.h"
 
 dspCostedBOMBase::dspCostedBOMBase(QWidget* parent, const char* name, Qt::WindowFlags fl)
     : display(parent, name, fl)
@@ -52,7 +53,12 @@ dspCostedBOMBase::dspCostedBOMBase(QWidget* parent, const char* name, Qt::Window
   list()->addColumn(tr("Ext. Cost"),  _priceColumn,Qt::AlignRight, true, "extendedcost");
   list()->setPopulateLinear();
 
-  connect(omfgThis, SIGNAL(bomsUpdated(int, bool)), this, SLOT(sFillList(int, bool)));
+  // refresh for the selected bill or one of the components it shows
+  RefreshScheduler *refresh = RefreshScheduler::connect(omfgThis, SIGNAL(bomsUpdated(int, bool)),
+                                                        this, SLOT(sFillList()));
+  refresh->setIds(_item->id());
+  refresh->setIdList(list(), true);
+  connect(_item, SIGNAL(newId(int)), refresh, SLOT(setIds(int)));
 
   _revision->setMode(RevisionLineEdit::View);
   _revision->setType("BOM");
@@ -45,6 +45,7 @@ dspGLTransactions::dspGLTransactions(QWidget* parent, const char*, Qt::WindowFla
   setMetaSQLOptions("gltransactions", "detail");
   setUseAltId(true);
   setParameterWidgetVisible(true);
+  setCursorPageSize(500);
 
   QString qryType = QString( "SELECT  1, '%1' UNION "
                              "SELECT  2, '%2' UNION "
@@ -29,6 +29,20 @@
 #include "purchaseRequest.h"
 #include "workOrder.h"
 #include "parameterwidget.h"
+#include "refreshscheduler.h"
+
+// does an updated work order make or consume a listed item site, or is it gone?
+static const char *woAffectsItemsitesSql =
+  "SELECT 1"
+  "  FROM unnest(CAST(:ids AS INTEGER[])) AS updated(id)"
+  "  LEFT OUTER JOIN wo ON (wo_id=updated.id)"
+  " WHERE (wo_id IS NULL)"
+  "    OR (wo_itemsite_id = ANY(CAST(:keys AS INTEGER[])))"
+  "    OR EXISTS(SELECT 1"
+  "                FROM womatl"
+  "               WHERE ((womatl_wo_id=updated.id)"
+  "                  AND (womatl_itemsite_id = ANY(CAST(:keys AS INTEGER[])))))"
+  " LIMIT 1;";
 
 dspInventoryAvailability::dspInventoryAvailability(QWidget* parent, const char*, Qt::WindowFlags fl)
     : display(parent, "dspInventoryAvailability", fl)
@@ -73,9 +87,12 @@ dspInventoryAvailability::dspInventoryAvailability(QWidget* parent, const char*,
   sByVendorChanged();
 
   connect(_showReorder, SIGNAL(toggled(bool)), this, SLOT(sHandleShowReorder(bool)));
-  connect(omfgThis, SIGNAL(workOrdersUpdated(int, bool)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(workOrdersUpdated(int, bool)), this, SLOT(sFillList()));
+  connect(_showShortages, SIGNAL(toggled(bool)), this, SLOT(sHandleRefreshFilter()));
+  connect(_showReorder, SIGNAL(toggled(bool)), this, SLOT(sHandleRefreshFilter()));
   connect(_byVendor, SIGNAL(toggled(bool)), this, SLOT(sByVendorChanged()));
   connect(_asof, SIGNAL(currentIndexChanged(int)), this, SLOT(sAsofChanged(int)));
+  sHandleRefreshFilter();
 }
 
 void dspInventoryAvailability::languageChange()
@@ -447,6 +464,23 @@ void dspInventoryAvailability::sHandleShowReorder(bool pValue)
     _showShortages->setChecked(true);
 }
 
+void dspInventoryAvailability::sHandleRefreshFilter()
+{
+  RefreshScheduler *refresh = RefreshScheduler::find(this, SLOT(sFillList()));
+  if (! refresh)
+    return;
+
+  // a work order can push an unlisted item site into a shortage or
+  // reorder list, so only filter when the list is not restricted that way
+  if (_showShortages->isChecked() || _showReorder->isChecked())
+    refresh->clearIdFilter();
+  else
+  {
+    refresh->setIdList(list());
+    refresh->setIdQuery(woAffectsItemsitesSql);
+  }
+}
+
 void dspInventoryAvailability::sByVendorChanged()
 {
   list()->clear();
@@ -46,6 +46,7 @@ public slots:
     virtual void sEnterMiscCount();
     virtual void sEnterAdjustment();
     virtual void sHandleShowReorder( bool pValue );
+    virtual void sHandleRefreshFilter();
     virtual void sByVendorChanged();
     virtual void sAsofChanged(int index);
 
@@ -24,6 +24,22 @@
 #include "workOrder.h"
 #include "purchaseOrder.h"
 #include "errorReporter.h"
+#include "refreshscheduler.h"
+
+// does an updated work order make or consume the selected item, or is it gone?
+static const char *woAffectsItemsSql =
+  "SELECT 1"
+  "  FROM unnest(CAST(:ids AS INTEGER[])) AS updated(id)"
+  "  LEFT OUTER JOIN wo ON (wo_id=updated.id)"
+  " WHERE (wo_id IS NULL)"
+  "    OR EXISTS(SELECT 1"
+  "                FROM itemsite"
+  "               WHERE ((itemsite_item_id = ANY(CAST(:keys AS INTEGER[])))"
+  "                  AND ((itemsite_id=wo_itemsite_id)"
+  "                    OR (itemsite_id IN (SELECT womatl_itemsite_id"
+  "                                          FROM womatl"
+  "                                         WHERE (womatl_wo_id=updated.id))))))"
+  " LIMIT 1;";
 
 dspRunningAvailability::dspRunningAvailability(QWidget* parent, const char*, Qt::WindowFlags fl)
   : display(parent, "dspRunningAvailability", fl)
@@ -60,7 +76,11 @@ dspRunningAvailability::dspRunningAvailability(QWidget* parent, const char*, Qt:
   _orderMultiple->setValidator(omfgThis->qtyVal());
   _orderToQty->setValidator(omfgThis->qtyVal());
 
-  connect(omfgThis, SIGNAL(workOrdersUpdated(int, bool)), this, SLOT(sFillList()));
+  RefreshScheduler *refresh = RefreshScheduler::connect(omfgThis, SIGNAL(workOrdersUpdated(int, bool)),
+                                                        this, SLOT(sFillList()));
+  refresh->setIds(_item->id());
+  refresh->setIdQuery(woAffectsItemsSql);
+  connect(_item, SIGNAL(newId(int)), refresh, SLOT(setIds(int)));
 
   if (!_metrics->boolean("MultiWhs"))
   {
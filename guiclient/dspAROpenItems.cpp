@@ -42,6 +42,7 @@
 #include "printCreditMemo.h"
 #include "printInvoice.h"
 #include "printStatementByCustomer.h"
+#include "refreshscheduler.h"
 #include "salesOrder.h"
 #include "storedProcErrorLookup.h"
 
@@ -98,8 +99,8 @@ dspAROpenItems::dspAROpenItems(QWidget* parent, const char*, Qt::WindowFlags fl)
   list()->addColumn(tr("Credit Card"),            -1, Qt::AlignLeft,   false, "ccard_number");
   list()->addColumn(tr("Notes"),                  -1, Qt::AlignLeft,   false, "notes");
   
-  connect(omfgThis, SIGNAL(creditMemosUpdated()), this, SLOT(sFillList()));
-  connect(omfgThis, SIGNAL(invoicesUpdated(int, bool)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(creditMemosUpdated()), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(invoicesUpdated(int, bool)), this, SLOT(sFillList()));
 
   disconnect(newAction(), SIGNAL(triggered()), this, SLOT(sNew()));
   connect(newAction(), SIGNAL(triggered()), this, SLOT(sCreateInvoice()));
@@ -20,6 +20,7 @@
 #include "mqlutil.h"
 
 #include <openreports.h>
+#include "refreshscheduler.h"
 #include "selectOrderForBilling.h"
 #include "printInvoices.h"
 #include "createInvoices.h"
@@ -57,7 +58,7 @@ dspBillingSelections::dspBillingSelections(QWidget* parent, const char* name, Qt
   if (_privileges->check("PostARDocuments"))
     connect(_cobill, SIGNAL(valid(bool)), _post, SLOT(setEnabled(bool)));
 
-  connect(omfgThis, SIGNAL(billingSelectionUpdated(int, int)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(billingSelectionUpdated(int, int)), this, SLOT(sFillList()));
 
   sFillList();
 }
@@ -169,6 +169,13 @@ void dspCreditCardTransactions::sPopulateMenu( QMenu * pMenu, QTreeWidgetItem *p
     pMenu->addAction(postAct);
   }
 
+  if (_privileges->check("ProcessCreditCards"))
+  {
+    QAction* postAllAct = new QAction(tr("Post All Listed Preauthorizations..."), this);
+    connect(postAllAct, SIGNAL(triggered()), this, SLOT(sPostAllPreauth()));
+    pMenu->addAction(postAllAct);
+  }
+
   if (_voidPreauth->isEnabled())
   {
     QAction* voidAct = new QAction(tr("Void"), this);
@@ -220,6 +227,50 @@ void dspCreditCardTransactions::sPostPreauth()
   _postPreauth->setEnabled(true);
 }
 
+/* Capture every pre-authorization in the list.
+
+   The ccpayments-list query returns the ccpay_id as each row's id and a
+   non-zero altId only on rows that are authorized pre-authorizations, the
+   same test sgetCCAmount() uses to enable Post for the selected row.
+   capturePreauthorized() checks ccpay_status again on the server, so a
+   row that changed since the list was filled is skipped, not charged.
+ */
+void dspCreditCardTransactions::sPostAllPreauth()
+{
+  QList<int> ccpayids;
+  for (int i = 0; i < _preauth->topLevelItemCount(); i++)
+  {
+    XTreeWidgetItem *item = _preauth->topLevelItem(i);
+    if (item->altId() != 0 && ! item->isHidden())
+      ccpayids.append(item->id());
+  }
+  if (ccpayids.isEmpty())
+    return;
+
+  CreditCardProcessor *cardproc = CreditCardProcessor::getProcessor();
+  if (! cardproc)
+  {
+    QMessageBox::critical(this, tr("Credit Card Processing Error"),
+                          CreditCardProcessor::errorMsg());
+    return;
+  }
+
+  _postPreauth->setEnabled(false);
+  _voidPreauth->setEnabled(false);
+
+  QStringList errors;
+  int captured = cardproc->capturePreauthorized(ccpayids, errors, this);
+  delete cardproc;
+
+  if (! errors.isEmpty())
+    QMessageBox::warning(this, tr("Credit Card Processing Warning"),
+                         tr("<p>%1 of %2 transactions were posted.</p><ul><li>%3</li></ul>")
+                         .arg(captured).arg(ccpayids.size())
+                         .arg(errors.join("</li><li>")));
+
+  sFillList();
+}
+
 void dspCreditCardTransactions::sPrintCCReceipt()
 {
   CreditCardProcessor::printReceipt(_preauth->id());
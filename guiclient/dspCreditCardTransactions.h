@@ -33,6 +33,7 @@ public:
 public slots:
     virtual void sFillList();
     virtual void sPostPreauth();
+    virtual void sPostAllPreauth();
     virtual void sPopulateMenu(QMenu* pMenu, QTreeWidgetItem* pItem);
     virtual void sPrintCCReceipt();
     virtual void sVoidPreauth();
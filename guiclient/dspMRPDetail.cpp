@@ -27,6 +27,7 @@
 #include "workOrder.h"
 #include "mqlutil.h"
 #include "errorReporter.h"
+#include "timephasedbuckets.h"
 
 dspMRPDetail::dspMRPDetail(QWidget* parent, const char* name, Qt::WindowFlags fl)
     : XWidget(parent, name, fl)
@@ -231,76 +232,77 @@ void dspMRPDetail::sFillItemsites()
 
 void dspMRPDetail::sFillMRPDetail()
 {
-  XSqlQuery dspFillMRPDetail;
   _mrp->clear();
 
   _mrp->setColumnCount(1);
 
+  QList<DatePair> periods;
   QList<XTreeWidgetItem*> selected = _periods->selectedItems();
   for (int i = 0; i < selected.size(); i++)
   {
-    XTreeWidgetItem *cursor = (XTreeWidgetItem*)selected[i];
-    _mrp->addColumn(formatDate(((PeriodListViewItem *)cursor)->startDate()), _qtyColumn, Qt::AlignRight);
+    PeriodListViewItem *cursor = (PeriodListViewItem*)selected[i];
+    _mrp->addColumn(formatDate(cursor->startDate()), _qtyColumn, Qt::AlignRight);
+    periods.append(DatePair(cursor->startDate(), cursor->endDate()));
   }
+  if (periods.isEmpty())
+    return;
 
-  XTreeWidgetItem *qoh = 0;
-  XTreeWidgetItem *allocations = 0;
-  XTreeWidgetItem *orders = 0;
-  XTreeWidgetItem *availability = 0;
-  XTreeWidgetItem *firmedAllocations = 0;
-  XTreeWidgetItem *firmedOrders = 0;
-  XTreeWidgetItem *firmedAvailability = 0;
-  double        runningAvailability = 0.0;
-  double	runningFirmed = 0.0;
-  int           counter = 0;
+  // one round trip for every selected period
+  TimePhasedBuckets buckets;
+  buckets.setBuckets(periods);
+
+  XSqlQuery mrpq;
+  mrpq.prepare("SELECT bucket_seq, itemsite_qtyonhand AS qoh,"
+               "       qtyAllocated(itemsite_id, bucket_start, bucket_end) AS allocations,"
+               "       qtyOrdered(itemsite_id, bucket_start, bucket_end) AS orders,"
+               "       qtyFirmedAllocated(itemsite_id, bucket_start, bucket_end) AS firmedallocations,"
+               "       qtyFirmed(itemsite_id, bucket_start, bucket_end) AS firmedorders"
+               "  FROM itemsite, " + TimePhasedBuckets::bucketTable() +
+               " WHERE (itemsite_id=:itemsite_id)"
+               " ORDER BY bucket_seq;");
+  buckets.bindValues(mrpq);
+  mrpq.bindValue(":itemsite_id", _itemsite->id());
+  mrpq.exec();
+  if (ErrorReporter::error(QtCriticalMsg, this, tr("Error Retrieving MRP Detail"),
+                           mrpq, __FILE__, __LINE__))
+    return;
+  if (! mrpq.first())
+    return;
 
-  for (int i = 0; i < selected.size(); i++)
+  double qohValue = mrpq.value("qoh").toDouble();
+  mrpq.seek(-1);
+  buckets.load(mrpq, QString(), QStringList() << "allocations" << "orders"
+                                              << "firmedallocations" << "firmedorders");
+
+  QVector<double> allocated       = buckets.series(QVariant(), "allocations");
+  QVector<double> ordered         = buckets.series(QVariant(), "orders");
+  QVector<double> firmedAllocated = buckets.series(QVariant(), "firmedallocations");
+  QVector<double> firmedOrdered   = buckets.running(QVariant(), "firmedorders");
+
+  XTreeWidgetItem *qoh                = new XTreeWidgetItem(_mrp, 0, QVariant(tr("Projected QOH")));
+  XTreeWidgetItem *allocations        = new XTreeWidgetItem(_mrp, qoh, 0, QVariant(tr("Allocations")));
+  XTreeWidgetItem *orders             = new XTreeWidgetItem(_mrp, allocations,  0, QVariant(tr("Orders")));
+  XTreeWidgetItem *availability       = new XTreeWidgetItem(_mrp, orders, 0, QVariant(tr("Availability")));
+  XTreeWidgetItem *firmedAllocations  = new XTreeWidgetItem(_mrp, availability, 0, QVariant(tr("Firmed Allocations")));
+  XTreeWidgetItem *firmedOrders       = new XTreeWidgetItem(_mrp, firmedAllocations, 0, QVariant(tr("Firmed Orders")));
+  XTreeWidgetItem *firmedAvailability = new XTreeWidgetItem(_mrp, firmedOrders, 0, QVariant(tr("Firmed Availability")));
+
+  double runningAvailability = qohValue;
+  for (int i = 0; i < buckets.bucketCount(); i++)
   {
-    XTreeWidgetItem *cursor = (XTreeWidgetItem*)selected[i];
-    counter++;
-    ParameterList params;
-    params.append("cursorId", cursor->id());
-    params.append("counter", counter);
-    params.append("itemsite_id", _itemsite->id());
-
-    MetaSQLQuery mql = mqlLoad("mrpDetail", "detail");
-    dspFillMRPDetail = mql.toQuery(params);
-    if (dspFillMRPDetail.first())
-    {
-      if (counter == 1)
-      {
-        runningFirmed = dspFillMRPDetail.value("firmedorders1").toDouble();
-        runningAvailability = (dspFillMRPDetail.value("qoh").toDouble() - dspFillMRPDetail.value("allocations1").toDouble() + dspFillMRPDetail.value("orders1").toDouble());
-
-        qoh                = new XTreeWidgetItem(_mrp, 0, QVariant(tr("Projected QOH")), dspFillMRPDetail.value("f_qoh"));
-        allocations        = new XTreeWidgetItem(_mrp, qoh, 0, QVariant(tr("Allocations")), formatQty(dspFillMRPDetail.value("allocations1").toDouble()));
-        orders             = new XTreeWidgetItem(_mrp, allocations,  0, QVariant(tr("Orders")), formatQty(dspFillMRPDetail.value("orders1").toDouble()));
-        availability       = new XTreeWidgetItem(_mrp, orders, 0, QVariant(tr("Availability")), formatQty(runningAvailability));
-        firmedAllocations  = new XTreeWidgetItem(_mrp, availability, 0, QVariant(tr("Firmed Allocations")), formatQty(dspFillMRPDetail.value("firmedallocations1").toDouble()));
-        firmedOrders       = new XTreeWidgetItem(_mrp, firmedAllocations, 0, QVariant(tr("Firmed Orders")), formatQty(runningFirmed));
-        firmedAvailability = new XTreeWidgetItem(_mrp, firmedOrders, 0, QVariant(tr("Firmed Availability")), formatQty( runningAvailability -
-                                                                                                            dspFillMRPDetail.value("firmedallocations1").toDouble() +
-                                                                                                            runningFirmed ) );
-      }
-      else
-      {
-        qoh->setText(counter, formatQty(runningAvailability));
-        allocations->setText(counter, formatQty(dspFillMRPDetail.value(QString("allocations%1").arg(counter)).toDouble()));
-        orders->setText(counter, formatQty(dspFillMRPDetail.value(QString("orders%1").arg(counter)).toDouble()));
-
-        runningAvailability =  ( runningAvailability - dspFillMRPDetail.value(QString("allocations%1").arg(counter)).toDouble() +
-                                                       dspFillMRPDetail.value(QString("orders%1").arg(counter)).toDouble() );
-        availability->setText(counter, formatQty(runningAvailability));
-
-        firmedAllocations->setText(counter, formatQty(dspFillMRPDetail.value(QString("firmedallocations%1").arg(counter)).toDouble()));
-
-        runningFirmed += dspFillMRPDetail.value(QString("firmedorders%1").arg(counter)).toDouble();
-        firmedOrders->setText(counter, formatQty(runningFirmed));
-        firmedAvailability->setText(counter, formatQty( runningAvailability -
-                                                              dspFillMRPDetail.value(QString("firmedallocations%1").arg(counter)).toDouble() +
-                                                              runningFirmed ) );
-      }
-    }
+    int column = i + 1;
+    qoh->setText(column, formatQty(runningAvailability));
+    allocations->setText(column, formatQty(allocated.at(i)));
+    orders->setText(column, formatQty(ordered.at(i)));
+
+    runningAvailability = runningAvailability - allocated.at(i) + ordered.at(i);
+    availability->setText(column, formatQty(runningAvailability));
+
+    firmedAllocations->setText(column, formatQty(firmedAllocated.at(i)));
+    firmedOrders->setText(column, formatQty(firmedOrdered.at(i)));
+    firmedAvailability->setText(column, formatQty(runningAvailability -
+                                                  firmedAllocated.at(i) +
+                                                  firmedOrdered.at(i)));
   }
 }
 
@@ -18,6 +18,7 @@
 
 #include "employee.h"
 #include "errorReporter.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 #include "parameterwidget.h"
 
@@ -39,7 +40,7 @@ employees::employees(QWidget* parent, const char*, Qt::WindowFlags fl)
   if (_metrics->boolean("MultiWhs"))
     parameterWidget()->append(tr("Site"), "warehous_id", ParameterWidget::Site);
 
-  connect(omfgThis, SIGNAL(employeeUpdated(int)),     this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(employeeUpdated(int)), this, SLOT(sFillList()));
 
   list()->addColumn(tr("Site"),   _whsColumn,  Qt::AlignLeft, true, "warehous_code");
   list()->addColumn(tr("Active"), _ynColumn,   Qt::AlignLeft, true, "emp_active");
@@ -11,22 +11,77 @@
 #include <stdio.h>
 
 #include "errorLog.h"
+#include "errorLogStore.h"
 #include "guiclient.h"
 
-#include <QObject>
-#include <QVariant>
-#include <QMessageBox>
-#include <QStringList>
+#include <QAction>
+#include <QApplication>
+#include <QAtomicInt>
+#include <QClipboard>
 #include <QDateTime>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QObject>
+#include <QScrollBar>
 #include <QSqlError>
+#include <QStringList>
+#include <QVariant>
 
 #include "xtsettings.h"
 
-static QStringList _errorList;
 static errorLogListener * listener = 0;
 
+/* The message handler runs on whatever thread logged the message, so it
+   reads which message types to bring to the user's attention from here
+   instead of the settings store. Bit n is set for QtMsgType n.
+ */
+static QAtomicInt _catchTypes(0);
+
+static void errorLogSetCatch(QtMsgType type, bool catchIt)
+{
+  int bit = 1 << int(type);
+  if (catchIt)
+    _catchTypes.fetchAndOrOrdered(bit);
+  else
+    _catchTypes.fetchAndAndOrdered(~bit);
+}
+
+static bool errorLogCatches(QtMsgType type)
+{
+  return _catchTypes.load() & (1 << int(type));
+}
+
+static void errorLogAppend(errorLogEntry &entry, bool notify)
+{
+  if (errorLogStore::append(entry, notify) && listener)
+    QMetaObject::invokeMethod(listener, "sFlush", Qt::QueuedConnection);
+}
+
+static QString errorLogType(const errorLogEntry &entry)
+{
+  if (entry.sqlError)
+    return QObject::tr("Database");
+
+  switch (entry.type)
+  {
+    case QtDebugMsg:    return QObject::tr("Debug");
+#if QT_VERSION >= 0x050500
+    case QtInfoMsg:     return QObject::tr("Info");
+#endif
+    case QtWarningMsg:  return QObject::tr("Warning");
+    case QtCriticalMsg: return QObject::tr("Critical");
+    case QtFatalMsg:    return QObject::tr("Fatal");
+  }
+  return QString();
+}
+
+/* Called on the GUI thread before messages are caught. */
 void errorLogListener::initialize()
 {
+  errorLogSetCatch(QtDebugMsg,    xtsettingsValue("catchQDebug").toBool());
+  errorLogSetCatch(QtWarningMsg,  xtsettingsValue("catchQWarning").toBool());
+  errorLogSetCatch(QtCriticalMsg, xtsettingsValue("catchQCritical").toBool());
+  errorLogSetCatch(QtFatalMsg,    xtsettingsValue("catchQFatal").toBool());
   listener = new errorLogListener();
 }
 
@@ -37,23 +92,151 @@ void errorLogListener::destroy()
   listener = 0;
 }
 
+errorLogModel::errorLogModel(QObject *parent)
+  : QAbstractTableModel(parent)
+{
+  errorLogStore::range(_first, _last, _generation);
+}
+
+int errorLogModel::columnCount(const QModelIndex &parent) const
+{
+  return parent.isValid() ? 0 : MessageColumn + 1;
+}
+
+int errorLogModel::rowCount(const QModelIndex &parent) const
+{
+  return parent.isValid() ? 0 : _last - _first + 1;
+}
+
+QVariant errorLogModel::headerData(int section, Qt::Orientation orientation,
+                                   int role) const
+{
+  if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+    return QVariant();
+
+  switch (section)
+  {
+    case TimeColumn:    return tr("Time");
+    case TypeColumn:    return tr("Type");
+    case CountColumn:   return tr("Count");
+    case MessageColumn: return tr("Message");
+  }
+  return QVariant();
+}
+
+QVariant errorLogModel::data(const QModelIndex &index, int role) const
+{
+  errorLogEntry entry;
+  if (! index.isValid() || ! errorLogStore::at(_first + index.row(), entry))
+    return QVariant();
+
+  if (role == Qt::DisplayRole)
+  {
+    switch (index.column())
+    {
+      case TimeColumn:    return entry.last.toString();
+      case TypeColumn:    return errorLogType(entry);
+      case CountColumn:   return entry.count;
+      case MessageColumn: return entry.message.simplified();
+    }
+  }
+  else if (role == Qt::ToolTipRole)
+    return text(index.row());
+  else if (role == Qt::TextAlignmentRole && index.column() == CountColumn)
+    return int(Qt::AlignRight | Qt::AlignVCenter);
+
+  return QVariant();
+}
+
+/** @brief Return the full text of the entry in @a row, as the log showed it
+           before it kept structured entries.
+ */
+QString errorLogModel::text(int row) const
+{
+  errorLogEntry entry;
+  if (! errorLogStore::at(_first + row, entry))
+    return QString();
+
+  QString msg = entry.first.toString();
+  if (entry.sqlError)
+    msg += " " + entry.message + "\n" + entry.sql;
+  else
+    msg += " " + errorLogType(entry) + ": " + entry.message;
+  if (! entry.source.isEmpty())
+    msg += "\n" + entry.source;
+  if (entry.count > 1)
+    msg += "\n" + tr("Repeated %1 times, last at %2")
+                    .arg(entry.count).arg(entry.last.toString());
+  return msg;
+}
+
+/* Bring the rows in line with the log: drop the rows that fell off the
+   front, add the rows appended since the last refresh, and update the
+   times and counts since any entry may have been repeated.
+ */
+void errorLogModel::refresh()
+{
+  int first, last, generation;
+  errorLogStore::range(first, last, generation);
+
+  if (generation != _generation)
+  {
+    beginResetModel();
+    _first      = first;
+    _last       = last;
+    _generation = generation;
+    endResetModel();
+    return;
+  }
+
+  if (first > _first)
+  {
+    int drop = qMin(first, _last + 1) - _first;
+    if (drop > 0)
+    {
+      beginRemoveRows(QModelIndex(), 0, drop - 1);
+      _first += drop;
+      endRemoveRows();
+    }
+    _first = first;
+    if (_last < _first - 1)
+      _last = _first - 1;
+  }
+
+  if (last > _last)
+  {
+    beginInsertRows(QModelIndex(), rowCount(), rowCount() + last - _last - 1);
+    _last = last;
+    endInsertRows();
+  }
+
+  if (rowCount() > 0)
+    emit dataChanged(index(0, TimeColumn), index(rowCount() - 1, CountColumn));
+}
+
 errorLog::errorLog(QWidget* parent, const char * name, Qt::WindowFlags flags)
     : XWidget(parent, name, flags)
 {
   setupUi(this);
 
-  for(int i = 0; i < _errorList.size(); i++)
-    _errorLog->append(_errorList.at(i));
+  _model = new errorLogModel(this);
+  _errorLog->setModel(_model);
+  _errorLog->header()->setStretchLastSection(true);
+  _errorLog->scrollToBottom();
+
+  QAction *copyAct = new QAction(tr("Copy"), _errorLog);
+  copyAct->setShortcut(QKeySequence::Copy);
+  _errorLog->addAction(copyAct);
 
   _debug->setChecked(xtsettingsValue("catchQDebug").toBool());
   _warning->setChecked(xtsettingsValue("catchQWarning").toBool());
   _critical->setChecked(xtsettingsValue("catchQCritical").toBool());
   _fatal->setChecked(xtsettingsValue("catchQFatal").toBool());
 
-  connect(_clear,   SIGNAL(clicked()),           _errorLog, SLOT(clear()));
   connect(_clear,   SIGNAL(clicked()),            listener, SLOT(clear()));
   connect(_clear,   SIGNAL(clicked()),            omfgThis, SLOT(sClearErrorMessages()));
-  connect(listener, SIGNAL(updated(const QString &)), this, SLOT(updateErrors(const QString &)));
+  connect(copyAct,  SIGNAL(triggered()),          this,     SLOT(sCopy()));
+  connect(listener, SIGNAL(updated()),            this,     SLOT(updateErrors()));
   connect(_debug,   SIGNAL(toggled(bool)),        this,     SLOT(toggleDebug(bool)));
   connect(_warning, SIGNAL(toggled(bool)),        this,     SLOT(toggleWarning(bool)));
   connect(_critical,SIGNAL(toggled(bool)),        this,     SLOT(toggleCritical(bool)));
@@ -70,28 +253,48 @@ void errorLog::languageChange()
   retranslateUi(this);
 }
 
-void errorLog::updateErrors(const QString & msg)
+void errorLog::updateErrors()
 {
-  _errorLog->append(msg);
+  QScrollBar *bar = _errorLog->verticalScrollBar();
+  bool atBottom = (bar->value() == bar->maximum());
+
+  _model->refresh();
+
+  if (atBottom)
+    _errorLog->scrollToBottom();
+}
+
+void errorLog::sCopy()
+{
+  QStringList lines;
+  foreach (QModelIndex index, _errorLog->selectionModel()->selectedRows())
+    lines << _model->text(index.row());
+
+  if (! lines.isEmpty())
+    QApplication::clipboard()->setText(lines.join("\n"));
 }
 
 void errorLog::toggleDebug(bool y)
 {
+  errorLogSetCatch(QtDebugMsg, y);
   xtsettingsSetValue("catchQDebug", y);
 }
 
 void errorLog::toggleWarning(bool y)
 {
+  errorLogSetCatch(QtWarningMsg, y);
   xtsettingsSetValue("catchQWarning", y);
 }
 
 void errorLog::toggleCritical(bool y)
 {
+  errorLogSetCatch(QtCriticalMsg, y);
   xtsettingsSetValue("catchQCritical", y);
 }
 
 void errorLog::toggleFatal(bool y)
 {
+  errorLogSetCatch(QtFatalMsg, y);
   xtsettingsSetValue("catchQFatal", y);
 }
 
@@ -108,74 +311,67 @@ errorLogListener::~errorLogListener()
 
 void errorLogListener::error(const QString & sql, const QSqlError & error)
 {
-  QString msg;
-  msg = QDateTime::currentDateTime().toString();
-  msg += " " + error.text();
-  msg += "\n" + sql;
-
-  _errorList.append(msg);
-  if(_errorList.size() > 20)
-    _errorList.removeFirst();
+  errorLogEntry entry;
+  entry.first    = QDateTime::currentDateTime();
+  entry.last     = entry.first;
+  entry.type     = QtCriticalMsg;
+  entry.sqlError = true;
+  entry.message  = error.text();
+  entry.sql      = sql;
+  entry.sqlHash  = qHash(sql);
+  entry.count    = 1;
 
-  emit updated(msg);
-  if(omfgThis)
-    omfgThis->sNewErrorMessage();
+  errorLogAppend(entry, true);
 }
 
 void errorLogListener::clear()
 {
-  bool blocked = blockSignals(true);
-  _errorList.clear();
-  (void)blockSignals(blocked);
+  errorLogStore::clear();
+  emit updated();
+}
+
+/* Tell the GUI about everything logged since the last flush. */
+void errorLogListener::sFlush()
+{
+  bool notify = errorLogStore::takeNotify();
+
+  emit updated();
+  if(omfgThis && notify)
+    omfgThis->sNewErrorMessage();
 }
 
 
 #if QT_VERSION >= 0x050000
-void xTupleMessageOutput(QtMsgType type, const QMessageLogContext&, const QString &pMsg)
+void xTupleMessageOutput(QtMsgType type, const QMessageLogContext &context, const QString &pMsg)
 #else
 void xTupleMessageOutput(QtMsgType type, const char *pMsg)
 #endif
 {
-  QString msg;
-  msg = QDateTime::currentDateTime().toString();
+  errorLogEntry entry;
+  entry.first    = QDateTime::currentDateTime();
+  entry.last     = entry.first;
+  entry.type     = type;
+  entry.sqlError = false;
+  entry.message  = pMsg;
+  entry.sqlHash  = 0;
+  entry.count    = 1;
+#if QT_VERSION >= 0x050000
+  if (context.file)
+    entry.source = QString("%1:%2").arg(context.file).arg(context.line);
+#endif
+
   bool notify = false;
   bool iserror= (type == QtCriticalMsg) || (type == QtFatalMsg);
 
-  switch (type) {
-    case QtDebugMsg:
-      notify = xtsettingsValue("catchQDebug").toBool();
-      msg += " Debug: ";
-      break;
 #if QT_VERSION >= 0x050500
-    case QtInfoMsg:
-      notify = xtsettingsValue("catchQWarning").toBool();
-      msg += " Info: ";
-      break;
+  if (type == QtInfoMsg)
+    notify = errorLogCatches(QtWarningMsg);
+  else
 #endif
-    case QtWarningMsg:
-      notify = xtsettingsValue("catchQWarning").toBool();
-      msg += " Warning: ";
-      break;
-    case QtCriticalMsg:
-      notify = xtsettingsValue("catchQCritical").toBool();
-      msg += " Critical: ";
-      break;
-    case QtFatalMsg:
-      notify = xtsettingsValue("catchQFatal").toBool();
-      msg += " Fatal: ";
-      //abort();
-      break;
-  }
-  msg += pMsg;
-  _errorList.append(msg);
-  if(_errorList.size() > 20)
-    _errorList.removeFirst();
-
-  if(listener && notify)
-    listener->updated(msg);
-  if(omfgThis && notify && iserror)
-    omfgThis->sNewErrorMessage();
+    notify = errorLogCatches(type);
 
-  printf("%s\n", qPrintable(msg));
-}
+  errorLogAppend(entry, notify && iserror);
 
+  printf("%s %s: %s\n", qPrintable(entry.first.toString()),
+         qPrintable(errorLogType(entry)), qPrintable(entry.message));
+}
@@ -14,8 +14,39 @@
 #include "xwidget.h"
 #include <xsqlquery.h>
 
+#include <QAbstractTableModel>
+
 #include "ui_errorLog.h"
 
+/* Shows the entries of the error log. Rows are read from the log only
+   when the view asks for them, so only the visible rows are formatted.
+ */
+class errorLogModel : public QAbstractTableModel
+{
+  Q_OBJECT
+
+  public:
+    enum Column { TimeColumn, TypeColumn, CountColumn, MessageColumn };
+
+    errorLogModel(QObject *parent = 0);
+
+    virtual int      columnCount(const QModelIndex &parent = QModelIndex()) const;
+    virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    virtual QVariant headerData(int section, Qt::Orientation orientation,
+                                int role = Qt::DisplayRole) const;
+    virtual int      rowCount(const QModelIndex &parent = QModelIndex()) const;
+
+    QString text(int row) const;
+
+  public slots:
+    void refresh();
+
+  protected:
+    int _first;
+    int _last;
+    int _generation;
+};
+
 class errorLog : public XWidget, public Ui::errorLog
 {
     Q_OBJECT
@@ -25,7 +56,8 @@ public:
     ~errorLog();
 
 public slots:
-    virtual void updateErrors(const QString &);
+    virtual void updateErrors();
+    virtual void sCopy();
 
 protected slots:
     virtual void languageChange();
@@ -33,6 +65,9 @@ protected slots:
     virtual void toggleWarning(bool);
     virtual void toggleCritical(bool);
     virtual void toggleFatal(bool);
+
+protected:
+    errorLogModel *_model;
 };
 
 class errorLogListener : public QObject, public XSqlQueryErrorListener {
@@ -51,7 +86,10 @@ class errorLogListener : public QObject, public XSqlQueryErrorListener {
     void clear();
 
   signals:
-    void updated(const QString &);
+    void updated();
+
+  private slots:
+    void sFlush();
 };
 
 
@@ -0,0 +1,132 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#include "errorLogStore.h"
+
+#include <QContiguousCache>
+#include <QMultiHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+/* _errorIndex finds the entry a new message repeats wherever it is in the
+   log, not just at the end, so messages from several sources that take
+   turns still collapse into one entry each.
+ */
+static QMutex                          _errorMutex;
+static QContiguousCache<errorLogEntry> _errorList(ERRORLOG_CAPACITY);
+static QMultiHash<uint, int>           _errorIndex;  // entry key -> index in _errorList
+static int                             _errorGeneration = 0;
+static bool                            _errorPending    = false;
+static bool                            _errorNotify     = false;
+
+static uint errorLogKey(const errorLogEntry &entry)
+{
+  return qHash(entry.message) ^ (qHash(entry.source) << 1) ^ entry.sqlHash
+       ^ (uint(entry.type) << 28) ^ (entry.sqlError ? 0x80000000 : 0);
+}
+
+static bool errorLogSame(const errorLogEntry &a, const errorLogEntry &b)
+{
+  return a.key      == b.key      &&
+         a.type     == b.type     &&
+         a.sqlError == b.sqlError &&
+         a.sqlHash  == b.sqlHash  &&
+         a.message  == b.message  &&
+         a.source   == b.source;
+}
+
+/* Add @a entry to the log, or count it against the entry it repeats.
+   On return entry.count holds the count of the entry it ended up in.
+   Returns true if the caller should queue a flush to tell the GUI; only
+   one is outstanding at a time.
+ */
+bool errorLogStore::append(errorLogEntry &entry, bool notify)
+{
+  entry.key = errorLogKey(entry);
+
+  QMutexLocker locker(&_errorMutex);
+
+  bool merged = false;
+  for (QMultiHash<uint, int>::iterator it = _errorIndex.find(entry.key);
+       it != _errorIndex.end() && it.key() == entry.key; ++it)
+  {
+    errorLogEntry &prev = _errorList[it.value()];
+    if (errorLogSame(prev, entry))
+    {
+      prev.last = entry.first;
+      prev.count++;
+      entry.count = prev.count;
+      merged = true;
+      break;
+    }
+  }
+
+  if (! merged)
+  {
+    if (_errorList.isFull())
+      _errorIndex.remove(_errorList.first().key, _errorList.firstIndex());
+
+    _errorList.append(entry);
+    if (_errorList.areIndexesValid())
+      _errorIndex.insert(entry.key, _errorList.lastIndex());
+    else
+    {
+      _errorList.normalizeIndexes();
+      _errorIndex.clear();
+      for (int i = _errorList.firstIndex(); i <= _errorList.lastIndex(); i++)
+        _errorIndex.insert(_errorList.at(i).key, i);
+      _errorGeneration++;
+    }
+  }
+
+  _errorNotify = _errorNotify || notify;
+  bool post = ! _errorPending;
+  _errorPending = true;
+  return post;
+}
+
+bool errorLogStore::at(int index, errorLogEntry &entry)
+{
+  QMutexLocker locker(&_errorMutex);
+  if (! _errorList.containsIndex(index))
+    return false;
+
+  entry = _errorList.at(index);
+  return true;
+}
+
+void errorLogStore::range(int &first, int &last, int &generation)
+{
+  QMutexLocker locker(&_errorMutex);
+  generation = _errorGeneration;
+  first = _errorList.firstIndex();
+  last  = _errorList.isEmpty() ? first - 1 : _errorList.lastIndex();
+}
+
+void errorLogStore::clear()
+{
+  QMutexLocker locker(&_errorMutex);
+  _errorList.clear();
+  _errorIndex.clear();
+  _errorGeneration++;
+  _errorNotify = false;
+}
+
+/* Called by the flush append() asked for. Returns whether anything logged
+   since the last flush should be brought to the user's attention.
+ */
+bool errorLogStore::takeNotify()
+{
+  QMutexLocker locker(&_errorMutex);
+  bool notify   = _errorNotify;
+  _errorPending = false;
+  _errorNotify  = false;
+  return notify;
+}
@@ -0,0 +1,52 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#ifndef ERRORLOGSTORE_H
+#define ERRORLOGSTORE_H
+
+#include <QDateTime>
+#include <QString>
+#include <QtGlobal>
+
+#define ERRORLOG_CAPACITY 500
+
+/* One entry in the error log. A burst of identical messages is kept as a
+   single entry whose count goes up, so a failing auto-refresh or a chatty
+   script cannot push everything else out of the log.
+ */
+struct errorLogEntry
+{
+  QDateTime first;
+  QDateTime last;
+  QtMsgType type;
+  bool      sqlError;
+  QString   source;
+  QString   message;
+  QString   sql;
+  uint      sqlHash;
+  int       count;
+  uint      key;        // set by errorLogStore::append()
+};
+
+/* The entries behind the Database Log window. Messages can arrive on any
+   thread, so every function locks the store. Entries are numbered from
+   first to last; the numbers only change when generation goes up.
+ */
+class errorLogStore
+{
+  public:
+    static bool append(errorLogEntry &entry, bool notify);
+    static bool at(int index, errorLogEntry &entry);
+    static void range(int &first, int &last, int &generation);
+    static void clear();
+    static bool takeNotify();
+};
+
+#endif // ERRORLOGSTORE_H
@@ -20,6 +20,7 @@
 #include <selectmql.h>
 
 #include "exporthelper.h"
+#include "metasqlcache.h"
 #include "storedProcErrorLookup.h"
 #include "errorReporter.h"
 
@@ -197,36 +198,21 @@ void exportData::sHandleButtons()
       QString xml = "<report>";
 
       QStringList paramlist;
-      XSqlQuery qiq;
-      qiq.prepare("SELECT qryitem_src, qryitem_group, qryitem_detail"
-                  "  FROM qryitem"
-                  " WHERE ((qryitem_qryhead_id=:id)"
-                  "    AND (qryitem_src!='REL'))"
-                  " ORDER BY qryitem_order;");
-      qiq.bindValue(":id", _qrySetList->id());
-      qiq.exec();
-      while (qiq.next())
-      {
-        QString qryitem_src = qiq.value("qryitem_src").toString();
-        if (qryitem_src == "MQL")
-        {
-          bool valid = false;
-          QString errmsg;
-          QString tmpqry;
-          tmpqry = MQLUtil::mqlLoad(qiq.value("qryitem_group").toString(),
-                                    qiq.value("qryitem_detail").toString(),
-                                    errmsg, &valid);
-          if (valid)
-            paramlist.append(MQLEdit::getParamsFromMetaSQLText(tmpqry));
-        }
-        else if (qryitem_src == "CUSTOM")
-          paramlist.append(MQLEdit::getParamsFromMetaSQLText(qiq.value("qryitem_detail").toString()));
-      }
+      QSqlError   err;
+      QList<MetaSQLCacheEntry> items =
+        MetaSQLCache::instance()->loadQuerySet(_qrySetList->id(), err);
       if (ErrorReporter::error(QtCriticalMsg, this, tr("Error Retrieving Query Information"),
-                                    qiq, __FILE__, __LINE__))
+                               err, __FILE__, __LINE__))
       {
         return;
       }
+      foreach (MetaSQLCacheEntry item, items)
+      {
+        if (item.valid)
+          foreach (QString param, item.params)
+            if (! paramlist.contains(param))
+              paramlist.append(param);
+      }
       paramlist.sort();
       for (int i = 0; i < paramlist.size(); i++)
         xml += "\n <parameter name='" + paramlist.at(i) + "'/>";
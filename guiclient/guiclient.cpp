@@ -68,6 +68,7 @@
 #include "inputManager.h"
 #include "xdoublevalidator.h"
 
+#include "datecluster.h"
 #include "distributeInventory.h"
 #include "documents.h"
 #include "splashconst.h"
@@ -204,6 +205,12 @@ static QScriptValue settingsSetValue(QScriptContext *context, QScriptEngine *eng
     @arg @c PrivA @c PrivB - the user can have either @c PrivA or @c PrivB
     @arg @c PrivA+PrivB    - the user must have both @c PrivA and @c PrivB
 
+    Every Action is checked when it is created and again whenever the
+    privileges reload, so its enabled state is always current for scripts,
+    hotkeys and findChild() callers; Privileges::check() compiles each
+    expression once, which keeps this cheap. Only the visual side is lazy:
+    toolbar icons are given as resource paths and only loaded when painted.
+
     @sa Privileges::isDba()
 
     @todo Add support for @c \@name:mode - call @c name::userHasPriv(mode)
@@ -230,12 +237,12 @@ Action::Action( QWidget *pParent, const char *pName, const QString &pDisplayName
 Action::Action( QWidget *pParent, const char *pName, const QString &pDisplayName,
                 QObject *pTarget, const char *pActivateSlot,
                 QWidget *pAddTo, const QString & pEnabled,
-                const QPixmap *pIcon, QWidget *pToolBar ) :
+                const QIcon &pIcon, QWidget *pToolBar ) :
  QAction(pDisplayName, pParent)
 {
   init(pParent, pName, pDisplayName, pTarget, pActivateSlot, pAddTo, pEnabled);
 
-  setIcon(QIcon(*pIcon));
+  setIcon(pIcon);
   pToolBar->addAction(this);
 }
 
@@ -243,13 +250,13 @@ Action::Action( QWidget *pParent, const char *pName, const QString &pDisplayName
 Action::Action( QWidget *pParent, const char *pName, const QString &pDisplayName,
                 QObject *pTarget, const char *pActivateSlot,
                 QWidget *pAddTo, const QString & pEnabled,
-                const QPixmap *pIcon, QWidget *pToolBar,
+                const QIcon &pIcon, QWidget *pToolBar,
                 const QString &pToolTip ) :
  QAction(pDisplayName, pParent)
 {
   init(pParent, pName, pDisplayName, pTarget, pActivateSlot, pAddTo, pEnabled);
 
-  setIcon(QIcon(*pIcon));
+  setIcon(pIcon);
   pToolBar->addAction(this);
   setToolTip(pToolTip);
 }
@@ -315,6 +322,7 @@ GUIClient::GUIClient(const QString &pDatabaseURL, const QString &pUsername)
     _menuBar(0),
     _inputManager(0),
     _shown(false),
+    _menuReady(false),
     _shuttingDown(false),
     _menu(0)
 {
@@ -425,6 +433,7 @@ GUIClient::GUIClient(const QString &pDatabaseURL, const QString &pUsername)
   XComboBox::_guiClientInterface = VirtualClusterLineEdit::_guiClientInterface;
   XTextEdit::_guiClientInterface = VirtualClusterLineEdit::_guiClientInterface;
   XTextEditHighlighter::_guiClientInterface = VirtualClusterLineEdit::_guiClientInterface;
+  XDateEdit::_guiClientInterface = VirtualClusterLineEdit::_guiClientInterface;
 
   _splash->showMessage(tr("Completing Initialization"), SplashTextAlignment, SplashTextColor);
   qApp->processEvents();
@@ -505,8 +514,10 @@ GUIClient::GUIClient(const QString &pDatabaseURL, const QString &pUsername)
   _singleWindow = "";
   if (window.first())
     _singleWindow = window.value("usr_window").toString();
-  if (_singleWindow.isEmpty())
+  if (_singleWindow.isEmpty() && _privileges->isReady())
     initMenuBar();
+  else if (_singleWindow.isEmpty())
+    connect(_privileges, SIGNAL(ready()), this, SLOT(initMenuBar()));
   else
     _showTopLevel = true; // if we are in single level mode we want to run toplevel always
 
@@ -716,6 +727,13 @@ void GUIClient::initMenuBar()
   findChild<QToolBar*>("Sales Tools")->setVisible(_preferences->boolean("ShowSOToolbar"));
   findChild<QToolBar*>("Accounting Tools")->setVisible(_preferences->boolean("ShowGLToolbar"));
 
+  if (firstRun)
+  {
+    _menuReady = true;
+    if (_shown)
+      runInitMenuScripts();
+  }
+
   firstRun = false;
   qApp->restoreOverrideCursor();
 }
@@ -728,6 +746,7 @@ void GUIClient::saveToolbarPositions()
   xtsettingsSetValue("MainWindowState", saveState(1));
 
   // Set preferences base on visibility of toolbars
+  _preferences->beginBatch();
   _preferences->set("ShowPDToolbar", findChild<QToolBar*>("Products Tools")->isVisible());
   _preferences->set("ShowIMToolbar", findChild<QToolBar*>("Inventory Tools")->isVisible());
   if(_metrics->value("Application") != "PostBooks")
@@ -737,6 +756,7 @@ void GUIClient::saveToolbarPositions()
   _preferences->set("ShowCRMToolbar", findChild<QToolBar*>("CRM Tools")->isVisible());
   _preferences->set("ShowSOToolbar", findChild<QToolBar*>("Sales Tools")->isVisible());
   _preferences->set("ShowGLToolbar", findChild<QToolBar*>("Accounting Tools")->isVisible());
+  _preferences->commitBatch();
 }
 
 /** @brief Save information about the current state of the application
@@ -803,84 +823,93 @@ void GUIClient::closeEvent(QCloseEvent *event)
 
     Primarily this involves running application extension @c initMenu
     scripts and setting up the script engine debugger if necessary.
+    The scripts extend the menus, so if the privileges have not arrived
+    yet and the menus are not built, initMenuBar() runs them instead.
   */
 void GUIClient::showEvent(QShowEvent *event)
 {
   if(!_shown)
   {
     _shown = true;
-    // We only want the scripting to work on the NEO menu
-    // START script code
-      XSqlQuery sq;
-      sq.prepare("SELECT script_source "
-                 "  FROM script "
-                 "JOIN (SELECT c.oid, n.nspname AS schema "
-                 "  FROM pg_class AS c "
-                 "  JOIN pg_namespace AS n ON c.relnamespace=n.oid) AS schema_table "
-                 "ON script.tableoid=schema_table.oid "
-                 "JOIN (SELECT regexp_split_to_table AS pkgname, row_number() over () AS seq "
-                 "  FROM regexp_split_to_table(buildsearchpath(), ',')) AS path "
-                 "ON pkgname = schema "
-                 " WHERE script_enabled AND script_name = 'initMenu' "
-                 "ORDER BY script_order, seq;");
-      sq.exec();
-      QScriptEngine * engine = 0;
-      QScriptEngineDebugger * debugger = 0;
-      bool found_one = false;
-      while(sq.next())
-      {
-        found_one = true;
-        QString script = sq.value("script_source").toString();
-        if(!engine)
-        {
-          engine = new QScriptEngine(this);
-          if (_preferences->boolean("EnableScriptDebug"))
-          {
-            debugger = new QScriptEngineDebugger(this);
-            debugger->attachTo(engine);
-          }
-          loadScriptGlobals(engine);
-          setupInclude(engine);
-        }
+    if (_menuReady || ! _singleWindow.isEmpty())
+      runInitMenuScripts();
+  }
 
-        QScriptValue result = engine->evaluate(script, "initMenu");
-        if (engine->hasUncaughtException())
-        {
-          int line = engine->uncaughtExceptionLineNumber();
-          qDebug() << "uncaught exception at line" << line << ":" << result.toString();
-        }
+  QMainWindow::showEvent(event);
+}
+
+/** @brief Run the application extension @c initMenu scripts and give the
+           actions they add the hotkeys the user has assigned.
+  */
+void GUIClient::runInitMenuScripts()
+{
+  // We only want the scripting to work on the NEO menu
+  XSqlQuery sq;
+  sq.prepare("SELECT script_source "
+             "  FROM script "
+             "JOIN (SELECT c.oid, n.nspname AS schema "
+             "  FROM pg_class AS c "
+             "  JOIN pg_namespace AS n ON c.relnamespace=n.oid) AS schema_table "
+             "ON script.tableoid=schema_table.oid "
+             "JOIN (SELECT regexp_split_to_table AS pkgname, row_number() over () AS seq "
+             "  FROM regexp_split_to_table(buildsearchpath(), ',')) AS path "
+             "ON pkgname = schema "
+             " WHERE script_enabled AND script_name = 'initMenu' "
+             "ORDER BY script_order, seq;");
+  sq.exec();
+  QScriptEngine * engine = 0;
+  QScriptEngineDebugger * debugger = 0;
+  bool found_one = false;
+  while(sq.next())
+  {
+    found_one = true;
+    QString script = sq.value("script_source").toString();
+    if(!engine)
+    {
+      engine = new QScriptEngine(this);
+      if (_preferences->boolean("EnableScriptDebug"))
+      {
+        debugger = new QScriptEngineDebugger(this);
+        debugger->attachTo(engine);
       }
-      if(found_one)
+      loadScriptGlobals(engine);
+      setupInclude(engine);
+    }
+
+    QScriptValue result = engine->evaluate(script, "initMenu");
+    if (engine->hasUncaughtException())
+    {
+      int line = engine->uncaughtExceptionLineNumber();
+      qDebug() << "uncaught exception at line" << line << ":" << result.toString();
+    }
+  }
+  if(found_one)
+  {
+    QList<QMenu*> menulist = findChildren<QMenu*>();
+    for(int m = 0; m < menulist.size(); ++m)
+    {
+      QList<QAction*> actionlist = menulist.at(m)->actions();
+      for(int i = 0; i < actionlist.size(); ++i)
       {
-        QList<QMenu*> menulist = findChildren<QMenu*>();
-        for(int m = 0; m < menulist.size(); ++m)
+        QAction* act = actionlist.at(i);
+        if(!act->objectName().isEmpty())
         {
-          QList<QAction*> actionlist = menulist.at(m)->actions();
-          for(int i = 0; i < actionlist.size(); ++i)
+          QString hotkey;
+          hotkey = _preferences->parent(act->objectName());
+          if (!hotkey.isNull() && !_hotkeyList.contains(hotkey))
           {
-            QAction* act = actionlist.at(i);
-            if(!act->objectName().isEmpty())
-            {
-              QString hotkey;
-              hotkey = _preferences->parent(act->objectName());
-              if (!hotkey.isNull() && !_hotkeyList.contains(hotkey))
-              {
-                _hotkeyList << hotkey;
-                act->setShortcutContext(Qt::ApplicationShortcut);
-                if (hotkey.left(1) == "C")
-                  act->setShortcut(QString("Ctrl+%1").arg(hotkey.right(1)));
-
-                else if (hotkey.left(1) == "F")
-                  act->setShortcut(hotkey);
-              }
-            }
+            _hotkeyList << hotkey;
+            act->setShortcutContext(Qt::ApplicationShortcut);
+            if (hotkey.left(1) == "C")
+              act->setShortcut(QString("Ctrl+%1").arg(hotkey.right(1)));
+
+            else if (hotkey.left(1) == "F")
+              act->setShortcut(hotkey);
           }
         }
       }
-    // END script code
+    }
   }
-
-  QMainWindow::showEvent(event);
 }
 
 /** @brief Write a message to the debugging log.
@@ -901,6 +930,23 @@ void GUIClient::sReportError(const QString &pError)
   qDebug("%s", qPrintable(pError));
 }
 
+/** @brief Return the database server's current date.
+
+    The date is read from the server on every tick along with the time
+    left until the server's midnight, so it stays correct between ticks
+    without another query.
+ */
+const QDate GUIClient::dbDate()
+{
+  if (_dbDateRollover.isValid())
+  {
+    qint64 past = _dbDateRollover.secsTo(QDateTime::currentDateTime());
+    if (past >= 0)
+      return _dbDate.addDays(1 + past / 86400);
+  }
+  return _dbDate;
+}
+
 /** @brief This method is called approximately once per minute.
 
     It checks the database to see if there are any new
@@ -919,10 +965,15 @@ void GUIClient::sReportError(const QString &pError)
     */
 void GUIClient::sTick()
 {
-  XSqlQuery tickle("SELECT CURRENT_DATE AS dbdate, hasEvents() AS events;" );
+  XSqlQuery tickle("SELECT CURRENT_DATE AS dbdate,"
+                   "       CAST(EXTRACT(EPOCH FROM (CURRENT_DATE + 1) - LOCALTIMESTAMP)"
+                   "            AS INTEGER) AS rollover,"
+                   "       hasEvents() AS events;" );
   if (tickle.first())
   {
     _dbDate = tickle.value("dbdate").toDate();
+    _dbDateRollover = QDateTime::currentDateTime()
+                        .addSecs(tickle.value("rollover").toInt());
 
     if (isVisible())
     {
@@ -1083,6 +1134,15 @@ void GUIClient::sSystemMessageAdded()
     connect(omfgThis, SIGNAL(salesOrdersUpdated(int, bool)), this, SLOT(sFillList()));
     @endcode
 
+    Lists that can take a long time to fill should connect through
+    RefreshScheduler instead, which folds a burst of update signals into
+    one refresh and waits until a hidden window is shown again:
+
+    @code
+    RefreshScheduler::connect(omfgThis, SIGNAL(salesOrdersUpdated(int, bool)),
+                              this, SLOT(sFillList()));
+    @endcode
+
     @note These slots can only be used to notify other windows in the
     same application instance. They do not notify other running programs
     on the same or other workstations.
@@ -1110,6 +1170,7 @@ void GUIClient::sItemsitesUpdated()
 /** @brief This slot tells other open windows the definition or status of one or more Sites or Warehouses has changed. */
 void GUIClient::sWarehousesUpdated()
 {
+  XDateEdit::clearCalendarCache();
   emit warehousesUpdated();
 }
 
@@ -13,6 +13,7 @@
 
 #include <QAction>
 #include <QDate>
+#include <QDateTime>
 #include <QMainWindow>
 #include <QTimer>
 
@@ -125,12 +126,12 @@ class Action : public QAction
     Action( QWidget *, const char *, const QString &,
             QObject *, const char *,
             QWidget *, bool,
-            const QPixmap *, QWidget *);
+            const QIcon &, QWidget *);
             
     Action( QWidget *, const char *, const QString &,
             QObject *, const char *,
             QWidget *, bool,
-            const QPixmap *, QWidget *,
+            const QIcon &, QWidget *,
             const QString &);
 
     Action( QWidget *, const char *, const QString &,
@@ -140,12 +141,12 @@ class Action : public QAction
     Action( QWidget *, const char *, const QString &,
             QObject *, const char *,
             QWidget *, const QString &,
-            const QPixmap *, QWidget *);
+            const QIcon &, QWidget *);
             
     Action( QWidget *, const char *, const QString &,
             QObject *, const char *,
             QWidget *, const QString &,
-            const QPixmap *, QWidget *,
+            const QIcon &, QWidget *,
             const QString &); 
 
   private:
@@ -190,7 +191,7 @@ class GUIClient : public QMainWindow
 
     Q_INVOKABLE inline const QDate startOfTime()       { return _startOfTime;  }
     Q_INVOKABLE inline const QDate endOfTime()         { return _endOfTime;    }
-    Q_INVOKABLE inline const QDate dbDate()            { return _dbDate;       }
+    Q_INVOKABLE const QDate dbDate();
 
     Q_INVOKABLE inline QDoubleValidator *qtyVal()      { return _qtyVal;       }
     Q_INVOKABLE inline QDoubleValidator *transQtyVal() { return _transQtyVal;  }
@@ -395,6 +396,7 @@ class GUIClient : public QMainWindow
   protected:
     void closeEvent(QCloseEvent *);
     void showEvent(QShowEvent *);
+    void runInitMenuScripts();
 
     void addDocumentWatch(QString path, int id);
     bool removeDocumentWatch(QString path);
@@ -435,6 +437,7 @@ class GUIClient : public QMainWindow
     QDate _startOfTime;
     QDate _endOfTime;
     QDate _dbDate;
+    QDateTime _dbDateRollover;
 
     QDoubleValidator *_qtyVal;
     QDoubleValidator *_transQtyVal;
@@ -456,6 +459,7 @@ class GUIClient : public QMainWindow
     QFont *_fixedFont;
 
     bool _shown;
+    bool _menuReady;
     bool _shuttingDown;
 
     QFileSystemWatcher* _fileWatcher;
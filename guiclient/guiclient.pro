@@ -469,6 +469,7 @@ FORMS =   absoluteCalendarItem.ui               \
           purgeInvoices.ui                      \
           purgePostedCountSlips.ui              \
           purgePostedCounts.ui                  \
+          queryStatistics.ui                    \
           quickRelocateLot.ui                   \
           quotes.ui                             \
           reasonCode.ui                         \
@@ -711,6 +712,7 @@ HEADERS = ../common/format.h                    \
           cashReceiptItem.h             \
           cashReceiptMiscDistrib.h      \
           cashReceiptsEditList.h        \
+          cchttpclient.h                \
           changePoitemQty.h             \
           changeWoQty.h                 \
           characteristic.h              \
@@ -847,6 +849,7 @@ HEADERS = ../common/format.h                    \
           enterPoitemReceipt.h                  \
           enterPoitemReturn.h                   \
           errorLog.h                            \
+          errorLogStore.h                       \
           eventManager.h                        \
           expenseCategories.h                   \
           expenseCategory.h                     \
@@ -1072,6 +1075,7 @@ HEADERS = ../common/format.h                    \
           purgeInvoices.h               \
           purgePostedCountSlips.h       \
           purgePostedCounts.h           \
+          queryStatistics.h             \
           quickRelocateLot.h            \
           quotes.h                      \
           reasonCode.h                  \
@@ -1082,6 +1086,7 @@ HEADERS = ../common/format.h                    \
           reassignProductCategoryByProductCategory.h    \
           recallOrders.h                        \
           reconcileBankaccount.h                \
+          refreshscheduler.h                    \
           registrationKey.h                     \
           registrationKeyDialog.h               \
           rejectCode.h                          \
@@ -1195,6 +1200,7 @@ HEADERS = ../common/format.h                    \
           termses.h                     \
           thawItemSitesByClassCode.h    \
           timeoutHandler.h              \
+          timephasedbuckets.h           \
           todoCalendarControl.h         \
           todoItem.h                    \
           todoList.h                    \
@@ -1335,6 +1341,7 @@ SOURCES = absoluteCalendarItem.cpp              \
           cashReceiptItem.cpp                   \
           cashReceiptMiscDistrib.cpp            \
           cashReceiptsEditList.cpp              \
+          cchttpclient.cpp                      \
           changePoitemQty.cpp                   \
           changeWoQty.cpp                       \
           characteristic.cpp                    \
@@ -1470,6 +1477,7 @@ SOURCES = absoluteCalendarItem.cpp              \
           enterPoitemReceipt.cpp                \
           enterPoitemReturn.cpp                 \
           errorLog.cpp                          \
+          errorLogStore.cpp                     \
           eventManager.cpp                      \
           expenseCategories.cpp                 \
           expenseCategory.cpp                   \
@@ -1693,6 +1701,7 @@ SOURCES = absoluteCalendarItem.cpp              \
           purgeInvoices.cpp                     \
           purgePostedCountSlips.cpp             \
           purgePostedCounts.cpp                 \
+          queryStatistics.cpp                   \
           quickRelocateLot.cpp                  \
           quotes.cpp                            \
           reasonCode.cpp                        \
@@ -1703,6 +1712,7 @@ SOURCES = absoluteCalendarItem.cpp              \
           reassignProductCategoryByProductCategory.cpp  \
           recallOrders.cpp                      \
           reconcileBankaccount.cpp              \
+          refreshscheduler.cpp                  \
           registrationKey.cpp                   \
           registrationKeyDialog.cpp             \
           rejectCode.cpp                        \
@@ -1816,6 +1826,7 @@ SOURCES = absoluteCalendarItem.cpp              \
           termses.cpp                           \
           thawItemSitesByClassCode.cpp          \
           timeoutHandler.cpp                    \
+          timephasedbuckets.cpp                 \
           todoCalendarControl.cpp               \
           todoItem.cpp                          \
           todoList.cpp                          \
@@ -8,6 +8,11 @@
  * to be bound by its terms.
  */
 
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <QGridLayout>
 #include <QtHelp/QHelpContentWidget>
 #include <QtHelp/QHelpSearchEngine>
@@ -28,6 +33,7 @@
 #include "helpView.h"
 #include "helpViewBrowser.h"
 #include "xtHelp.h"
+#include "xtsettings.h"
 
 static QIcon iconFromImageByName(QString name)
 {
@@ -43,6 +49,27 @@ static QIcon iconFromImageByName(QString name)
   return QIcon();
 }
 
+/* Qt keeps the search index in a folder next to the collection file,
+   named for the collection with a leading dot.
+ */
+static QString indexFolder(const QFileInfo &collection)
+{
+  return collection.absolutePath() + QDir::separator() + "." +
+         collection.completeBaseName();
+}
+
+static QString collectionChecksum(const QString &filename)
+{
+  QFile file(filename);
+  if (! file.open(QIODevice::ReadOnly))
+    return QString();
+
+  QCryptographicHash hash(QCryptographicHash::Md5);
+  while (! file.atEnd())
+    hash.addData(file.read(1024 * 1024));
+  return QString(hash.result().toHex());
+}
+
 static helpView *helpViewSingleton = 0;
 
 helpView* helpView::getInstance(QWidget *parent)
@@ -113,8 +140,64 @@ helpView::helpView(QWidget *parent)
 
   omfgThis->addDockWidget(Qt::TopDockWidgetArea, this);
 
-  _searchEngine->reindexDocumentation();
+  connect(_searchEngine, SIGNAL(indexingStarted()),  this, SLOT(sIndexingStarted()));
+  connect(_searchEngine, SIGNAL(indexingFinished()), this, SLOT(sIndexingFinished()));
+
+  if (indexIsStale())
+    _searchEngine->reindexDocumentation();
+}
+
+/* The search index only needs rebuilding when the collection file changes.
+   Its size and modification time are checked first so the file is only
+   read to compute its checksum when one of them differs.
+ */
+bool helpView::indexIsStale()
+{
+  QFileInfo collection(_help->collectionFile());
+  if (! collection.exists())
+    return false;
+
+  QString stamp = QString("%1:%2:%3").arg(collection.absoluteFilePath())
+                                     .arg(collection.size())
+                                     .arg(collection.lastModified().toString(Qt::ISODate));
+  QString checksum = xtsettingsValue("HelpIndex/checksum").toString();
+
+  QDir folder(indexFolder(collection));
+  bool missing = ! folder.exists() ||
+                 folder.entryList(QDir::AllEntries | QDir::NoDotAndDotDot).isEmpty();
+  if (! missing && ! checksum.isEmpty() &&
+      stamp == xtsettingsValue("HelpIndex/stamp").toString())
+    return false;
+
+  QString current = collectionChecksum(collection.absoluteFilePath());
+  if (! missing && current == checksum)
+  {
+    xtsettingsSetValue("HelpIndex/stamp", stamp);
+    return false;
+  }
+
+  // remember what is being indexed until the indexer says it is done
+  _indexedStamp    = stamp;
+  _indexedChecksum = current;
+  return true;
+}
 
+void helpView::sIndexingStarted()
+{
+  _searchEngine->queryWidget()->setToolTip(tr("Indexing the help documentation. "
+                                              "Search results may be incomplete."));
+}
+
+void helpView::sIndexingFinished()
+{
+  _searchEngine->queryWidget()->setToolTip(QString());
+  if (! _indexedChecksum.isEmpty())
+  {
+    xtsettingsSetValue("HelpIndex/stamp",    _indexedStamp);
+    xtsettingsSetValue("HelpIndex/checksum", _indexedChecksum);
+    _indexedStamp.clear();
+    _indexedChecksum.clear();
+  }
 }
 
 helpView::~helpView()
@@ -40,7 +40,13 @@ class helpView : public QDockWidget
     void sLocationChanged(Qt::DockWidgetArea);
     void showLink(const QModelIndex &index);
 
+  protected slots:
+    void sIndexingFinished();
+    void sIndexingStarted();
+
   protected:
+    bool indexIsStale();
+
     xtHelp              *_help;
     helpViewBrowser     *_helpBrowser;
     QTabWidget          *_searchTabs;
@@ -51,6 +57,8 @@ class helpView : public QDockWidget
 
 
     QString             _loc;
+    QString             _indexedChecksum;
+    QString             _indexedStamp;
 
   private:
     helpView(QWidget *parent = 0);
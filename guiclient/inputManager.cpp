@@ -9,13 +9,16 @@
  */
 
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QEvent>
+#include <QFile>
 #include <QKeyEvent>
 #include <QList>
 #include <QObject>
 #include <QSqlError>
 #include <QScriptEngine>
 #include <QScriptValue>
+#include <QTimer>
 
 #include <xsqlquery.h>
 
@@ -92,8 +95,15 @@ InputManagerPrivate::InputManagerPrivate(InputManager *parent)
   : QObject(parent),
     _parent(parent),
     _state(cIdle),
-    _event(0)
+    _event(0),
+    _resolveScheduled(false),
+    _scanCount(0),
+    _maxQueued(0),
+    _totalLatency(0),
+    _maxLatency(0)
 {
+  _clock.start();
+
   if (eventList.isEmpty())
   {
     // MUST BE CAREFUL HERE. e.g. POXX and POLI must take pohead_number = :f1 and return pohead_id as id
@@ -121,6 +131,12 @@ InputManagerPrivate::InputManagerPrivate(InputManager *parent)
   }
 }
 
+InputManagerPrivate::~InputManagerPrivate()
+{
+  qDeleteAll(_pending);
+  _pending.clear();
+}
+
 ReceiverItem InputManagerPrivate::findReceiver(int pMask)
 {
   for (int counter = 0; counter < _receivers.count(); counter++)
@@ -341,7 +357,7 @@ bool InputManager::eventFilter(QObject *, QEvent *pEvent)
             case cBCUPCCode:
             case cBCLocationIssue:
             case cBCLocationContents:
-              _private->dispatchScan(_private->_event->type);
+              _private->queueScan(_private->_event->type);
               // FALLTHROUGH
 
             default:
@@ -411,80 +427,292 @@ QString InputManagerPrivate::queryFieldName(int barcodeType, int receiverType)
   return result;
 }
 
-void InputManagerPrivate::dispatchScan(int type)
+/* Decoding a scan only queues it. The lookups run once control returns to
+   the event loop, so a burst of scans is captured without waiting on the
+   database and then resolved together.
+ */
+void InputManagerPrivate::queueScan(int type)
 {
   if (DEBUG)
-    qDebug("dispatchScan(%d) entered", type);
+    qDebug("queueScan(%d) entered", type);
   ReceiverItem receiver = findReceiver(type);
-  if (! receiver.isNull())
+  if (receiver.isNull())
+    return;
+
+  if (DEBUG)
+    qDebug() << "queueScan() receiver:"        << receiver.type()
+             << receiver.parent()      << "->" << receiver.target()
+             << "[" << receiver.slot() << "]"  << receiver.isNull();
+
+  PendingScan *scan = new PendingScan;
+  scan->type      = type;
+  scan->event     = _event;
+  scan->number    = _buffer.left(_length1);
+  scan->subNumber = _buffer.mid(_length1, _length2);
+  scan->seqNumber = _buffer.right(_length3);
+  scan->fieldName = queryFieldName(type, receiver.type());
+  scan->target    = receiver.target();
+  scan->slot      = receiver.slot();
+  scan->scanned   = _clock.elapsed();
+  scan->resolved  = false;
+  scan->found     = false;
+  scan->id        = -1;
+  if (DEBUG)
+    qDebug() << "queueScan:" << _length1 << _length2 << _length3
+             << scan->number << scan->subNumber << scan->seqNumber;
+
+  // TODO: can we remove this special-casing for kit sales order items?
+  if (type & cBCSalesOrderLineItem) {
+    int subsep = scan->subNumber.indexOf(".");
+    if (subsep >= 0)
+    {
+      scan->subNumber = scan->subNumber.left(subsep);
+      scan->seqNumber = scan->subNumber.right(scan->subNumber.length() - (subsep + 1));
+    }
+    if (scan->seqNumber.isEmpty())
+      scan->seqNumber = "0";
+  }
+
+  if (_length3 > 0)
+    scan->descrip = _event->descrip.arg(scan->number, scan->subNumber, scan->seqNumber);
+  else if (_length2 > 0)
+    scan->descrip = _event->descrip.arg(scan->number, scan->subNumber);
+  else
+    scan->descrip = _event->descrip.arg(scan->number);
+
+  _pending.append(scan);
+  _maxQueued = qMax(_maxQueued, _pending.size());
+
+  if (! _resolveScheduled)
   {
-    if (DEBUG)
-      qDebug() << "dispatchScan() receiver:"     << receiver.type()
-               << receiver.parent()      << "->" << receiver.target()
-               << "[" << receiver.slot() << "]"  << receiver.isNull();
+    _resolveScheduled = true;
+    QTimer::singleShot(0, this, SLOT(sResolve()));
+  }
+}
 
-    QString number    = _buffer.left(_length1);
-    QString subNumber = _buffer.mid(_length1, _length2);
-    QString seqNumber = _buffer.right(_length3);
-    if (DEBUG)
-      qDebug() << "dispatchScan:" << _length1 << _length2 << _length3 << number << subNumber << seqNumber;
-
-    // TODO: can we remove this special-casing for kit sales order items?
-    if (type & cBCSalesOrderLineItem) {
-      int subsep = subNumber.indexOf(".");
-      if (subsep >= 0)
-      {
-        subNumber = subNumber.left(subsep);
-        seqNumber = subNumber.right(subNumber.length() - (subsep + 1));
-      }
-      if (seqNumber.isEmpty())
-        seqNumber = "0";
+/* Look up every queued scan, one query per bar code type, then hand the
+   results to the receivers in the order they were scanned.
+ */
+void InputManagerPrivate::sResolve()
+{
+  _resolveScheduled = false;
+
+  QList<ScanEvent*> order;
+  QHash<ScanEvent*, QList<PendingScan*> > byEvent;
+  foreach (PendingScan *scan, _pending)
+  {
+    if (scan->resolved)
+      continue;
+    if (scan->fieldName.isEmpty())
+    {
+      scan->resolved = true;
+      scan->error    = tr("Don't know how to send %1 (barcode %2)")
+                       .arg(scan->descrip).arg(scan->type);
+      continue;
     }
+    if (! byEvent.contains(scan->event))
+      order.append(scan->event);
+    byEvent[scan->event].append(scan);
+  }
+
+  foreach (ScanEvent *event, order)
+  {
+    QList<PendingScan*> scans = byEvent.value(event);
+    if (scans.size() == 1 || ! resolveBatch(scans))
+      foreach (PendingScan *scan, scans)
+        resolveOne(scan);
+  }
+
+  deliverResolved();
+}
+
+/* Run the lookup for several scans of the same type in a single round trip
+   by giving each copy of the query its own placeholders. Returns false if
+   the combined query failed so the caller can isolate the bad scan.
+   scanrow keeps each copy's rows in the order that copy returned them, so
+   the row picked for a scan is the one resolveOne() would have picked.
+ */
+bool InputManagerPrivate::resolveBatch(const QList<PendingScan*> &scans)
+{
+  QString query = scans.first()->event->query.trimmed();
+  if (query.endsWith(";"))
+    query.chop(1);
 
-    QString descrip;
-    if (_length3 > 0)
-      descrip = _event->descrip.arg(number, subNumber, seqNumber);
-    else if (_length2 > 0)
-      descrip = _event->descrip.arg(number, subNumber);
-    else
-      descrip = _event->descrip.arg(number);
-
-    XSqlQuery q;
-    q.prepare(_event->query);
-    q.bindValue(":f1", number);
-    q.bindValue(":f2", subNumber);
-    q.bindValue(":f3", seqNumber);
-    q.exec();
-    if (q.first())
+  QStringList parts;
+  for (int i = 0; i < scans.size(); i++)
+  {
+    QString part = query;
+    part.replace(":f1", QString(":f1_%1").arg(i))
+        .replace(":f2", QString(":f2_%1").arg(i))
+        .replace(":f3", QString(":f3_%1").arg(i));
+    parts << "SELECT " + QString::number(i) + " AS scanseq,"
+             "       ROW_NUMBER() OVER () AS scanrow, scanq.*"
+             "  FROM (" + part + ") AS scanq";
+  }
+
+  XSqlQuery q;
+  q.prepare(parts.join(" UNION ALL ") + " ORDER BY scanseq, scanrow;");
+  for (int i = 0; i < scans.size(); i++)
+  {
+    q.bindValue(QString(":f1_%1").arg(i), scans.at(i)->number);
+    q.bindValue(QString(":f2_%1").arg(i), scans.at(i)->subNumber);
+    q.bindValue(QString(":f3_%1").arg(i), scans.at(i)->seqNumber);
+  }
+  if (! q.exec())
+    return false;
+
+  while (q.next())
+  {
+    PendingScan *scan = scans.value(q.value("scanseq").toInt(), 0);
+    if (scan && ! scan->found)  // the first row wins, as with q.first()
     {
-      message(tr("Scanned %1").arg(descrip), 1000);
+      scan->found = true;
+      scan->id    = q.value(scan->fieldName).toInt();
+    }
+  }
 
-      QString fieldName = queryFieldName(type, receiver.type());
+  foreach (PendingScan *scan, scans)
+    scan->resolved = true;
 
-      if (fieldName.isEmpty())
-      {
-        message(tr("Don't know how to send %1 (barcode %2, receiver %3)")
-                .arg(descrip).arg(type, receiver.type()));
-        return;
-      }
+  return true;
+}
 
-      int id = q.value(fieldName).toInt();
-      QGenericArgument idArg = Q_ARG(int, id);
+void InputManagerPrivate::resolveOne(PendingScan *scan)
+{
+  XSqlQuery q;
+  q.prepare(scan->event->query);
+  q.bindValue(":f1", scan->number);
+  q.bindValue(":f2", scan->subNumber);
+  q.bindValue(":f3", scan->seqNumber);
+  q.exec();
+  if (q.first())
+  {
+    scan->found = true;
+    scan->id    = q.value(scan->fieldName).toInt();
+  }
+  else if (q.lastError().type() != QSqlError::NoError)
+    scan->error = tr("Error Scanning %1: %2").arg(scan->descrip, q.lastError().text());
+
+  scan->resolved = true;
+}
+
+void InputManagerPrivate::deliverResolved()
+{
+  while (! _pending.isEmpty() && _pending.first()->resolved)
+  {
+    PendingScan *scan = _pending.takeFirst();
+
+    qint64 latency = _clock.elapsed() - scan->scanned;
+    _scanCount++;
+    _totalLatency += latency;
+    _maxLatency    = qMax(_maxLatency, latency);
+
+    if (! scan->error.isEmpty())
+      message(scan->error, 1000);
+    else if (! scan->found)
+      message(tr("%1 not found").arg(scan->descrip));
+    else if (scan->target)
+    {
+      message(tr("Scanned %1").arg(scan->descrip), 1000);
+
+      QGenericArgument idArg = Q_ARG(int, scan->id);
       // convert "1methodName(args)(stuff)" to just "methodName"
-      QString methodName = receiver.slot();
+      QString methodName = scan->slot;
       methodName.replace(QRegExp("^1([a-z][a-z0-9_]*).*", Qt::CaseInsensitive), "\\1");
 
       if (DEBUG)
-        qDebug() << receiver.target() << methodName.toLatin1().data() << id;
-      (void)QMetaObject::invokeMethod(receiver.target(),
+        qDebug() << scan->target << methodName.toLatin1().data() << scan->id;
+      (void)QMetaObject::invokeMethod(scan->target,
                                       methodName.toLatin1().data(), idArg);
-      emit gotBarCode(type, id);
+      emit gotBarCode(scan->type, scan->id);
+    }
+
+    delete scan;
+  }
+}
+
+/** Feed a recorded keystroke stream through the scanner decoder as if it
+    had been typed, wait for every resulting scan to be delivered, and
+    report how fast the pipeline ran. Returns a map with @c scans,
+    @c msec, @c scansPerSecond, @c avgLatency and @c maxLatency.
+ */
+QVariantMap InputManager::replay(const QString &keystrokes)
+{
+  resetStatistics();
+
+  QElapsedTimer timer;
+  timer.start();
+  for (int i = 0; i < keystrokes.size(); i++)
+  {
+    QChar c = keystrokes.at(i);
+#ifdef Q_OS_MAC
+    if (c.unicode() < 0x20)
+    {
+      QKeyEvent ctrl(QEvent::KeyPress, Qt::Key_Meta, Qt::NoModifier);
+      eventFilter(this, &ctrl);
+      QKeyEvent key(QEvent::KeyPress, c.unicode() + 64, Qt::MetaModifier);
+      eventFilter(this, &key);
+      continue;
     }
-    else if (q.lastError().type() != QSqlError::NoError)
-      message(tr("Error Scanning %1: %2").arg(descrip, q.lastError().text()), 1000);
-    else
-      message(tr("%1 not found").arg(descrip));
+#endif
+    QKeyEvent key(QEvent::KeyPress, c.unicode() < 0x20 ? 0 : c.toUpper().unicode(),
+                  Qt::NoModifier, QString(c));
+    eventFilter(this, &key);
+  }
+
+  while (! _private->_pending.isEmpty())
+  {
+    int before = _private->_pending.size();
+    _private->sResolve();
+    if (_private->_pending.size() == before)
+      break;
   }
+
+  QVariantMap result = statistics();
+  qint64 msec = timer.elapsed();
+  result.insert("msec", msec);
+  result.insert("scansPerSecond", msec > 0 ? _private->_scanCount * 1000.0 / msec
+                                           : double(_private->_scanCount));
+  return result;
+}
+
+/** Replay the keystrokes saved in @a filename.
+    @see replay
+ */
+QVariantMap InputManager::replayFile(const QString &filename)
+{
+  QFile file(filename);
+  if (! file.open(QIODevice::ReadOnly))
+  {
+    QVariantMap result;
+    result.insert("error", file.errorString());
+    return result;
+  }
+  return replay(QString::fromLatin1(file.readAll()));
+}
+
+/** Return counters for scans delivered since the last resetStatistics():
+    @c scans, @c queued, @c maxQueued, @c avgLatency and @c maxLatency,
+    with latencies in milliseconds from decode to delivery.
+ */
+QVariantMap InputManager::statistics() const
+{
+  QVariantMap result;
+  result.insert("scans",      _private->_scanCount);
+  result.insert("queued",     _private->_pending.size());
+  result.insert("maxQueued",  _private->_maxQueued);
+  result.insert("avgLatency", _private->_scanCount
+                              ? double(_private->_totalLatency) / _private->_scanCount : 0.0);
+  result.insert("maxLatency", _private->_maxLatency);
+  return result;
+}
+
+void InputManager::resetStatistics()
+{
+  _private->_scanCount    = 0;
+  _private->_maxQueued    = _private->_pending.size();
+  _private->_totalLatency = 0;
+  _private->_maxLatency   = 0;
 }
 
 void InputManager::scriptAPI(QScriptEngine *engine, QString globalName)
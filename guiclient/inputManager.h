@@ -13,6 +13,7 @@
 
 #include <QObject>
 #include <QEvent>
+#include <QVariant>
 
 class InputManagerPrivate;
 class QScriptEngine;
@@ -47,6 +48,11 @@ class InputManager : public QObject
     Q_INVOKABLE void notify(int, QObject *, QObject *, const QString &);
     Q_INVOKABLE QString slotName(const QString &);
 
+    Q_INVOKABLE QVariantMap replay(const QString &keystrokes);
+    Q_INVOKABLE QVariantMap replayFile(const QString &filename);
+    Q_INVOKABLE QVariantMap statistics() const;
+    Q_INVOKABLE void        resetStatistics();
+
     void scriptAPI(QScriptEngine *engine, QString globalName);
 
   public slots:
@@ -11,9 +11,11 @@
 #ifndef __INPUTMANAGERPRIVATE_H__
 #define __INPUTMANAGERPRIVATE_H__
 
+#include <QElapsedTimer>
 #include <QHash>
 #include <QList>
 #include <QObject>
+#include <QPointer>
 
 class InputManager;
 class ScanEvent;
@@ -39,12 +41,35 @@ class ReceiverItem
     bool    _null;
 };
 
+/* One decoded bar code waiting to be looked up and delivered. The receiver
+   is chosen when the scan is decoded so later focus changes don't reroute it.
+ */
+class PendingScan
+{
+  public:
+    int               type;
+    ScanEvent        *event;
+    QString           number;
+    QString           subNumber;
+    QString           seqNumber;
+    QString           descrip;
+    QString           fieldName;
+    QPointer<QObject> target;
+    QString           slot;
+    qint64            scanned;
+    bool              resolved;
+    bool              found;
+    int               id;
+    QString           error;
+};
+
 class InputManagerPrivate : public QObject
 {
   Q_OBJECT
 
   public:
     InputManagerPrivate(InputManager *parent);
+    ~InputManagerPrivate();
 
     static QHash<QString, ScanEvent*> eventList;
 
@@ -58,12 +83,26 @@ class InputManagerPrivate : public QObject
     int                 _length3;
     QString             _buffer;
 
-    void dispatchScan(int type);
+    QList<PendingScan*> _pending;
+    bool                _resolveScheduled;
+    QElapsedTimer       _clock;
+    int                 _scanCount;
+    int                 _maxQueued;
+    qint64              _totalLatency;
+    qint64              _maxLatency;
+
+    void queueScan(int type);
+    bool resolveBatch(const QList<PendingScan*> &scans);
+    void resolveOne(PendingScan *scan);
+    void deliverResolved();
 
     void         addToEventList(QString prefix, int type, int length1, int length2, int length3, QString descrip, QString query);
     ReceiverItem findReceiver(int pMask);
     QString      queryFieldName(int barcodeType, int receiverType);
 
+  public slots:
+    void sResolve();
+
   signals:
     void gotBarCode(int type, int id);
 };
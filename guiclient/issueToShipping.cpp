@@ -11,7 +11,9 @@
 
 #include "issueToShipping.h"
 
+#include <QHash>
 #include <QSqlError>
+#include <QStringList>
 #include <QVariant>
 
 #include <metasql.h>
@@ -427,22 +429,353 @@ bool issueToShipping::sufficientInventory(int porderheadid)
 
 void issueToShipping::sIssueLineBalance()
 {
-  bool refresh = false;
-
   QList<XTreeWidgetItem*> selected = _soitem->selectedItems();
-  for (int i = 0; i < selected.size(); i++)
+  if (selected.size() == 1)
   {
-    XTreeWidgetItem *cursor = (XTreeWidgetItem*)selected[i];
-    if (sIssueLineBalance(cursor->id(), cursor->altId()))
-      refresh = true;
-    else
-      break;
+    if (sIssueLineBalance(selected[0]->id(), selected[0]->altId()))
+      sFillList();
+    return;
   }
 
-  if (refresh)
+  if (issueLineBalances(selected) > 0)
     sFillList();
 }
 
+static QString intArray(const QList<int> &values)
+{
+  QStringList list;
+  foreach (int value, values)
+    list << QString::number(value);
+  return "{" + list.join(",") + "}";
+}
+
+static QString numericArray(const QList<double> &values)
+{
+  QStringList list;
+  foreach (double value, values)
+    list << QString::number(value, 'f', 6);
+  return "{" + list.join(",") + "}";
+}
+
+/* Issue the balance of several lines together. The inventory check, line
+   details, itemlocdist series and parent itemlocdist records for all of
+   the lines take one query each, the distribution prompts for controlled
+   items are all answered before anything is posted, and the lines are
+   issued in a single transaction. Job items post production first, so
+   they still go through sIssueLineBalance(id, altId) one at a time.
+
+   Lines that cannot be issued are skipped and listed in one message at
+   the end. Returns the number of lines issued.
+ */
+int issueToShipping::issueLineBalances(const QList<XTreeWidgetItem*> &lines)
+{
+  QStringList errors;
+  QList<int>  ids;
+  QList<XTreeWidgetItem*> jobLines;
+  QHash<int, XTreeWidgetItem*> lineById;
+  foreach (XTreeWidgetItem *line, lines)
+  {
+    if (line->altId() == 0)
+    {
+      ids << line->id();
+      lineById.insert(line->id(), line);
+    }
+    else
+      jobLines << line;
+  }
+
+  int issued = 0;
+  XSqlQuery rollback;
+  rollback.prepare("ROLLBACK;");
+
+  // check inventory for every line at once, only naming the items that fail
+  if (! ids.isEmpty() &&
+      (_requireInventory->isChecked() ||
+       (_order->isSO() && _metrics->boolean("EnableSOReservations"))))
+  {
+    XSqlQuery sufficientq;
+    sufficientq.prepare("SELECT id, sufficientInventoryToShipItem(:ordertype, id) AS result"
+                        "  FROM unnest(CAST(:ids AS INTEGER[])) AS id;");
+    sufficientq.bindValue(":ordertype", _order->type());
+    sufficientq.bindValue(":ids",       intArray(ids));
+    sufficientq.exec();
+    QHash<int, int> insufficient;
+    while (sufficientq.next())
+      if (sufficientq.value("result").toInt() < 0)
+        insufficient.insert(sufficientq.value("id").toInt(), sufficientq.value("result").toInt());
+    if (ErrorReporter::error(QtCriticalMsg, this, tr("Insufficient Inventory To Ship"),
+                             sufficientq, __FILE__, __LINE__))
+      return 0;
+
+    if (! insufficient.isEmpty())
+    {
+      ParameterList errp;
+      errp.append(_order->isSO() ? "soitem_ids" : "toitem_ids", intArray(insufficient.keys()));
+      MetaSQLQuery errm("<? if exists(\"soitem_ids\") ?>"
+                        "SELECT coitem_id AS id, item_number, warehous_code "
+                        "  FROM coitem, item, itemsite, whsinfo "
+                        " WHERE ((coitem_itemsite_id=itemsite_id)"
+                        "   AND  (itemsite_item_id=item_id)"
+                        "   AND  (itemsite_warehous_id=warehous_id)"
+                        "   AND  (coitem_id=ANY(CAST(<? value(\"soitem_ids\") ?> AS INTEGER[]))));"
+                        "<? elseif exists(\"toitem_ids\")?>"
+                        "SELECT toitem_id AS id, item_number, tohead_srcname AS warehous_code "
+                        "  FROM toitem, tohead, item "
+                        " WHERE ((toitem_item_id=item_id)"
+                        "   AND  (toitem_tohead_id=tohead_id)"
+                        "   AND  (toitem_id=ANY(CAST(<? value(\"toitem_ids\") ?> AS INTEGER[]))));"
+                        "<? endif ?>");
+      XSqlQuery errq = errm.toQuery(errp);
+      while (errq.next())
+      {
+        int id = errq.value("id").toInt();
+        errors << storedProcErrorLookup("sufficientInventoryToShipItem", insufficient.value(id))
+                  .arg(errq.value("item_number").toString())
+                  .arg(errq.value("warehous_code").toString());
+        ids.removeAll(id);
+      }
+      (void)ErrorReporter::error(QtCriticalMsg, this, tr("Insufficient Inventory To Ship"),
+                                 errq, __FILE__, __LINE__);
+    }
+  }
+
+  // gather the balance and item details for every line
+  QList<double> balances;
+  QList<int>    itemsites;
+  QList<bool>   controlled;
+  if (! ids.isEmpty())
+  {
+    XSqlQuery detailq;
+    detailq.prepare("SELECT orderitem_id, orderitem_itemsite_id AS itemsite_id,"
+                    "       calcIssueToShippingLineBalance(:orderType, orderitem_id) AS balance,"
+                    "       isControlledItemsite(orderitem_itemsite_id) AS controlled"
+                    "  FROM orderitem"
+                    " WHERE orderitem_orderhead_type = :orderType"
+                    "   AND orderitem_id = ANY(CAST(:ids AS INTEGER[]));");
+    detailq.bindValue(":orderType", _order->type());
+    detailq.bindValue(":ids",       intArray(ids));
+    detailq.exec();
+    QHash<int, int> row;
+    QList<QVariantList> details;
+    while (detailq.next())
+    {
+      row.insert(detailq.value("orderitem_id").toInt(), details.size());
+      details << (QVariantList() << detailq.value("balance")
+                                 << detailq.value("itemsite_id")
+                                 << detailq.value("controlled"));
+    }
+    if (ErrorReporter::error(QtCriticalMsg, this, tr("Error Gathering Order Item Info."),
+                             detailq, __FILE__, __LINE__))
+      return 0;
+
+    foreach (int id, ids)
+    {
+      if (! row.contains(id))
+      {
+        errors << tr("Could not find orderitem info for line %1.")
+                  .arg(lineById.value(id)->text("linenumber"));
+        ids.removeAll(id);
+        continue;
+      }
+      QVariantList detail = details.at(row.value(id));
+      if (detail.at(0).toDouble() <= 0)   // nothing left to issue
+      {
+        ids.removeAll(id);
+        continue;
+      }
+      balances   << detail.at(0).toDouble();
+      itemsites  << detail.at(1).toInt();
+      controlled << detail.at(2).toBool();
+    }
+  }
+
+  // one series per line, fetched together
+  QList<int> series;
+  if (! ids.isEmpty())
+  {
+    XSqlQuery seriesq;
+    seriesq.prepare("SELECT NEXTVAL('itemloc_series_seq') AS result"
+                    "  FROM generate_series(1, :count);");
+    seriesq.bindValue(":count", ids.size());
+    seriesq.exec();
+    while (seriesq.next())
+      series << seriesq.value("result").toInt();
+    if (series.size() != ids.size())
+    {
+      ErrorReporter::error(QtCriticalMsg, this, tr("Failed to Retrieve the Next itemloc_series_seq"),
+                           seriesq, __FILE__, __LINE__);
+      return 0;
+    }
+  }
+
+  XSqlQuery cleanup;
+  cleanup.prepare("SELECT deleteitemlocseries(series, TRUE)"
+                  "  FROM unnest(CAST(:series AS INTEGER[])) AS series;");
+  cleanup.bindValue(":series", intArray(series));
+
+  // create the itemlocdist records for the controlled lines and distribute them
+  QList<int> controlledIds, controlledSeries, controlledItemsites;
+  QList<double> controlledQty;
+  for (int i = 0; i < ids.size(); i++)
+  {
+    if (controlled.at(i))
+    {
+      controlledIds       << ids.at(i);
+      controlledSeries    << series.at(i);
+      controlledItemsites << itemsites.at(i);
+      controlledQty       << balances.at(i);
+    }
+  }
+  if (! controlledIds.isEmpty())
+  {
+    XSqlQuery parentq;
+    parentq.prepare("SELECT createItemlocdistParent((CAST(:itemsites AS INTEGER[]))[i],"
+                    "                               (CAST(:qty AS NUMERIC[]))[i] * -1,"
+                    "                               :orderType, (CAST(:ids AS INTEGER[]))[i],"
+                    "                               (CAST(:series AS INTEGER[]))[i],"
+                    "                               NULL, NULL, 'SH') AS result"
+                    "  FROM generate_subscripts(CAST(:ids AS INTEGER[]), 1) AS i;");
+    parentq.bindValue(":itemsites", intArray(controlledItemsites));
+    parentq.bindValue(":qty",       numericArray(controlledQty));
+    parentq.bindValue(":orderType", _order->type());
+    parentq.bindValue(":ids",       intArray(controlledIds));
+    parentq.bindValue(":series",    intArray(controlledSeries));
+    parentq.exec();
+    if (ErrorReporter::error(QtCriticalMsg, this, tr("Error Creating itemlocdist Records"),
+                             parentq, __FILE__, __LINE__))
+    {
+      cleanup.exec();
+      return 0;
+    }
+
+    foreach (int itemlocSeries, controlledSeries)
+    {
+      if (distributeInventory::SeriesAdjust(itemlocSeries, this, QString(), QDate(),
+                                            QDate(), true) == XDialog::Rejected)
+      {
+        cleanup.exec();
+        QMessageBox::information( this, tr("Issue to Shipping"), tr("Issue Canceled") );
+        return 0;
+      }
+    }
+  }
+
+  // issue every line in one statement; if any line fails, issue them one
+  // at a time so the failures can be reported and the rest still posted
+  QList<int> failedSeries;
+  if (! ids.isEmpty())
+  {
+    XSqlQuery issue;
+    issue.exec("BEGIN;");
+    issue.prepare("SELECT (CAST(:series AS INTEGER[]))[i] AS series,"
+                  "       issueToShipping(:ordertype::text, (CAST(:ids AS INTEGER[]))[i],"
+                  "                       (CAST(:qty AS NUMERIC[]))[i],"
+                  "                       (CAST(:series AS INTEGER[]))[i], :ts,"
+                  "                       NULL, false, true) AS result"
+                  "  FROM generate_subscripts(CAST(:ids AS INTEGER[]), 1) AS i"
+                  " ORDER BY i;");
+    issue.bindValue(":ordertype", _order->type());
+    issue.bindValue(":ids",       intArray(ids));
+    issue.bindValue(":qty",       numericArray(balances));
+    issue.bindValue(":series",    intArray(series));
+    issue.bindValue(":ts",        _transDate->date());
+    issue.exec();
+    bool ok = issue.lastError().type() == QSqlError::NoError;
+    while (ok && issue.next())
+      ok = (issue.value("result").toInt() == issue.value("series").toInt());
+    if (! ok || issue.size() != ids.size())
+    {
+      rollback.exec();
+      issue.exec("BEGIN;");
+      for (int i = 0; i < ids.size(); i++)
+      {
+        XTreeWidgetItem *line = lineById.value(ids.at(i));
+        issue.exec("SAVEPOINT issueline;");
+        issue.prepare("SELECT issueToShipping(:ordertype::text, :soitem_id, :qty,"
+                      "                       :itemlocSeries, :ts, NULL, false, true) AS result;");
+        issue.bindValue(":ordertype",     _order->type());
+        issue.bindValue(":soitem_id",     ids.at(i));
+        issue.bindValue(":qty",           balances.at(i));
+        issue.bindValue(":itemlocSeries", series.at(i));
+        issue.bindValue(":ts",            _transDate->date());
+        issue.exec();
+        QString lineError;
+        if (! issue.first())
+          lineError = issue.lastError().databaseText();
+        else if (issue.value("result").toInt() != series.at(i))
+          lineError = storedProcErrorLookup("issueToShipping", issue.value("result").toInt());
+
+        if (lineError.isEmpty())
+          issue.exec("RELEASE SAVEPOINT issueline;");
+        else
+        {
+          issue.exec("ROLLBACK TO SAVEPOINT issueline;");
+          errors << tr("Line %1 (%2): %3").arg(line->text("linenumber"),
+                                              line->text("item_number"), lineError);
+          failedSeries << series.at(i);
+        }
+      }
+    }
+
+    // Transfer Orders need pre-assign records for the lot/serial# so they
+    // are available when the Transfer Order is received
+    if (_order->type() == "TO")
+    {
+      XSqlQuery lsdetail;
+      lsdetail.prepare("INSERT INTO lsdetail "
+                       " (lsdetail_itemsite_id, lsdetail_created, lsdetail_source_type, "
+                       "  lsdetail_source_id, lsdetail_source_number, lsdetail_ls_id, lsdetail_qtytoassign, "
+                       "  lsdetail_expiration, lsdetail_warrpurc ) "
+                       "SELECT invhist_itemsite_id, NOW(), 'TR', "
+                       "   (CAST(:ids AS INTEGER[]))[i], invhist_ordnumber, invdetail_ls_id, (invdetail_qty * -1.0), "
+                       "   invdetail_expiration, invdetail_warrpurc "
+                       "FROM generate_subscripts(CAST(:ids AS INTEGER[]), 1) AS i "
+                       "  JOIN invhist ON (invhist_series=(CAST(:series AS INTEGER[]))[i]) "
+                       "  JOIN invdetail ON (invdetail_invhist_id=invhist_id) "
+                       "WHERE NOT ((CAST(:series AS INTEGER[]))[i] = ANY(CAST(:failed AS INTEGER[])));");
+      lsdetail.bindValue(":ids",    intArray(ids));
+      lsdetail.bindValue(":series", intArray(series));
+      lsdetail.bindValue(":failed", intArray(failedSeries));
+      lsdetail.exec();
+      if (lsdetail.lastError().type() != QSqlError::NoError)
+      {
+        rollback.exec();
+        cleanup.exec();
+        ErrorReporter::error(QtCriticalMsg, this, tr("Error Issuing Item"),
+                             lsdetail, __FILE__, __LINE__);
+        return 0;
+      }
+    }
+
+    issue.exec("COMMIT;");
+    if (ErrorReporter::error(QtCriticalMsg, this, tr("Error Issuing Item"),
+                             issue, __FILE__, __LINE__))
+    {
+      rollback.exec();
+      cleanup.exec();
+      return 0;
+    }
+    issued += ids.size() - failedSeries.size();
+
+    if (! failedSeries.isEmpty())
+    {
+      cleanup.bindValue(":series", intArray(failedSeries));
+      cleanup.exec();
+    }
+  }
+
+  if (! errors.isEmpty())
+    ErrorReporter::error(QtCriticalMsg, this, tr("Error Issuing Items"),
+                         tr("<p>The following lines were not issued:<br>%1")
+                         .arg(errors.join("<br>")), __FILE__, __LINE__);
+
+  foreach (XTreeWidgetItem *line, jobLines)
+    if (sIssueLineBalance(line->id(), line->altId()))
+      issued++;
+
+  return issued;
+}
+
 bool issueToShipping::sIssueLineBalance(int id, int altId)
 {   
   if (altId == 0) // Not a Job costed item
@@ -764,15 +1097,11 @@ void issueToShipping::sIssueAllBalance()
   if (! sufficientInventory(orderid))
     return;
 
+  // attempt to issue all lines
+  QList<XTreeWidgetItem*> lines;
   for (int i = 0; i < _soitem->topLevelItemCount(); i++)
-  {
-    XTreeWidgetItem *cursor = (XTreeWidgetItem*)_soitem->topLevelItem(i);
-    if (sIssueLineBalance(cursor->id(),cursor->altId()))
-      refresh = true;
-    // attempt to issue all lines
-    //else
-    //  break;
-  }
+    lines << (XTreeWidgetItem*)_soitem->topLevelItem(i);
+  refresh = (issueLineBalances(lines) > 0);
 
   if (refresh)
     sFillList();
@@ -57,6 +57,7 @@ protected:
     bool        _captive;
 
 private:
+    int 	issueLineBalances(const QList<XTreeWidgetItem*> &lines);
     bool	sufficientInventory(int);
     bool	sufficientItemInventory(int);
 
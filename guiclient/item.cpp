@@ -38,6 +38,7 @@
 #include "itemtax.h"
 #include "itemSource.h"
 #include "mqlutil.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 
 const char *_itemTypes[] = { "P", "M", "F", "R", "S", "T", "O", "L", "K", "B", "C", "Y" };
@@ -196,7 +197,7 @@ item::item(QWidget* parent, const char* name, Qt::WindowFlags fl)
   _itemSite->addColumn(tr("Avg. Cost"),     _moneyColumn, Qt::AlignRight, true, "avgcost" );
   _itemSite->setDragString("itemsiteid=");
 
-  connect(omfgThis, SIGNAL(itemsitesUpdated()), SLOT(sFillListItemSites()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(itemsitesUpdated()), this, SLOT(sFillListItemSites()));
 
   _itemtax->addColumn(tr("Tax Type"),_itemColumn, Qt::AlignLeft,true,"taxtype_name");
   _itemtax->addColumn(tr("Tax Zone"),    -1, Qt::AlignLeft,true,"taxzone");
@@ -16,6 +16,7 @@
 #include "mqlutil.h"
 #include "itemGroup.h"
 #include "guiclient.h"
+#include "refreshscheduler.h"
 
 itemGroups::itemGroups(QWidget* parent, const char* name, Qt::WindowFlags fl)
   : XWidget(parent, name, fl)
@@ -49,7 +50,7 @@ itemGroups::itemGroups(QWidget* parent, const char* name, Qt::WindowFlags fl)
     _new->setEnabled(false);
   }
   
-  connect(omfgThis, SIGNAL(itemGroupsUpdated(int, bool)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(itemGroupsUpdated(int, bool)), this, SLOT(sFillList()));
 
   sFillList();
 }
@@ -21,6 +21,7 @@
 #include "dspInventoryAvailability.h"
 #include "itemSite.h"
 #include "parameterwidget.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 #include "errorReporter.h"
 
@@ -69,7 +70,7 @@ itemSites::itemSites(QWidget* parent, const char*, Qt::WindowFlags fl)
   list()->addColumn(tr("Last Cnt'd"),    _dateColumn,  Qt::AlignCenter, false,  "datelastcount" );
   list()->addColumn(tr("Last Used"),     _dateColumn,  Qt::AlignCenter, false,  "datelastused" );
 
-  connect(omfgThis, SIGNAL(itemsitesUpdated()), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(itemsitesUpdated()), this, SLOT(sFillList()));
 }
 
 enum SetResponse itemSites::set(const ParameterList &pParams)
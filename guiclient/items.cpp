@@ -21,6 +21,7 @@
 #include "errorReporter.h"
 #include "item.h"
 #include "parameterwidget.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 
 items::items(QWidget* parent, const char*, Qt::WindowFlags fl)
@@ -32,6 +33,7 @@ items::items(QWidget* parent, const char*, Qt::WindowFlags fl)
   setNewVisible(true);
   setSearchVisible(true);
   setQueryOnStartEnabled(true);
+  setCursorPageSize(500);
   setParameterWidgetVisible(true);
 
   QString qryType = QString( "SELECT  1, '%1' UNION "
@@ -97,7 +99,7 @@ items::items(QWidget* parent, const char*, Qt::WindowFlags fl)
     connect(list(), SIGNAL(itemSelected(int)), this, SLOT(sView()));
   }
 
-  connect(omfgThis, SIGNAL(itemsUpdated(int, bool)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(itemsUpdated(int, bool)), this, SLOT(sFillList()));
 }
 
 
@@ -22,6 +22,7 @@
 #include "getGLDistDate.h"
 #include "invoice.h"
 #include "mqlutil.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 #include "errorReporter.h"
 
@@ -57,7 +58,7 @@ listRecurringInvoices::listRecurringInvoices(QWidget* parent, const char* name,
   if (_privileges->check("MaintainMiscInvoices") || _privileges->check("ViewMiscInvoices"))
     connect(_invchead, SIGNAL(valid(bool)), _view, SLOT(setEnabled(bool)));
 
-  connect(omfgThis, SIGNAL(invoicesUpdated(int, bool)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(invoicesUpdated(int, bool)), this, SLOT(sFillList()));
 
   sFillList();
 }
@@ -113,6 +113,7 @@
 
 #include "createfiscalyear.h"
 #include "errorReporter.h"
+#include "exporthelper.h"
 #include "login2.h"
 #include "currenciesDialog.h"
 #include "registrationKeyDialog.h"
@@ -120,6 +121,7 @@
 #include "version.h"
 #include "metrics.h"
 #include "metricsenc.h"
+#include "queryprofiler.h"
 #include "scripttoolbox.h"
 #include "xmainwindow.h"
 #include "checkForUpdates.h"
@@ -161,6 +163,7 @@ int main(int argc, char *argv[])
   bool    _enhancedAuth   = false;
   bool    havePasswd      = false;
   bool    forceWelcomeStub= false;
+  QString profileFile;
 #if QT_VERSION >= 0x050000
   qInstallMessageHandler(xTupleMessageOutput);
 #else
@@ -220,9 +223,16 @@ int main(int argc, char *argv[])
       }
       else if (argument.contains("-forceWelcomeStub", Qt::CaseInsensitive))
         forceWelcomeStub = true;
+      else if (argument.contains("-profile=", Qt::CaseInsensitive))
+        profileFile = argument.right(argument.length() - 9);
     }
   }
 
+  // time queries and client-side work for the whole session and write a
+  // summary on exit, so runs of different builds can be compared
+  if (! profileFile.isEmpty())
+    QueryProfiler::instance()->setEnabled(true);
+
   // Try and load a default translation file and install it
   // otherwise if we are non-english inform the user that translation are available
   bool checkLanguage = false;
@@ -295,6 +305,7 @@ int main(int argc, char *argv[])
   _splash->showMessage(QObject::tr("Loading Database Metrics"), SplashTextAlignment, SplashTextColor);
   qApp->processEvents();
   _metrics = new Metrics();
+  ExportHelper::XSLTClearCacheOn(_metrics, SIGNAL(loaded()));
 
   // TODO: we should compose the splash screen on the fly from parts
   QString edition("PostBooks");
@@ -866,6 +877,13 @@ int main(int argc, char *argv[])
 
   app.exec();
 
+  if (! profileFile.isEmpty())
+  {
+    QString errmsg;
+    if (! QueryProfiler::instance()->exportBenchmark(profileFile, &errmsg))
+      qWarning("%s", qPrintable(errmsg));
+  }
+
 //  Clean up
   delete _metrics;
   delete _preferences;
@@ -12,7 +12,6 @@
 #define menuCRM_h
 
 #include <QObject>
-#include <QPixmap>
 
 class QToolBar;
 class QMenu;
@@ -28,7 +27,7 @@ class menuCRM : public QObject
     const char*		slot;
     QMenu*		menu;
     QString		priv;
-    QPixmap*	pixmap;
+    const char*	pixmap;
     QToolBar*		toolBar;
     bool		visible;
     const QString   toolTip;
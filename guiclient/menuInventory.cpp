@@ -11,7 +11,6 @@
 #include <QAction>
 #include <QMenu>
 #include <QMenuBar>
-#include <QPixmap>
 #include <QToolBar>
 
 #include <parameter.h>
@@ -250,7 +249,7 @@ menuInventory::menuInventory(GUIClient *Pparent) :
     //  Inventory | Receiving
     { "menu",            tr("R&eceiving"),                 (char*)receivingMenu,  mainMenu,      "true",          NULL, NULL, true, NULL },
     { "sr.enterReceipt", tr("&New Receipt..."),            SLOT(sEnterReceipt()), receivingMenu, "EnterReceipts", NULL, NULL, true, NULL },
-    { "sr.postReceipts", tr("&List Unposted Receipts..."), SLOT(sPostReceipts()), receivingMenu, "EnterReceipts", new QPixmap(":/images/postReceipts.png"), toolBar,  true, tr("List Unposted Receipts") },
+    { "sr.postReceipts", tr("&List Unposted Receipts..."), SLOT(sPostReceipts()), receivingMenu, "EnterReceipts", ":/images/postReceipts.png", toolBar,  true, tr("List Unposted Receipts") },
     { "separator",       NULL,                             NULL,                  receivingMenu, "true",          NULL, NULL, true, NULL },
     { "sr.enterReturn",  tr("Purchase Order &Return..."),  SLOT(sEnterReturn()),  receivingMenu, "EnterReturns",  NULL, NULL, true, NULL },
     { "separator",       NULL,                             NULL,                  receivingMenu, "true",          NULL, NULL, true, NULL },
@@ -261,7 +260,7 @@ menuInventory::menuInventory(GUIClient *Pparent) :
 
     //  Inventory | Shipping
     { "menu",                        tr("&Shipping"),                      (char*)shippingMenu,           mainMenu,     "true",                 NULL, NULL, true, NULL },
-    { "sr.issueToShipping",          tr("&Issue to Shipping..."),          SLOT(sIssueStockToShipping()), shippingMenu, "IssueStockToShipping", new QPixmap(":/images/issueStockToShipping.png"), toolBar,  true, tr("Issue to Shipping") },
+    { "sr.issueToShipping",          tr("&Issue to Shipping..."),          SLOT(sIssueStockToShipping()), shippingMenu, "IssueStockToShipping", ":/images/issueStockToShipping.png", toolBar,  true, tr("Issue to Shipping") },
     { "sr.maintainShippingContents", tr("&Maintain Shipping Contents..."), SLOT(sDspShippingContents()),  shippingMenu, "ViewShipping",         NULL, NULL, true, NULL },
     { "separator",                   NULL,                                 NULL,                          shippingMenu, "true",                 NULL, NULL, true, NULL },
     { "sr.shipOrder",                tr("&Ship Order..."),                 SLOT(sShipOrders()),           shippingMenu, "ShipOrders",           NULL, NULL, true, NULL },
@@ -337,7 +336,7 @@ menuInventory::menuInventory(GUIClient *Pparent) :
     {  "separator",                   NULL,                                  NULL,                                      reportsMenu,    "true",         NULL, NULL, true, NULL },
 
     //  Inventory| Reports | Inventory Availability
-    { "im.dspInventoryAvailability",       tr("Inventory &Availability..."), SLOT(sDspInventoryAvailability()), reportsMenu, "ViewInventoryAvailability", new QPixmap(":/images/dspInventoryAvailabilityByPlannerCode.png"), toolBar, true, tr("Inventory Availability by Planner Code") },
+    { "im.dspInventoryAvailability",       tr("Inventory &Availability..."), SLOT(sDspInventoryAvailability()), reportsMenu, "ViewInventoryAvailability", ":/images/dspInventoryAvailabilityByPlannerCode.png", toolBar, true, tr("Inventory Availability by Planner Code") },
     { "im.dspSubstituteAvailabilityByRootItem",         tr("&Substitute Availability..."),       SLOT(sDspSubstituteAvailabilityByRootItem()), reportsMenu, "ViewInventoryAvailability",        NULL, NULL, true, NULL },
     {  "separator",                   NULL,                                  NULL,                                      reportsMenu,    "true",         NULL, NULL, true, NULL },
 
@@ -359,9 +358,9 @@ menuInventory::menuInventory(GUIClient *Pparent) :
     // Inventory | Item Site
     { "menu",                           tr("&Item Site"),       (char*)itemSitesMenu,   mainMenu,       "true",              NULL, NULL, true, NULL },
     { "im.newItemSite",                 tr("&New..."),          SLOT(sNewItemSite()),   itemSitesMenu,  "MaintainItemSites", NULL, NULL, true, NULL },
-    { "im.listItemSites",               tr("&List..."),         SLOT(sItemSites()),     itemSitesMenu,  "MaintainItemSites ViewItemSites", new QPixmap(":/images/itemSites.png"), toolBar, true, tr("List Item Sites") },
+    { "im.listItemSites",               tr("&List..."),         SLOT(sItemSites()),     itemSitesMenu,  "MaintainItemSites ViewItemSites", ":/images/itemSites.png", toolBar, true, tr("List Item Sites") },
     { "separator", NULL, NULL, itemSitesMenu,   "true", NULL, NULL, true, NULL },
-    { "im.itemAvailabilityWorkbench",   tr("&Workbench..."),    SLOT(sDspItemAvailabilityWorkbench()),  itemSitesMenu, "ViewItemAvailabilityWorkbench", new QPixmap(":/images/itemAvailabilityWorkbench.png"), toolBar, true, tr("Item Availability Workbench") },
+    { "im.itemAvailabilityWorkbench",   tr("&Workbench..."),    SLOT(sDspItemAvailabilityWorkbench()),  itemSitesMenu, "ViewItemAvailabilityWorkbench", ":/images/itemAvailabilityWorkbench.png", toolBar, true, tr("Item Availability Workbench") },
 
     //  Inventory | Lot/Serial Control
     { "menu",                           tr("&Lot/Serial Control"),      (char*)lotSerialControlMenu,    mainMenu, "true",       NULL, NULL, _metrics->boolean("LotSerialControl") , NULL },
@@ -449,7 +448,7 @@ void menuInventory::addActionsToMenu(actionProperties acts[], unsigned int numEl
                   acts[i].slot,
                   acts[i].menu,
                   acts[i].priv,
-                  (acts[i].pixmap),
+                  QIcon(acts[i].pixmap),
                   acts[i].toolBar,
                   acts[i].toolTip) ;
     }
@@ -462,7 +461,7 @@ void menuInventory::addActionsToMenu(actionProperties acts[], unsigned int numEl
                   acts[i].slot,
                   acts[i].menu,
                   acts[i].priv,
-                  (acts[i].pixmap),
+                  QIcon(acts[i].pixmap),
                   acts[i].toolBar,
                   acts[i].actionTitle) ;
     }
@@ -28,7 +28,7 @@ class menuInventory : public QObject
     const char*		slot;
     QMenu*		menu;
     QString		priv;
-    QPixmap*		pixmap;
+    const char*		pixmap;
     QToolBar*		toolBar;
     bool		visible;
     const QString   toolTip;
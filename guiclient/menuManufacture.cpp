@@ -156,7 +156,7 @@ menuManufacture::menuManufacture(GUIClient *Pparent) :
     { "menu",                           tr("&Reports"), (char*)reportsMenu,     mainMenu,       "true", 0, 0,   true, NULL },
     
     //  Production | Reports | Schedule
-    { "wo.dspWoSchedule",  tr("Work Order &Schedule"), SLOT(sDspWoSchedule()),reportsMenu, "MaintainWorkOrders ViewWorkOrders", new QPixmap(":/images/dspWoScheduleByPlannerCode.png"), toolBar, true, tr("Work Order Schedule by Planner Code") },
+    { "wo.dspWoSchedule",  tr("Work Order &Schedule"), SLOT(sDspWoSchedule()),reportsMenu, "MaintainWorkOrders ViewWorkOrders", ":/images/dspWoScheduleByPlannerCode.png", toolBar, true, tr("Work Order Schedule by Planner Code") },
 
     //  Production | Reports | Material Requirements
     { "menu",                                       tr("&Material Requirements"),(char*)reportsMatlReqMenu,              reportsMenu,        "true",                              0, 0, true, NULL },
@@ -223,7 +223,7 @@ void menuManufacture::addActionsToMenu(actionProperties acts[], unsigned int num
                   acts[i].slot,
                   acts[i].menu,
                   acts[i].priv,
-                  (acts[i].pixmap),
+                  QIcon(acts[i].pixmap),
                   acts[i].toolBar,
                   acts[i].toolTip) ;
     }
@@ -236,7 +236,7 @@ void menuManufacture::addActionsToMenu(actionProperties acts[], unsigned int num
                   acts[i].slot,
                   acts[i].menu,
                   acts[i].priv,
-                  (acts[i].pixmap),
+                  QIcon(acts[i].pixmap),
                   acts[i].toolBar,
                   acts[i].actionTitle) ;
     }
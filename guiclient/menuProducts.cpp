@@ -11,7 +11,6 @@
 #include <QAction>
 #include <QMenuBar>
 #include <QStatusBar>
-#include <QPixmap>
 #include <QMenu>
 #include <QToolBar>
 
@@ -146,7 +145,7 @@ menuProducts::menuProducts(GUIClient *Pparent) :
   // Product | Items
   { "menu",	tr("&Item"), (char*)itemsMenu,	mainMenu, "true", NULL, NULL, true , NULL },
   { "pd.enterNewItem", tr("&New..."), SLOT(sNewItem()), itemsMenu, "MaintainItemMasters", NULL, NULL, true , NULL },
-  { "pd.listItems", tr("&List..."), SLOT(sItems()), itemsMenu, "MaintainItemMasters ViewItemMasters", new QPixmap(":/images/items.png"), toolBar, true , tr("List Items") },
+  { "pd.listItems", tr("&List..."), SLOT(sItems()), itemsMenu, "MaintainItemMasters ViewItemMasters", ":/images/items.png", toolBar, true , tr("List Items") },
   { "pd.copyItem", tr("&Copy..."), SLOT(sCopyItem()), itemsMenu, "MaintainItemMasters" , NULL, NULL, true, NULL },
   { "separator", NULL, NULL, itemsMenu,	"true", NULL, NULL, true , NULL },
   { "pd.itemAvailabilityWorkbench", tr("&Workbench..."), SLOT(sDspItemAvailabilityWorkbench()), itemsMenu, "ViewItemAvailabilityWorkbench", NULL, NULL, true , NULL },
@@ -157,7 +156,7 @@ menuProducts::menuProducts(GUIClient *Pparent) :
   // Product | Bill of Materials
   { "menu",	tr("Bill Of Ma&terials"), (char*)bomMenu,	mainMenu, "true", NULL, NULL, true , NULL },
   { "pd.enterNewBOM", tr("&New..."), SLOT(sNewBOM()), bomMenu, "MaintainBOMs", NULL, NULL, true , NULL },
-  { "pd.listBOMs", tr("&List..."), SLOT(sBOMs()), bomMenu, "MaintainBOMs ViewBOMs", new QPixmap(":/images/boms.png"), toolBar, true , tr("List Bill of Materials") },
+  { "pd.listBOMs", tr("&List..."), SLOT(sBOMs()), bomMenu, "MaintainBOMs ViewBOMs", ":/images/boms.png", toolBar, true , tr("List Bill of Materials") },
   { "pd.copyBOM", tr("&Copy..."), SLOT(sCopyBOM()), bomMenu, "MaintainBOMs", NULL, NULL, true , NULL },
   { "separator", NULL, NULL, bomMenu,	"true", NULL, NULL, true , NULL },
   { "pd.massReplaceComponentItem", tr("Mass &Replace..."), SLOT(sMassReplaceComponent()), bomMenu, "MaintainBOMs", NULL, NULL, true , NULL },
@@ -255,7 +254,7 @@ void menuProducts::addActionsToMenu(actionProperties acts[], unsigned int numEle
                   acts[i].slot,
                   acts[i].menu,
                   acts[i].priv,
-                  (acts[i].pixmap),
+                  QIcon(acts[i].pixmap),
                   acts[i].toolBar,
                   acts[i].toolTip) ;
     }
@@ -268,7 +267,7 @@ void menuProducts::addActionsToMenu(actionProperties acts[], unsigned int numEle
                   acts[i].slot,
                   acts[i].menu,
                   acts[i].priv,
-                  (acts[i].pixmap),
+                  QIcon(acts[i].pixmap),
                   acts[i].toolBar,
                   acts[i].actionTitle) ;
     }
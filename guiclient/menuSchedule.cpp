@@ -11,7 +11,6 @@
 #include <QAction>
 #include <QMenuBar>
 #include <QStatusBar>
-#include <QPixmap>
 #include <QMenu>
 #include <QToolBar>
 
@@ -69,7 +68,7 @@ menuSchedule::menuSchedule(GUIClient *Pparent) :
  
     // Schedule | Schedule | MRP
     { "menu",	tr("Run &MRP"), (char*)plannedOrdersMrpMenu,	plannedOrdersMenu,	"true",	NULL, NULL, true	, NULL },
-    { "ms.runMRPByPlannerCode", tr("by &Planner Code..."), SLOT(sCreatePlannedReplenOrdersByPlannerCode()), plannedOrdersMrpMenu, "CreatePlannedOrders", new QPixmap(":/images/runMrpByPlannerCode.png"), toolBar, true , tr("Run MRP by Planner Code") },
+    { "ms.runMRPByPlannerCode", tr("by &Planner Code..."), SLOT(sCreatePlannedReplenOrdersByPlannerCode()), plannedOrdersMrpMenu, "CreatePlannedOrders", ":/images/runMrpByPlannerCode.png", toolBar, true , tr("Run MRP by Planner Code") },
     { "ms.runMRPByItem", tr("by &Item..."), SLOT(sCreatePlannedReplenOrdersByItem()), plannedOrdersMrpMenu, "CreatePlannedOrders", NULL, NULL, true , NULL },
     
     { "separator", NULL, NULL, plannedOrdersMenu, "true", NULL, NULL, true , NULL },
@@ -84,7 +83,7 @@ menuSchedule::menuSchedule(GUIClient *Pparent) :
     { "menu",	tr("&Reports"), (char*)reportsMenu, mainMenu, "true", NULL, NULL, true , NULL },
   
     // Schedule | Report | Planned Orders
-    { "ms.dspPlannedOrders", tr("Planned &Orders..."), SLOT(sDspPlannedOrders()), reportsMenu, "ViewPlannedOrders", new QPixmap(":/images/dspPlannedOrdersByPlannerCode.png"), toolBar, true , tr("Planned Orders") },
+    { "ms.dspPlannedOrders", tr("Planned &Orders..."), SLOT(sDspPlannedOrders()), reportsMenu, "ViewPlannedOrders", ":/images/dspPlannedOrdersByPlannerCode.png", toolBar, true , tr("Planned Orders") },
 
     { "separator", NULL, NULL, reportsMenu, "true", NULL, NULL, true , NULL },
     { "ms.dspRunningAvailability", tr("&Running Availability..."), SLOT(sDspRunningAvailability()), reportsMenu, "ViewInventoryAvailability", NULL, NULL, true , NULL },
@@ -130,7 +129,7 @@ void menuSchedule::addActionsToMenu(actionProperties acts[], unsigned int numEle
                   acts[i].slot,
                   acts[i].menu,
                   acts[i].priv,
-                  (acts[i].pixmap),
+                  QIcon(acts[i].pixmap),
                   acts[i].toolBar,
                   acts[i].toolTip) ;
     }
@@ -143,7 +142,7 @@ void menuSchedule::addActionsToMenu(actionProperties acts[], unsigned int numEle
                   acts[i].slot,
                   acts[i].menu,
                   acts[i].priv,
-                  (acts[i].pixmap),
+                  QIcon(acts[i].pixmap),
                   acts[i].toolBar,
                   acts[i].actionTitle) ;
     }
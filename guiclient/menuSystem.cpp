@@ -15,7 +15,6 @@
 #include <QMenu>
 #include <QMenuBar>
 #include <QMessageBox>
-#include <QPixmap>
 #include <QPluginLoader>
 #include <QToolBar>
 #include <QMdiArea>
@@ -44,6 +43,7 @@
 #include "userPreferences.h"
 #include "hotkeys.h"
 #include "errorLog.h"
+#include "queryStatistics.h"
 
 #include "customCommands.h"
 #include "employee.h"
@@ -104,6 +104,7 @@ menuSystem::menuSystem(GUIClient *Pparent) :
 
     { "sys.eventManager",             tr("E&vent Manager..."),              SLOT(sEventManager()),             systemMenu, "true",                                      NULL, NULL, true },
     { "sys.viewDatabaseLog",          tr("View Database &Log..."),          SLOT(sErrorLog()),                 systemMenu, "true",                                      NULL, NULL, true },
+    { "sys.queryStatistics",          tr("&Query Statistics..."),           SLOT(sQueryStatistics()),          systemMenu, "true",                                      NULL, NULL, true },
     { "separator",                    NULL,                                 NULL,                              systemMenu, "true",                                      NULL, NULL, true },
     { "sys.preferences",              tr("&Preferences..."),                SLOT(sPreferences()),              systemMenu, "MaintainPreferencesSelf MaintainPreferencesOthers",  NULL,   NULL,   true },
     { "sys.hotkeys",                  tr("&Hot Keys..."),                   SLOT(sHotKeys()),                  systemMenu, "true",  NULL,   NULL,   !(_privileges->check("MaintainPreferencesSelf") || _privileges->check("MaintainPreferencesOthers")) },
@@ -205,7 +206,7 @@ void menuSystem::addActionsToMenu(actionProperties acts[], unsigned int numElems
                   acts[i].slot,
                   acts[i].menu,
                   acts[i].priv,
-                  (acts[i].pixmap),
+                  QIcon(acts[i].pixmap),
                   acts[i].toolBar) ;
     }
     else
@@ -337,6 +338,11 @@ void menuSystem::sErrorLog()
   omfgThis->handleNewWindow(new errorLog());
 }
 
+void menuSystem::sQueryStatistics()
+{
+  omfgThis->handleNewWindow(new queryStatistics());
+}
+
 void menuSystem::sPrintAlignment()
 {
   orReport report("Alignment");
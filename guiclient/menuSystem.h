@@ -12,10 +12,8 @@
 #define menuSystem_h
 
 #include <QObject>
-#include <QPixmap>
 
 class QMenu;
-class QPixmap;
 class QToolBar;
 class GUIClient;
 class Action;
@@ -30,7 +28,7 @@ class menuSystem : public QObject
     const char*		slot;
     QMenu*		menu;
     QString		priv;
-    QPixmap*		pixmap;
+    const char*		pixmap;
     QToolBar*		toolBar;
     bool		visible;
   };
@@ -53,6 +51,7 @@ class menuSystem : public QObject
     void sSearchEmployees();
     void sEmployeeGroups();
     void sErrorLog();
+    void sQueryStatistics();
 
     void sCustomCommands();
     void sScripts();
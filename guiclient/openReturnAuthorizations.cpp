@@ -19,6 +19,7 @@
 #include <metasql.h>
 
 #include "mqlutil.h"
+#include "refreshscheduler.h"
 #include "returnAuthorization.h"
 #include "openReturnAuthorizations.h"
 #include "printRaForm.h"
@@ -60,7 +61,7 @@ openReturnAuthorizations::openReturnAuthorizations(QWidget* parent, const char*
     connect(_ra, SIGNAL(itemSelected(int)), _view, SLOT(animateClick()));
   }
 
-  connect(omfgThis, SIGNAL(returnAuthorizationsUpdated()), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(returnAuthorizationsUpdated()), this, SLOT(sFillList()));
 }
 
 openReturnAuthorizations::~openReturnAuthorizations()
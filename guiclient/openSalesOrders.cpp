@@ -22,6 +22,7 @@
 #include "issueToShipping.h"
 #include "printPackingList.h"
 #include "printSoForm.h"
+#include "refreshscheduler.h"
 #include "salesOrder.h"
 #include "storedProcErrorLookup.h"
 #include "parameterwidget.h"
@@ -99,7 +100,7 @@ openSalesOrders::openSalesOrders(QWidget* parent, const char*, Qt::WindowFlags f
     connect(list(), SIGNAL(itemSelected(int)), this, SLOT(sView()));
   }
 
-  connect(omfgThis, SIGNAL(salesOrdersUpdated(int, bool)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(salesOrdersUpdated(int, bool)), this, SLOT(sFillList()));
   connect(_showClosed, SIGNAL(toggled(bool)), this, SLOT(sFillList()));
 }
 
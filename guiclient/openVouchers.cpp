@@ -25,6 +25,7 @@
 #include "failedPostList.h"
 #include "getGLDistDate.h"
 #include "miscVoucher.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 #include "voucher.h"
 
@@ -71,7 +72,7 @@ openVouchers::openVouchers(QWidget* parent, const char* name, Qt::WindowFlags fl
   if (_privileges->check("PostVouchers"))
     connect(_vohead, SIGNAL(valid(bool)), _post, SLOT(setEnabled(bool)));
 
-  connect(omfgThis, SIGNAL(vouchersUpdated()), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(vouchersUpdated()), this, SLOT(sFillList()));
 
   sFillList();
 }
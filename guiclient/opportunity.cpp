@@ -19,6 +19,7 @@
 #include <openreports.h>
 
 #include "errorReporter.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 #include "todoItem.h"
 #include "salesOrder.h"
@@ -80,8 +81,8 @@ opportunity::opportunity(QWidget* parent, const char* name, bool modal, Qt::Wind
   connect(_printSale, SIGNAL(clicked()), this, SLOT(sPrintSale()));
   connect(_salesList, SIGNAL(populateMenu(QMenu*,QTreeWidgetItem*)), this, SLOT(sPopulateSalesMenu(QMenu*)));
   connect(_salesList, SIGNAL(valid(bool)), this, SLOT(sHandleSalesPrivs()));
-  connect(omfgThis,	SIGNAL(quotesUpdated(int, bool)), this, SLOT(sFillSalesList()));
-  connect(omfgThis,	SIGNAL(salesOrdersUpdated(int, bool)), this, SLOT(sFillSalesList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(quotesUpdated(int, bool)), this, SLOT(sFillSalesList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(salesOrdersUpdated(int, bool)), this, SLOT(sFillSalesList()));
   connect(_assignedTo, SIGNAL(newId(int)), this, SLOT(sHandleAssigned()));
 
   _probability->setValidator(new QIntValidator(this));
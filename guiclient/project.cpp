@@ -22,6 +22,7 @@
 #include "mqlutil.h"
 #include "errorReporter.h"
 #include "guiErrorCheck.h"
+#include "refreshscheduler.h"
 #include "task.h"
 #include "salesOrder.h"
 #include "salesOrderItem.h"
@@ -98,10 +99,10 @@ project::project(QWidget* parent, const char* name, bool modal, Qt::WindowFlags
   connect(_showWo, SIGNAL(toggled(bool)), this, SLOT(sFillTaskList()));
   connect(_showIn, SIGNAL(toggled(bool)), this, SLOT(sFillTaskList()));
 
-  connect(omfgThis, SIGNAL(salesOrdersUpdated(int, bool)), this, SLOT(sFillTaskList()));
-  connect(omfgThis, SIGNAL(quotesUpdated(int, bool)), this, SLOT(sFillTaskList()));
-  connect(omfgThis, SIGNAL(workOrdersUpdated(int, bool)), this, SLOT(sFillTaskList()));
-  connect(omfgThis, SIGNAL(purchaseOrdersUpdated(int, bool)), this, SLOT(sFillTaskList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(salesOrdersUpdated(int, bool)), this, SLOT(sFillTaskList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(quotesUpdated(int, bool)), this, SLOT(sFillTaskList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(workOrdersUpdated(int, bool)), this, SLOT(sFillTaskList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(purchaseOrdersUpdated(int, bool)), this, SLOT(sFillTaskList()));
 
   _charass->setType("PROJ");
 
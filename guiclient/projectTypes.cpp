@@ -14,6 +14,7 @@
 #include "projectType.h"
 #include "errorReporter.h"
 #include "guiclient.h"
+#include "refreshscheduler.h"
 
 projectTypes::projectTypes(QWidget* parent, const char* name, Qt::WindowFlags fl)
   : XWidget(parent, name, fl)
@@ -42,7 +43,7 @@ projectTypes::projectTypes(QWidget* parent, const char* name, Qt::WindowFlags fl
     _new->setEnabled(false);
   }
 
-  connect(omfgThis, SIGNAL(itemGroupsUpdated(int, bool)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(itemGroupsUpdated(int, bool)), this, SLOT(sFillList()));
 
   sFillList();
 }
@@ -22,6 +22,7 @@
 
 #include "parameterwidget.h"
 #include "project.h"
+#include "refreshscheduler.h"
 #include "task.h"
 #include "salesOrder.h"
 #include "salesOrderItem.h"
@@ -77,7 +78,7 @@ projects::projects(QWidget* parent, const char*, Qt::WindowFlags fl)
   _incidents->setChecked(false);
   _showHierarchy->setChecked(false);
 
-  connect(omfgThis, SIGNAL(projectsUpdated(int)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(projectsUpdated(int)), this, SLOT(sFillList()));
   connect(_showComplete, SIGNAL(toggled(bool)), this, SLOT(sFillList()));
 
   _ordersGroup->hide();
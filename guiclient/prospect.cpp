@@ -23,6 +23,7 @@
 #include "errorReporter.h"
 #include "guiErrorCheck.h"
 #include "printQuote.h"
+#include "refreshscheduler.h"
 #include "salesOrder.h"
 #include "storedProcErrorLookup.h"
 
@@ -40,7 +41,7 @@ prospect::prospect(QWidget* parent, const char* name, Qt::WindowFlags fl)
   connect(_quotes,	SIGNAL(populateMenu(QMenu*,QTreeWidgetItem*)),	this,	SLOT(sPopulateQuotesMenu(QMenu*)));
   connect(_save,	SIGNAL(clicked()),	this,	SLOT(sSave()));
   connect(_viewQuote,	SIGNAL(clicked()),	this,	SLOT(sViewQuote()));
-  connect(omfgThis,	SIGNAL(quotesUpdated(int, bool)), this, SLOT(sFillQuotesList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(quotesUpdated(int, bool)), this, SLOT(sFillQuotesList()));
 
   if (_privileges->check("MaintainQuotes"))
     connect(_quotes, SIGNAL(itemSelected(int)), _editQuote, SLOT(animateClick()));
@@ -19,6 +19,7 @@
 #include "errorReporter.h"
 #include "parameterwidget.h"
 #include "prospect.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 
 prospects::prospects(QWidget* parent, const char*, Qt::WindowFlags fl)
@@ -63,7 +64,7 @@ prospects::prospects(QWidget* parent, const char*, Qt::WindowFlags fl)
   list()->addColumn(tr("Country"), 100, Qt::AlignLeft  , false, "addr_country" );
   list()->addColumn(tr("Postal Code"), 75, Qt::AlignLeft  , false, "addr_postalcode" );
 
-  connect(omfgThis, SIGNAL(prospectsUpdated()), SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(prospectsUpdated()), this, SLOT(sFillList()));
 }
 
 void prospects::sNew()
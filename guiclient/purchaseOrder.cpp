@@ -26,6 +26,7 @@
 #include "poitemTableModel.h"
 #include "printPurchaseOrder.h"
 #include "purchaseOrderItem.h"
+#include "querybatch.h"
 #include "vendorAddressList.h"
 #include "taxBreakdown.h"
 #include "salesOrder.h"
@@ -35,6 +36,25 @@
 #define cDelete 0x01
 #define cClose  0x02
 
+static const char *totalsSql =
+             "SELECT SUM(poitem_qty_ordered * poitem_unitprice) AS total,"
+             "       SUM(poitem_qty_ordered * poitem_unitprice) AS f_total,"
+             "       SUM(poitem_freight) AS freightsub, "
+             "       SUM(poitem_qty_ordered) AS qtyord_total, "
+             "       SUM(poitem_qty_ordered * (item_prodweight + item_packweight)) AS wt_total "
+             "FROM poitem "
+             "  LEFT OUTER JOIN itemsite ON poitem_itemsite_id = itemsite_id "
+             "  LEFT OUTER JOIN item ON itemsite_item_id = item_id "
+             "WHERE (poitem_pohead_id=:pohead_id);";
+
+static const char *taxSql =
+                "SELECT SUM(tax) AS tax "
+                "FROM ("
+                "SELECT ROUND(SUM(taxdetail_tax),2) AS tax "
+                "FROM tax "
+                " JOIN calculateTaxDetailSummary('PO', :pohead_id, 'T') ON (taxdetail_tax_id=tax_id)"
+                "GROUP BY tax_id) AS data;";
+
 purchaseOrder::purchaseOrder(QWidget* parent, const char* name, Qt::WindowFlags fl)
     : XWidget(parent, name, fl)
 {
@@ -1319,8 +1339,26 @@ void purchaseOrder::sFillList()
     return;
   }
 
-  sCalculateTax();
-  sCalculateTotals();
+  // the tax and the totals are read in one round trip. setting the tax
+  // would normally recalculate the totals, so hold that until both are in.
+  QueryBatch batch;
+  int taxStmt = -1;
+  if (_vendor->isValid() && saveDetail())
+  {
+    taxStmt = batch.add(taxSql);
+    batch.bindValue(taxStmt, ":pohead_id", _poheadid);
+  }
+  int totalsStmt = batch.add(totalsSql);
+  batch.bindValue(totalsStmt, ":pohead_id", _poheadid);
+  batch.exec();
+
+  if (taxStmt >= 0)
+  {
+    disconnect(_tax, SIGNAL(valueChanged()), this, SLOT(sCalculateTotals()));
+    showTax(batch.result(taxStmt));
+    connect(_tax, SIGNAL(valueChanged()), this, SLOT(sCalculateTotals()));
+  }
+  showTotals(batch.result(totalsStmt));
 
   _poCurrency->setEnabled(_poitem->topLevelItemCount() == 0);
   _qecurrency->setEnabled(_poitem->topLevelItemCount() == 0);
@@ -1330,25 +1368,22 @@ void purchaseOrder::sFillList()
 
 void purchaseOrder::sCalculateTotals()
 {
-  XSqlQuery purchaseCalculateTotals;
-  purchaseCalculateTotals.prepare( "SELECT SUM(poitem_qty_ordered * poitem_unitprice) AS total,"
-             "       SUM(poitem_qty_ordered * poitem_unitprice) AS f_total,"
-             "       SUM(poitem_freight) AS freightsub, "
-             "       SUM(poitem_qty_ordered) AS qtyord_total, "
-             "       SUM(poitem_qty_ordered * (item_prodweight + item_packweight)) AS wt_total "
-             "FROM poitem "
-             "  LEFT OUTER JOIN itemsite ON poitem_itemsite_id = itemsite_id "
-             "  LEFT OUTER JOIN item ON itemsite_item_id = item_id "
-             "WHERE (poitem_pohead_id=:pohead_id);" );
-  purchaseCalculateTotals.bindValue(":pohead_id", _poheadid);
-  purchaseCalculateTotals.exec();
-  if (purchaseCalculateTotals.first())
+  QueryBatch batch;
+  int totalsStmt = batch.add(totalsSql);
+  batch.bindValue(totalsStmt, ":pohead_id", _poheadid);
+  batch.exec();
+  showTotals(batch.result(totalsStmt));
+}
+
+void purchaseOrder::showTotals(QueryBatchResult &totals)
+{
+  if (totals.first())
   {
-    _totalQtyOrd->setLocalValue(purchaseCalculateTotals.value("qtyord_total").toDouble());
-    _totalWeight->setLocalValue(purchaseCalculateTotals.value("wt_total").toDouble());
-    _subtotal->setLocalValue(purchaseCalculateTotals.value("f_total").toDouble());
-    _totalFreight->setLocalValue(purchaseCalculateTotals.value("freightsub").toDouble() + _freight->localValue());
-    _total->setLocalValue(purchaseCalculateTotals.value("total").toDouble() + _tax->localValue() + purchaseCalculateTotals.value("freightsub").toDouble() + _freight->localValue());
+    _totalQtyOrd->setLocalValue(totals.value("qtyord_total").toDouble());
+    _totalWeight->setLocalValue(totals.value("wt_total").toDouble());
+    _subtotal->setLocalValue(totals.value("f_total").toDouble());
+    _totalFreight->setLocalValue(totals.value("freightsub").toDouble() + _freight->localValue());
+    _total->setLocalValue(totals.value("total").toDouble() + _tax->localValue() + totals.value("freightsub").toDouble() + _freight->localValue());
   }
 }
 
@@ -1636,20 +1671,20 @@ void purchaseOrder::sCalculateTax()
   if (!saveDetail())
     return;
 
-  XSqlQuery taxq;
-  taxq.prepare( "SELECT SUM(tax) AS tax "
-                "FROM ("
-                "SELECT ROUND(SUM(taxdetail_tax),2) AS tax "
-                "FROM tax "
-                " JOIN calculateTaxDetailSummary('PO', :pohead_id, 'T') ON (taxdetail_tax_id=tax_id)"
-                "GROUP BY tax_id) AS data;" );
-  taxq.bindValue(":pohead_id", _poheadid);
-  taxq.exec();
-  if (taxq.first())
-    _tax->setLocalValue(taxq.value("tax").toDouble());
-  else if (ErrorReporter::error(QtCriticalMsg, this, tr("Calculating P/O Tax"),
-                                    taxq, __FILE__, __LINE__))
-        return;
+  QueryBatch batch;
+  int taxStmt = batch.add(taxSql);
+  batch.bindValue(taxStmt, ":pohead_id", _poheadid);
+  batch.exec();
+  showTax(batch.result(taxStmt));
+}
+
+void purchaseOrder::showTax(QueryBatchResult &tax)
+{
+  if (tax.first())
+    _tax->setLocalValue(tax.value("tax").toDouble());
+  else
+    ErrorReporter::error(QtCriticalMsg, this, tr("Calculating P/O Tax"),
+                         tax.lastError(), __FILE__, __LINE__);
 }
 
 void purchaseOrder::sTaxDetail()
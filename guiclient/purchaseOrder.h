@@ -20,6 +20,7 @@
 #include "ui_purchaseOrder.h"
 
 class PoitemTableModel;
+class QueryBatchResult;
 
 class purchaseOrder : public XWidget, public Ui::purchaseOrder
 {
@@ -81,6 +82,8 @@ signals:
 
 private:
     void setPoheadid(const int);
+    void showTax(QueryBatchResult &tax);
+    void showTotals(QueryBatchResult &totals);
     bool _captive;
     bool _userOrderNumber;
     bool _useWarehouseFOB;
@@ -0,0 +1,132 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#include "queryStatistics.h"
+
+#include <QFileDialog>
+#include <QMessageBox>
+
+#include "queryprofiler.h"
+#include "refreshscheduler.h"
+
+queryStatistics::queryStatistics(QWidget* parent, const char * name, Qt::WindowFlags flags)
+    : XWidget(parent, name, flags)
+{
+  setupUi(this);
+
+  QueryProfiler *profiler = QueryProfiler::instance();
+
+  _list->setRootIsDecorated(true);
+  _list->addColumn(tr("Window / Statement"), -1,            Qt::AlignLeft,  true, "context");
+  _list->addColumn(tr("Round Trips"),   _qtyColumn,         Qt::AlignRight, true, "roundtrips");
+  _list->addColumn(tr("Distinct Binds"),_qtyColumn,         Qt::AlignRight, true, "binds");
+  _list->addColumn(tr("Round Trip (ms)"),_qtyColumn,        Qt::AlignRight, true, "msec");
+  _list->addColumn(tr("Rows"),          _qtyColumn,         Qt::AlignRight, true, "rows");
+  _list->addColumn(tr("Repeated"),      _ynColumn,          Qt::AlignCenter,true, "nplusone");
+
+  _record->setChecked(profiler->isEnabled());
+  _threshold->setValue(profiler->nPlusOneThreshold());
+
+  connect(_record,      SIGNAL(toggled(bool)),    profiler, SLOT(setEnabled(bool)));
+  connect(_threshold,   SIGNAL(valueChanged(int)),profiler, SLOT(setNPlusOneThreshold(int)));
+  connect(_clear,       SIGNAL(clicked()),        profiler, SLOT(reset()));
+  connect(_clear,       SIGNAL(clicked()),        this,     SLOT(sClear()));
+  connect(_export,      SIGNAL(clicked()),        this,     SLOT(sExport()));
+  connect(_nPlusOneOnly,SIGNAL(toggled(bool)),    this,     SLOT(sFillList()));
+  connect(profiler,     SIGNAL(updated()),        this,     SLOT(sFillList()));
+
+  sFillList();
+}
+
+queryStatistics::~queryStatistics()
+{
+  // no need to delete child widgets, Qt does it all for us
+}
+
+void queryStatistics::languageChange()
+{
+  retranslateUi(this);
+}
+
+void queryStatistics::sFillList()
+{
+  QueryProfiler *profiler = QueryProfiler::instance();
+  int            threshold = profiler->nPlusOneThreshold();
+
+  // keep the user's place while the list refreshes under them
+  QStringList expanded;
+  for (int i = 0; i < _list->topLevelItemCount(); i++)
+    if (_list->topLevelItem(i)->isExpanded())
+      expanded << _list->topLevelItem(i)->text(0);
+
+  _list->clear();
+
+  int id = 0;
+  foreach (QueryProfiler::ContextStats ctx, profiler->contexts())
+  {
+    QList<QueryProfiler::StatementStats> stmts = _nPlusOneOnly->isChecked()
+                                               ? profiler->nPlusOne(ctx.context)
+                                               : ctx.statements;
+    if (stmts.isEmpty() && _nPlusOneOnly->isChecked())
+      continue;
+
+    bool repeated = ! profiler->nPlusOne(ctx.context).isEmpty();
+    XTreeWidgetItem *parent = new XTreeWidgetItem(_list, ++id,
+                                                  ctx.context, ctx.roundTrips,
+                                                  QVariant(), ctx.usec / 1000.0,
+                                                  ctx.rows,
+                                                  repeated ? tr("Yes") : QString());
+    if (repeated)
+      parent->setTextColor("red");
+
+    foreach (QueryProfiler::StatementStats stmt, stmts)
+    {
+      XTreeWidgetItem *child = new XTreeWidgetItem(parent, ++id,
+                                                   stmt.sql.left(250), stmt.calls,
+                                                   stmt.distinctBinds, stmt.usec / 1000.0,
+                                                   stmt.rows,
+                                                   stmt.distinctBinds >= threshold ? tr("Yes") : QString());
+      child->setToolTip(0, stmt.sql);
+      if (stmt.distinctBinds >= threshold)
+        child->setTextColor("red");
+    }
+
+    parent->setExpanded(expanded.contains(ctx.context));
+  }
+
+  QVariantMap refreshes = RefreshScheduler::statistics();
+  _refreshes->setText(tr("Window refreshes: %1 update signals received, "
+                         "%2 ignored by id, %3 refreshes run, %4 saved, "
+                         "%5 deferred while hidden")
+                      .arg(refreshes.value("signalsReceived").toLongLong())
+                      .arg(refreshes.value("signalsFiltered").toLongLong())
+                      .arg(refreshes.value("refreshesRun").toLongLong())
+                      .arg(refreshes.value("refreshesSaved").toLongLong())
+                      .arg(refreshes.value("refreshesHidden").toLongLong()));
+}
+
+void queryStatistics::sClear()
+{
+  RefreshScheduler::resetStatistics();
+  sFillList();
+}
+
+void queryStatistics::sExport()
+{
+  QString filename = QFileDialog::getSaveFileName(this, tr("Export Query Trace"),
+                                                  QString("querytrace.json"),
+                                                  tr("Trace Files (*.json)"));
+  if (filename.isEmpty())
+    return;
+
+  QString errmsg;
+  if (! QueryProfiler::instance()->exportTrace(filename, &errmsg))
+    QMessageBox::critical(this, tr("Export Failed"), errmsg);
+}
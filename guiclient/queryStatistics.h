@@ -0,0 +1,35 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#ifndef QUERYSTATISTICS_H
+#define QUERYSTATISTICS_H
+
+#include "xwidget.h"
+
+#include "ui_queryStatistics.h"
+
+class queryStatistics : public XWidget, public Ui::queryStatistics
+{
+    Q_OBJECT
+
+public:
+    queryStatistics(QWidget* parent = 0, const char * = 0, Qt::WindowFlags flags = 0);
+    ~queryStatistics();
+
+public slots:
+    virtual void sFillList();
+
+protected slots:
+    virtual void languageChange();
+    virtual void sClear();
+    virtual void sExport();
+};
+
+#endif // QUERYSTATISTICS_H
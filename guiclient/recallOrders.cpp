@@ -17,6 +17,7 @@
 #include <metasql.h>
 #include <parameter.h>
 #include "mqlutil.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 #include "errorReporter.h"
 
@@ -27,7 +28,7 @@ recallOrders::recallOrders(QWidget* parent, const char* name, Qt::WindowFlags fl
 
   connect(_query,      SIGNAL(clicked()),                  this, SLOT(sFillList()));
   connect(_recall,	   SIGNAL(clicked()),	                 this, SLOT(sRecall()));
-  connect(omfgThis,    SIGNAL(invoicesUpdated(int, bool)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(invoicesUpdated(int, bool)), this, SLOT(sFillList()));
 
   _showInvoiced->setEnabled(_privileges->check("RecallInvoicedShipment"));
   
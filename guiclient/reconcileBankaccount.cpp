@@ -23,6 +23,7 @@
 #include "mqlutil.h"
 #include "bankAdjustment.h"
 #include "importData.h"
+#include "refreshscheduler.h"
 #include "toggleBankrecCleared.h"
 #include "storedProcErrorLookup.h"
 #include "errorReporter.h"
@@ -91,10 +92,10 @@ reconcileBankaccount::reconcileBankaccount(QWidget* parent, const char* name, Qt
   
     _import->setVisible(_metrics->boolean("ImportBankReconciliation"));
   
-    connect(omfgThis, SIGNAL(bankAdjustmentsUpdated(int, bool)), this, SLOT(populate()));
-    connect(omfgThis, SIGNAL(checksUpdated(int, int, bool)), this, SLOT(populate()));
-    connect(omfgThis, SIGNAL(cashReceiptsUpdated(int, bool)), this, SLOT(populate()));
-    connect(omfgThis, SIGNAL(glSeriesUpdated()), this, SLOT(populate()));
+    RefreshScheduler::connect(omfgThis, SIGNAL(bankAdjustmentsUpdated(int, bool)), this, SLOT(populate()));
+    RefreshScheduler::connect(omfgThis, SIGNAL(checksUpdated(int, int, bool)), this, SLOT(populate()));
+    RefreshScheduler::connect(omfgThis, SIGNAL(cashReceiptsUpdated(int, bool)), this, SLOT(populate()));
+    RefreshScheduler::connect(omfgThis, SIGNAL(glSeriesUpdated()), this, SLOT(populate()));
 }
 
 reconcileBankaccount::~reconcileBankaccount()
@@ -0,0 +1,375 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#include "refreshscheduler.h"
+
+#include <QEvent>
+#include <QMetaObject>
+#include <QSqlError>
+#include <QStringList>
+#include <QTimer>
+#include <QTreeWidgetItemIterator>
+#include <QWidget>
+
+#include <xsqlquery.h>
+
+#include "xtreewidget.h"
+
+#define DEBUG false
+
+/** @class RefreshScheduler
+
+    @brief Turns bursts of global update signals into a single refresh of
+           the window listening to them.
+
+    Windows usually connect GUIClient's update signals, such as
+    workOrdersUpdated(int, bool), straight to their sFillList() slot. A
+    batch that posts hundreds of records then re-runs the window's query
+    once per record, and does so even when the window is minimized or
+    hidden behind another tab. Connect through RefreshScheduler instead:
+
+    @code
+    RefreshScheduler::connect(omfgThis, SIGNAL(workOrdersUpdated(int, bool)),
+                              this, SLOT(sFillList()));
+    @endcode
+
+    The signals are collected for delay() milliseconds and the slot is
+    called once. If the window is not showing at that point, the refresh
+    waits until the window is shown or restored. Every signal connected to
+    the same receiver and slot shares one scheduler, so a window listening
+    to several related signals still refreshes only once per burst.
+
+    A window that displays a known set of records can ignore updates to
+    other records with setIds() or setIdList(). Updates that carry no id,
+    or an id of -1 or less, always cause a refresh. setIds(int) is a slot,
+    so the filter can follow a cluster's selection:
+
+    @code
+    RefreshScheduler *refresh =
+      RefreshScheduler::connect(omfgThis, SIGNAL(bomsUpdated(int, bool)),
+                                this, SLOT(sFillList()));
+    refresh->setIds(_item->id());
+    connect(_item, SIGNAL(newId(int)), refresh, SLOT(setIds(int)));
+    @endcode
+
+    When the signal's id is not the kind of record the window is keyed on,
+    such as a work order id arriving at a window that lists item sites,
+    setIdQuery() maps one to the other on the server once per burst.
+
+    statistics() reports how many signals arrived and how many refreshes
+    they turned into.
+ */
+
+int RefreshScheduler::_delay = 250;
+
+static qint64 _signalsReceived = 0;
+static qint64 _signalsFiltered = 0;
+static qint64 _refreshesRun    = 0;
+static qint64 _refreshesHidden = 0;
+
+RefreshScheduler::RefreshScheduler(QWidget *receiver, const char *member)
+  : QObject(receiver),
+    _receiver(receiver),
+    _pending(false),
+    _deferred(false),
+    _filtered(false),
+    _altId(false)
+{
+  _member = QMetaObject::normalizedSignature(member + 1);  // skip SLOT() code
+  setObjectName(QString("_refreshScheduler_") + _member);
+
+  _timer = new QTimer(this);
+  _timer->setSingleShot(true);
+  QObject::connect(_timer, SIGNAL(timeout()), this, SLOT(sTimeout()));
+}
+
+/** @brief Connect @a signal from @a sender to the parameterless slot
+           @a member of @a receiver, coalescing bursts of the signal.
+
+    Returns the scheduler so the caller can set an id filter.
+ */
+RefreshScheduler *RefreshScheduler::connect(QObject *sender, const char *signal,
+                                            QWidget *receiver, const char *member)
+{
+  if (! sender || ! signal || ! receiver || ! member)
+    return 0;
+
+  RefreshScheduler *scheduler = find(receiver, member);
+  if (! scheduler)
+    scheduler = new RefreshScheduler(receiver, member);
+
+  // signals whose first argument is a record id can be filtered on it
+  QByteArray sig  = QMetaObject::normalizedSignature(signal + 1);
+  QByteArray args = sig.mid(sig.indexOf('(') + 1);
+  if (args.startsWith("int,") || args.startsWith("int)"))
+    QObject::connect(sender, signal, scheduler, SLOT(sUpdated(int)));
+  else
+    QObject::connect(sender, signal, scheduler, SLOT(sUpdated()));
+
+  return scheduler;
+}
+
+/** @brief Return the scheduler for @a receiver and @a member, or the first
+           scheduler on @a receiver if @a member is 0.
+ */
+RefreshScheduler *RefreshScheduler::find(QWidget *receiver, const char *member)
+{
+  if (! receiver)
+    return 0;
+
+  QByteArray normalized;
+  if (member)
+    normalized = QMetaObject::normalizedSignature(member + 1);
+
+  foreach (RefreshScheduler *scheduler, receiver->findChildren<RefreshScheduler*>())
+    if (scheduler->_receiver == receiver &&
+        (normalized.isEmpty() || scheduler->_member == normalized))
+      return scheduler;
+
+  return 0;
+}
+
+int RefreshScheduler::delay()
+{
+  return _delay;
+}
+
+/** @brief Set how long to collect update signals before refreshing. */
+void RefreshScheduler::setDelay(int msec)
+{
+  _delay = qMax(0, msec);
+}
+
+QVariantMap RefreshScheduler::statistics()
+{
+  QVariantMap result;
+  result.insert("signalsReceived", _signalsReceived);
+  result.insert("signalsFiltered", _signalsFiltered);
+  result.insert("refreshesRun",    _refreshesRun);
+  result.insert("refreshesHidden", _refreshesHidden);
+  result.insert("refreshesSaved",  qMax(Q_INT64_C(0), _signalsReceived - _refreshesRun));
+  return result;
+}
+
+void RefreshScheduler::resetStatistics()
+{
+  _signalsReceived = 0;
+  _signalsFiltered = 0;
+  _refreshesRun    = 0;
+  _refreshesHidden = 0;
+}
+
+/** @brief Only refresh for updates to one of @a ids.
+
+    The ids are kept alongside any list given to setIdList().
+ */
+void RefreshScheduler::setIds(const QSet<int> &ids)
+{
+  _ids      = ids;
+  _filtered = true;
+}
+
+void RefreshScheduler::setIds(int id)
+{
+  setIds(QSet<int>() << id);
+}
+
+/** @brief Also refresh for updates to records currently shown in @a list.
+
+    The ids are read from the list when the update arrives, using each
+    item's id() or, if @a altId is true, its altId().
+ */
+void RefreshScheduler::setIdList(XTreeWidget *list, bool altId)
+{
+  _list     = list;
+  _altId    = altId;
+  _filtered = (list != 0) || _filtered;
+}
+
+/** @brief Decide on the server whether the updated records matter.
+
+    Instead of comparing the signal's id with the filter directly, collect
+    the ids that arrive during a burst and run @a sql once before the
+    refresh. It gets the collected ids bound to @c :ids and the filter's
+    ids, from setIds() and setIdList(), bound to @c :keys, both as
+    INTEGER[] literals. The window refreshes if the query returns a row.
+    Use this when the signal carries, say, a work order id but the window
+    is keyed on items. If the query fails the window refreshes anyway, so
+    the fill reports the problem.
+ */
+void RefreshScheduler::setIdQuery(const QString &sql)
+{
+  _idQuery = sql;
+}
+
+void RefreshScheduler::clearIdFilter()
+{
+  _ids.clear();
+  _list     = 0;
+  _filtered = false;
+  _idQuery.clear();
+  _candidates.clear();
+}
+
+QSet<int> RefreshScheduler::keys() const
+{
+  QSet<int> result = _ids;
+  if (_list)
+  {
+    for (QTreeWidgetItemIterator it(_list); *it; ++it)
+    {
+      XTreeWidgetItem *item = static_cast<XTreeWidgetItem*>(*it);
+      result.insert(_altId ? item->altId() : item->id());
+    }
+  }
+  return result;
+}
+
+bool RefreshScheduler::wants(int id) const
+{
+  if (! _filtered || id <= 0)
+    return true;
+
+  return keys().contains(id);
+}
+
+static QString intArray(const QSet<int> &ids)
+{
+  QStringList list;
+  foreach (int id, ids)
+    list << QString::number(id);
+  return "{" + list.join(",") + "}";
+}
+
+bool RefreshScheduler::resolveCandidates()
+{
+  XSqlQuery idq;
+  idq.prepare(_idQuery);
+  idq.bindValue(":ids",  intArray(_candidates));
+  idq.bindValue(":keys", intArray(keys()));
+  idq.exec();
+  if (idq.first())
+    return true;
+  if (idq.lastError().type() != QSqlError::NoError)
+  {
+    if (DEBUG)
+      qDebug("RefreshScheduler id query failed for %s: %s",
+             _receiver->metaObject()->className(),
+             qPrintable(idq.lastError().text()));
+    return true;
+  }
+
+  _signalsFiltered += _candidates.size();
+  return false;
+}
+
+bool RefreshScheduler::isShowing() const
+{
+  if (! _receiver->isVisible())
+    return false;
+
+  // minimized windows and MDI subwindows keep their children "visible"
+  for (QWidget *w = _receiver; w; w = w->parentWidget())
+    if (w->isMinimized())
+      return false;
+
+  return true;
+}
+
+void RefreshScheduler::sUpdated()
+{
+  sUpdated(-1);
+}
+
+void RefreshScheduler::sUpdated(int id)
+{
+  _signalsReceived++;
+
+  if (! _pending)
+  {
+    if (_filtered && id > 0 && ! _idQuery.isEmpty())
+      _candidates.insert(id);     // checked together in sTimeout()
+    else if (wants(id))
+      _pending = true;
+    else
+    {
+      _signalsFiltered++;
+      return;
+    }
+  }
+
+  if (! _timer->isActive() && ! _deferred)
+    _timer->start(_delay);
+}
+
+void RefreshScheduler::sTimeout()
+{
+  if (! _pending && _candidates.isEmpty())
+    return;
+
+  if (! isShowing())
+  {
+    if (! _deferred)
+    {
+      _deferred = true;
+      _refreshesHidden++;
+      for (QWidget *w = _receiver; w; w = w->parentWidget())
+        w->installEventFilter(this);
+    }
+    return;
+  }
+
+  if (! _pending)
+  {
+    _pending = resolveCandidates();
+    _candidates.clear();
+  }
+
+  if (_pending)
+    refreshNow();
+  else
+    stopDeferring();
+}
+
+void RefreshScheduler::stopDeferring()
+{
+  if (_deferred)
+  {
+    _deferred = false;
+    for (QWidget *w = _receiver; w; w = w->parentWidget())
+      w->removeEventFilter(this);
+  }
+}
+
+/** @brief Call the receiver's slot now, dropping any pending update. */
+void RefreshScheduler::refreshNow()
+{
+  _timer->stop();
+  _pending = false;
+  _candidates.clear();
+  stopDeferring();
+
+  _refreshesRun++;
+  if (DEBUG)
+    qDebug("RefreshScheduler refreshing %s::%s",
+           _receiver->metaObject()->className(), _member.constData());
+
+  QByteArray method = _member.left(_member.indexOf('('));
+  QMetaObject::invokeMethod(_receiver, method.constData());
+}
+
+bool RefreshScheduler::eventFilter(QObject *watched, QEvent *event)
+{
+  if (_deferred &&
+      (event->type() == QEvent::Show || event->type() == QEvent::WindowStateChange))
+    _timer->start(0);   // let the show or restore finish before querying
+
+  return QObject::eventFilter(watched, event);
+}
@@ -0,0 +1,83 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#ifndef __REFRESHSCHEDULER_H__
+#define __REFRESHSCHEDULER_H__
+
+#include <QByteArray>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QString>
+#include <QVariant>
+
+class QTimer;
+class QWidget;
+class XTreeWidget;
+
+class RefreshScheduler : public QObject
+{
+  Q_OBJECT
+
+  public:
+    static RefreshScheduler *connect(QObject *sender, const char *signal,
+                                     QWidget *receiver, const char *member);
+    static RefreshScheduler *find(QWidget *receiver, const char *member = 0);
+
+    static int  delay();
+    static void setDelay(int msec);
+
+    static QVariantMap statistics();
+    static void        resetStatistics();
+
+    void setIds(const QSet<int> &ids);
+    void setIdList(XTreeWidget *list, bool altId = false);
+    void setIdQuery(const QString &sql);
+    void clearIdFilter();
+
+    bool isPending()  const { return _pending;  }
+    bool isDeferred() const { return _deferred; }
+
+  public slots:
+    void setIds(int id);
+    void refreshNow();
+
+  protected:
+    RefreshScheduler(QWidget *receiver, const char *member);
+    virtual bool eventFilter(QObject *watched, QEvent *event);
+
+  private slots:
+    void sUpdated();
+    void sUpdated(int id);
+    void sTimeout();
+
+  private:
+    bool      isShowing() const;
+    QSet<int> keys() const;
+    bool      wants(int id) const;
+    bool      resolveCandidates();
+    void      stopDeferring();
+
+    QWidget               *_receiver;
+    QByteArray             _member;
+    QTimer                *_timer;
+    bool                   _pending;
+    bool                   _deferred;
+    bool                   _filtered;
+    QSet<int>              _ids;
+    QPointer<XTreeWidget>  _list;
+    bool                   _altId;
+    QString                _idQuery;
+    QSet<int>              _candidates;
+
+    static int             _delay;
+};
+
+#endif
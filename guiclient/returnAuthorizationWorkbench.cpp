@@ -22,6 +22,7 @@
 #include "creditcardprocessor.h"
 #include "mqlutil.h"
 #include "printCreditMemo.h"
+#include "refreshscheduler.h"
 #include "returnAuthorization.h"
 #include "returnAuthCheck.h"
 #include "storedProcErrorLookup.h"
@@ -44,8 +45,8 @@ returnAuthorizationWorkbench::returnAuthorizationWorkbench(QWidget* parent, cons
   connect(_printdue, SIGNAL(clicked()), this, SLOT(sPrintDue()));
   connect(_process, SIGNAL(clicked()), this, SLOT(sProcess()));
   connect(_radue, SIGNAL(valid(bool)), this, SLOT(sHandleButton()));
-  connect(omfgThis, SIGNAL(returnAuthorizationsUpdated()), this, SLOT(sFillListReview()));
-  connect(omfgThis, SIGNAL(returnAuthorizationsUpdated()), this, SLOT(sFillListDue()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(returnAuthorizationsUpdated()), this, SLOT(sFillListReview()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(returnAuthorizationsUpdated()), this, SLOT(sFillListDue()));
 
   _ra->addColumn(tr("Auth. #"),      _orderColumn,    Qt::AlignLeft,   true, "rahead_number"   );
   _ra->addColumn(tr("Customer"),     _bigMoneyColumn, Qt::AlignLeft,   true, "cust_name"  );
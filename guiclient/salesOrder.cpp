@@ -13,6 +13,7 @@
 
 #include <QAction>
 #include <QCloseEvent>
+#include <QElapsedTimer>
 #include <QKeyEvent>
 #include <QMenu>
 #include <QMessageBox>
@@ -32,6 +33,8 @@
 #include "distributeInventory.h"
 #include "issueLineToShipping.h"
 #include "mqlutil.h"
+#include "querybatch.h"
+#include "queryprofiler.h"
 #include "salesOrderItem.h"
 #include "storedProcErrorLookup.h"
 #include "taxBreakdown.h"
@@ -68,6 +71,14 @@
 #define iAskToUpdate  2
 #define iJustUpdate   3
 
+static const char *taxSql =
+                "SELECT SUM(tax) AS tax "
+                "FROM ("
+                "SELECT ROUND(SUM(taxdetail_tax),2) AS tax "
+                "FROM tax "
+                " JOIN calculateTaxDetailSummary(:type, :head_id, 'T') ON (taxdetail_tax_id=tax_id)"
+                "GROUP BY tax_id) AS data;";
+
 salesOrder::salesOrder(QWidget *parent, const char *name, Qt::WindowFlags fl)
   : XWidget(parent, name, fl)
 {
@@ -2471,6 +2482,11 @@ void salesOrder::sDelete()
 
 void salesOrder::populate()
 {
+  // The header is read with plain queries rather than a QueryBatch. The
+  // cohead.* and quhead.* rows repeat column names under COALESCE aliases,
+  // which one JSON object per row cannot carry, and the slots called after
+  // it (sPopulateShipments(), sFillCharacteristic(), sFillItemList()) read
+  // the widgets it sets and run again on their own, so they can't join it.
   if ( (_mode == cNew) || (_mode == cEdit) || (_mode == cView) )
   {
     XSqlQuery so;
@@ -2839,6 +2855,7 @@ void salesOrder::populate()
 
 void salesOrder::sFillItemList()
 {
+  QueryProfiler *profiler = QueryProfiler::instance();
   XSqlQuery fillSales;
   if (ISORDER(_mode))
     fillSales.prepare( "SELECT COALESCE(getSoSchedDate(:head_id),:ship_date) AS shipdate;" );
@@ -2847,7 +2864,7 @@ void salesOrder::sFillItemList()
 
   fillSales.bindValue(":head_id", _soheadid);
   fillSales.bindValue(":ship_date", _shipDate->date());
-  fillSales.exec();
+  profiler->exec(fillSales);
   if (fillSales.first())
   {
     _shipDateCache = fillSales.value("shipdate").toDate();
@@ -2874,7 +2891,10 @@ void salesOrder::sFillItemList()
     params.append("sohead_id", _soheadid);
     if (_metrics->boolean("EnableSOReservations"))
       params.append("includeReservations");
+    QElapsedTimer timer;
+    timer.start();
     XSqlQuery fl = mql.toQuery(params);
+    profiler->record(fl, timer.nsecsElapsed() / 1000);
     _soitem->populate(fl, true);
     if (ErrorReporter::error(QtCriticalMsg, this, tr("Error Retreiving Sales Order Information"),
                                   fl, __FILE__, __LINE__))
@@ -2901,7 +2921,7 @@ void salesOrder::sFillItemList()
     fillSales.prepare(sql);
     fillSales.bindValue(":cohead_id", _soheadid);
     fillSales.bindValue(":cust_id", _cust->id());
-    fillSales.exec();
+    profiler->exec(fillSales);
     while (fillSales.next())
       _amountAtShipping->setLocalValue(_amountAtShipping->localValue() +
                                        fillSales.value("shippingAmount").toDouble());
@@ -2917,7 +2937,10 @@ void salesOrder::sFillItemList()
 
     ParameterList params;
     params.append("quhead_id", _soheadid);
+    QElapsedTimer timer;
+    timer.start();
     XSqlQuery fl = mql.toQuery(params);
+    profiler->record(fl, timer.nsecsElapsed() / 1000);
     _cust->setReadOnly(fl.size() || !ISNEW(_mode));
     _soitem->populate(fl);
     if (ErrorReporter::error(QtCriticalMsg, this, tr("Error Retrieving Sales Order Information"),
@@ -2927,37 +2950,26 @@ void salesOrder::sFillItemList()
     }
   }
 
-  //  Determine the subtotal
+  //  Determine the subtotal, weight, freight and tax together
+  QueryBatch batch;
+  int subtotalStmt = -1;
+  int weightStmt   = -1;
+  int freightStmt  = -1;
   if (ISORDER(_mode))
-    fillSales.prepare( "SELECT SUM(round((coitem_qtyord * coitem_qty_invuomratio) * (coitem_price / coitem_price_invuomratio),2)) AS subtotal,"
-                       "       SUM(round((coitem_qtyord * coitem_qty_invuomratio) * (coitem_unitcost / coitem_price_invuomratio),2)) AS totalcost "
-                       "FROM cohead JOIN coitem ON (coitem_cohead_id=cohead_id) "
-                       "WHERE ( (cohead_id=:head_id)"
-                       " AND (coitem_status <> 'X') );" );
+    subtotalStmt = batch.add("SELECT SUM(round((coitem_qtyord * coitem_qty_invuomratio) * (coitem_price / coitem_price_invuomratio),2)) AS subtotal,"
+                             "       SUM(round((coitem_qtyord * coitem_qty_invuomratio) * (coitem_unitcost / coitem_price_invuomratio),2)) AS totalcost "
+                             "FROM cohead JOIN coitem ON (coitem_cohead_id=cohead_id) "
+                             "WHERE ( (cohead_id=:head_id)"
+                             " AND (coitem_status <> 'X') );" );
   else
-    fillSales.prepare( "SELECT SUM(round((quitem_qtyord * quitem_qty_invuomratio) * (quitem_price / quitem_price_invuomratio),2)) AS subtotal,"
-                       "       SUM(round((quitem_qtyord * quitem_qty_invuomratio) * (quitem_unitcost / quitem_price_invuomratio),2)) AS totalcost "
-                       "FROM quhead JOIN quitem ON (quitem_quhead_id=quhead_id) "
-                       "WHERE (quhead_id=:head_id);" );
-  fillSales.bindValue(":head_id", _soheadid);
-  fillSales.exec();
-  if (fillSales.first())
-  {
-    _subtotal->setLocalValue(fillSales.value("subtotal").toDouble());
-    _margin->setLocalValue(fillSales.value("subtotal").toDouble() - fillSales.value("totalcost").toDouble());
-    if (_subtotal->localValue() > 0.0)
-      _marginPercent->setDouble(_margin->localValue() / _subtotal->localValue() * 100.0);
-    else
-      _marginPercent->setDouble(0.0);
-  }
-  else if (ErrorReporter::error(QtCriticalMsg, this, tr("Error Retrieving Sales Order Information"),
-                                fillSales, __FILE__, __LINE__))
-  {
-    return;
-  }
+    subtotalStmt = batch.add("SELECT SUM(round((quitem_qtyord * quitem_qty_invuomratio) * (quitem_price / quitem_price_invuomratio),2)) AS subtotal,"
+                             "       SUM(round((quitem_qtyord * quitem_qty_invuomratio) * (quitem_unitcost / quitem_price_invuomratio),2)) AS totalcost "
+                             "FROM quhead JOIN quitem ON (quitem_quhead_id=quhead_id) "
+                             "WHERE (quhead_id=:head_id);" );
+  batch.bindValue(subtotalStmt, ":head_id", _soheadid);
 
   if (ISORDER(_mode))
-    fillSales.prepare("SELECT SUM(COALESCE(coitem_qtyord * coitem_qty_invuomratio, 0.00) *"
+    weightStmt = batch.add("SELECT SUM(COALESCE(coitem_qtyord * coitem_qty_invuomratio, 0.00) *"
               "           COALESCE(item_prodweight, 0.00)) AS netweight,"
               "       SUM(COALESCE(coitem_qtyord * coitem_qty_invuomratio, 0.00) *"
               "           (COALESCE(item_prodweight, 0.00) +"
@@ -2970,7 +2982,7 @@ void salesOrder::sFillItemList()
               " AND (coitem_cohead_id=:head_id)) "
               "GROUP BY cohead_freight;");
   else if (ISQUOTE(_mode))
-    fillSales.prepare("SELECT SUM(COALESCE(quitem_qtyord * quitem_qty_invuomratio, 0.00) *"
+    weightStmt = batch.add("SELECT SUM(COALESCE(quitem_qtyord * quitem_qty_invuomratio, 0.00) *"
               "           COALESCE(item_prodweight, 0.00)) AS netweight,"
               "       SUM(COALESCE(quitem_qtyord * quitem_qty_invuomratio, 0.00) *"
               "           (COALESCE(item_prodweight, 0.00) +"
@@ -2980,46 +2992,73 @@ void salesOrder::sFillItemList()
               "   AND   (quitem_quhead_id=quhead_id)"
               "   AND   (quitem_quhead_id=:head_id)) "
               " GROUP BY quhead_freight;");
-  fillSales.bindValue(":head_id", _soheadid);
-  fillSales.exec();
-  if (fillSales.first())
-    _weight->setDouble(fillSales.value("grossweight").toDouble());
-  else if (ErrorReporter::error(QtCriticalMsg, this, tr("Error Retrieving Sales Order Information"),
-                                fillSales, __FILE__, __LINE__))
-  {
-    return;
-  }
+  batch.bindValue(weightStmt, ":head_id", _soheadid);
 
   if (_calcfreight)
   {
     if (ISORDER(_mode))
-      fillSales.prepare("SELECT SUM(freightdata_total) AS freight "
+      freightStmt = batch.add("SELECT SUM(freightdata_total) AS freight "
                 "FROM freightDetail('SO', :head_id, :cust_id, :shipto_id, :orderdate, :shipvia, :curr_id);");
     else if (ISQUOTE(_mode))
-      fillSales.prepare("SELECT SUM(freightdata_total) AS freight "
+      freightStmt = batch.add("SELECT SUM(freightdata_total) AS freight "
                 "FROM freightDetail('QU', :head_id, :cust_id, :shipto_id, :orderdate, :shipvia, :curr_id);");
-    fillSales.bindValue(":head_id", _soheadid);
-    fillSales.bindValue(":cust_id", _cust->id());
-    fillSales.bindValue(":shipto_id", _shipTo->id());
-    fillSales.bindValue(":orderdate", _orderDate->date());
-    fillSales.bindValue(":shipvia", _shipVia->currentText());
-    fillSales.bindValue(":curr_id", _orderCurrency->id());
-    fillSales.exec();
-    if (fillSales.first())
+    batch.bindValue(freightStmt, ":head_id", _soheadid);
+    batch.bindValue(freightStmt, ":cust_id", _cust->id());
+    batch.bindValue(freightStmt, ":shipto_id", _shipTo->id());
+    batch.bindValue(freightStmt, ":orderdate", _orderDate->date());
+    batch.bindValue(freightStmt, ":shipvia", _shipVia->currentText());
+    batch.bindValue(freightStmt, ":curr_id", _orderCurrency->id());
+  }
+
+  int taxStmt = batch.add(taxSql);
+  batch.bindValue(taxStmt, ":head_id", _soheadid);
+  batch.bindValue(taxStmt, ":type", ISQUOTE(_mode) ? "Q" : "S");
+  batch.exec();
+
+  QueryBatchResult &subtotal = batch.result(subtotalStmt);
+  if (subtotal.first())
+  {
+    _subtotal->setLocalValue(subtotal.value("subtotal").toDouble());
+    _margin->setLocalValue(subtotal.value("subtotal").toDouble() - subtotal.value("totalcost").toDouble());
+    if (_subtotal->localValue() > 0.0)
+      _marginPercent->setDouble(_margin->localValue() / _subtotal->localValue() * 100.0);
+    else
+      _marginPercent->setDouble(0.0);
+  }
+  else if (ErrorReporter::error(QtCriticalMsg, this, tr("Error Retrieving Sales Order Information"),
+                                subtotal.lastError(), __FILE__, __LINE__))
+  {
+    return;
+  }
+
+  QueryBatchResult &weight = batch.result(weightStmt);
+  if (weight.first())
+    _weight->setDouble(weight.value("grossweight").toDouble());
+  else if (ErrorReporter::error(QtCriticalMsg, this, tr("Error Retrieving Sales Order Information"),
+                                weight.lastError(), __FILE__, __LINE__))
+  {
+    return;
+  }
+
+  if (_calcfreight)
+  {
+    QueryBatchResult &freight = batch.result(freightStmt);
+    if (freight.first())
     {
       disconnect(_freight, SIGNAL(valueChanged()), this, SLOT(sFreightChanged()));
-      _freight->setLocalValue(fillSales.value("freight").toDouble());
+      _freight->setLocalValue(freight.value("freight").toDouble());
       connect(_freight, SIGNAL(valueChanged()), this, SLOT(sFreightChanged()));
       _freightCache = _freight->localValue();
     }
     else if (ErrorReporter::error(QtCriticalMsg, this, tr("Error Retrieving Sales Order Information"),
-                                  fillSales, __FILE__, __LINE__))
+                                  freight.lastError(), __FILE__, __LINE__))
     {
       return;
     }
   }
 
-  sCalculateTax();  // triggers sCalculateTotal();
+  if (showTax(batch.result(taxStmt)))
+    sCalculateTotal();
 
   _orderCurrency->setEnabled(_soitem->topLevelItemCount() == 0);
 }
@@ -4657,28 +4696,26 @@ void salesOrder::sFreightChanged()
 
 void salesOrder::sCalculateTax()
 {
-  XSqlQuery taxq;
-  taxq.prepare( "SELECT SUM(tax) AS tax "
-                "FROM ("
-                "SELECT ROUND(SUM(taxdetail_tax),2) AS tax "
-                "FROM tax "
-                " JOIN calculateTaxDetailSummary(:type, :cohead_id, 'T') ON (taxdetail_tax_id=tax_id)"
-                "GROUP BY tax_id) AS data;" );
+  QueryBatch batch;
+  int taxStmt = batch.add(taxSql);
+  batch.bindValue(taxStmt, ":head_id", _soheadid);
+  batch.bindValue(taxStmt, ":type", ISQUOTE(_mode) ? "Q" : "S");
+  batch.exec();
+  if (showTax(batch.result(taxStmt)))
+    sCalculateTotal();
+}
 
-  taxq.bindValue(":cohead_id", _soheadid);
-  if (ISQUOTE(_mode))
-    taxq.bindValue(":type","Q");
-  else
-    taxq.bindValue(":type","S");
-  taxq.exec();
-  if (taxq.first())
-    _tax->setLocalValue(taxq.value("tax").toDouble());
+/* Returns false if the tax could not be read, after reporting the error. */
+bool salesOrder::showTax(QueryBatchResult &tax)
+{
+  if (tax.first())
+    _tax->setLocalValue(tax.value("tax").toDouble());
   else if (ErrorReporter::error(QtCriticalMsg, this, tr("Error Retrieving Tax Information"),
-                                taxq, __FILE__, __LINE__))
+                                tax.lastError(), __FILE__, __LINE__))
   {
-    return;
+    return false;
   }
-  sCalculateTotal();
+  return true;
 }
 
 void salesOrder::sTaxZoneChanged()
@@ -18,6 +18,8 @@
 #include "ui_salesOrder.h"
 #include "dspShipmentsBySalesOrder.h"
 
+class QueryBatchResult;
+
 class salesOrder : public XWidget, public Ui::salesOrder
 {
   Q_OBJECT
@@ -127,6 +129,7 @@ class salesOrder : public XWidget, public Ui::salesOrder
 
   private:
     bool    deleteForCancel();
+    bool    showTax(QueryBatchResult &tax);
 
     bool    _saved;
     bool    _saving;
@@ -22,6 +22,7 @@
 
 #include "errorReporter.h"
 #include "guiclient.h"
+#include "refreshscheduler.h"
 #include "salesRep.h"
 #include "storedProcErrorLookup.h"
 
@@ -34,7 +35,7 @@ salesReps::salesReps(QWidget* parent, const char* name, Qt::WindowFlags fl)
   connect(_new, SIGNAL(clicked()), this, SLOT(sNew()));
   connect(_edit, SIGNAL(clicked()), this, SLOT(sEdit()));
   connect(_delete, SIGNAL(clicked()), this, SLOT(sDelete()));
-  connect(omfgThis, SIGNAL(salesRepUpdated(int)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(salesRepUpdated(int)), this, SLOT(sFillList()));
   connect(_showInactive, SIGNAL(toggled(bool)), this, SLOT(sFillList()));
   connect(_salesrep, SIGNAL(populateMenu(QMenu *, QTreeWidgetItem *, int)), this, SLOT(sPopulateMenu(QMenu*)));
   connect(_view, SIGNAL(clicked()), this, SLOT(sView()));
@@ -14,6 +14,7 @@
 #include <QDateTime>
 #include <QDesktopServices>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileDialog>
 #include <QGridLayout>
@@ -47,6 +48,7 @@
 #include "xuiloader.h"
 #include "getscreen.h"
 #include "errorReporter.h"
+#include "queryprofiler.h"
 
 /** @ingroup scriptapi
 
@@ -97,6 +99,20 @@ QWidget *ScriptToolbox::_lastWindow = 0;
   @param engine The script engine in which to create the toolbox object
 */
 
+// the toolbox execute* calls share this, so time them here for the profiler
+static XSqlQuery profiledQuery(MetaSQLQuery &mql, const ParameterList &params)
+{
+  QueryProfiler *profiler = QueryProfiler::instance();
+  if (! profiler->isEnabled())
+    return mql.toQuery(params);
+
+  QElapsedTimer timer;
+  timer.start();
+  XSqlQuery result = mql.toQuery(params);
+  profiler->record(result, timer.nsecsElapsed() / 1000);
+  return result;
+}
+
 ScriptToolbox::ScriptToolbox(QScriptEngine * engine)
   : QObject(engine)
 {
@@ -142,7 +158,7 @@ XSqlQuery ScriptToolbox::executeQuery(const QString & query)
 {
   ParameterList params;
   MetaSQLQuery mql(query);
-  return mql.toQuery(params);
+  return profiledQuery(mql, params);
 }
 /** @example initMenu_executeQueryExample.js */
 
@@ -179,7 +195,7 @@ XSqlQuery ScriptToolbox::executeQuery(const QString & query)
 XSqlQuery ScriptToolbox::executeQuery(const QString & query, const ParameterList & params)
 {
   MetaSQLQuery mql(query);
-  return mql.toQuery(params);
+  return profiledQuery(mql, params);
 }
 /** @example itemSiteViewItem.js */
 
@@ -210,7 +226,7 @@ XSqlQuery ScriptToolbox::executeDbQuery(const QString & group, const QString & n
 {
   ParameterList params;
   MetaSQLQuery mql = mqlLoad(group, name);
-  return mql.toQuery(params);
+  return profiledQuery(mql, params);
 }
 
 /** @brief Execute a MetaSQL query loaded from the @c metasql table.
@@ -252,7 +268,7 @@ XSqlQuery ScriptToolbox::executeDbQuery(const QString & group, const QString & n
 XSqlQuery ScriptToolbox::executeDbQuery(const QString & group, const QString & name, const ParameterList & params)
 {
   MetaSQLQuery mql = mqlLoad(group, name);
-  return mql.toQuery(params);
+  return profiledQuery(mql, params);
 }
 /** @example ccvoid.js */
 
@@ -262,7 +278,7 @@ XSqlQuery ScriptToolbox::executeBegin()
 {
   ParameterList params;
   MetaSQLQuery mql("BEGIN;");
-  return mql.toQuery(params);
+  return profiledQuery(mql, params);
 }
 
 /** @brief This is a convenience function that simply commits the currently open
@@ -272,7 +288,7 @@ XSqlQuery ScriptToolbox::executeCommit()
 {
   ParameterList params;
   MetaSQLQuery mql("COMMIT;");
-  return mql.toQuery(params);
+  return profiledQuery(mql, params);
 }
 
 /** @brief This is a convenience function that simply rolls back the currently
@@ -282,7 +298,7 @@ XSqlQuery ScriptToolbox::executeRollback()
 {
   ParameterList params;
   MetaSQLQuery mql("ROLLBACK;");
-  return mql.toQuery(params);
+  return profiledQuery(mql, params);
 }
 
 /** @brief Get a standard Quantity QValidator.
@@ -21,6 +21,7 @@
 
 #include "employee.h"
 #include "errorReporter.h"
+#include "refreshscheduler.h"
 
 #define DEBUG   false
 
@@ -94,7 +95,7 @@ searchForEmp::searchForEmp(QWidget* parent, const char* name, Qt::WindowFlags fl
   else
     connect(_emp, SIGNAL(itemSelected(int)), _view, SLOT(animateClick()));
 
-  connect(omfgThis, SIGNAL(itemsUpdated(int, bool)), SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(itemsUpdated(int, bool)), this, SLOT(sFillList()));
 
   if (_preferences->boolean("XCheckBox/forgetful"))
   {
@@ -25,6 +25,7 @@
 #include "errorReporter.h"
 #include "guiclient.h"
 #include "miscVoucher.h"
+#include "refreshscheduler.h"
 #include "selectBankAccount.h"
 #include "selectPayment.h"
 #include "storedProcErrorLookup.h"
@@ -84,7 +85,7 @@ selectPayments::selectPayments(QWidget* parent, const char* name, Qt::WindowFlag
   if (_privileges->check("ApplyAPMemos"))
       connect(_apopen, SIGNAL(valid(bool)), _applyallcredits, SLOT(setEnabled(bool)));
 
-  connect(omfgThis, SIGNAL(paymentsUpdated(int, int, bool)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(paymentsUpdated(int, int, bool)), this, SLOT(sFillList()));
 
   _ignoreUpdates = false;
 
@@ -435,7 +435,11 @@ void setup::save(bool close)
 
     if (! i.value().implementation)
       continue;
-    else if (cw)
+
+    // write each screen's metrics and preferences together
+    _metrics->beginBatch();
+    _preferences->beginBatch();
+    if (cw)
       ok = cw->sSave();
     else if (engine && engine->globalObject().property(method).isFunction())
     {
@@ -455,6 +459,8 @@ void setup::save(bool close)
                i.value().implementation);
       ok = true;
     }
+    _metrics->commitBatch();
+    _preferences->commitBatch();
 
     if (! ok)
     {
@@ -17,6 +17,7 @@
 
 #include "errorReporter.h"
 #include "parameterwidget.h"
+#include "refreshscheduler.h"
 #include "taxAuthority.h"
 
 taxAuthorities::taxAuthorities(QWidget* parent, const char*, Qt::WindowFlags fl)
@@ -38,7 +39,7 @@ taxAuthorities::taxAuthorities(QWidget* parent, const char*, Qt::WindowFlags fl)
   parameterWidget()->append(tr("Postal Code Pattern"), "addr_postalcode_pattern", ParameterWidget::Text);
   parameterWidget()->append(tr("Country Pattern"), "addr_country_pattern", ParameterWidget::Text);
 
-  connect(omfgThis, SIGNAL(taxAuthsUpdated(int)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(taxAuthsUpdated(int)), this, SLOT(sFillList()));
 
   list()->addColumn(tr("Code"), 70, Qt::AlignLeft,   true,  "taxauth_code" );
   list()->addColumn(tr("Name"), -1, Qt::AlignLeft,   true,  "taxauth_name" );
@@ -0,0 +1,182 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#include "timephasedbuckets.h"
+
+#include <QSqlRecord>
+
+#include <xsqlquery.h>
+
+#define DEBUG false
+
+/** @class TimePhasedBuckets
+
+    @brief A matrix of values by entity, measure and calendar bucket, filled
+           from a single query.
+
+    Rather than running one query per period, bind the whole period list
+    once with bindValues() and join to bucketTable(),
+    which yields one row per period with @c bucket_seq (starting at 1),
+    @c bucket_start and @c bucket_end. The query returns one row per entity
+    and bucket with one column per measure; pass it to load(), then read
+    the results back in period order with series() and running().
+
+    The displayTimePhased screens still use their period-id MetaSQL and do
+    not go through this class.
+ */
+
+TimePhasedBuckets::TimePhasedBuckets()
+{
+}
+
+void TimePhasedBuckets::setBuckets(const QList<DatePair> &buckets)
+{
+  _buckets = buckets;
+  clear();
+}
+
+/** Return a FROM-clause item that expands the bound period arrays into
+    rows, named @c bucket. Bind its values with bindValues().
+ */
+QString TimePhasedBuckets::bucketTable()
+{
+  return "(SELECT s AS bucket_seq,"
+         "        (CAST(:bucket_starts AS DATE[]))[s] AS bucket_start,"
+         "        (CAST(:bucket_ends AS DATE[]))[s] AS bucket_end"
+         "   FROM generate_subscripts(CAST(:bucket_starts AS DATE[]), 1) AS s"
+         ") AS bucket";
+}
+
+static QString dateArray(const QList<DatePair> &buckets, bool start)
+{
+  QStringList dates;
+  foreach (DatePair pair, buckets)
+    dates << (start ? pair.startDate : pair.endDate).toString(Qt::ISODate);
+  return "{" + dates.join(",") + "}";
+}
+
+void TimePhasedBuckets::bindValues(XSqlQuery &query) const
+{
+  query.bindValue(":bucket_starts", dateArray(_buckets, true));
+  query.bindValue(":bucket_ends",   dateArray(_buckets, false));
+}
+
+void TimePhasedBuckets::clear()
+{
+  _entities.clear();
+  _entityIndex.clear();
+  _measures.clear();
+  _measureIndex.clear();
+  _cells.clear();
+}
+
+quint64 TimePhasedBuckets::cellKey(const QVariant &entity, const QString &measure) const
+{
+  int e = _entityIndex.value(entity.toString(), -1);
+  int m = _measureIndex.value(measure, -1);
+  if (e < 0 || m < 0)
+    return Q_UINT64_C(0xFFFFFFFFFFFFFFFF);
+  return (quint64(e) << 32) | quint32(m);
+}
+
+/** Add @a value to the cell for @a entity, @a measure and the zero-based
+    @a bucket. Values for the same cell accumulate.
+ */
+void TimePhasedBuckets::add(const QVariant &entity, const QString &measure, int bucket, double value)
+{
+  if (bucket < 0 || bucket >= _buckets.size())
+    return;
+
+  QString ekey = entity.toString();
+  if (! _entityIndex.contains(ekey))
+  {
+    _entityIndex.insert(ekey, _entities.size());
+    _entities.append(entity);
+  }
+  if (! _measureIndex.contains(measure))
+  {
+    _measureIndex.insert(measure, _measures.size());
+    _measures.append(measure);
+  }
+
+  QVector<double> &cells = _cells[cellKey(entity, measure)];
+  if (cells.isEmpty())
+    cells.fill(0.0, _buckets.size());
+  cells[bucket] += value;
+}
+
+/** Load rows holding one column per measure. An empty @a entityColumn puts
+    every row in a single entity, looked up later with a null QVariant.
+ */
+bool TimePhasedBuckets::load(XSqlQuery &query, const QString &entityColumn,
+                             const QStringList &measureColumns,
+                             const QString &bucketColumn)
+{
+  QSqlRecord record = query.record();
+  int ecol = entityColumn.isEmpty() ? -1 : record.indexOf(entityColumn);
+  int bcol = record.indexOf(bucketColumn);
+  if (bcol < 0 || (! entityColumn.isEmpty() && ecol < 0))
+    return false;
+
+  QList<int> mcols;
+  foreach (QString measure, measureColumns)
+  {
+    int col = record.indexOf(measure);
+    if (col < 0)
+      return false;
+    mcols.append(col);
+  }
+
+  int rows = 0;
+  while (query.next())
+  {
+    QVariant entity = ecol < 0 ? QVariant() : query.value(ecol);
+    int      bucket = query.value(bcol).toInt() - 1;
+    for (int i = 0; i < mcols.size(); i++)
+      add(entity, measureColumns.at(i), bucket, query.value(mcols.at(i)).toDouble());
+    rows++;
+  }
+
+  if (DEBUG)
+    qDebug("TimePhasedBuckets::load() read %d rows into %d entities",
+           rows, _entities.size());
+  return true;
+}
+
+double TimePhasedBuckets::value(const QVariant &entity, const QString &measure, int bucket) const
+{
+  QVector<double> cells = _cells.value(cellKey(entity, measure));
+  return (bucket >= 0 && bucket < cells.size()) ? cells.at(bucket) : 0.0;
+}
+
+/** Return the values of one measure for every bucket, in period order. */
+QVector<double> TimePhasedBuckets::series(const QVariant &entity, const QString &measure) const
+{
+  QVector<double> cells = _cells.value(cellKey(entity, measure));
+  if (cells.isEmpty())
+    cells.fill(0.0, _buckets.size());
+  return cells;
+}
+
+/** Return the cumulative total of one measure at the end of each bucket,
+    starting from @a opening.
+ */
+QVector<double> TimePhasedBuckets::running(const QVariant &entity, const QString &measure,
+                                           double opening) const
+{
+  QVector<double> result = series(entity, measure);
+  double total = opening;
+  for (int i = 0; i < result.size(); i++)
+  {
+    total    += result.at(i);
+    result[i] = total;
+  }
+  return result;
+}
@@ -0,0 +1,60 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#ifndef __TIMEPHASEDBUCKETS_H__
+#define __TIMEPHASEDBUCKETS_H__
+
+#include <QHash>
+#include <QList>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+
+#include "calendarTools.h"
+
+class XSqlQuery;
+
+class TimePhasedBuckets
+{
+  public:
+    TimePhasedBuckets();
+
+    void                   setBuckets(const QList<DatePair> &);
+    const QList<DatePair> &buckets()     const { return _buckets;        }
+    int                    bucketCount() const { return _buckets.size(); }
+
+    static QString bucketTable();
+    void           bindValues(XSqlQuery &) const;
+
+    void clear();
+    void add(const QVariant &entity, const QString &measure, int bucket, double value);
+    bool load(XSqlQuery &, const QString &entityColumn,
+              const QStringList &measureColumns,
+              const QString &bucketColumn = "bucket_seq");
+
+    QVariantList    entities() const { return _entities; }
+    QStringList     measures() const { return _measures; }
+    double          value(const QVariant &entity, const QString &measure, int bucket) const;
+    QVector<double> series(const QVariant &entity, const QString &measure) const;
+    QVector<double> running(const QVariant &entity, const QString &measure,
+                            double opening = 0.0) const;
+
+  private:
+    quint64 cellKey(const QVariant &entity, const QString &measure) const;
+
+    QList<DatePair>          _buckets;
+    QVariantList             _entities;
+    QHash<QString, int>      _entityIndex;
+    QStringList              _measures;
+    QHash<QString, int>      _measureIndex;
+    QHash<quint64, QVector<double> > _cells;
+};
+
+#endif
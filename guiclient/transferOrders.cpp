@@ -22,6 +22,7 @@
 #include "copyTransferOrder.h"
 #include "issueToShipping.h"
 #include "printToForm.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 #include "transferOrder.h"
 #include "printPackingList.h"
@@ -47,7 +48,7 @@ transferOrders::transferOrders(QWidget* parent, const char* name, Qt::WindowFlag
   connect(_to, SIGNAL(itemSelectionChanged()), this, SLOT(sHandleButtons()));
   connect(_to, SIGNAL(populateMenu(QMenu*,QTreeWidgetItem*, int)), this, SLOT(sPopulateMenu(QMenu*,QTreeWidgetItem*)));
   connect(_view,	  SIGNAL(clicked()), this, SLOT(sView()));
-  connect(omfgThis, SIGNAL(transferOrdersUpdated(int)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(transferOrdersUpdated(int)), this, SLOT(sFillList()));
 
   _to->addColumn(tr("Order #"),                -1,  Qt::AlignLeft,   true,  "tohead_number"   );
   _to->addColumn(tr("Status"),       _statusColumn*2, Qt::AlignCenter, true,  "f_status" );
@@ -21,6 +21,7 @@
 #include <parameter.h>
 #include <openreports.h>
 #include "mqlutil.h"
+#include "refreshscheduler.h"
 #include "selectOrderForBilling.h"
 #include "errorReporter.h"
 
@@ -43,7 +44,7 @@ uninvoicedShipments::uninvoicedShipments(QWidget* parent, const char* name, Qt::
   _shipitem->addColumn(tr("Shipped"),                _qtyColumn,  Qt::AlignRight,  true,  "shipped" );
   _shipitem->addColumn(tr("Approved"),               _qtyColumn,  Qt::AlignRight,  true,  "selected" );
   
-  connect(omfgThis, SIGNAL(billingSelectionUpdated(int, int)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(billingSelectionUpdated(int, int)), this, SLOT(sFillList()));
 
   sFillList();
 }
@@ -24,6 +24,7 @@
 #include "failedPostList.h"
 #include "getGLDistDate.h"
 #include "printCreditMemo.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 #include "errorReporter.h"
 
@@ -68,7 +69,7 @@ unpostedCreditMemos::unpostedCreditMemos(QWidget* parent, const char* name, Qt::
     if (_privileges->check("PostARDocuments"))
       connect(_cmhead, SIGNAL(valid(bool)), _post, SLOT(setEnabled(bool)));
 
-    connect(omfgThis, SIGNAL(creditMemosUpdated()), this, SLOT(sFillList()));
+    RefreshScheduler::connect(omfgThis, SIGNAL(creditMemosUpdated()), this, SLOT(sFillList()));
 
     sFillList();
 }
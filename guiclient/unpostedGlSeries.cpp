@@ -22,6 +22,7 @@
 #include "failedPostList.h"
 #include "getGLDistDate.h"
 #include "glSeries.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 
 unpostedGlSeries::unpostedGlSeries(QWidget* parent, const char* name, Qt::WindowFlags fl)
@@ -36,7 +37,7 @@ unpostedGlSeries::unpostedGlSeries(QWidget* parent, const char* name, Qt::Window
   connect(_post,     SIGNAL(clicked()),		this, SLOT(sPost()));
   connect(_print,    SIGNAL(clicked()),		this, SLOT(sPrint()));
   connect(_view,     SIGNAL(clicked()),		this, SLOT(sView()));
-  connect(omfgThis,  SIGNAL(glSeriesUpdated()),	this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(glSeriesUpdated()), this, SLOT(sFillList()));
 
   _glseries->addColumn(tr("Date"),          _dateColumn,     Qt::AlignCenter, true,  "glseries_distdate" );
   _glseries->addColumn(tr("Source"),        _orderColumn,    Qt::AlignCenter, true,  "glseries_source" );
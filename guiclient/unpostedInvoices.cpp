@@ -24,6 +24,7 @@
 #include "invoice.h"
 #include "mqlutil.h"
 #include "printInvoice.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 #include "distributeInventory.h"
 #include "errorReporter.h"
@@ -71,7 +72,7 @@ unpostedInvoices::unpostedInvoices(QWidget* parent, const char* name, Qt::Window
   if (_preferences->boolean("XCheckBox/forgetful"))
     _printJournal->setChecked(true);
 
-  connect(omfgThis, SIGNAL(invoicesUpdated(int, bool)), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(invoicesUpdated(int, bool)), this, SLOT(sFillList()));
 
   sFillList();
 }
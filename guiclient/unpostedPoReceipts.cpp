@@ -27,6 +27,7 @@
 #include "getGLDistDate.h"
 #include "mqlutil.h"
 #include "purchaseOrderItem.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 #include "transferOrderItem.h"
 #include "returnAuthorizationItem.h"
@@ -44,7 +45,7 @@ unpostedPoReceipts::unpostedPoReceipts(QWidget* parent, const char* name, Qt::Wi
   connect(_print,         SIGNAL(clicked()), this, SLOT(sPrint()));
   connect(_recv, SIGNAL(populateMenu(QMenu*,QTreeWidgetItem*,int)), this, SLOT(sPopulateMenu(QMenu*,QTreeWidgetItem*)));
   connect(_viewOrderItem,    SIGNAL(clicked()), this, SLOT(sViewOrderItem()));
-  connect(omfgThis, SIGNAL(purchaseOrderReceiptsUpdated()), this, SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(purchaseOrderReceiptsUpdated()), this, SLOT(sFillList()));
 
   _recv->addColumn(tr("Order #"),       _orderColumn, Qt::AlignRight,  true, "recv_order_number"  );
   _recv->addColumn(tr("Type"),          50,           Qt::AlignCenter, true, "recv_order_type" );
@@ -23,6 +23,7 @@
 #include "printPurchaseOrder.h"
 #include "printPoForm.h"
 #include "guiclient.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 #include "parameterwidget.h"
 #include "errorReporter.h"
@@ -47,8 +48,8 @@ unpostedPurchaseOrders::unpostedPurchaseOrders(QWidget* parent, const char*, Qt:
   parameterWidget()->append(tr("Vendor Type Pattern"), "vendtype_pattern", ParameterWidget::Text);
   parameterWidget()->appendComboBox(tr("Purchase Agent"), "pohead_agent_usr_id", XComboBox::Agent);
 
-  connect(omfgThis,	SIGNAL(purchaseOrdersUpdated(int, bool)),
-                                              this,	SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(purchaseOrdersUpdated(int, bool)),
+                            this, SLOT(sFillList()));
 
   list()->addColumn(tr("P/O #"),         _orderColumn, Qt::AlignLeft,   true, "pohead_number" );
   list()->addColumn(tr("Vendor #"),      _orderColumn, Qt::AlignLeft,   true, "vend_number"   );
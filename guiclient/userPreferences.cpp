@@ -301,6 +301,7 @@ void userPreferences::sApply()
 
 void userPreferences::sSave(bool close)
 {
+  _pref->beginBatch();
   if (_backgroundImage->isChecked())
     _pref->set("BackgroundImageid", _backgroundImageid);
   else
@@ -379,6 +380,7 @@ void userPreferences::sSave(bool close)
   _pref->set("AlarmSysmsgDefault", _alarmSysmsg->isChecked());
 
   _pref->set("EnableScriptDebug", _debug->isChecked());
+  _pref->commitBatch();
 
   if (_currentUser->isChecked())
   {
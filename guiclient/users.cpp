@@ -15,6 +15,7 @@
 #include <parameter.h>
 
 #include "errorReporter.h"
+#include "refreshscheduler.h"
 #include "user.h"
 
 users::users(QWidget* parent, const char* name, Qt::WindowFlags fl)
@@ -30,7 +31,7 @@ users::users(QWidget* parent, const char* name, Qt::WindowFlags fl)
   connect(_showInactive,  SIGNAL(toggled(bool)), this,  SLOT(sFillList()));
   connect(_usr,       SIGNAL(itemSelected(int)), _edit, SLOT(animateClick()));
   connect(_usr,             SIGNAL(valid(bool)), _edit, SLOT(setEnabled(bool)));
-  connect(omfgThis,SIGNAL(userUpdated(QString)), this,  SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(userUpdated(QString)), this, SLOT(sFillList()));
 
   _usr->addColumn(tr("Username"),    80, Qt::AlignLeft,   true, "usr_username");
   _usr->addColumn(tr("Proper Name"), -1, Qt::AlignLeft,   true, "usr_propername");
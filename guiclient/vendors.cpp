@@ -19,6 +19,7 @@
 
 #include "errorReporter.h"
 #include "parameterwidget.h"
+#include "refreshscheduler.h"
 #include "storedProcErrorLookup.h"
 #include "vendor.h"
 
@@ -62,7 +63,7 @@ vendors::vendors(QWidget* parent, const char*, Qt::WindowFlags fl)
 
   setupCharacteristics("V");
 
-  connect(omfgThis, SIGNAL(vendorsUpdated()), SLOT(sFillList()));
+  RefreshScheduler::connect(omfgThis, SIGNAL(vendorsUpdated()), this, SLOT(sFillList()));
 
   if (_privileges->check("MaintainVendors"))
     connect(list(), SIGNAL(itemSelected(int)), this, SLOT(sEdit()));
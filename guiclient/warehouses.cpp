@@ -19,6 +19,7 @@
 
 #include <openreports.h>
 #include "itemSites.h"
+#include "refreshscheduler.h"
 #include "warehouse.h"
 
 warehouses::warehouses(QWidget* parent, const char* name, Qt::WindowFlags fl)
@@ -50,7 +51,7 @@ warehouses::warehouses(QWidget* parent, const char* name, Qt::WindowFlags fl)
     connect(_warehouse, SIGNAL(itemSelected(int)), _view, SLOT(animateClick()));
   }
 
-  connect(omfgThis, SIGNAL(warehousesUpdated()),  SLOT(sFillList())  );
+  RefreshScheduler::connect(omfgThis, SIGNAL(warehousesUpdated()), this, SLOT(sFillList()));
 
   sFillList();
 }
@@ -45,6 +45,7 @@
 #include "woMaterialItem.h"
 #include "errorReporter.h"
 #include "guiErrorCheck.h"
+#include "querybatch.h"
 
 #define DEBUG false
 
@@ -704,20 +705,20 @@ void workOrder::sUpdateStartDate()
                        startDate, __FILE__, __LINE__);
 }
 
-void workOrder::sPopulateItemChar( int pItemid )
+/* %1 is replaced with the item id, either a placeholder or a subquery
+   on the work order when the item is not known yet.
+ */
+static QString itemCharSql(const QString &itemid)
 {
-  XSqlQuery workPopulateItemChar;
-  _itemchar->removeRows(0, _itemchar->rowCount());
-  if (pItemid != -1)
-  {
-    workPopulateItemChar.prepare( "SELECT DISTINCT char_id, char_name,"
-               "       COALESCE(b.charass_value, (SELECT c.charass_value FROM charass c WHERE ((c.charass_target_type='I') AND (c.charass_target_id=:item_id) AND (c.charass_default) AND (c.charass_char_id=char_id)) LIMIT 1)) AS charass_value"
+  return QString(
+               "SELECT DISTINCT char_id, char_name,"
+               "       COALESCE(b.charass_value, (SELECT c.charass_value FROM charass c WHERE ((c.charass_target_type='I') AND (c.charass_target_id=%1) AND (c.charass_default) AND (c.charass_char_id=char_id)) LIMIT 1)) AS charass_value"
                "   FROM (SELECT DISTINCT char_id, char_type, char_name, char_order "
                "         FROM charass, char, charuse"
                "         WHERE ((charass_char_id=char_id)"
                "         AND (charuse_char_id=char_id AND charuse_target_type = 'W') "
                "         AND (charass_target_type='I') "
-               "         AND (charass_target_id=:item_id) ) "
+               "         AND (charass_target_id=%1) ) "
                "         UNION SELECT char_id, char_type, char_name, char_order"
                "         FROM charass, char "
                "         WHERE ((charass_char_id=char_id)"
@@ -725,29 +726,45 @@ void workOrder::sPopulateItemChar( int pItemid )
                "   LEFT OUTER JOIN charass b ON ((:wo_id=b.charass_target_id)"
                "                                  AND ('W'=b.charass_target_type)"
                "                                  AND (b.charass_char_id=char_id))"
-               "   LEFT OUTER JOIN item     i1 ON (i1.item_id=:item_id)"
+               "   LEFT OUTER JOIN item     i1 ON (i1.item_id=%1)"
                "   LEFT OUTER JOIN charass  i2 ON ((i1.item_id=i2.charass_target_id)"
                "                                   AND ('I'=i2.charass_target_type)"
                "                                   AND (i2.charass_char_id=char_id)"
                "                                   AND (i2.charass_default))"
-               " ORDER BY char_name;" );
-    workPopulateItemChar.bindValue(":item_id", pItemid);
-    workPopulateItemChar.bindValue(":wo_id", _woid);
-    workPopulateItemChar.exec();
-    int row = 0;
-    QModelIndex idx;
-    while(workPopulateItemChar.next())
-    {
-      _itemchar->insertRow(_itemchar->rowCount());
-      idx = _itemchar->index(row, 0);
-      _itemchar->setData(idx, workPopulateItemChar.value("char_name"), Qt::DisplayRole);
-      _itemchar->setData(idx, workPopulateItemChar.value("char_id"), Qt::UserRole);
-      idx = _itemchar->index(row, 1);
-      _itemchar->setData(idx, workPopulateItemChar.value("charass_value"), Qt::DisplayRole);
-      _itemchar->setData(idx, pItemid, Xt::IdRole);
-      _itemchar->setData(idx, pItemid, Qt::UserRole);
-      row++;
-    }
+               " ORDER BY char_name;")
+      .arg(itemid);
+}
+
+void workOrder::sPopulateItemChar( int pItemid )
+{
+  _itemchar->removeRows(0, _itemchar->rowCount());
+  if (pItemid != -1)
+  {
+    QueryBatch batch;
+    int charStmt = batch.add(itemCharSql(":item_id"));
+    batch.bindValue(charStmt, ":item_id", pItemid);
+    batch.bindValue(charStmt, ":wo_id", _woid);
+    batch.exec();
+    showItemChar(batch.result(charStmt), pItemid);
+  }
+}
+
+void workOrder::showItemChar(QueryBatchResult &chars, int pItemid)
+{
+  _itemchar->removeRows(0, _itemchar->rowCount());
+  int row = 0;
+  QModelIndex idx;
+  while(chars.next())
+  {
+    _itemchar->insertRow(_itemchar->rowCount());
+    idx = _itemchar->index(row, 0);
+    _itemchar->setData(idx, chars.value("char_name"), Qt::DisplayRole);
+    _itemchar->setData(idx, chars.value("char_id").toInt(), Qt::UserRole);
+    idx = _itemchar->index(row, 1);
+    _itemchar->setData(idx, chars.value("charass_value"), Qt::DisplayRole);
+    _itemchar->setData(idx, pItemid, Xt::IdRole);
+    _itemchar->setData(idx, pItemid, Qt::UserRole);
+    row++;
   }
 }
 
@@ -1967,8 +1984,9 @@ void workOrder::populate()
 {
 
   XSqlQuery workpopulate;
-  XSqlQuery wo;
-  wo.prepare( "SELECT wo_itemsite_id, wo_priority, wo_status,"
+  // read the header and the item characteristics in one round trip
+  QueryBatch batch;
+  int woStmt = batch.add( "SELECT wo_itemsite_id, wo_priority, wo_status,"
               "       formatWoNumber(wo_id) AS f_wonumber,"
               "       wo_qtyord,"
               "       wo_qtyrcv,"
@@ -1978,11 +1996,17 @@ void workOrder::populate()
               "       wo_postedvalue-wo_wipvalue AS rcvdvalue,"
               "       wo_prodnotes, wo_prj_id, "
               "       wo_bom_rev_id, wo_boo_rev_id, "
-              "       wo_cosmethod "
-              "FROM wo "
+              "       wo_cosmethod, itemsite_item_id "
+              "FROM wo JOIN itemsite ON (wo_itemsite_id=itemsite_id) "
               "WHERE (wo_id=:wo_id);" );
-  wo.bindValue(":wo_id", _woid);
-  wo.exec();
+  batch.bindValue(woStmt, ":wo_id", _woid);
+  int charStmt = batch.add(itemCharSql("(SELECT itemsite_item_id"
+                                       "   FROM wo JOIN itemsite ON (wo_itemsite_id=itemsite_id)"
+                                       "  WHERE (wo_id=:wo_id))"));
+  batch.bindValue(charStmt, ":wo_id", _woid);
+  batch.exec();
+
+  QueryBatchResult &wo = batch.result(woStmt);
   if (wo.first())
   {
 
@@ -1991,7 +2015,10 @@ void workOrder::populate()
     _oldDueDate = wo.value("wo_duedate").toDate();
 
     _woNumber->setText(wo.value("f_wonumber").toString());
+    disconnect(_item, SIGNAL(newId(int)), this, SLOT(sPopulateItemChar(int)));
     _item->setItemsiteid(wo.value("wo_itemsite_id").toInt());
+    connect(_item, SIGNAL(newId(int)), this, SLOT(sPopulateItemChar(int)));
+    showItemChar(batch.result(charStmt), wo.value("itemsite_item_id").toInt());
     _priority->setValue(_oldPriority);
     _postedValue->setText(wo.value("wo_postedvalue").toDouble());
     _rcvdValue->setText(wo.value("rcvdvalue").toDouble());
@@ -2070,7 +2097,7 @@ void workOrder::populate()
   {
     ErrorReporter::error(QtCriticalMsg, this, tr("Error Retrieving Work Order Information for WO #: %1")
                          .arg(_woid),
-                         wo, __FILE__, __LINE__);
+                         wo.lastError(), __FILE__, __LINE__);
     if(_captive)
       close();
   }
@@ -17,6 +17,8 @@
 #include <parameter.h>
 #include "ui_workOrder.h"
 
+class QueryBatchResult;
+
 class workOrder : public XWidget, public Ui::workOrder
 {
     Q_OBJECT
@@ -84,6 +86,8 @@ signals:
   
 
 private:
+    void showItemChar(QueryBatchResult &chars, int pItemid);
+
     bool _captive;
     int _planordid;
     int _sense;
@@ -16,6 +16,7 @@
 
 #include "storedProcErrorLookup.h"
 #include "errorReporter.h"
+#include "exporthelper.h"
 
 bool xsltMap::userHasPriv()
 {
@@ -215,6 +216,7 @@ void xsltMap::sSave()
     return;
   }
 
+  ExportHelper::XSLTClearCache();
   accept();
 }
 
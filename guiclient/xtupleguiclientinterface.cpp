@@ -104,3 +104,8 @@ int xTupleGuiClientInterface::hunspell_ignore(const QString word)
 {
   return omfgThis->hunspell_ignore(word);
 }
+
+QDate xTupleGuiClientInterface::dbDate()
+{
+  return omfgThis->dbDate();
+}
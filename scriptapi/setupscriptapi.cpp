@@ -120,6 +120,7 @@
 #include "qtreewidgetitemproto.h"
 #include "qtsetup.h"
 #include "qudpsocketproto.h"
+#include "queryprofiler.h"
 #include "qurlproto.h"
 #include "qurlqueryproto.h"
 #include "quuidproto.h"
@@ -151,6 +152,7 @@
 
 void setupScriptApi(QScriptEngine *engine)
 {
+  QueryProfilerTimer timer("setupScriptApi");
 
   setupEngineEvaluate(engine);
   setupExportHelper(engine);
@@ -0,0 +1,97 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#include "alloccounter.h"
+
+#include <QAtomicInteger>
+#include <QFile>
+
+#include <cstdlib>
+#include <new>
+
+#if defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+static QAtomicInteger<qint64> __allocations;
+
+static void *countedAlloc(std::size_t size)
+{
+  __allocations.fetchAndAddRelaxed(1);
+  void *p = std::malloc(size ? size : 1);
+  if (! p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void *operator new(std::size_t size)                         { return countedAlloc(size); }
+void *operator new[](std::size_t size)                       { return countedAlloc(size); }
+void  operator delete(void *p) throw()                       { std::free(p); }
+void  operator delete[](void *p) throw()                     { std::free(p); }
+
+void *operator new(std::size_t size, const std::nothrow_t &) throw()
+{
+  __allocations.fetchAndAddRelaxed(1);
+  return std::malloc(size ? size : 1);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) throw()
+{
+  __allocations.fetchAndAddRelaxed(1);
+  return std::malloc(size ? size : 1);
+}
+
+void  operator delete(void *p, const std::nothrow_t &) throw()   { std::free(p); }
+void  operator delete[](void *p, const std::nothrow_t &) throw() { std::free(p); }
+
+void AllocCounter::reset()
+{
+  __allocations.store(0);
+}
+
+qint64 AllocCounter::allocations()
+{
+  return __allocations.load();
+}
+
+/* Linux lets a process reset its high-water mark so each benchmark reports
+   its own peak. Elsewhere the peak only ever grows over the run.
+ */
+void AllocCounter::resetPeakRss()
+{
+#if defined(Q_OS_LINUX)
+  QFile clear("/proc/self/clear_refs");
+  if (clear.open(QIODevice::WriteOnly))
+    clear.write("5");
+#endif
+}
+
+qint64 AllocCounter::peakRssKb()
+{
+#if defined(Q_OS_LINUX)
+  QFile status("/proc/self/status");
+  if (status.open(QIODevice::ReadOnly))
+  {
+    foreach (QByteArray line, status.readAll().split('\n'))
+      if (line.startsWith("VmHWM:"))
+        return line.mid(6).trimmed().split(' ').first().toLongLong();
+  }
+#endif
+#if defined(Q_OS_UNIX)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+#if defined(Q_OS_MAC)
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+  return -1;
+}
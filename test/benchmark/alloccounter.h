@@ -0,0 +1,33 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#ifndef __ALLOCCOUNTER_H__
+#define __ALLOCCOUNTER_H__
+
+#include <QtGlobal>
+
+/** @brief Counts heap allocations made through operator new.
+
+  alloccounter.cpp replaces the global operator new and delete for the
+  benchmark binary, so the counts include allocations made by Qt and the
+  xTuple libraries. Memory obtained with malloc() directly, for example by
+  libpq, is not counted; peakRssKb() covers that.
+ */
+class AllocCounter
+{
+  public:
+    static void   reset();
+    static qint64 allocations();
+
+    static void   resetPeakRss();
+    static qint64 peakRssKb();
+};
+
+#endif
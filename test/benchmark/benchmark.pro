@@ -0,0 +1,47 @@
+#
+# This file is part of the xTuple ERP: PostBooks Edition, a free and
+# open source Enterprise Resource Planning software suite,
+# Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+# It is licensed to you under the Common Public Attribution License
+# version 1.0, the full text of which (including xTuple-specific Exhibits)
+# is available at www.xtuple.com/CPAL.  By using this software, you agree
+# to be bound by its terms.
+#
+
+# Benchmarks for the list, export, import and scripting paths, run against
+# a seeded PostgreSQL database. Build the application first so ../../lib
+# holds the xTuple libraries, then:
+#   make -C benchmark check TESTARGS="-o results.xml,xml"
+# See tst_benchmark.cpp and pgfixture.h for the environment it reads.
+include( ../../global.pri )
+
+# global.pri sets its relative paths for projects one level down
+! isEmpty( OPENRPT_DIR_REL    ) { OPENRPT_DIR    = ../$${OPENRPT_DIR}
+                                  OPENRPT_BLD    = ../$${OPENRPT_BLD}    }
+! isEmpty( OPENRPT_LIBDIR_REL ) { OPENRPT_LIBDIR = ../$${OPENRPT_LIBDIR} }
+! isEmpty( CSVIMP_HEADERS_REL ) { CSVIMP_HEADERS = ../$${CSVIMP_HEADERS} }
+
+TEMPLATE = app
+TARGET   = tst_benchmark
+CONFIG  += qt warn_on console testcase
+CONFIG  -= app_bundle
+QT      += network sql script scripttools xml xmlpatterns
+QT      += widgets printsupport testlib
+
+INCLUDEPATH += ../../common ../../widgets ../../scriptapi \
+               $${OPENRPT_DIR}/common           $${OPENRPT_BLD}/common \
+               $${OPENRPT_DIR}/OpenRPT/renderer $${OPENRPT_BLD}/OpenRPT/renderer \
+               $${OPENRPT_DIR}/MetaSQL          $${OPENRPT_BLD}/MetaSQL \
+               $${CSVIMP_HEADERS}
+DEPENDPATH  += $${INCLUDEPATH}
+
+QMAKE_LIBDIR = ../../lib $${OPENRPT_LIBDIR} $$QMAKE_LIBDIR
+LIBS        += -lxtuplecommon -lxtuplewidgets -lwrtembed -lopenrptcommon
+LIBS        += -lrenderer -lxtuplescriptapi -lqzint $${DMTXLIB} -lMetaSQL
+
+HEADERS = alloccounter.h \
+          pgfixture.h
+
+SOURCES = alloccounter.cpp \
+          pgfixture.cpp \
+          tst_benchmark.cpp
@@ -0,0 +1,205 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#include "pgfixture.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QProcess>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStandardPaths>
+#include <QTcpServer>
+#include <QTemporaryDir>
+
+#define DEBUG false
+
+/* Just enough of the xTuple schema for the code under test: the locale
+   lookup in format.cpp and the metric functions ImportHelper reads.
+   Import treatments are 'None' so imported files are left where they are.
+ */
+static const char *__schema[] = {
+  "CREATE SCHEMA bench;",
+  "SET search_path TO bench, public;",
+  "CREATE FUNCTION getEffectiveXtUser() RETURNS TEXT AS $$"
+  "  SELECT CURRENT_USER::TEXT; $$ LANGUAGE sql;",
+  "CREATE FUNCTION fetchMetricBool(TEXT) RETURNS BOOLEAN AS $$"
+  "  SELECT false; $$ LANGUAGE sql;",
+  "CREATE FUNCTION fetchMetricText(TEXT) RETURNS TEXT AS $$"
+  "  SELECT CASE WHEN $1 LIKE '%Treatment' THEN 'None' END; $$ LANGUAGE sql;",
+  "CREATE TABLE locale (locale_id INTEGER PRIMARY KEY,"
+  "                     locale_qty_scale INTEGER, locale_curr_scale INTEGER);",
+  "INSERT INTO locale VALUES (1, 2, 2);",
+  "CREATE TABLE usr (usr_username TEXT, usr_locale_id INTEGER);",
+  "INSERT INTO usr VALUES (CURRENT_USER, 1);",
+  "CREATE TABLE bench_import (item_number TEXT, item_descrip1 TEXT,"
+  "                           item_qty NUMERIC(18,6));",
+  0
+};
+
+PgFixture::PgFixture()
+  : _dir(0),
+    _port(0)
+{
+}
+
+PgFixture::~PgFixture()
+{
+  stop();
+}
+
+QString PgFixture::itemTable(int rows)
+{
+  return QString("bench.item_%1").arg(rows);
+}
+
+bool PgFixture::start(QString &errmsg)
+{
+  QSqlDatabase db = QSqlDatabase::addDatabase("QPSQL");
+
+  if (! qgetenv("BENCH_PGHOST").isEmpty())
+  {
+    db.setHostName(QString::fromLocal8Bit(qgetenv("BENCH_PGHOST")));
+    db.setPort(qgetenv("BENCH_PGPORT").isEmpty() ? 5432 : qgetenv("BENCH_PGPORT").toInt());
+    db.setDatabaseName(QString::fromLocal8Bit(qgetenv("BENCH_PGDATABASE")));
+    db.setUserName(QString::fromLocal8Bit(qgetenv("BENCH_PGUSER")));
+    db.setPassword(QString::fromLocal8Bit(qgetenv("BENCH_PGPASSWORD")));
+  }
+  else
+  {
+    _bindir = QString::fromLocal8Bit(qgetenv("PG_BINDIR"));
+    QString initdb = _bindir.isEmpty() ? QStandardPaths::findExecutable("initdb")
+                                       : QDir(_bindir).filePath("initdb");
+    if (initdb.isEmpty())
+    {
+      errmsg = "Could not find initdb; set PG_BINDIR or BENCH_PGHOST";
+      return false;
+    }
+    _bindir = QFileInfo(initdb).absolutePath();
+
+    QTcpServer probe;
+    if (! probe.listen(QHostAddress::LocalHost))
+    {
+      errmsg = "Could not find a free port: " + probe.errorString();
+      return false;
+    }
+    _port = probe.serverPort();
+    probe.close();
+
+    _dir = new QTemporaryDir();
+    QString data = QDir(_dir->path()).filePath("data");
+    if (! run("initdb", QStringList() << "-D" << data << "-U" << "admin"
+                                      << "-A" << "trust" << "-E" << "UTF8"
+                                      << "--no-sync", errmsg) ||
+        ! run("pg_ctl", QStringList() << "-D" << data << "-w"
+                                      << "-l" << QDir(_dir->path()).filePath("log")
+                                      << "-o" << QString("-p %1 -c listen_addresses=localhost"
+                                                         " -c fsync=off").arg(_port)
+                                      << "start", errmsg))
+    {
+      delete _dir;
+      _dir = 0;
+      return false;
+    }
+
+    db.setHostName("localhost");
+    db.setPort(_port);
+    db.setDatabaseName("postgres");
+    db.setUserName("admin");
+  }
+
+  if (! db.open())
+  {
+    errmsg = db.lastError().text();
+    return false;
+  }
+
+  exec("DROP SCHEMA IF EXISTS bench CASCADE;", errmsg);
+  for (int i = 0; __schema[i]; i++)
+    if (! exec(__schema[i], errmsg))
+      return false;
+
+  return true;
+}
+
+void PgFixture::stop()
+{
+  if (QSqlDatabase::database(QSqlDatabase::defaultConnection, false).isOpen())
+  {
+    QString errmsg;
+    if (! _dir)
+      exec("DROP SCHEMA IF EXISTS bench CASCADE;", errmsg);
+    QSqlDatabase::database().close();
+  }
+
+  if (_dir)
+  {
+    QString errmsg;
+    run("pg_ctl", QStringList() << "-D" << QDir(_dir->path()).filePath("data")
+                                << "-w" << "-m" << "fast" << "stop", errmsg);
+    delete _dir;
+    _dir = 0;
+  }
+  _seeded.clear();
+}
+
+/* The item rows are generated on the server. Numbers, descriptions and
+   dates are spread so sorting on any column has real work to do.
+ */
+bool PgFixture::seed(int rows, QString &errmsg)
+{
+  if (_seeded.contains(rows))
+    return true;
+
+  QString table = itemTable(rows);
+  if (! exec(QString("CREATE TABLE %1 AS"
+                     " SELECT i AS item_id,"
+                     "        'ITEM' || lpad(((i::BIGINT * 7919) % %2)::TEXT, 8, '0') AS item_number,"
+                     "        md5(i::TEXT) AS item_descrip1,"
+                     "        ((i % 1000) * 1.25)::NUMERIC(18,6) AS item_qty,"
+                     "        (((i::BIGINT * 104729) % 100000) / 100.0)::NUMERIC(16,2) AS item_price,"
+                     "        DATE '2010-01-01' + (i % 3650) AS item_date,"
+                     "        (i % 3 = 0) AS item_active"
+                     "   FROM generate_series(1, %2) AS i;")
+               .arg(table).arg(rows), errmsg) ||
+      ! exec(QString("ALTER TABLE %1 ADD PRIMARY KEY (item_id);").arg(table), errmsg) ||
+      ! exec(QString("ANALYZE %1;").arg(table), errmsg))
+    return false;
+
+  _seeded.insert(rows);
+  return true;
+}
+
+bool PgFixture::exec(const QString &sql, QString &errmsg)
+{
+  QSqlQuery q;
+  if (! q.exec(sql))
+  {
+    errmsg = q.lastError().text();
+    return false;
+  }
+  return true;
+}
+
+bool PgFixture::run(const QString &program, const QStringList &args, QString &errmsg)
+{
+  QProcess proc;
+  proc.setProcessChannelMode(QProcess::MergedChannels);
+  proc.start(QDir(_bindir).filePath(program), args);
+  if (! proc.waitForFinished(120000) || proc.exitCode() != 0)
+  {
+    errmsg = QString("%1 failed: %2").arg(program, QString::fromLocal8Bit(proc.readAll()));
+    return false;
+  }
+  if (DEBUG)
+    qDebug("%s", proc.readAll().constData());
+  return true;
+}
@@ -0,0 +1,53 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#ifndef __PGFIXTURE_H__
+#define __PGFIXTURE_H__
+
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+class QTemporaryDir;
+
+/** @brief A PostgreSQL database seeded with synthetic rows for benchmarks.
+
+  If BENCH_PGHOST is set the fixture connects to that server, using
+  BENCH_PGPORT, BENCH_PGDATABASE, BENCH_PGUSER and BENCH_PGPASSWORD, and
+  creates its tables in a bench schema that is dropped again by stop().
+  Otherwise it runs initdb and pg_ctl, from PG_BINDIR or the PATH, to start
+  a throwaway cluster in a temporary directory.
+
+  The fixture opens the default QSqlDatabase connection so XSqlQuery and
+  the widgets under test use it without further setup.
+ */
+class PgFixture
+{
+  public:
+    PgFixture();
+    ~PgFixture();
+
+    bool start(QString &errmsg);
+    void stop();
+
+    bool seed(int rows, QString &errmsg);
+    static QString itemTable(int rows);
+
+  protected:
+    bool exec(const QString &sql, QString &errmsg);
+    bool run(const QString &program, const QStringList &args, QString &errmsg);
+
+    QTemporaryDir *_dir;
+    QString        _bindir;
+    int            _port;
+    QSet<int>      _seeded;
+};
+
+#endif
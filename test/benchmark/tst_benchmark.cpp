@@ -0,0 +1,401 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QScriptEngine>
+#include <QTemporaryFile>
+#include <QtTest>
+
+#include <parameter.h>
+
+#include "alloccounter.h"
+#include "exporthelper.h"
+#include "importhelper.h"
+#include "pgfixture.h"
+#include "setupscriptapi.h"
+#include "storedProcErrorLookup.h"
+#include "tarfile.h"
+#include "xcombobox.h"
+#include "xsqlquery.h"
+#include "xtreewidget.h"
+
+/* Each benchmark runs once per scenario inside QBENCHMARK_ONCE, so the
+   QTest output (-o results.xml,xml or -o results.csv,csv) carries the wall
+   time. Operations per second, allocations and peak RSS are written to
+   the JSON file named by BENCH_RESULTS, benchmark-results.json by default.
+
+   Scenarios are 10k, 100k and 1M rows. BENCH_MAX_ROWS drops the larger
+   ones, e.g. for a quick run in CI.
+ */
+class tst_Benchmark : public QObject
+{
+  Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void xtreewidgetPopulate_data();
+    void xtreewidgetPopulate();
+    void xtreewidgetSort_data();
+    void xtreewidgetSort();
+    void xcomboboxPopulate_data();
+    void xcomboboxPopulate();
+    void exportDelimited_data();
+    void exportDelimited();
+    void importXML_data();
+    void importXML();
+    void tarFile_data();
+    void tarFile();
+    void storedProcErrorLookup();
+    void scriptEngineSetup();
+
+  private:
+    void   scenarios(int divisor = 1);
+    void   seed(int rows);
+    void   begin();
+    void   record(int rows, qint64 ops);
+    static QString itemSql(int rows);
+
+    PgFixture     _db;
+    QJsonArray    _results;
+    QElapsedTimer _timer;
+};
+
+void tst_Benchmark::initTestCase()
+{
+  QString errmsg;
+  if (! _db.start(errmsg))
+    QSKIP(qPrintable("No PostgreSQL for the benchmarks: " + errmsg));
+}
+
+void tst_Benchmark::cleanupTestCase()
+{
+  _db.stop();
+
+  QString path = QString::fromLocal8Bit(qgetenv("BENCH_RESULTS"));
+  if (path.isEmpty())
+    path = "benchmark-results.json";
+
+  QFile file(path);
+  if (file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    file.write(QJsonDocument(_results).toJson());
+  else
+    qWarning("Could not write %s: %s", qPrintable(path), qPrintable(file.errorString()));
+}
+
+/* Benchmarks whose cost per row is much higher than a list fill, like the
+   XML import's one INSERT per row, pass a divisor so the largest scenario
+   still finishes in minutes.
+ */
+void tst_Benchmark::scenarios(int divisor)
+{
+  QTest::addColumn<int>("rows");
+
+  int max = qgetenv("BENCH_MAX_ROWS").isEmpty() ? 1000000 : qgetenv("BENCH_MAX_ROWS").toInt();
+  if (10000 <= max)   QTest::newRow("10k")  << 10000   / divisor;
+  if (100000 <= max)  QTest::newRow("100k") << 100000  / divisor;
+  if (1000000 <= max) QTest::newRow("1M")   << 1000000 / divisor;
+}
+
+void tst_Benchmark::seed(int rows)
+{
+  QString errmsg;
+  if (! _db.seed(rows, errmsg))
+    QFAIL(qPrintable(errmsg));
+}
+
+QString tst_Benchmark::itemSql(int rows)
+{
+  return QString("SELECT item_id, item_number, item_descrip1,"
+                 "       item_qty, 'qty' AS item_qty_xtnumericrole,"
+                 "       item_price, 'salesprice' AS item_price_xtnumericrole,"
+                 "       item_date, item_active"
+                 "  FROM %1 ORDER BY item_id;").arg(PgFixture::itemTable(rows));
+}
+
+void tst_Benchmark::begin()
+{
+  AllocCounter::resetPeakRss();
+  AllocCounter::reset();
+  _timer.start();
+}
+
+void tst_Benchmark::record(int rows, qint64 ops)
+{
+  qint64 nsecs  = _timer.nsecsElapsed();
+  qint64 allocs = AllocCounter::allocations();
+
+  QJsonObject result;
+  result.insert("benchmark",   QString(QTest::currentTestFunction()));
+  result.insert("scenario",    QString(QTest::currentDataTag()));
+  result.insert("rows",        rows);
+  result.insert("ops",         double(ops));
+  result.insert("msecs",       nsecs / 1000000.0);
+  result.insert("opsPerSec",   nsecs ? ops * 1e9 / nsecs : 0.0);
+  result.insert("allocations", double(allocs));
+  result.insert("peakRssKb",   double(AllocCounter::peakRssKb()));
+  _results.append(result);
+
+  qDebug("%s %s: %lld ops in %.1f ms, %lld allocations, peak RSS %lld kB",
+         QTest::currentTestFunction(), QTest::currentDataTag(),
+         ops, nsecs / 1000000.0, allocs, AllocCounter::peakRssKb());
+}
+
+void tst_Benchmark::xtreewidgetPopulate_data()
+{
+  scenarios();
+}
+
+void tst_Benchmark::xtreewidgetPopulate()
+{
+  QFETCH(int, rows);
+  seed(rows);
+
+  XTreeWidget list(0);
+  list.addColumn("Number",      100, Qt::AlignLeft,  true, "item_number");
+  list.addColumn("Description", 200, Qt::AlignLeft,  true, "item_descrip1");
+  list.addColumn("Qty",         80,  Qt::AlignRight, true, "item_qty");
+  list.addColumn("Price",       80,  Qt::AlignRight, true, "item_price");
+  list.addColumn("Date",        80,  Qt::AlignLeft,  true, "item_date");
+  list.addColumn("Active",      40,  Qt::AlignLeft,  true, "item_active");
+
+  XSqlQuery q;
+  q.prepare(itemSql(rows));
+
+  QBENCHMARK_ONCE {
+    begin();
+    q.exec();
+    list.populate(q);
+    record(rows, rows);
+  }
+  QCOMPARE(list.topLevelItemCount(), rows);
+}
+
+void tst_Benchmark::xtreewidgetSort_data()
+{
+  scenarios();
+}
+
+void tst_Benchmark::xtreewidgetSort()
+{
+  QFETCH(int, rows);
+  seed(rows);
+
+  XTreeWidget list(0);
+  list.addColumn("Number",      100, Qt::AlignLeft,  true, "item_number");
+  list.addColumn("Description", 200, Qt::AlignLeft,  true, "item_descrip1");
+  list.addColumn("Price",       80,  Qt::AlignRight, true, "item_price");
+  list.populate(XSqlQuery(itemSql(rows)));
+  QCOMPARE(list.topLevelItemCount(), rows);
+
+  // text, then numeric, then reversed, so every comparison path is timed
+  QBENCHMARK_ONCE {
+    begin();
+    list.sortItems(1, Qt::AscendingOrder);
+    list.sortItems(2, Qt::AscendingOrder);
+    list.sortItems(0, Qt::DescendingOrder);
+    record(rows, 3);
+  }
+}
+
+void tst_Benchmark::xcomboboxPopulate_data()
+{
+  scenarios();
+}
+
+void tst_Benchmark::xcomboboxPopulate()
+{
+  QFETCH(int, rows);
+  seed(rows);
+
+  XComboBox combo;
+  XSqlQuery q;
+  q.prepare(QString("SELECT item_id, item_number || ' - ' || item_descrip1, item_number"
+                    "  FROM %1 ORDER BY item_number;").arg(PgFixture::itemTable(rows)));
+
+  QBENCHMARK_ONCE {
+    begin();
+    q.exec();
+    combo.populate(q);
+    record(rows, rows);
+  }
+  QCOMPARE(combo.count(), rows);
+}
+
+void tst_Benchmark::exportDelimited_data()
+{
+  scenarios();
+}
+
+void tst_Benchmark::exportDelimited()
+{
+  QFETCH(int, rows);
+  seed(rows);
+
+  ParameterList params;
+  QString       errmsg;
+  QString       result;
+  QString       mql = QString("SELECT item_number, item_descrip1, item_qty,"
+                              "       item_price, item_date, item_active"
+                              "  FROM %1"
+                              " <? if exists('active') ?> WHERE item_active <? endif ?>"
+                              " ORDER BY item_id;").arg(PgFixture::itemTable(rows));
+
+  QBENCHMARK_ONCE {
+    begin();
+    result = ExportHelper::generateDelimited(mql, params, errmsg);
+    record(rows, rows);
+  }
+  QVERIFY2(errmsg.isEmpty(), qPrintable(errmsg));
+  QVERIFY(result.count('\n') >= rows);
+}
+
+void tst_Benchmark::importXML_data()
+{
+  scenarios(10);
+}
+
+void tst_Benchmark::importXML()
+{
+  QFETCH(int, rows);
+
+  QTemporaryFile file(QDir::tempPath() + "/benchXXXXXX.xml");
+  file.setAutoRemove(true);
+  QVERIFY(file.open());
+  file.write("<?xml version=\"1.0\"?>\n<xtupleimport>\n");
+  for (int i = 1; i <= rows; i++)
+    file.write(QString("<bench_import schema=\"bench\">"
+                       "<item_number>IMP%1</item_number>"
+                       "<item_descrip1>Imported item %1</item_descrip1>"
+                       "<item_qty>%2</item_qty>"
+                       "</bench_import>\n").arg(i).arg(i % 1000).toUtf8());
+  file.write("</xtupleimport>\n");
+  file.close();
+
+  XSqlQuery truncate("TRUNCATE bench.bench_import;");
+
+  QString errmsg;
+  QString warnmsg;
+  bool    ok = false;
+  QBENCHMARK_ONCE {
+    begin();
+    ok = ImportHelper::importXML(file.fileName(), errmsg, warnmsg);
+    record(rows, rows);
+  }
+  QVERIFY2(ok, qPrintable(errmsg));
+
+  XSqlQuery count("SELECT COUNT(*) AS imported FROM bench.bench_import;");
+  QVERIFY(count.first());
+  QCOMPARE(count.value("imported").toInt(), rows);
+}
+
+void tst_Benchmark::tarFile_data()
+{
+  scenarios(10);
+}
+
+/* Package files are tar archives of many small members, so build one in
+   memory with a 512 byte header and one data block per member.
+ */
+void tst_Benchmark::tarFile()
+{
+  QFETCH(int, rows);
+
+  QByteArray archive;
+  archive.reserve((rows + 2) * 1024);
+  for (int i = 0; i < rows; i++)
+  {
+    QByteArray body = QString("<script name=\"member%1\">print(%1);</script>\n")
+                        .arg(i).toUtf8();
+    QByteArray header(512, '\0');
+    QByteArray name = QString("package/member%1.xml").arg(i).toLatin1();
+    memcpy(header.data(),       name.constData(), name.size());
+    memcpy(header.data() + 100, "0000644",  7);
+    memcpy(header.data() + 108, "0000000",  7);
+    memcpy(header.data() + 116, "0000000",  7);
+    QByteArray size = QByteArray::number(body.size(), 8).rightJustified(11, '0');
+    memcpy(header.data() + 124, size.constData(), 11);
+    memcpy(header.data() + 136, "00000000000", 11);
+    header[156] = '0';
+    memcpy(header.data() + 257, "ustar", 5);
+
+    memset(header.data() + 148, ' ', 8);
+    unsigned int checksum = 0;
+    for (int c = 0; c < 512; c++)
+      checksum += (unsigned char)header.at(c);
+    QByteArray sum = QByteArray::number(checksum, 8).rightJustified(6, '0');
+    memcpy(header.data() + 148, sum.constData(), 6);
+    header[154] = '\0';
+
+    archive.append(header);
+    body.append(QByteArray(512 - body.size() % 512, '\0'));
+    archive.append(body);
+  }
+  archive.append(QByteArray(1024, '\0'));
+
+  int members = 0;
+  QBENCHMARK_ONCE {
+    begin();
+    TarFile tar(archive);
+    QVERIFY(tar.isValid());
+    members = tar._list.size();
+    record(rows, rows);
+  }
+  QCOMPARE(members, rows);
+}
+
+void tst_Benchmark::storedProcErrorLookup()
+{
+  const int lookups = 100000;
+  QString   result;
+
+  QBENCHMARK_ONCE {
+    begin();
+    for (int i = 0; i < lookups; i++)
+      result = ::storedProcErrorLookup(i % 2 ? "deleteItem" : "closeAccountingPeriod",
+                                       -(i % 10) - 1);
+    record(0, lookups);
+  }
+  QVERIFY(! result.isEmpty());
+}
+
+void tst_Benchmark::scriptEngineSetup()
+{
+  const int engines = 20;
+
+  QBENCHMARK_ONCE {
+    begin();
+    for (int i = 0; i < engines; i++)
+    {
+      QScriptEngine engine;
+      setupScriptApi(&engine);
+    }
+    record(0, engines);
+  }
+}
+
+// the widgets need a QApplication but never a screen
+int main(int argc, char *argv[])
+{
+  if (qgetenv("QT_QPA_PLATFORM").isEmpty())
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+
+  QApplication app(argc, argv);
+  tst_Benchmark bench;
+  return QTest::qExec(&bench, argc, argv);
+}
+
+#include "tst_benchmark.moc"
@@ -0,0 +1,27 @@
+#
+# This file is part of the xTuple ERP: PostBooks Edition, a free and
+# open source Enterprise Resource Planning software suite,
+# Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+# It is licensed to you under the Common Public Attribution License
+# version 1.0, the full text of which (including xTuple-specific Exhibits)
+# is available at www.xtuple.com/CPAL.  By using this software, you agree
+# to be bound by its terms.
+#
+
+# CCHttpClient only needs QtNetwork, so the test builds it directly
+# instead of linking the whole client.
+TEMPLATE = app
+TARGET   = tst_cchttpclient
+CONFIG  += qt warn_on console testcase
+CONFIG  -= app_bundle
+QT      += network testlib
+QT      -= gui
+
+INCLUDEPATH += ../../guiclient
+
+HEADERS = ../../guiclient/cchttpclient.h \
+          mockgateway.h
+
+SOURCES = ../../guiclient/cchttpclient.cpp \
+          mockgateway.cpp \
+          tst_cchttpclient.cpp
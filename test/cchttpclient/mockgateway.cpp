@@ -0,0 +1,202 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#include "mockgateway.h"
+
+#include <QHostAddress>
+#include <QMutexLocker>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QTimer>
+
+MockGateway::MockGateway()
+  : QObject(0),
+    _server(0),
+    _port(0),
+    _requests(0),
+    _connections(0),
+    _inFlight(0),
+    _maxInFlight(0)
+{
+  _thread = new QThread();
+  moveToThread(_thread);
+  _thread->start();
+  QMetaObject::invokeMethod(this, "sListen", Qt::BlockingQueuedConnection);
+}
+
+MockGateway::~MockGateway()
+{
+  _thread->quit();
+  _thread->wait();
+  delete _thread;
+}
+
+void MockGateway::sListen()
+{
+  _server = new QTcpServer(this);
+  connect(_server, SIGNAL(newConnection()), this, SLOT(sNewConnection()));
+  _server->listen(QHostAddress::LocalHost, 0);
+
+  QMutexLocker lock(&_mutex);
+  _port = _server->serverPort();
+}
+
+quint16 MockGateway::port() const
+{
+  QMutexLocker lock(&_mutex);
+  return _port;
+}
+
+void MockGateway::enqueue(int pstatus, const QByteArray &pbody, int pdelay)
+{
+  Response response;
+  response.status = pstatus;
+  response.body   = pbody;
+  response.delay  = pdelay;
+
+  QMutexLocker lock(&_mutex);
+  _script.enqueue(response);
+}
+
+int MockGateway::requests() const
+{
+  QMutexLocker lock(&_mutex);
+  return _requests;
+}
+
+int MockGateway::connections() const
+{
+  QMutexLocker lock(&_mutex);
+  return _connections;
+}
+
+int MockGateway::maxInFlight() const
+{
+  QMutexLocker lock(&_mutex);
+  return _maxInFlight;
+}
+
+QList<QByteArray> MockGateway::bodies() const
+{
+  QMutexLocker lock(&_mutex);
+  return _bodies;
+}
+
+void MockGateway::reset()
+{
+  QMutexLocker lock(&_mutex);
+  _script.clear();
+  _bodies.clear();
+  _requests    = 0;
+  _connections = 0;
+  _maxInFlight = _inFlight;
+}
+
+void MockGateway::sNewConnection()
+{
+  while (_server->hasPendingConnections())
+  {
+    QTcpSocket *socket = _server->nextPendingConnection();
+    connect(socket, SIGNAL(readyRead()),    this,   SLOT(sReadyRead()));
+    connect(socket, SIGNAL(disconnected()), this,   SLOT(sDisconnected()));
+
+    QMutexLocker lock(&_mutex);
+    _connections++;
+  }
+}
+
+void MockGateway::sDisconnected()
+{
+  QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+  if (socket)
+  {
+    _buffers.remove(socket);
+    socket->deleteLater();
+  }
+}
+
+void MockGateway::sReadyRead()
+{
+  QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+  if (! socket)
+    return;
+
+  QByteArray &buffer = _buffers[socket];
+  buffer += socket->readAll();
+
+  // handle every complete request in the buffer
+  forever
+  {
+    int headerEnd = buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0)
+      return;
+
+    int length = 0;
+    foreach (QByteArray line, buffer.left(headerEnd).split('\n'))
+      if (line.toLower().startsWith("content-length:"))
+        length = line.mid(15).trimmed().toInt();
+    if (buffer.size() < headerEnd + 4 + length)
+      return;
+
+    QByteArray body = buffer.mid(headerEnd + 4, length);
+    buffer.remove(0, headerEnd + 4 + length);
+
+    Pending pending;
+    pending.socket = socket;
+    {
+      QMutexLocker lock(&_mutex);
+      _requests++;
+      _bodies.append(body);
+      _inFlight++;
+      _maxInFlight = qMax(_maxInFlight, _inFlight);
+      if (_script.isEmpty())
+      {
+        pending.response.status = 200;
+        pending.response.body   = "OK";
+        pending.response.delay  = 0;
+      }
+      else
+        pending.response = _script.dequeue();
+    }
+    QTimer *timer = new QTimer(this);
+    timer->setSingleShot(true);
+    connect(timer, SIGNAL(timeout()), this, SLOT(sRespond()));
+    _pending.insert(timer, pending);
+    timer->start(pending.response.delay);
+  }
+}
+
+void MockGateway::sRespond()
+{
+  QTimer *timer = qobject_cast<QTimer*>(sender());
+  if (! timer || ! _pending.contains(timer))
+    return;
+
+  Pending pending = _pending.take(timer);
+  timer->deleteLater();
+  {
+    QMutexLocker lock(&_mutex);
+    _inFlight--;
+  }
+  if (! pending.socket ||
+      pending.socket->state() != QAbstractSocket::ConnectedState)
+    return;
+
+  QByteArray reason = pending.response.status == 200 ? "OK" : "Error";
+  QByteArray reply  = "HTTP/1.1 " + QByteArray::number(pending.response.status) +
+                      " " + reason + "\r\n"
+                      "Content-Type: text/plain\r\n"
+                      "Content-Length: " + QByteArray::number(pending.response.body.size()) +
+                      "\r\n"
+                      "Connection: keep-alive\r\n"
+                      "\r\n" + pending.response.body;
+  pending.socket->write(reply);
+}
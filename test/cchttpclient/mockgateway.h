@@ -0,0 +1,89 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#ifndef MOCKGATEWAY_H
+#define MOCKGATEWAY_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QPointer>
+#include <QQueue>
+#include <QTcpSocket>
+
+class QTcpServer;
+class QThread;
+class QTimer;
+
+/* A minimal HTTP server standing in for a credit card gateway.
+
+   Responses are scripted with enqueue() and handed out in order, one per
+   POST received; when the script runs out every request gets 200 "OK".
+   The gateway runs on its own thread because CCHttpClient::wait() blocks
+   the thread that calls it.
+ */
+class MockGateway : public QObject
+{
+  Q_OBJECT
+
+  public:
+    struct Response
+    {
+      int        status;
+      QByteArray body;
+      int        delay;   // msec before answering
+    };
+
+    MockGateway();
+    ~MockGateway();
+
+    quint16 port() const;
+    void    enqueue(int pstatus, const QByteArray &pbody = QByteArray(), int pdelay = 0);
+
+    int     requests()       const;
+    int     connections()    const;
+    int     maxInFlight()    const;
+    QList<QByteArray> bodies() const;
+
+  public slots:
+    void    reset();
+
+  private slots:
+    void    sListen();
+    void    sNewConnection();
+    void    sDisconnected();
+    void    sReadyRead();
+    void    sRespond();
+
+  private:
+    struct Pending
+    {
+      QPointer<QTcpSocket> socket;
+      Response             response;
+    };
+
+    QThread                      *_thread;
+    QTcpServer                   *_server;
+    QHash<QTcpSocket*, QByteArray> _buffers;
+    QHash<QTimer*, Pending>       _pending;
+
+    mutable QMutex     _mutex;
+    QQueue<Response>   _script;
+    QList<QByteArray>  _bodies;
+    quint16            _port;
+    int                _requests;
+    int                _connections;
+    int                _inFlight;
+    int                _maxInFlight;
+};
+
+#endif
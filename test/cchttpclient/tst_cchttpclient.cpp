@@ -0,0 +1,206 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#include <QElapsedTimer>
+#include <QNetworkRequest>
+#include <QtTest>
+
+#include "cchttpclient.h"
+#include "mockgateway.h"
+
+class tst_CCHttpClient : public QObject
+{
+  Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+
+    void post();
+    void reusesConnection();
+    void retriesUndelivered();
+    void givesUpAfterRetries();
+    void doesNotResendAfterTimeout();
+    void boundsConcurrency();
+    void abortQueued();
+
+  private:
+    QNetworkRequest request() const;
+    bool            run(int pid, QByteArray &response,
+                        QNetworkReply::NetworkError &error, QString &errorString);
+
+    MockGateway  *_gateway;
+    CCHttpClient *_client;
+};
+
+void tst_CCHttpClient::initTestCase()
+{
+  _gateway = new MockGateway();
+  QVERIFY(_gateway->port() > 0);
+  _client = CCHttpClient::shared();
+}
+
+void tst_CCHttpClient::cleanupTestCase()
+{
+  delete _gateway;
+  _gateway = 0;
+}
+
+void tst_CCHttpClient::init()
+{
+  QCOMPARE(_client->pending(), 0);
+  _gateway->reset();
+  _client->setMaxConcurrent(4);
+  _client->setMaxRetries(2);
+  _client->setTimeout(5000);
+}
+
+QNetworkRequest tst_CCHttpClient::request() const
+{
+  QNetworkRequest result(QUrl(QString("http://127.0.0.1:%1/").arg(_gateway->port())));
+  result.setHeader(QNetworkRequest::ContentTypeHeader, "text/plain");
+  return result;
+}
+
+bool tst_CCHttpClient::run(int pid, QByteArray &response,
+                           QNetworkReply::NetworkError &error, QString &errorString)
+{
+  return _client->wait(pid) &&
+         _client->takeResult(pid, response, error, errorString);
+}
+
+void tst_CCHttpClient::post()
+{
+  _gateway->enqueue(200, "APPROVED");
+
+  QByteArray                  response;
+  QNetworkReply::NetworkError error;
+  QString                     errorString;
+  QVERIFY(run(_client->post(request(), "amount=1.00"), response, error, errorString));
+
+  QCOMPARE(error, QNetworkReply::NoError);
+  QCOMPARE(response, QByteArray("APPROVED"));
+  QCOMPARE(_gateway->requests(), 1);
+  QCOMPARE(_gateway->bodies().value(0), QByteArray("amount=1.00"));
+}
+
+void tst_CCHttpClient::reusesConnection()
+{
+  QByteArray                  response;
+  QNetworkReply::NetworkError error;
+  QString                     errorString;
+  for (int i = 0; i < 3; i++)
+  {
+    QVERIFY(run(_client->post(request(), "x"), response, error, errorString));
+    QCOMPARE(error, QNetworkReply::NoError);
+  }
+
+  // a connection left open by an earlier test may be reused as well
+  QCOMPARE(_gateway->requests(), 3);
+  QVERIFY(_gateway->connections() <= 1);
+}
+
+void tst_CCHttpClient::retriesUndelivered()
+{
+  _gateway->enqueue(503);
+  _gateway->enqueue(503);
+  _gateway->enqueue(200, "APPROVED");
+
+  QByteArray                  response;
+  QNetworkReply::NetworkError error;
+  QString                     errorString;
+  QVERIFY(run(_client->post(request(), "x"), response, error, errorString));
+
+  QCOMPARE(error, QNetworkReply::NoError);
+  QCOMPARE(response, QByteArray("APPROVED"));
+  QCOMPARE(_gateway->requests(), 3);
+}
+
+void tst_CCHttpClient::givesUpAfterRetries()
+{
+  _client->setMaxRetries(1);
+  _gateway->enqueue(503);
+  _gateway->enqueue(503);
+  _gateway->enqueue(200);
+
+  QByteArray                  response;
+  QNetworkReply::NetworkError error;
+  QString                     errorString;
+  QVERIFY(run(_client->post(request(), "x"), response, error, errorString));
+
+  QVERIFY(error != QNetworkReply::NoError);
+  QCOMPARE(_gateway->requests(), 2);
+}
+
+// the service may have charged the card, so a timeout must not be resent
+void tst_CCHttpClient::doesNotResendAfterTimeout()
+{
+  _client->setTimeout(300);
+  _gateway->enqueue(200, "LATE", 1500);
+
+  QByteArray                  response;
+  QNetworkReply::NetworkError error;
+  QString                     errorString;
+  QElapsedTimer               timer;
+  timer.start();
+  QVERIFY(run(_client->post(request(), "x"), response, error, errorString));
+
+  QVERIFY(error != QNetworkReply::NoError);
+  QVERIFY(timer.elapsed() < 1500);
+  QTest::qWait(1500);
+  QCOMPARE(_gateway->requests(), 1);
+}
+
+void tst_CCHttpClient::boundsConcurrency()
+{
+  _client->setMaxConcurrent(2);
+  for (int i = 0; i < 6; i++)
+    _gateway->enqueue(200, "OK", 200);
+
+  QList<int> ids;
+  for (int i = 0; i < 6; i++)
+    ids.append(_client->post(request(), QByteArray::number(i)));
+
+  QByteArray                  response;
+  QNetworkReply::NetworkError error;
+  QString                     errorString;
+  foreach (int id, ids)
+  {
+    QVERIFY(run(id, response, error, errorString));
+    QCOMPARE(error, QNetworkReply::NoError);
+  }
+
+  QCOMPARE(_gateway->requests(), 6);
+  QVERIFY(_gateway->maxInFlight() <= 2);
+}
+
+void tst_CCHttpClient::abortQueued()
+{
+  _client->setMaxConcurrent(1);
+  _gateway->enqueue(200, "FIRST", 300);
+
+  int first  = _client->post(request(), "1");
+  int second = _client->post(request(), "2");
+  _client->abort(second);
+
+  QByteArray                  response;
+  QNetworkReply::NetworkError error;
+  QString                     errorString;
+  QVERIFY(run(second, response, error, errorString));
+  QCOMPARE(error, QNetworkReply::OperationCanceledError);
+
+  QVERIFY(run(first, response, error, errorString));
+  QCOMPARE(error, QNetworkReply::NoError);
+  QCOMPARE(_gateway->requests(), 1);
+}
+
+QTEST_GUILESS_MAIN(tst_CCHttpClient)
+#include "tst_cchttpclient.moc"
@@ -0,0 +1,25 @@
+#
+# This file is part of the xTuple ERP: PostBooks Edition, a free and
+# open source Enterprise Resource Planning software suite,
+# Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+# It is licensed to you under the Common Public Attribution License
+# version 1.0, the full text of which (including xTuple-specific Exhibits)
+# is available at www.xtuple.com/CPAL.  By using this software, you agree
+# to be bound by its terms.
+#
+
+# The error log store only needs QtCore, so the test builds it directly
+# instead of linking the whole client.
+TEMPLATE = app
+TARGET   = tst_errorlog
+CONFIG  += qt warn_on console testcase
+CONFIG  -= app_bundle
+QT      += testlib
+QT      -= gui
+
+INCLUDEPATH += ../../guiclient
+
+HEADERS = ../../guiclient/errorLogStore.h
+
+SOURCES = ../../guiclient/errorLogStore.cpp \
+          tst_errorlog.cpp
@@ -0,0 +1,238 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QtTest>
+
+#include "errorLogStore.h"
+
+static errorLogEntry makeEntry(const QString &message, QtMsgType type = QtWarningMsg)
+{
+  errorLogEntry entry;
+  entry.first    = QDateTime::currentDateTime();
+  entry.last     = entry.first;
+  entry.type     = type;
+  entry.sqlError = false;
+  entry.message  = message;
+  entry.sqlHash  = 0;
+  entry.count    = 1;
+  return entry;
+}
+
+/* Logs a burst of messages taking turns among a few distinct texts, the way
+   several failing auto-refreshes would.
+ */
+class BurstThread : public QThread
+{
+  public:
+    BurstThread(int messages, int distinct, QAtomicInt *posts)
+      : _messages(messages), _distinct(distinct), _posts(posts)
+    {
+    }
+
+  protected:
+    void run()
+    {
+      for (int i = 0; i < _messages; i++)
+      {
+        errorLogEntry entry = makeEntry(QString("burst message %1").arg(i % _distinct));
+        if (errorLogStore::append(entry, false))
+          _posts->ref();
+      }
+    }
+
+    int         _messages;
+    int         _distinct;
+    QAtomicInt *_posts;
+};
+
+class tst_ErrorLog : public QObject
+{
+  Q_OBJECT
+
+  private slots:
+    void init();
+
+    void countsRepeats();
+    void mergesInterleaved();
+    void keepsDistinctApart();
+    void boundsEntries();
+    void forgetsEvicted();
+    void postsOnce();
+    void burst();
+
+  private:
+    int  entries();
+    int  totalCount();
+};
+
+void tst_ErrorLog::init()
+{
+  errorLogStore::clear();
+  errorLogStore::takeNotify();
+}
+
+int tst_ErrorLog::entries()
+{
+  int first, last, generation;
+  errorLogStore::range(first, last, generation);
+  return last - first + 1;
+}
+
+int tst_ErrorLog::totalCount()
+{
+  int first, last, generation;
+  errorLogStore::range(first, last, generation);
+
+  int result = 0;
+  for (int i = first; i <= last; i++)
+  {
+    errorLogEntry entry;
+    if (errorLogStore::at(i, entry))
+      result += entry.count;
+  }
+  return result;
+}
+
+void tst_ErrorLog::countsRepeats()
+{
+  for (int i = 1; i <= 5; i++)
+  {
+    errorLogEntry entry = makeEntry("repeated");
+    errorLogStore::append(entry, false);
+    QCOMPARE(entry.count, i);
+  }
+  QCOMPARE(entries(), 1);
+}
+
+void tst_ErrorLog::mergesInterleaved()
+{
+  for (int i = 0; i < 30; i++)
+  {
+    errorLogEntry entry = makeEntry(QString("source %1").arg(i % 3));
+    errorLogStore::append(entry, false);
+  }
+  QCOMPARE(entries(), 3);
+
+  int first, last, generation;
+  errorLogStore::range(first, last, generation);
+  for (int i = first; i <= last; i++)
+  {
+    errorLogEntry entry;
+    QVERIFY(errorLogStore::at(i, entry));
+    QCOMPARE(entry.count, 10);
+  }
+}
+
+void tst_ErrorLog::keepsDistinctApart()
+{
+  errorLogEntry warning  = makeEntry("same text", QtWarningMsg);
+  errorLogEntry critical = makeEntry("same text", QtCriticalMsg);
+  errorLogEntry located  = makeEntry("same text", QtWarningMsg);
+  located.source = "somefile.cpp:42";
+  errorLogEntry sql      = makeEntry("same text", QtWarningMsg);
+  sql.sqlError = true;
+  sql.sql      = "SELECT 1;";
+  sql.sqlHash  = qHash(sql.sql);
+
+  errorLogStore::append(warning,  false);
+  errorLogStore::append(critical, false);
+  errorLogStore::append(located,  false);
+  errorLogStore::append(sql,      false);
+  QCOMPARE(entries(), 4);
+}
+
+void tst_ErrorLog::boundsEntries()
+{
+  for (int i = 0; i < ERRORLOG_CAPACITY * 4; i++)
+  {
+    errorLogEntry entry = makeEntry(QString("distinct %1").arg(i));
+    errorLogStore::append(entry, false);
+  }
+  QCOMPARE(entries(), ERRORLOG_CAPACITY);
+
+  int first, last, generation;
+  errorLogStore::range(first, last, generation);
+  errorLogEntry entry;
+  QVERIFY(errorLogStore::at(last, entry));
+  QCOMPARE(entry.message, QString("distinct %1").arg(ERRORLOG_CAPACITY * 4 - 1));
+  QVERIFY(errorLogStore::at(first, entry));
+  QCOMPARE(entry.message, QString("distinct %1").arg(ERRORLOG_CAPACITY * 3));
+}
+
+void tst_ErrorLog::forgetsEvicted()
+{
+  errorLogEntry entry = makeEntry("evicted");
+  errorLogStore::append(entry, false);
+  for (int i = 0; i < ERRORLOG_CAPACITY; i++)
+  {
+    errorLogEntry filler = makeEntry(QString("filler %1").arg(i));
+    errorLogStore::append(filler, false);
+  }
+
+  // the first entry fell off the front, so a repeat starts a new one
+  entry = makeEntry("evicted");
+  errorLogStore::append(entry, false);
+  QCOMPARE(entry.count, 1);
+  QCOMPARE(entries(), ERRORLOG_CAPACITY);
+
+  entry = makeEntry("evicted");
+  errorLogStore::append(entry, false);
+  QCOMPARE(entry.count, 2);
+}
+
+void tst_ErrorLog::postsOnce()
+{
+  errorLogEntry entry = makeEntry("first");
+  QVERIFY(errorLogStore::append(entry, false));
+  entry = makeEntry("second");
+  QVERIFY(! errorLogStore::append(entry, true));
+  QVERIFY(errorLogStore::takeNotify());
+
+  entry = makeEntry("third");
+  QVERIFY(errorLogStore::append(entry, false));
+  QVERIFY(! errorLogStore::takeNotify());
+}
+
+/* A million messages from several threads at once: nothing is lost, the
+   repeats collapse however they interleave, and only one flush is asked
+   for until the GUI takes it.
+ */
+void tst_ErrorLog::burst()
+{
+  const int threads  = 8;
+  const int messages = 125000;
+  const int distinct = 16;
+
+  QAtomicInt posts(0);
+  QList<BurstThread *> workers;
+  for (int i = 0; i < threads; i++)
+    workers.append(new BurstThread(messages, distinct, &posts));
+
+  QElapsedTimer timer;
+  timer.start();
+  foreach (BurstThread *worker, workers)
+    worker->start();
+  foreach (BurstThread *worker, workers)
+    QVERIFY(worker->wait(120000));
+  qint64 msecs = timer.elapsed();
+  qDeleteAll(workers);
+
+  QCOMPARE(entries(), distinct);
+  QCOMPARE(totalCount(), threads * messages);
+  QCOMPARE(posts.load(), 1);
+
+  qDebug("%d messages in %lld ms", threads * messages, msecs);
+}
+
+QTEST_GUILESS_MAIN(tst_ErrorLog)
+#include "tst_errorlog.moc"
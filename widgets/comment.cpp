@@ -327,6 +327,8 @@ void comment::populate()
                   "WHERE (comment_id=:comment_id);" );
   _query.bindValue(":comment_id", _commentid);
   _query.exec();
+  if (! _touchedIds.contains(_commentid))
+    _touchedIds.append(_commentid);
   if (_query.first())
   {
     _cmnttype->setId(_query.value("comment_cmnttype_id").toInt());
@@ -49,6 +49,7 @@ class XTUPLEWIDGETS_EXPORT comment : public QDialog, public Ui::comment
     QList <QVariant> _commentIDList;
     int _commentLocation;
     int _commentid;
+    QList<int> _touchedIds;
     int _targetId;
     int _mode;
     QString _sourcetype;
@@ -15,10 +15,14 @@
 #include <QVBoxLayout>
 #include <QList>
 #include <QTextBrowser>
+#include <QTextCursor>
+#include <QTextFrame>
 #include <QDateTime>
 #include <QDesktopServices>
 #include <QDebug>
 #include <QScrollBar>
+#include <QSqlError>
+#include <QTimer>
 #if QT_VERSION >= 0x050000
 #include <QUrlQuery>
 #endif
@@ -27,6 +31,8 @@
 #include <parameter.h>
 #include <xsqlquery.h>
 
+#include "errorReporter.h"
+
 #include "comment.h"
 #include "comments.h"
 
@@ -135,6 +141,10 @@ Comments::Comments(QWidget *pParent, const char *name) :
   setObjectName(name);
   _sourceid = -1;
   _editable = true;
+  _pageSize = 50;
+  _atEnd    = true;
+  _newestId = -1;
+  _oldestId = -1;
   if (_strMap.isEmpty()) {
     (void)commentMap();
   }
@@ -206,6 +216,8 @@ Comments::Comments(QWidget *pParent, const char *name) :
   connect(_comment, SIGNAL(itemSelected(int)), _viewComment, SLOT(animateClick()));
   connect(_browser, SIGNAL(anchorClicked(QUrl)), this, SLOT(anchorClicked(QUrl)));
   connect(_verbose, SIGNAL(toggled(bool)), this, SLOT(setVerboseCommentList(bool)));
+  connect(_comment->verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(sScrolled(int)));
+  connect(_browser->verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(sScrolled(int)));
 
   setFocusProxy(_comment);
   setVerboseCommentList(_verboseCommentList);
@@ -255,7 +267,7 @@ void Comments::sNew()
   if (newdlg.exec() != QDialog::Rejected)
   {
     emit commentAdded();
-    refresh();
+    sFetchNewer();
   }
 }
 
@@ -266,7 +278,7 @@ void Comments::sView()
   params.append("sourceType", _sourcetype);
   params.append("source_id", _sourceid);
   params.append("comment_id", _comment->id());
-  params.append("commentIDList", _commentIDList);
+  params.append("commentIDList", allCommentIDs());
 
   comment newdlg(this, "", true);
   newdlg.setWindowModality(Qt::WindowModal);
@@ -281,105 +293,273 @@ void Comments::sEdit()
   params.append("sourceType", _sourcetype);
   params.append("source_id", _sourceid);
   params.append("comment_id", _comment->id());
-  params.append("commentIDList", _commentIDList);
+  params.append("commentIDList", allCommentIDs());
 
   comment newdlg(this, "", true);
   newdlg.setWindowModality(Qt::WindowModal);
   newdlg.set(params);
   newdlg.exec();
-  refresh();
+  refreshComments(newdlg._touchedIds);
 }
 
+/** Reload the comment list from scratch, fetching only the newest page.
+
+    Older comments are fetched a page at a time by fetchMore() as the user
+    scrolls toward the end of either the list or the verbose text.
+ */
 void Comments::refresh()
 {
   _browser->document()->clear();
+  _commentFrames.clear();
   _editmap->clear();
   _editmap2->clear();
+  _comment->clear();
+  _atEnd      = false;
+  _newestDate = QDateTime();
+  _newestId   = -1;
+  _oldestDate = QDateTime();
+  _oldestId   = -1;
   if(-1 == _sourceid)
   {
-    _comment->clear();
+    _atEnd = true;
     return;
   }
 
+  if(_sourcetype == "CRMA")
+    _comment->showColumn(2);
+  else
+    _comment->hideColumn(2);
+
+  XSqlQuery comment;
+  if (fetch(comment, FirstPage))
+    _comment->populate(comment, false, XTreeWidget::Append);
+  QTimer::singleShot(0, this, SLOT(sFillView()));
+}
+
+/** Append the next page of older comments to the list and the verbose text.
+ */
+void Comments::fetchMore()
+{
+  if (_atEnd || -1 == _sourceid)
+    return;
+
   XSqlQuery comment;
-  if(_sourcetype != "CRMA")
+  if (fetch(comment, NextPage))
+    _comment->populate(comment, false, XTreeWidget::Append);
+  QTimer::singleShot(0, this, SLOT(sFillView()));
+}
+
+/** Keep fetching older pages until the visible view can scroll, so
+    sScrolled() has something to react to.
+ */
+void Comments::sFillView()
+{
+  QScrollBar *scrbar = _verboseCommentList ? _browser->verticalScrollBar()
+                                           : _comment->verticalScrollBar();
+  if (! _atEnd && scrbar->maximum() <= 0)
+    fetchMore();
+}
+
+/** Insert comments posted since the last fetch at the top of the list
+    without reloading the ones already shown.
+ */
+void Comments::sFetchNewer()
+{
+  if (_newestId < 0)
   {
-    _comment->hideColumn(2);
-    comment.prepare( "SELECT comment_id, comment_date, comment_source,"
-                     "       CASE WHEN (cmnttype_name IS NOT NULL) THEN cmnttype_name"
-                     "            ELSE :none"
-                     "       END AS type,"
-                     "       comment_user,"
-                     "       firstLine(detag(comment_text)) AS first,"
-                     "       comment_text, "
-                     "       COALESCE(cmnttype_editable,false) AS editable, "
-                     "       comment_public, "
-                     "       comment_user=getEffectiveXtUser() AS self "
-                     "FROM comment LEFT OUTER JOIN cmnttype ON (comment_cmnttype_id=cmnttype_id) "
-                     "WHERE ( (comment_source=:source)"
-                     " AND (comment_source_id=:sourceid) ) "
-                     "ORDER BY comment_date DESC;" );
+    refresh();
+    return;
   }
-  else
+
+  XSqlQuery comment;
+  if (! fetch(comment, Newer))
+    return;
+
+  int oldCount = _comment->topLevelItemCount();
+  _comment->populate(comment, false, XTreeWidget::Append);
+  int added = _comment->topLevelItemCount() - oldCount;
+  for (int i = 0; i < added; i++)
+    _comment->insertTopLevelItem(i, (XTreeWidgetItem*)_comment->takeTopLevelItem(oldCount + i));
+}
+
+/** Re-read a single comment and update its entry in place.
+ */
+void Comments::refreshComment(int pCommentid)
+{
+  refreshComments(QList<int>() << pCommentid);
+}
+
+/** Re-read the given comments and update the ones already shown in place.
+
+    Comments that have not been fetched yet are left for fetchMore(); if
+    none of them is shown, they are assumed to be new and fetched as such.
+ */
+void Comments::refreshComments(const QList<int> &pCommentids)
+{
+  QList<int> shown;
+  foreach (int cid, pCommentids)
+    if (_commentFrames.contains(cid))
+      shown.append(cid);
+
+  if (shown.isEmpty())
+  {
+    sFetchNewer();
+    return;
+  }
+
+  XSqlQuery comment;
+  if (! fetch(comment, Single, shown))
+    return;
+
+  QStringList cols;
+  cols << "type" << "first" << "comment_public";
+  comment.seek(-1);
+  while (comment.next())
+  {
+    XTreeWidgetItem *item = _comment->findXTreeWidgetItemWithId(_comment,
+                                               comment.value("comment_id").toInt());
+    if (! item)
+      continue;
+
+    foreach (QString col, cols)
+    {
+      int colidx = _comment->column(col);
+      if (colidx < 0)
+        continue;
+      item->setData(colidx, Xt::RawRole, comment.value(col));
+      if (comment.value(col).type() == QVariant::Bool)
+        item->setText(colidx, comment.value(col).toBool() ? tr("Yes") : tr("No"));
+      else
+        item->setText(colidx, comment.value(col));
+    }
+  }
+}
+
+/** Return the ids of every comment in the feed, newest first, whether or
+    not it has been fetched yet. The comment dialog steps through this list.
+ */
+QList<QVariant> Comments::allCommentIDs()
+{
+  QList<QVariant> result;
+  if (-1 == _sourceid)
+    return result;
+
+  XSqlQuery comment;
+  if (fetch(comment, AllIds))
+  {
+    while (comment.next())
+      result.append(comment.value("comment_id"));
+  }
+  return result;
+}
+
+/** Run the comment query for one slice of the feed and render the result.
+
+    Comments are paged by (comment_date, comment_id) so each page is an
+    index range scan instead of an OFFSET that rereads everything before it.
+    firstLine(detag()) is applied outside the UNION so the server only
+    evaluates it for the rows actually returned.
+
+    @param comment    The query to run; on success it is left positioned
+                      for XTreeWidget::populate()
+    @param style      Which slice of the feed to fetch
+    @param pCommentids The comments to re-read when style is Single
+
+    @return true if the query ran without error
+ */
+bool Comments::fetch(XSqlQuery &comment, FetchStyle style,
+                     const QList<int> &pCommentids)
+{
+  QString source =
+             "SELECT comment_id, comment_date, comment_source,"
+             "       CASE WHEN (cmnttype_name IS NOT NULL) THEN cmnttype_name"
+             "            ELSE :none"
+             "       END AS type,"
+             "       comment_user, comment_text,"
+             "       COALESCE(cmnttype_editable,false) AS editable,"
+             "       comment_public"
+             "  FROM comment LEFT OUTER JOIN cmnttype ON (comment_cmnttype_id=cmnttype_id)"
+             " WHERE((comment_source=:source)"
+             "   AND (comment_source_id=:sourceid) )";
+  if(_sourcetype == "CRMA")
   {
     // If it's CRMAccount we want to do some extra joining in our SQL
-    _comment->showColumn(2);
-    comment.prepare( "SELECT comment_id, comment_date, comment_source,"
-                     "       CASE WHEN (cmnttype_name IS NOT NULL) THEN cmnttype_name"
-                     "            ELSE :none"
-                     "       END AS type,"
-                     "       comment_user,"
-                     "       firstLine(detag(comment_text)) AS first,"
-                     "       comment_text, "
-                     "       COALESCE(cmnttype_editable,false) AS editable, "
-                     "       comment_public, "
-                     "       comment_user=getEffectiveXtUser() AS self "
-                     "  FROM comment LEFT OUTER JOIN cmnttype ON (comment_cmnttype_id=cmnttype_id) "
-                     " WHERE((comment_source=:source)"
-                     "   AND (comment_source_id=:sourceid) ) "
-                     " UNION "
-                     "SELECT comment_id, comment_date, comment_source,"
-                     "       CASE WHEN (cmnttype_name IS NOT NULL) THEN cmnttype_name"
-                     "            ELSE :none"
-                     "       END,"
-                     "       comment_user, firstLine(detag(comment_text)),"
-                     "       comment_text, "
-                     "       COALESCE(cmnttype_editable,false) AS editable, "
-                     "       comment_public, "
-                     "       comment_user=getEffectiveXtUser() AS self "
-                     "  FROM crmacct, comment LEFT OUTER JOIN cmnttype ON (comment_cmnttype_id=cmnttype_id) "
-                     " WHERE((comment_source=:sourceCust)"
-                     "   AND ( (crmacct_id=:sourceid) OR (crmacct_parent_id=:sourceid) )"
-                     "   AND (comment_source_id=crmacct_cust_id) ) "
-                     " UNION "
-                     "SELECT comment_id, comment_date, comment_source,"
-                     "       CASE WHEN (cmnttype_name IS NOT NULL) THEN cmnttype_name"
-                     "            ELSE :none"
-                     "       END,"
-                     "       comment_user, firstLine(detag(comment_text)),"
-                     "       comment_text, "
-                     "       COALESCE(cmnttype_editable,false) AS editable, "
-                     "       comment_public, "
-                     "       comment_user=getEffectiveXtUser() AS self "
-                     "  FROM crmacct, comment LEFT OUTER JOIN cmnttype ON (comment_cmnttype_id=cmnttype_id) "
-                     " WHERE((comment_source=:sourceVend)"
-                     "   AND ( (crmacct_id=:sourceid) OR (crmacct_parent_id=:sourceid) )"
-                     "   AND (comment_source_id=crmacct_vend_id) ) "
-                     " UNION "
-                     "SELECT comment_id, comment_date, comment_source,"
-                     "       CASE WHEN (cmnttype_name IS NOT NULL) THEN cmnttype_name"
-                     "            ELSE :none"
-                     "       END,"
-                     "       comment_user, firstLine(detag(comment_text)),"
-                     "       comment_text, "
-                     "       COALESCE(cmnttype_editable,false) AS editable, "
-                     "       comment_public, "
-                     "       comment_user=getEffectiveXtUser() AS self "
-                     "  FROM cntct, comment LEFT OUTER JOIN cmnttype ON (comment_cmnttype_id=cmnttype_id) "
-                     " WHERE((comment_source=:sourceContact)"
-                     "   AND (cntct_crmacct_id=:sourceid)"
-                     "   AND (comment_source_id=cntct_id) ) "
-                     "ORDER BY comment_date DESC;" );
+    source +=
+             " UNION "
+             "SELECT comment_id, comment_date, comment_source,"
+             "       CASE WHEN (cmnttype_name IS NOT NULL) THEN cmnttype_name"
+             "            ELSE :none"
+             "       END,"
+             "       comment_user, comment_text,"
+             "       COALESCE(cmnttype_editable,false),"
+             "       comment_public"
+             "  FROM crmacct, comment LEFT OUTER JOIN cmnttype ON (comment_cmnttype_id=cmnttype_id)"
+             " WHERE((comment_source=:sourceCust)"
+             "   AND ( (crmacct_id=:sourceid) OR (crmacct_parent_id=:sourceid) )"
+             "   AND (comment_source_id=crmacct_cust_id) )"
+             " UNION "
+             "SELECT comment_id, comment_date, comment_source,"
+             "       CASE WHEN (cmnttype_name IS NOT NULL) THEN cmnttype_name"
+             "            ELSE :none"
+             "       END,"
+             "       comment_user, comment_text,"
+             "       COALESCE(cmnttype_editable,false),"
+             "       comment_public"
+             "  FROM crmacct, comment LEFT OUTER JOIN cmnttype ON (comment_cmnttype_id=cmnttype_id)"
+             " WHERE((comment_source=:sourceVend)"
+             "   AND ( (crmacct_id=:sourceid) OR (crmacct_parent_id=:sourceid) )"
+             "   AND (comment_source_id=crmacct_vend_id) )"
+             " UNION "
+             "SELECT comment_id, comment_date, comment_source,"
+             "       CASE WHEN (cmnttype_name IS NOT NULL) THEN cmnttype_name"
+             "            ELSE :none"
+             "       END,"
+             "       comment_user, comment_text,"
+             "       COALESCE(cmnttype_editable,false),"
+             "       comment_public"
+             "  FROM cntct, comment LEFT OUTER JOIN cmnttype ON (comment_cmnttype_id=cmnttype_id)"
+             " WHERE((comment_source=:sourceContact)"
+             "   AND (cntct_crmacct_id=:sourceid)"
+             "   AND (comment_source_id=cntct_id) )";
+  }
+
+  QString where;
+  QString limit;
+  switch (style)
+  {
+    case NextPage:
+      where = "WHERE ((comment_date, comment_id) < (:oldestdate, :oldestid)) ";
+      limit = "LIMIT :pagesize";
+      break;
+    case Newer:
+      where = "WHERE ((comment_date, comment_id) > (:newestdate, :newestid)) ";
+      break;
+    case Single:
+      where = "WHERE (comment_id = ANY(CAST(:comment_ids AS INTEGER[]))) ";
+      break;
+    case AllIds:
+      break;
+    case FirstPage:
+    default:
+      limit = "LIMIT :pagesize";
+      break;
+  }
+
+  QString cols = "comment_id, comment_date, comment_source, type,"
+                 "       comment_user,"
+                 "       firstLine(detag(comment_text)) AS first,"
+                 "       comment_text, editable, comment_public,"
+                 "       comment_user=getEffectiveXtUser() AS self ";
+  if (style == AllIds)
+    cols = "comment_id ";
+
+  comment.prepare("SELECT " + cols +
+                  "  FROM (" + source + ") AS cmnt "
+                  + where +
+                  "ORDER BY comment_date DESC, comment_id DESC "
+                  + limit + ";");
+  if(_sourcetype == "CRMA")
+  {
     comment.bindValue(":sourceCust", "C");
     comment.bindValue(":sourceContact", "T");
     comment.bindValue(":sourceVend", "V");
@@ -387,47 +567,140 @@ void Comments::refresh()
   comment.bindValue(":none", tr("None"));
   comment.bindValue(":source", _sourcetype);
   comment.bindValue(":sourceid", _sourceid);
+  switch (style)
+  {
+    case NextPage:
+      comment.bindValue(":oldestdate", _oldestDate);
+      comment.bindValue(":oldestid",   _oldestId);
+      comment.bindValue(":pagesize",   _pageSize);
+      break;
+    case Newer:
+      comment.bindValue(":newestdate", _newestDate);
+      comment.bindValue(":newestid",   _newestId);
+      break;
+    case Single:
+    {
+      QStringList ids;
+      foreach (int cid, pCommentids)
+        ids.append(QString::number(cid));
+      comment.bindValue(":comment_ids", "{" + ids.join(",") + "}");
+      break;
+    }
+    case AllIds:
+      break;
+    case FirstPage:
+    default:
+      comment.bindValue(":pagesize",   _pageSize);
+      break;
+  }
+
   comment.exec();
+  if (ErrorReporter::error(QtCriticalMsg, this, tr("Error Getting Comments"),
+                           comment, __FILE__, __LINE__))
+    return false;
+
+  if (style == AllIds)
+    return true;
 
-  QString lclHtml = "<body>";
-  QRegExp br("\r?\n");
-  _commentIDList.clear();
+  if ((style == FirstPage || style == NextPage) && comment.size() < _pageSize)
+    _atEnd = true;
+
+  QTextCursor cursor(_browser->document());
+  if (style == Newer)
+    cursor = _browser->document()->rootFrame()->firstCursorPosition();
+  else
+    cursor.movePosition(QTextCursor::End);
+
+  int newCount = 0;
   while(comment.next())
   {
-    _editmap->insert(comment.value("comment_id").toInt(),comment.value("editable").toBool());
-    _editmap2->insert(comment.value("comment_id").toInt(),comment.value("self").toBool());
-    
     int cid = comment.value("comment_id").toInt();
-    _commentIDList.push_back(cid);
-    lclHtml += comment.value("comment_date").toDateTime().toString();
-    lclHtml += " ";
-    lclHtml += comment.value("type").toString();
-    lclHtml += " ";
-    lclHtml += comment.value("comment_user").toString();
-    if(_x_metrics && _x_metrics->boolean("CommentPublicPrivate"))
+    cacheEditable(comment);
+
+    if (style == Single && _commentFrames.contains(cid))
     {
-      lclHtml += " (";
-      if(comment.value("comment_public").toBool())
-        lclHtml += "Public";
-      else
-        lclHtml += "Private";
-      lclHtml += ")";
+      QTextFrame *frame = _commentFrames.value(cid);
+      QTextCursor replace = frame->firstCursorPosition();
+      replace.setPosition(frame->lastPosition(), QTextCursor::KeepAnchor);
+      replace.insertHtml(commentHtml(comment));
+      continue;
     }
-    if(userCanEdit(cid))
+
+    QTextFrame *frame = cursor.insertFrame(QTextFrameFormat());
+    cursor.insertHtml(commentHtml(comment));
+    cursor = frame->lastCursorPosition();
+    cursor.movePosition(QTextCursor::NextCharacter);
+    _commentFrames.insert(cid, frame);
+
+    if (style == Newer)
+      newCount++;
+
+    QDateTime date = comment.value("comment_date").toDateTime();
+    if (_newestId < 0 || (style == Newer && newCount == 1))
+    {
+      _newestDate = date;
+      _newestId   = cid;
+    }
+    if (style != Newer)
     {
-      lclHtml += " <a href=\"edit?id=";
-      lclHtml += QString::number(cid);
-      lclHtml += "\">edit</a>";
+      _oldestDate = date;
+      _oldestId   = cid;
     }
-    lclHtml += "<p>\n<blockquote>";
-    lclHtml += comment.value("comment_text").toString().replace("<", "&lt;").replace(br,"<br>\n");
-    lclHtml += "</pre></blockquote>\n<hr>\n";
   }
-  lclHtml += "</body>";
 
-  _browser->document()->setHtml(lclHtml);
   comment.first();
-  _comment->populate(comment);
+  return true;
+}
+
+/** Render one comment as the rich text block shown in the verbose view.
+ */
+QString Comments::commentHtml(const XSqlQuery &comment)
+{
+  static QRegExp br("\r?\n");
+  int cid = comment.value("comment_id").toInt();
+
+  QString lclHtml;
+  lclHtml += comment.value("comment_date").toDateTime().toString();
+  lclHtml += " ";
+  lclHtml += comment.value("type").toString();
+  lclHtml += " ";
+  lclHtml += comment.value("comment_user").toString();
+  if(_x_metrics && _x_metrics->boolean("CommentPublicPrivate"))
+  {
+    lclHtml += " (";
+    if(comment.value("comment_public").toBool())
+      lclHtml += "Public";
+    else
+      lclHtml += "Private";
+    lclHtml += ")";
+  }
+  if(userCanEdit(cid))
+  {
+    lclHtml += " <a href=\"edit?id=";
+    lclHtml += QString::number(cid);
+    lclHtml += "\">edit</a>";
+  }
+  lclHtml += "<p>\n<blockquote>";
+  lclHtml += comment.value("comment_text").toString().replace("<", "&lt;").replace(br,"<br>\n");
+  lclHtml += "</blockquote>\n<hr>\n";
+
+  return lclHtml;
+}
+
+void Comments::cacheEditable(const XSqlQuery &comment)
+{
+  int cid = comment.value("comment_id").toInt();
+  _editmap->replace(cid, comment.value("editable").toBool());
+  _editmap2->replace(cid, comment.value("self").toBool());
+}
+
+/** Fetch the next page once either view is scrolled near its end.
+ */
+void Comments::sScrolled(int pValue)
+{
+  QScrollBar *scrbar = qobject_cast<QScrollBar*>(sender());
+  if (scrbar && pValue >= scrbar->maximum() - scrbar->pageStep() / 2)
+    fetchMore();
 }
 
 void Comments::setVerboseCommentList(bool vcl)
@@ -455,12 +728,12 @@ void Comments::anchorClicked(const QUrl & url)
       params.append("sourceType", _sourcetype);
       params.append("source_id", _sourceid);
       params.append("comment_id", cid);
-      params.append("commentIDList", _commentIDList);
+      params.append("commentIDList", allCommentIDs());
 
       comment newdlg(this, "", true);
       newdlg.set(params);
       newdlg.exec();
-      refresh();
+      refreshComments(newdlg._touchedIds);
     }
   }
   else
@@ -11,6 +11,7 @@
 #ifndef comments_h
 #define comments_h
 
+#include <QDateTime>
 #include <QMultiMap>
 
 #include <xsqlquery.h>
@@ -20,6 +21,7 @@
 
 class QPushButton;
 class QTextBrowser;
+class QTextFrame;
 class XTreeWidget;
 class Comment;
 
@@ -52,7 +54,8 @@ class XTUPLEWIDGETS_EXPORT Comments : public QWidget
 {
   Q_OBJECT
 
-  Q_PROPERTY(int type READ type WRITE setType)
+  Q_PROPERTY(int type     READ type     WRITE setType)
+  Q_PROPERTY(int pageSize READ pageSize WRITE setPageSize)
   
   friend class comment;
 
@@ -89,6 +92,7 @@ class XTUPLEWIDGETS_EXPORT Comments : public QWidget
 
     inline int sourceid()             { return _sourceid; }
     int         type() const;
+    inline int  pageSize() const      { return _pageSize; }
   
     static QMap<QString, struct CommentMap*> &commentMap();
 
@@ -101,15 +105,23 @@ class XTUPLEWIDGETS_EXPORT Comments : public QWidget
     void setReadOnly(bool);
     void setVerboseCommentList(bool);
     void setEditable(bool p) {_editable = p;}
+    void setPageSize(int p)  {_pageSize = (p > 0 ? p : 1);}
 
     void sNew();
     void sView();
     void sEdit();
     void refresh();
+    void fetchMore();
+    void refreshComment(int);
 
     void anchorClicked(const QUrl &);
     void sCheckButtonPriv(bool); 
 
+  protected slots:
+    void sFetchNewer();
+    void sFillView();
+    void sScrolled(int);
+
   signals:
     void commentAdded();
 
@@ -122,10 +134,23 @@ class XTUPLEWIDGETS_EXPORT Comments : public QWidget
   
     static bool addToMap(int id, QString key, QString trans, QString param = QString(), QString ui = QString(), QString priv = QString());
 
+    enum FetchStyle { FirstPage, NextPage, Newer, Single, AllIds };
+    bool    fetch(XSqlQuery &, FetchStyle, const QList<int> & = QList<int>());
+    void    refreshComments(const QList<int> &);
+    QList<QVariant> allCommentIDs();
+    QString commentHtml(const XSqlQuery &);
+    void    cacheEditable(const XSqlQuery &);
+
     int                 _sourceid;
-    QList<QVariant> _commentIDList;
     bool _verboseCommentList;
     bool _editable;
+    int  _pageSize;
+    bool _atEnd;
+    QDateTime _newestDate;
+    int       _newestId;
+    QDateTime _oldestDate;
+    int       _oldestId;
+    QMap<int, QTextFrame*> _commentFrames;
 
     QTextBrowser *_browser;
     XTreeWidget *_comment;
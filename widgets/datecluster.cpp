@@ -13,6 +13,7 @@
 #include <QDateTime>
 #include <QDebug>
 #include <QDesktopWidget>
+#include <QHash>
 #include <QHBoxLayout>
 #include <QMessageBox>
 #include <QPoint>
@@ -21,8 +22,11 @@
 #include <QSqlError>
 #include <QVBoxLayout>
 #include <QValidator>
+#include <QVector>
 #include <QtScript>
 
+#include <algorithm>
+
 #include <xsqlquery.h>
 #include <parameter.h>
 
@@ -30,9 +34,14 @@
 #include "dcalendarpopup.h"
 #include "errorReporter.h"
 #include "format.h"
+#include "guiclientinterface.h"
 
 #define DEBUG false
 
+// how far either side of today to keep each site's working days, and for how long
+#define CALENDAR_DAYS   730
+#define CALENDAR_MAXAGE 3600
+
 static bool determineIfStd()
 {
   if (_x_metrics && _x_metrics->value("Application") == "Standard")
@@ -103,6 +112,139 @@ void DCalendarPopup::dateSelected(const QDate &pDate)
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/* The working days of one site for a range of dates around today, read in
+   one query from the site's work week and calendar exceptions, so a user
+   entering dates does not wait for a round trip on each one. The answer
+   for today is checked against calculatenextworkingdate(); if the two
+   disagree, or the query fails, dates go to the server until the calendar
+   is next reloaded.
+ */
+class XDateEditCalendar
+{
+  public:
+    QDate          start;
+    QDate          end;
+    QDateTime      loaded;
+    bool           usable;
+    QVector<QDate> workdays;
+
+    XDateEditCalendar() : usable(false) {}
+
+    bool load(int siteId, const QDate &today)
+    {
+      XSqlQuery workq;
+      workq.prepare("SELECT day AS workday"
+                    "  FROM (SELECT CAST(generate_series(CAST(:start AS DATE),"
+                    "                                    CAST(:end AS DATE),"
+                    "                                    INTERVAL '1 day') AS DATE) AS day"
+                    "       ) AS days"
+                    "  LEFT OUTER JOIN whsweek ON (whsweek_warehous_id=:whsid"
+                    "                          AND whsweek_weekday=EXTRACT(DOW FROM day))"
+                    " WHERE COALESCE((SELECT whscal_active"
+                    "                   FROM whscal"
+                    "                  WHERE whscal_warehous_id=:whsid"
+                    "                    AND day BETWEEN whscal_effective AND whscal_expires"
+                    "                  ORDER BY whscal_effective DESC"
+                    "                  LIMIT 1),"
+                    "                whsweek_workday, true)"
+                    " ORDER BY day;");
+      workq.bindValue(":whsid", siteId);
+      workq.bindValue(":start", today.addDays(-CALENDAR_DAYS));
+      workq.bindValue(":end",   today.addDays(CALENDAR_DAYS));
+      workq.exec();
+
+      start  = today.addDays(-CALENDAR_DAYS);
+      end    = today.addDays(CALENDAR_DAYS);
+      loaded = QDateTime::currentDateTime();
+      workdays.clear();
+      while (workq.next())
+        workdays.append(workq.value("workday").toDate());
+      if (workq.lastError().type() != QSqlError::NoError)
+        return false;
+
+      XSqlQuery checkq;
+      checkq.prepare("SELECT calculatenextworkingdate(:whsid, :date, 0) AS result;");
+      checkq.bindValue(":whsid", siteId);
+      checkq.bindValue(":date",  today);
+      checkq.exec();
+      QDate expected;
+      if (! checkq.first() || ! nextWorkingDate(today, expected) ||
+          expected != checkq.value("result").toDate())
+      {
+        if (DEBUG)
+          qDebug("XDateEditCalendar for site %d disagrees with the server",
+                 siteId);
+        return false;
+      }
+
+      if (DEBUG)
+        qDebug("XDateEditCalendar loaded %d working days for site %d",
+               workdays.size(), siteId);
+      return true;
+    }
+
+    /* Find the first working day on or after @a date. Return false if the
+       answer lies outside the cached range.
+     */
+    bool nextWorkingDate(const QDate &date, QDate &result) const
+    {
+      if (date < start || date > end)
+        return false;
+
+      QVector<QDate>::const_iterator it = std::lower_bound(workdays.constBegin(),
+                                                           workdays.constEnd(),
+                                                           date);
+      if (it == workdays.constEnd())
+        return false;
+
+      result = *it;
+      return true;
+    }
+};
+
+static QHash<int, XDateEditCalendar> _calendars;
+
+GuiClientInterface *XDateEdit::_guiClientInterface = 0;
+
+/* Return the server's date without a query if the application knows it. */
+static QDate knownDbDate()
+{
+  if (XDateEdit::_guiClientInterface)
+    return XDateEdit::_guiClientInterface->dbDate();
+  return QDate();
+}
+
+static bool cachedNextWorkingDate(int siteId, const QDate &date, QDate &result)
+{
+  QDate today = knownDbDate();
+  if (! today.isValid())
+    today = QDate::currentDate();
+
+  XDateEditCalendar &calendar = _calendars[siteId];
+  if (! calendar.loaded.isValid() ||
+      calendar.loaded.secsTo(QDateTime::currentDateTime()) > CALENDAR_MAXAGE ||
+      calendar.start != today.addDays(-CALENDAR_DAYS))
+  {
+    // a calendar that failed to load is not tried again until it is stale
+    calendar.usable = calendar.load(siteId, today);
+  }
+
+  return calendar.usable && calendar.nextWorkingDate(date, result);
+}
+
+/** @brief Forget the working days cached for @a siteId, or for every site
+           if @a siteId is -1. GUIClient::sWarehousesUpdated() calls this,
+           so windows that change a site or its calendar only need to
+           announce the change as they already do.
+ */
+void XDateEdit::clearCalendarCache(int siteId)
+{
+  if (siteId == -1)
+    _calendars.clear();
+  else
+    _calendars.remove(siteId);
+}
+
 XDateEdit::XDateEdit(QWidget *parent, const char *name) :
   XLineEdit(parent, name)
 {
@@ -138,11 +280,9 @@ void XDateEdit::parseDate()
            qPrintable(dateString),
            qPrintable(_currentDate.toString()), _allowNull);
 
-#ifdef GUIClient_h
-  QDate today = ofmgThis->dbDate();
-#else
-  QDate today = QDate::currentDate();
-#endif
+  QDate today = knownDbDate();
+  if (! today.isValid())
+    today = QDate::currentDate();
 
   if (_parsed)
   {
@@ -480,7 +620,8 @@ void XDateEdit::checkDate(const QDate &pDate)
 {
   QDate nextWorkDate = pDate;
 
-  if(determineIfStd() && (_siteId != -1) && (pDate != _currentDate))
+  if(determineIfStd() && (_siteId != -1) && (pDate != _currentDate) &&
+     ! cachedNextWorkingDate(_siteId, pDate, nextWorkDate))
   {
     XSqlQuery workday;
 
@@ -532,6 +673,10 @@ QDate XDateEdit::currentDefault()
     return _nullDate;
   else if (_default==Current)
   {
+    QDate today = knownDbDate();
+    if (today.isValid())
+      return today;
+
     query.exec("SELECT current_date AS result;");
     if (query.first())
       return query.value("result").toDate();
@@ -20,12 +20,13 @@
 #include "xdatawidgetmapper.h"
 #include "xlineedit.h"
 
+class GuiClientInterface;
 class ParameterList;
 class QFocusEvent;
 class QScriptEngine;
 class XSqlQuery;
 
-class XDateEdit : public XLineEdit
+class XTUPLEWIDGETS_EXPORT XDateEdit : public XLineEdit
 {
   Q_OBJECT
   Q_PROPERTY(QDate    date            READ date        WRITE setDate)
@@ -52,6 +53,10 @@ class XDateEdit : public XLineEdit
     inline  void      setNullString(const QString &pNullString) { _nullString = pNullString;}
     inline  void      setNullDate(const QDate &pNullDate)       { _nullDate   = pNullDate;    }
 
+    static void clearCalendarCache(int siteId = -1);
+
+    static GuiClientInterface *_guiClientInterface;
+
   public slots:
     virtual void setDataWidgetMap(XDataWidgetMapper* m);
     virtual void setFieldName(QString p) { _fieldName = p; }
@@ -16,6 +16,8 @@
 #include <QMenu>
 #include <QMessageBox>
 #include <QSettings>
+#include <QSqlDatabase>
+#include <QSqlError>
 #include <QUrl>
 #include <QtScript>
 
@@ -31,8 +33,34 @@
 #include "imageAssignment.h"
 #include "docAttach.h"
 
+#define DEBUG false
+
+// entries older than this are read again even without a notification,
+// which covers documents changed outside of this widget
+#define DOCUMENTS_CACHE_SECS    300
+#define DOCUMENTS_CACHE_ENTRIES 50
+
 QMap<QString, struct DocumentMap*> Documents::_strMap;
 QMap<int,     struct DocumentMap*> Documents::_intMap;
+QHash<QString, Documents::CacheEntry> Documents::_cache;
+
+/* Document types whose privileges depend on who owns the target record.
+   A user with the View/MaintainAll privilege sees every record of the type,
+   one with only the Personal privilege sees the records they own or are
+   assigned to. All other types are checked once per type.
+ */
+static const struct {
+  const char *type;
+  const char *privs;
+} _ownedTypes[] = {
+  { "T",     "Contacts"      },
+  { "CRMA",  "CRMAccounts"   },
+  { "INCDT", "Incidents"     },
+  { "OPP",   "Opportunities" },
+  { "TODO",  "ToDoItems"     },
+  { "J",     "Projects"      },
+  { "TASK",  "Projects"      }
+};
 
 /** Add another document type to the map by both key and int.
 
@@ -116,6 +144,16 @@ Documents::Documents(QWidget *pParent) :
   connect(_doc, SIGNAL(itemSelected(int)), this, SLOT(handleItemSelected()));
   handleSelection();
 
+  QSqlDriver *driver = QSqlDatabase::database().driver();
+  if (driver)
+  {
+    foreach (QString notice, QStringList() << "docassUpdated" << "usrprivUpdated")
+      if (! driver->subscribedToNotifications().contains(notice))
+        driver->subscribeToNotification(notice);
+    connect(driver, SIGNAL(notification(const QString&, QSqlDriver::NotificationSource, const QVariant&)),
+            this,   SLOT(sNotified(const QString&, QSqlDriver::NotificationSource, const QVariant&)));
+  }
+
   if (_x_privileges)
   {
     QMenu * newDocMenu = new QMenu;
@@ -161,7 +199,7 @@ void Documents::setType(QString sourceType)
 void Documents::setId(int pSourceid)
 {
   _sourceid = pSourceid;
-  refresh();
+  populate(true);
 }
 
 void Documents::setReadOnly(bool pReadOnly)
@@ -210,7 +248,7 @@ void Documents::sNewDoc(QString ptype, QString pui)
     QMessageBox::critical(this, tr("Error Creating Document"),
                           tr("Cannot find the '%1'' window to create a %2").arg(ui, type));
   }
-  refresh();
+  changed();
 }
 
 void Documents::sNewImage()
@@ -223,7 +261,7 @@ void Documents::sNewImage()
   newdlg.set(params);
 
   if (newdlg.exec() != QDialog::Rejected)
-    refresh();
+    changed();
 }
 
 void Documents::sInsertDocass(QString target_type, int target_id)
@@ -236,8 +274,10 @@ void Documents::sInsertDocass(QString target_type, int target_id)
   ins.bindValue(":targetid", target_id);
   ins.bindValue(":targettype", target_type);
   ins.exec();
-  ErrorReporter::error(QtCriticalMsg, this, tr("Attachment Error"),
-                       ins, __FILE__, __LINE__);
+  if (ErrorReporter::error(QtCriticalMsg, this, tr("Attachment Error"),
+                           ins, __FILE__, __LINE__))
+    return;
+  changed();
 }
 
 void Documents::sEditDoc()
@@ -277,7 +317,7 @@ void Documents::sOpenDoc(QString mode)
     newdlg.set(params);
 
     if (newdlg.exec() != QDialog::Rejected)
-      refresh();
+      changed();
     return;
   }
   // TODO: url -- change to use docass instead of url
@@ -293,7 +333,7 @@ void Documents::sOpenDoc(QString mode)
       newdlg.set(params);
       newdlg.exec();
 
-      refresh();
+      changed();
       return;
     }
 
@@ -396,7 +436,10 @@ void Documents::sOpenDoc(QString mode)
     newdlg->exec();
   }
 
-  refresh();
+  if (mode == "edit")
+    changed();
+  else
+    refresh();
 }
 
 void Documents::sViewDoc()
@@ -414,7 +457,7 @@ void Documents::sAttachDoc()
   newdlg.set(params);
   newdlg.exec();
 
-  refresh();
+  changed();
 }
 
 void Documents::sDetachDoc()
@@ -449,10 +492,69 @@ void Documents::sDetachDoc()
   detach.exec();
   ErrorReporter::error(QtCriticalMsg, this, tr("Error Detaching"),
                        detach, __FILE__, __LINE__);
-  refresh();
+  changed();
 }
 
+/** Forget every cached document list. The lists of other records can show
+    the same attachment from the other side, so a change to one record
+    clears them all.
+ */
+void Documents::clearCache()
+{
+  _cache.clear();
+}
+
+QString Documents::cacheKey() const
+{
+  return QString("%1:%2").arg(_sourcetype).arg(_sourceid);
+}
+
+/* Called after this widget changed the documents of the current record.
+   Other clients get a docassUpdated notification naming the record so
+   they drop their cached lists and, if they show it, read it again.
+ */
+void Documents::changed()
+{
+  clearCache();
+
+  XSqlQuery notify;
+  notify.prepare("SELECT pg_notify('docassUpdated', :key);");
+  notify.bindValue(":key", cacheKey());
+  notify.exec();
+  if (DEBUG && notify.lastError().type() != QSqlError::NoError)
+    qDebug() << "Documents::changed() could not notify:" << notify.lastError().text();
+
+  populate(false);
+}
+
+void Documents::sNotified(const QString &pNotification,
+                          QSqlDriver::NotificationSource pSource,
+                          const QVariant &pPayload)
+{
+  if (pNotification == "usrprivUpdated")
+  {
+    clearCache();
+    if (_sourceid != -1)
+      populate(false);
+  }
+  else if (pNotification == "docassUpdated" && pSource != QSqlDriver::SelfSource)
+  {
+    clearCache();
+    if (_sourceid != -1 && pPayload.toString() == cacheKey())
+      populate(false);
+  }
+}
+
+/** Read the document list again from the database. Call this after
+    changing the documents attached to the current record outside of
+    this widget.
+ */
 void Documents::refresh()
+{
+  populate(false);
+}
+
+void Documents::populate(bool useCache)
 {
   if(-1 == _sourceid)
   {
@@ -460,14 +562,103 @@ void Documents::refresh()
     return;
   }
 
+  QString key = cacheKey();
+  if (useCache && _cache.contains(key))
+  {
+    CacheEntry entry = _cache.value(key);
+    if (entry.loaded.secsTo(QDateTime::currentDateTime()) < DOCUMENTS_CACHE_SECS)
+    {
+      if (DEBUG)
+        qDebug() << "Documents::populate() using cached list for" << key;
+      _doc->populate(entry.query, true);
+      return;
+    }
+    _cache.remove(key);
+  }
+
+  // evaluate the ownership-based privileges here instead of per row
+  QStringList personal, viewall, viewown, editall, editown;
+  for (unsigned int i = 0; i < sizeof(_ownedTypes) / sizeof(_ownedTypes[0]); i++)
+  {
+    QString type  = _ownedTypes[i].type;
+    QString privs = _ownedTypes[i].privs;
+    personal << type;
+    if (! _x_privileges)
+      continue;
+    if (_x_privileges->check("MaintainAll" + privs))
+      editall << type;
+    if (_x_privileges->check("MaintainAll" + privs) ||
+        _x_privileges->check("ViewAll" + privs))
+      viewall << type;
+    if (_x_privileges->check("MaintainPersonal" + privs))
+      editown << type;
+    if (_x_privileges->check("MaintainPersonal" + privs) ||
+        _x_privileges->check("ViewPersonal" + privs))
+      viewown << type;
+  }
+
   XSqlQuery query;
   
-  //Populate doc list
-  QString sql("SELECT id, target_number, target_type, "
+  //Populate doc list. hasPrivOnObject() runs once per document type for
+  //types whose privileges do not depend on the owner of the target record;
+  //the owned types are resolved with one join against their owner columns.
+  QString sql("WITH doc AS (SELECT * FROM _docinfo(:sourceid, :source)),"
+              " typepriv AS ("
+              "   SELECT target_type AS priv_type,"
+              "          hasPrivOnObject('view', target_type, MIN(target_id)) AS priv_view,"
+              "          hasPrivOnObject('edit', target_type, MIN(target_id)) AS priv_edit"
+              "     FROM doc"
+              "    WHERE NOT (target_type = ANY(CAST(:personal AS TEXT[])))"
+              "    GROUP BY target_type),"
+              " me AS (SELECT getEffectiveXtUser() AS me_username),"
+              " owned AS ("
+              "   SELECT 'T'::TEXT AS owned_type, cntct_id AS owned_id"
+              "     FROM cntct, me"
+              "    WHERE cntct_owner_username = me_username"
+              "      AND cntct_id IN (SELECT target_id FROM doc WHERE target_type='T')"
+              "   UNION ALL"
+              "   SELECT 'CRMA', crmacct_id"
+              "     FROM crmacct, me"
+              "    WHERE crmacct_owner_username = me_username"
+              "      AND crmacct_id IN (SELECT target_id FROM doc WHERE target_type='CRMA')"
+              "   UNION ALL"
+              "   SELECT 'INCDT', incdt_id"
+              "     FROM incdt, me"
+              "    WHERE me_username IN (incdt_owner_username, incdt_assigned_username)"
+              "      AND incdt_id IN (SELECT target_id FROM doc WHERE target_type='INCDT')"
+              "   UNION ALL"
+              "   SELECT 'OPP', ophead_id"
+              "     FROM ophead, me"
+              "    WHERE me_username IN (ophead_owner_username, ophead_username)"
+              "      AND ophead_id IN (SELECT target_id FROM doc WHERE target_type='OPP')"
+              "   UNION ALL"
+              "   SELECT 'TODO', todoitem_id"
+              "     FROM todoitem, me"
+              "    WHERE me_username IN (todoitem_owner_username, todoitem_username)"
+              "      AND todoitem_id IN (SELECT target_id FROM doc WHERE target_type='TODO')"
+              "   UNION ALL"
+              "   SELECT 'J', prj_id"
+              "     FROM prj, me"
+              "    WHERE me_username IN (prj_owner_username, prj_username)"
+              "      AND prj_id IN (SELECT target_id FROM doc WHERE target_type='J')"
+              "   UNION ALL"
+              "   SELECT 'TASK', prjtask_id"
+              "     FROM prjtask, me"
+              "    WHERE me_username IN (prjtask_owner_username, prjtask_username)"
+              "      AND prjtask_id IN (SELECT target_id FROM doc WHERE target_type='TASK'))"
+              "SELECT id, target_number, target_type, "
               " target_id AS target_number_xtidrole, source_type, source_id, purpose, "
               " name, description, "
-              " hasPrivOnObject('view', target_type, target_id) AS canview,"
-              " hasPrivOnObject('edit', target_type, target_id) AS canedit,"
+              " CASE WHEN (target_type = ANY(CAST(:viewall AS TEXT[]))) THEN true"
+              "      WHEN (target_type = ANY(CAST(:viewown AS TEXT[]))) THEN owned_id IS NOT NULL"
+              "      WHEN (target_type = ANY(CAST(:personal AS TEXT[]))) THEN false"
+              "      ELSE COALESCE(priv_view, false)"
+              " END AS canview,"
+              " CASE WHEN (target_type = ANY(CAST(:editall AS TEXT[]))) THEN true"
+              "      WHEN (target_type = ANY(CAST(:editown AS TEXT[]))) THEN owned_id IS NOT NULL"
+              "      WHEN (target_type = ANY(CAST(:personal AS TEXT[]))) THEN false"
+              "      ELSE COALESCE(priv_edit, false)"
+              " END AS canedit,"
               " CASE WHEN (purpose='I') THEN :inventory"
               " WHEN (purpose='P') THEN :product"
               " WHEN (purpose='E') THEN :engineering"
@@ -526,7 +717,9 @@ void Documents::refresh()
               " WHEN (target_type='IMG') THEN :image "
               " ELSE NULL "
               " END AS target_type_qtdisplayrole "
-              " FROM _docinfo(:sourceid, :source)"
+              " FROM doc"
+              " LEFT OUTER JOIN typepriv ON (target_type=priv_type)"
+              " LEFT OUTER JOIN owned ON (target_type=owned_type AND target_id=owned_id) "
               "ORDER by target_type_qtdisplayrole, target_number; ");
   query.prepare(sql);
   query.bindValue(":inventory", tr("Inventory Description"));
@@ -587,12 +780,40 @@ void Documents::refresh()
   query.bindValue(":url", tr("URL"));
   query.bindValue(":file", tr("File"));
 
+  query.bindValue(":personal", "{" + personal.join(",") + "}");
+  query.bindValue(":viewall",  "{" + viewall.join(",")  + "}");
+  query.bindValue(":viewown",  "{" + viewown.join(",")  + "}");
+  query.bindValue(":editall",  "{" + editall.join(",")  + "}");
+  query.bindValue(":editown",  "{" + editown.join(",")  + "}");
   query.bindValue(":source",   _sourcetype);
   query.bindValue(":sourceid", _sourceid);
   query.exec();
   _doc->populate(query,true);
-  ErrorReporter::error(QtCriticalMsg, this, tr("Error Getting Documents"),
-                       query, __FILE__, __LINE__);
+  if (ErrorReporter::error(QtCriticalMsg, this, tr("Error Getting Documents"),
+                           query, __FILE__, __LINE__))
+    return;
+
+  if (_cache.size() >= DOCUMENTS_CACHE_ENTRIES)
+  {
+    QString oldest;
+    QDateTime oldestLoaded;
+    QHashIterator<QString, CacheEntry> it(_cache);
+    while (it.hasNext())
+    {
+      it.next();
+      if (oldest.isEmpty() || it.value().loaded < oldestLoaded)
+      {
+        oldest       = it.key();
+        oldestLoaded = it.value().loaded;
+      }
+    }
+    _cache.remove(oldest);
+  }
+
+  CacheEntry entry;
+  entry.query  = query;
+  entry.loaded = QDateTime::currentDateTime();
+  _cache.insert(key, entry);
 }
 
 void Documents::handleSelection(bool /*pReadOnly*/)
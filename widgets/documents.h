@@ -11,6 +11,9 @@
 #ifndef documents_h
 #define documents_h
 
+#include <QDateTime>
+#include <QHash>
+#include <QSqlDriver>
 #include <QWidget>
 
 #include <xsqlquery.h>
@@ -88,6 +91,7 @@ class XTUPLEWIDGETS_EXPORT Documents : public QWidget, public Ui::documents
     int         type() const;
 
     static QMap<QString, struct DocumentMap*> &documentMap();
+    static void clearCache();
 
   public slots:
     void setType(int sourceType);
@@ -108,14 +112,26 @@ class XTUPLEWIDGETS_EXPORT Documents : public QWidget, public Ui::documents
   private slots:
     void handleSelection(bool = false);
     void handleItemSelected();
+    void sNotified(const QString &, QSqlDriver::NotificationSource, const QVariant &);
 
   private:
+    struct CacheEntry
+    {
+      XSqlQuery query;
+      QDateTime loaded;
+    };
+
     static QMap<QString, struct DocumentMap*> _strMap;
     static QMap<int,     struct DocumentMap*> _intMap;
+    static QHash<QString, CacheEntry> _cache;
     int                  _sourceid;
     QString              _sourcetype;
     bool                 _readOnly;
 
+    QString cacheKey() const;
+    void    changed();
+    void    populate(bool useCache);
+
     static bool addToMap(int id, QString key, QString trans, QString param = QString(), QString ui = QString(), QString priv = QString());
 
 };
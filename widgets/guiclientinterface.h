@@ -15,6 +15,7 @@
 
 #include <QString>
 #include <QAction>
+#include <QDate>
 
 class GuiClientInterface : public QObject
 {
@@ -36,6 +37,8 @@ class GuiClientInterface : public QObject
     virtual int hunspell_add(const QString word) = 0;
     virtual int hunspell_ignore(const QString word) = 0;
 
+    virtual QDate dbDate() = 0;
+
   signals:
     void dbConnectionLost();
 };
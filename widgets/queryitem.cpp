@@ -93,7 +93,13 @@ void QueryItem::clear()
 void QueryItem::setId(int p)
 {
   XSqlQuery itemq;
-  itemq.prepare("SELECT *"
+  itemq.prepare("SELECT qryitem.*,"
+                "       (SELECT metasql_id"
+                "          FROM metasql"
+                "         WHERE ((metasql_group=qryitem_group)"
+                "            AND (metasql_name=qryitem_detail))"
+                "         ORDER BY metasql_grade DESC"
+                "         LIMIT 1) AS metasql_id"
                 "  FROM qryitem"
                 " WHERE (qryitem_id=:id);");
   itemq.bindValue(":id", p);
@@ -113,30 +119,12 @@ void QueryItem::setId(int p)
               _qryRelation->setCode(itemq.value("qryitem_detail").toString());
               _qryStack->setCurrentWidget(_qryRelationPage);
               break;
-      case 1: {
-              XSqlQuery mqlq;
-              mqlq.prepare("SELECT metasql_id"
-                           "  FROM metasql"
-                           " WHERE ((metasql_group=:group)"
-                           "    AND (metasql_name=:name))"
-                           " ORDER BY metasql_grade DESC"
-                           " LIMIT 1;");
-              mqlq.bindValue(":group", itemq.value("qryitem_group"));
-              mqlq.bindValue(":name",  itemq.value("qryitem_detail"));
-              mqlq.exec();
-              if (mqlq.first())
+      case 1: if (! itemq.value("metasql_id").isNull())
               {
-                _selectmql->setId(mqlq.value("metasql_id").toInt());
+                _selectmql->setId(itemq.value("metasql_id").toInt());
                 _qryStack->setCurrentWidget(_qryMQLPage);
               }
-              else if (mqlq.lastError().type() != QSqlError::NoError)
-              {
-                QMessageBox::warning(this, tr("Database Error"),
-                                     mqlq.lastError().text());
-                return;
-              }
               break;
-              }
       case 2: _mqledit->_text->setPlainText(itemq.value("qryitem_detail").toString());
               _qryStack->setCurrentWidget(_qryCustomPage);
               break;
@@ -1096,17 +1096,7 @@ void VirtualList::sSelect()
 
 void VirtualList::sSearch(const QString& pTarget)
 {
-  for (int i = 0; i < _listTab->columnCount(); i++)
-  {
-    QList<XTreeWidgetItem*> matches = _listTab->findItems(pTarget, Qt::MatchStartsWith, i);
-
-    if (matches.size() > 0)
-    {
-      _listTab->setCurrentItem(matches[0]);
-      _listTab->scrollToItem(matches[0]);
-      return;
-    }
-  }
+  _listTab->sSearchColumn(pTarget, -1, XTreeWidget::SearchPrefix);
 }
 
 void VirtualList::sFillList()
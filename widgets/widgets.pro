@@ -206,7 +206,9 @@ SOURCES += widgets.cpp \
     xtextedit.cpp \
     xtreeview.cpp \
     xtreewidget.cpp \
+    xtreewidgetcursor.cpp \
     xtreewidgetprogress.cpp \
+    xtreewidgetsearch.cpp \
     xurllabel.cpp \
 
 HEADERS += widgets.h \
@@ -305,7 +307,9 @@ HEADERS += widgets.h \
     xtextedit.h \
     xtreeview.h \
     xtreewidget.h \
+    xtreewidgetcursor.h \
     xtreewidgetprogress.h \
+    xtreewidgetsearch.h \
     xurllabel.h \
 
 FORMS += alarmMaint.ui \
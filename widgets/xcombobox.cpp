@@ -26,6 +26,7 @@
 
 #include "xcombobox.h"
 #include "xcomboboxprivate.h"
+#include "queryprofiler.h"
 #include "xdatawidgetmapper.h"
 #include "xsqltablemodel.h"
 
@@ -1364,10 +1365,14 @@ void XComboBox::populate(XSqlQuery pQuery, int pSelected)
   if (! pQuery.isActive())
     pQuery.exec();
 
+  int rows = 0;
+  QueryProfilerTimer timer("XComboBox::populate", &rows);
+
   // strange if/loop construct lets multiple comboboxes share a query instance
   if (pQuery.first())
     do
     {
+      rows++;
       if (pQuery.record().count() < 3)
         append(pQuery.value(0).toInt(), pQuery.value(1).toString());
       else
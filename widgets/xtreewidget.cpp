@@ -16,12 +16,16 @@
 #include <QApplication>
 #include <QAbstractItemView>
 #include <QClipboard>
+#include <QColor>
 #include <QDate>
 #include <QDateTime>
 #include <QDrag>
+#include <QFile>
 #include <QFileDialog>
 #include <QFont>
+#include <QHash>
 #include <QHeaderView>
+#include <QLocale>
 #include <QMenu>
 #include <QMimeData>
 #include <QMouseEvent>
@@ -34,13 +38,17 @@
 #include <QTextDocument>
 #include <QTextDocumentWriter>
 #include <QTextEdit>
+#include <QTextStream>
 #include <QTextTable>
 #include <QTextTableCell>
 #include <QTextTableFormat>
 #include <QtScript>
 #include <QMessageBox>
 
+#include "queryprofiler.h"
+#include "xtreewidgetcursor.h"
 #include "xtreewidgetprogress.h"
+#include "xtreewidgetsearch.h"
 #include "xtsettings.h"
 #include "xsqlquery.h"
 #include "format.h"
@@ -77,6 +85,87 @@
 
 GuiClientInterface *XTreeWidget::_guiClientInterface = 0;
 
+/* Everything populateWorker() needs to format a cell that does not change
+   from row to row: the locale, the yes/no strings and each column's default
+   alignment. Each column also keeps the scale and colors its roles named in
+   the last row. Rows rarely change them, so a cell only compares the role
+   names with the column's instead of going through decimalPlaces() and
+   namedColor() again.
+ */
+class XTreeWidgetFormatPlan
+{
+  public:
+    class Column
+    {
+      public:
+        Column() : scale(-1), percent(false), fgSet(false), bgSet(false) {}
+
+        QString numericRole;
+        int     scale;          // -1 until a numeric role has been seen
+        bool    percent;        // percent and scrap are shown times 100
+        QString fgName;
+        QColor  fg;
+        bool    fgSet;
+        QString bgName;
+        QColor  bg;
+        bool    bgSet;
+    };
+
+    XTreeWidgetFormatPlan(QTreeWidgetItem *header, int count)
+      : yes(yesStr),
+        no(noStr),
+        defaultScale(decimalPlaces("")),
+        columns(count)
+    {
+      alignment.reserve(count);
+      for (int col = 0; col < count; col++)
+        alignment.append(header->textAlignment(col));
+    }
+
+    const Column &numeric(int col, const QString &role)
+    {
+      Column &column = columns[col];
+      if (column.scale < 0 || role != column.numericRole)
+      {
+        column.numericRole = role;
+        column.scale       = decimalPlaces(role);
+        column.percent     = (role == "percent" || role == "scrap");
+      }
+      return column;
+    }
+
+    const QColor &foreground(int col, const QString &name)
+    {
+      Column &column = columns[col];
+      if (! column.fgSet || name != column.fgName)
+      {
+        column.fgName = name;
+        column.fg     = namedColor(name);
+        column.fgSet  = true;
+      }
+      return column.fg;
+    }
+
+    const QColor &background(int col, const QString &name)
+    {
+      Column &column = columns[col];
+      if (! column.bgSet || name != column.bgName)
+      {
+        column.bgName = name;
+        column.bg     = namedColor(name);
+        column.bgSet  = true;
+      }
+      return column.bg;
+    }
+
+    QLocale         locale;
+    QString         yes;
+    QString         no;
+    int             defaultScale;
+    QVector<int>    alignment;
+    QVector<Column> columns;
+};
+
 static QTreeWidgetItem *searchChildren(XTreeWidgetItem *item, int pId);
 
 // cint() and round() regarding Issue #8897
@@ -121,7 +210,10 @@ XTreeWidget::XTreeWidget(QWidget *pParent) :
   for (int i = 0; i < ROWROLE_COUNT; i++)
     _rowRole[i] = 0;
   _progress = 0;
-  _subtotals = 0;
+  _calcPending = false;
+  _calculating = false;
+  _search    = new XTreeWidgetSearch(this);
+  _cursor    = new XTreeWidgetCursor(this);
 
   setUniformRowHeights(true); //#13439 speed improvement if all rows are known to be the same height
   setContextMenuPolicy(Qt::CustomContextMenu);
@@ -146,6 +238,13 @@ XTreeWidget::XTreeWidget(QWidget *pParent) :
   connect(this,           SIGNAL(itemChanged(QTreeWidgetItem*, int)),                       SLOT(sItemChanged(QTreeWidgetItem*, int)));
   connect(this,           SIGNAL(itemClicked(QTreeWidgetItem*, int)),                       SLOT(sItemClicked(QTreeWidgetItem*, int)));
   connect(&_workingTimer, SIGNAL(timeout()), this, SLOT(populateWorker()));
+  connect(model(),        SIGNAL(rowsInserted(const QModelIndex &, int, int)),          this, SLOT(sInvalidateSearch()));
+  connect(model(),        SIGNAL(rowsRemoved(const QModelIndex &, int, int)),           this, SLOT(sInvalidateSearch()));
+  connect(model(),        SIGNAL(dataChanged(const QModelIndex &, const QModelIndex &)), this, SLOT(sUpdateSearch(const QModelIndex &, const QModelIndex &)));
+  connect(model(),        SIGNAL(layoutChanged()),                                      this, SLOT(sInvalidateSearch()));
+  connect(model(),        SIGNAL(modelReset()),                                         this, SLOT(sInvalidateSearch()));
+  connect(model(),        SIGNAL(rowsInserted(const QModelIndex &, int, int)),          this, SLOT(sRowsChanged()));
+  connect(model(),        SIGNAL(rowsRemoved(const QModelIndex &, int, int)),           this, SLOT(sRowsChanged()));
 
   emit valid(false);
   setColumnCount(0);
@@ -170,6 +269,12 @@ XTreeWidget::XTreeWidget(QWidget *pParent) :
   connect(itemSelectedAct, SIGNAL(triggered()), this, SLOT(sItemSelected()));
   addAction(itemSelectedAct);
 
+  QAction* findNextAct = new QAction(this);
+  findNextAct->setShortcut(QKeySequence(QKeySequence::FindNext));
+  findNextAct->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+  connect(findNextAct, SIGNAL(triggered()), this, SLOT(sFindNext()));
+  addAction(findNextAct);
+
 }
 
 XTreeWidget::~XTreeWidget()
@@ -178,17 +283,6 @@ XTreeWidget::~XTreeWidget()
 
   cleanupAfterPopulate();
 
-  if (_subtotals)
-  {
-    for (int i = 0; i < _subtotals->size(); i++)
-    {
-      delete (*_subtotals)[i];
-      _subtotals->replace(i, 0);
-    }
-    delete _subtotals;
-    _subtotals = 0;
-  }
-
   if (_x_preferences)
   {
       xtsettingsSetValue( _settingsName + "/isForgetful",       _forgetful);
@@ -218,6 +312,12 @@ XTreeWidget::~XTreeWidget()
   for (int i = 0; i < _roles.size(); i++)
     delete _roles.value(i);
   _roles.clear();
+
+  disconnect(model(), 0, this, 0);
+  delete _search;
+  _search = 0;
+  delete _cursor;
+  _cursor = 0;
 }
 
 void XTreeWidget::populate(const QString &pSql, bool pUseAltId)
@@ -261,6 +361,81 @@ void XTreeWidget::populate(XSqlQuery pQuery, int pIndex, bool pUseAltId, Populat
     _workingTimer.start(WORKERINTERVAL);
 }
 
+/** @brief Fill the list a page at a time from a server-side cursor.
+
+    @a pQuery must be prepared and bound but not executed, for example the
+    result of MetaSQLQuery::toQuery() with pExec set to false. The list
+    holds a window of a few pages of @a pageSize rows. Pages are fetched
+    as the user scrolls toward either end of the window and the furthest
+    page is dropped, so client memory does not grow with the result. The
+    list's scroll bar spans the whole result, using the planner's estimate
+    of its size until the last row has been fetched.
+
+    The server sorts the rows, so clicking a column header starts over
+    from the first page in the new order. Searching moves the window to
+    the next rows that match, and exporting writes the result a window at
+    a time. Lists with indented rows, running values or totals keep every
+    page they fetch, since those need the rows before the ones shown.
+
+    @return false if the cursor could not be opened. cursorError() says why.
+ */
+bool XTreeWidget::populateCursor(XSqlQuery pQuery, int pIndex, bool pUseAltId, int pageSize)
+{
+  int     column = header()->isSortIndicatorShown() ? sortColumn() : -1;
+  QString field  = cursorSortField(column);
+  if (! _cursor->open(pQuery, pIndex, pUseAltId, pageSize, field, sortOrder()))
+    return false;
+
+  // a column the server cannot sort by can only be sorted once every row is here
+  if (column >= 0 && field.isEmpty() && ! _cursor->isWindowed())
+  {
+    fetchAll();
+    sortItems(column, sortOrder());
+  }
+  return true;
+}
+
+/* The query field the server can order the rows of @a column by, or an
+   empty string if the column does not have one of its own.
+ */
+QString XTreeWidget::cursorSortField(int column) const
+{
+  if (column < 0 || ! _roles.contains(column) ||
+      headerItem()->data(column, Qt::UserRole).toString() == "xtrunningrole")
+    return QString();
+
+  return _roles.value(column)->value("qteditrole").toString();
+}
+
+/** @brief Return true if the list holds only part of what populateCursor()
+           returned.
+ */
+bool XTreeWidget::cursorOpen() const
+{
+  return _cursor->isOpen();
+}
+
+/** @brief Return the planner's estimate of the rows populateCursor() will
+           return, or -1 if it is not known.
+ */
+int XTreeWidget::estimatedRowCount() const
+{
+  return _cursor->estimatedRows();
+}
+
+QSqlError XTreeWidget::cursorError() const
+{
+  return _cursor->lastError();
+}
+
+/** @brief Read every row populateCursor() returned into the list and stop
+           dropping pages. Memory then grows with the size of the result.
+ */
+void XTreeWidget::fetchAll()
+{
+  _cursor->fetchAll();
+}
+
 void XTreeWidget::populateWorker()
 {
   if (_workingParams.isEmpty())
@@ -330,13 +505,6 @@ void XTreeWidget::populateWorker()
       for (int ref = 0; ref < _roles.size(); ++ref)
         (*_colRole)[ref] = new int[COLROLE_COUNT];
 
-      if (! _subtotals)
-      {
-        _subtotals = new QList<QMap<int, double> *>();
-        for (int i = 0; i < _fieldCount; i++)
-          _subtotals->append(new QMap<int, double>());
-      }
-
       QSqlRecord  currRecord = pQuery.record();
 
       // apply indent, hidden and delete roles to col 0 if the caller requested them
@@ -430,6 +598,8 @@ void XTreeWidget::populateWorker()
       else
         setIndentation( 0);
 
+      _plan.reset(new XTreeWidgetFormatPlan(headerItem(), _roles.size()));
+
       if (! _linear && ! _progress)
       {
         _progress = new XTreeWidgetProgress(this);
@@ -444,8 +614,11 @@ void XTreeWidget::populateWorker()
     }
   }
 
-  int defaultScale = decimalPlaces("");
+  if (! _plan)
+    _plan.reset(new XTreeWidgetFormatPlan(headerItem(), _roles.size()));
+  int defaultScale = _plan->defaultScale;
   int cnt = 0;
+  QueryProfilerTimer timer("XTreeWidget::populate", &cnt);
 
   if (pQuery.at() >= 0) // if the query returned any rows at all
     do
@@ -531,8 +704,8 @@ void XTreeWidget::populateWorker()
         _last->setData(col, Xt::RawRole, rawValue);
 
         // TODO: this isn't necessary for all columns so do less often?
-        int     scale        = defaultScale;
-        QString numericrole  = "";
+        int  scale   = defaultScale;
+        bool percent = false;
         if ((*_colRole)[col][COLROLE_NUMERIC])
         {
           // Negative NUMERIC ROLE => default for column instead of column index
@@ -541,8 +714,10 @@ void XTreeWidget::populateWorker()
             scale = 0 - (*_colRole)[col][COLROLE_NUMERIC];
           else
           {
-            numericrole  = pQuery.value((*_colRole)[col][COLROLE_NUMERIC]).toString();
-            scale        = decimalPlaces(numericrole);
+            const XTreeWidgetFormatPlan::Column &numeric =
+              _plan->numeric(col, pQuery.value((*_colRole)[col][COLROLE_NUMERIC]).toString());
+            scale   = numeric.scale;
+            percent = numeric.percent;
           }
         }
 
@@ -566,10 +741,10 @@ void XTreeWidget::populateWorker()
           QVariant field = pQuery.value((*_colRole)[col][COLROLE_DISPLAY]);
           if (field.type() == QVariant::Int)
             _last->setData(col, Qt::DisplayRole,
-                          QLocale().toString(field.toInt()));
+                          _plan->locale.toString(field.toInt()));
           else if (field.type() == QVariant::Double)
             _last->setData(col, Qt::DisplayRole,
-                          QLocale().toString(field.toDouble(),
+                          _plan->locale.toString(field.toDouble(),
                                              'f', scale));
           else
             _last->setData(col, Qt::DisplayRole, field.toString());
@@ -581,25 +756,23 @@ void XTreeWidget::populateWorker()
                         pQuery.value((*_colRole)[col][COLROLE_NULL]).toString() :
                         "");
         }
-        else if ((*_colRole)[col][COLROLE_NUMERIC] &&
-                 ((numericrole == "percent") ||
-                  (numericrole == "scrap")))
+        else if (percent)
         {
           _last->setData(col, Qt::DisplayRole,
-                          QLocale().toString(rawValue.toDouble() * 100.0,
+                          _plan->locale.toString(rawValue.toDouble() * 100.0,
                                            'f', scale));
         }
         else if ((*_colRole)[col][COLROLE_NUMERIC] || rawValue.type() == QVariant::Double)
         {
           // Issue #8897
           _last->setData(col, Qt::DisplayRole,
-                          QLocale().toString(round(rawValue.toDouble(), scale),
+                          _plan->locale.toString(round(rawValue.toDouble(), scale),
                                            'f', scale));
         }
         else if (rawValue.type() == QVariant::Bool)
         {
           _last->setData(col, Qt::DisplayRole,
-                        rawValue.toBool() ? yesStr : noStr);
+                        rawValue.toBool() ? _plan->yes : _plan->no);
         }
         else
         {
@@ -626,14 +799,14 @@ void XTreeWidget::populateWorker()
         {
           QVariant fg = pQuery.value((*_colRole)[col][COLROLE_FOREGROUND]);
           if (!fg.isNull())
-            _last->setData(col, Qt::ForegroundRole, namedColor(fg.toString()));
+            _last->setData(col, Qt::ForegroundRole, _plan->foreground(col, fg.toString()));
         }
 
         if ((*_colRole)[col][COLROLE_BACKGROUND])
         {
           QVariant bg = pQuery.value((*_colRole)[col][COLROLE_BACKGROUND]);
           if (!bg.isNull())
-            _last->setData(col, Qt::BackgroundRole, namedColor(bg.toString()));
+            _last->setData(col, Qt::BackgroundRole, _plan->background(col, bg.toString()));
         }
 
         if ((*_colRole)[col][COLROLE_TEXTALIGNMENT])
@@ -643,7 +816,7 @@ void XTreeWidget::populateWorker()
             _last->setData(col, Qt::TextAlignmentRole, alignment);
         }
         else
-          _last->setData(col, Qt::TextAlignmentRole, headerItem()->textAlignment(col));
+          _last->setData(col, Qt::TextAlignmentRole, _plan->alignment.at(col));
 
         if ((*_colRole)[col][COLROLE_TOOLTIP])
         {
@@ -680,23 +853,10 @@ void XTreeWidget::populateWorker()
             _last->setData(col, Xt::IdRole, id);
         }
 
+        // the running value itself is calculated by populateCalculatedColumns
         if ((*_colRole)[col][COLROLE_RUNNING])
-        {
-          int set = pQuery.value((*_colRole)[col][COLROLE_RUNNING]).toInt();
-          _last->setData(col, Xt::RunningSetRole, set);
-          /* performance hack - populateCalculatedColumns will repeat this
-             but only redraw if necessary. redraw is much slower than recalc. */
-          if (! _subtotals->at(col)->contains(set))
-          {
-            if ((*_colRole)[col][COLROLE_RUNNINGINIT])
-              (*_subtotals)[col]->insert(set, pQuery.value((*_colRole)[col][COLROLE_RUNNINGINIT]).toDouble());
-            else
-              (*_subtotals)[col]->insert(set, 0.0);
-          }
-          (*(*_subtotals)[col])[set] += rawValue.toDouble();
-          _last->setData(col, Qt::DisplayRole,
-                         QLocale().toString((*_subtotals)[col]->value(set), 'f', scale));
-        }
+          _last->setData(col, Xt::RunningSetRole,
+                         pQuery.value((*_colRole)[col][COLROLE_RUNNING]).toInt());
 
         if ((*_colRole)[col][COLROLE_TOTAL])
         {
@@ -762,7 +922,9 @@ void XTreeWidget::populateWorker()
     cleanupAfterPopulate();
 
     populateCalculatedColumns();
-    if (sortColumn() >= 0 && header()->isSortIndicatorShown())
+    // pages read from a cursor already arrive in the order shown
+    if (sortColumn() >= 0 && header()->isSortIndicatorShown() &&
+        ! (_cursor && _cursor->isFetching()))
       sortItems(sortColumn(), header()->sortIndicatorOrder());
 
     if (DEBUG)
@@ -784,6 +946,8 @@ void XTreeWidget::cleanupAfterPopulate()
 
   _last = 0;
 
+  _plan.reset();
+
   // TODO: get rid of this when the code is rewritten
   //       as per above's todo about the QVector<int*>
   if (_colRole)
@@ -1088,6 +1252,8 @@ bool XTreeWidgetItem::operator>(const XTreeWidgetItem &other) const
 void XTreeWidget::sortItems(int column, Qt::SortOrder order)
 {
   int previd = id();
+  int items  = topLevelItemCount();
+  QueryProfilerTimer timer("XTreeWidget::sortItems", &items);
 
   // if old style then maintain backwards compatibility
   if (_roles.size() <= 0)
@@ -1102,6 +1268,21 @@ void XTreeWidget::sortItems(int column, Qt::SortOrder order)
 
   header()->setSortIndicator(column, order);
 
+  // rows still on the server are sorted there so later pages arrive in order
+  if (_cursor && _cursor->isOpen() && ! _cursor->isFetching())
+  {
+    QString field = cursorSortField(column);
+    if (! field.isEmpty() && _cursor->sort(field, order))
+    {
+      emit resorted();
+      return;
+    }
+    // rows outside the window cannot be sorted here
+    if (_cursor->isWindowed())
+      return;
+    fetchAll();
+  }
+
   // simple insertion sort using binary search to find the right insertion pt
   QString totalrole("totalrole");
   int     itemcount      = topLevelItemCount();
@@ -1214,65 +1395,225 @@ void XTreeWidget::sortItems(int column, Qt::SortOrder order)
   emit resorted();
 }
 
+/* Calculate xtrunningrole and xttotalrole columns.
+
+   The visible rows are flattened once in display order, children after
+   their parents, and each calculated column is then handled in a single
+   linear pass over plain arrays. Results are kept in _calcValues and
+   turned into display strings by XTreeWidgetItem::data() only when a cell
+   is actually painted or its text is requested.
+
+   Running columns accumulate across the top-level rows, per running set.
+   Total columns are summed per total set over every row, including
+   children and hidden rows, as they always have been; one total row is
+   appended per set. An indented parent row with no value of its own in a
+   total column shows the subtotal of its children in the same set.
+
+   populate() calls this when it finishes. Rows added or removed some other
+   way, such as by a script or a cursor page, queue another call.
+ */
 void XTreeWidget::populateCalculatedColumns()
 {
-  QMap<int, QMap<int, double> > totals; // <col <totalset, subtotal> >
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  QString      totalrole("totalrole");
+
+  _calcPending = false;
+  _calculating = true;
+
+  // start from scratch - sortItems() has already removed these but scripts may call us again
+  for (int row = topLevelItemCount() - 1; row >= 0; row--)
+  {
+    QTreeWidgetItem *item = QTreeWidget::topLevelItem(row);
+    if (item && item->data(0, Qt::UserRole).toString() == totalrole)
+      delete takeTopLevelItem(row);
+  }
+
+  int colcount = columnCount();
+  QVector<int> running;
+  QVector<int> totaled;
+  for (int col = 0; col < colcount; col++)
+  {
+    QString role = headerItem()->data(col, Qt::UserRole).toString();
+    if (role == "xtrunningrole")
+      running.append(col);
+    else if (role == "xttotalrole")
+      totaled.append(col);
+  }
+
+  _calcSlot.fill(-1, colcount);
+  _calcValues.clear();
+  if (running.isEmpty() && totaled.isEmpty())
+  {
+    _calculating = false;
+    return;
+  }
+
+  // flatten the rows in display order
+  QVector<XTreeWidgetItem *> rows;
+  QVector<int>               parent;
+  rows.reserve(topLevelItemCount());
+  parent.reserve(topLevelItemCount());
+  QVector<QPair<XTreeWidgetItem *, int> > stack;
+  for (int row = topLevelItemCount() - 1; row >= 0; row--)
+    stack.append(qMakePair(topLevelItem(row), -1));
+  while (! stack.isEmpty())
+  {
+    QPair<XTreeWidgetItem *, int> next = stack.last();
+    stack.removeLast();
+    XTreeWidgetItem *item = next.first;
+    if (! item)
+      continue;
+    int idx = rows.size();
+    item->_calcRow  = idx;
+    item->_calcTree = this;
+    rows.append(item);
+    parent.append(next.second);
+    for (int child = item->childCount() - 1; child >= 0; child--)
+      stack.append(qMakePair(item->child(child), idx));
+  }
+  const int n = rows.size();
+
+  QVector<double> raw(n);
+  QVector<int>    set(n);
+  QMap<int, QMap<int, double> > totals; // <set <col, total> >
   QMap<int, int> scales;                // keep scale for the col, not col[totalset]
-  for (int col = 0; topLevelItem(0) &&
-       col < topLevelItem(0)->columnCount(); col++)
+
+  for (int r = 0; r < running.size(); r++)
   {
-    if (headerItem()->data(col, Qt::UserRole).toString() == "xtrunningrole")
+    int col = running.at(r);
+    QVector<double> values(n, nan);
+
+    // assume that Xt::RunningSetRole exists if xtrunningrole exists
+    QVector<QPair<int, double> > acc;  // <set, running total>, rarely more than one
+    for (int i = 0; i < n; i++)
     {
-      QMap<int, double> subtotals;
-      // assume that Xt::RunningSetRole exists if xtrunningrole exists
-      for (int row = 0; row < topLevelItemCount(); row++)
-      {
-        int set = topLevelItem(row)->data(col, Xt::RunningSetRole).toInt();
-        if (!subtotals.contains(set))
-          subtotals[set] = topLevelItem(row)->data(col, Xt::RunningInitRole).toDouble();
-        subtotals[set] += topLevelItem(row)->data(col, Xt::RawRole).toDouble();
-
-        // setData apparently knows if the value hasn't changed
-        topLevelItem(row)->setData(col, Qt::DisplayRole,
-                                   QLocale().toString(subtotals[set], 'f',
-                                                      topLevelItem(row)->data(col, Xt::ScaleRole).toInt()));
-      }
+      if (parent.at(i) >= 0)
+        continue;
+      int s = rows.at(i)->QTreeWidgetItem::data(col, Xt::RunningSetRole).toInt();
+      int a = 0;
+      while (a < acc.size() && acc.at(a).first != s)
+        a++;
+      if (a == acc.size())
+        acc.append(qMakePair(s, rows.at(i)->QTreeWidgetItem::data(col, Xt::RunningInitRole).toDouble()));
+      acc[a].second += rows.at(i)->QTreeWidgetItem::data(col, Xt::RawRole).toDouble();
+      values[i] = acc.at(a).second;
     }
-    else if (headerItem()->data(col, Qt::UserRole).toString() == "xttotalrole")
+
+    _calcSlot[col] = _calcValues.size();
+    _calcValues.append(values);
+  }
+
+  for (int t = 0; t < totaled.size(); t++)
+  {
+    int col      = totaled.at(t);
+    int colscale = -99999;
+
+    // gather into contiguous arrays, then work only on those
+    QVector<bool> isNull(n);
+    for (int i = 0; i < n; i++)
     {
-      QMap<int, double> totalset;
-      int colscale = -99999;
-      // assume that Xt::TotalSetRole exists if xttotalrole exists
-      for (int row = 0; row < topLevelItemCount(); row++)
+      QVariant value = rows.at(i)->QTreeWidgetItem::data(col, Xt::RawRole);
+      isNull[i] = value.isNull();
+      raw[i]    = value.toDouble();
+      set[i]    = rows.at(i)->QTreeWidgetItem::data(col, Xt::TotalSetRole).toInt();
+      int scale = rows.at(i)->QTreeWidgetItem::data(col, Xt::ScaleRole).toInt();
+      if (scale > colscale)
+        colscale = scale;
+    }
+
+    const double *v = raw.constData();
+    const int    *k = set.constData();
+    QMap<int, double> totalset;
+    for (int i = 0; i < n; i++)
+    {
+      if (! totalset.contains(k[i]))
+        totalset[k[i]] = rows.at(i)->QTreeWidgetItem::data(col, Xt::TotalInitRole).toDouble();
+      totalset[k[i]] += v[i];
+    }
+
+    // children always follow their parent so one backward pass rolls up subtotals
+    QVector<double> sub(raw);
+    QVector<double> values(n, nan);
+    bool            anySub = false;
+    for (int i = n - 1; i >= 0; i--)
+    {
+      int p = parent.at(i);
+      if (rows.at(i)->childCount() > 0 && isNull.at(i))
       {
-        int set = topLevelItem(row)->data(col, Xt::TotalSetRole).toInt();
-        if (!totalset.contains(set))
-          totalset[set] = topLevelItem(row)->data(col, Xt::TotalInitRole).toInt();
-        totalset[set] += topLevelItem(row)->totalForItem(col, set);
-        if (topLevelItem(row)->data(col, Xt::ScaleRole).toInt() > colscale)
-          colscale = topLevelItem(row)->data(col, Xt::ScaleRole).toInt();
+        values[i] = sub.at(i);
+        anySub    = true;
       }
-      totals.insert(col, totalset);
-      scales.insert(col, colscale);
+      if (p >= 0 && k[p] == k[i])
+        sub[p] += sub.at(i);
+    }
+    if (anySub)
+    {
+      _calcSlot[col] = _calcValues.size();
+      _calcValues.append(values);
     }
+
+    QMapIterator<int, double> it(totalset);
+    while (it.hasNext())
+    {
+      it.next();
+      totals[it.key()].insert(col, it.value());
+    }
+    if (totalset.isEmpty())
+      totals[0].insert(col, 0.0);
+    scales.insert(col, colscale);
   }
 
-  // punt: for now only report values of totalset[0] for each totaled col
-  // TODO: figure out how to handle multiple totalsets
   if (totals.size() > 0)
   {
-    XTreeWidgetItem *last = new XTreeWidgetItem(this, -1, -1,
-                                                (totals.size() == 1) ? tr("Total") : tr("Totals"));
-    last->setData(0, Qt::UserRole, "totalrole");
-    QMapIterator<int, QMap<int, double> > it(totals);
-    while (it.hasNext())
+    QString label = (totaled.size() == 1) ? tr("Total") : tr("Totals");
+    QMapIterator<int, QMap<int, double> > setit(totals);
+    while (setit.hasNext())
     {
-      it.next();
-      last->setData(it.key(), Qt::DisplayRole,
-                    QLocale().toString(it.value().value(0), 'f',
+      setit.next();
+      XTreeWidgetItem *last = new XTreeWidgetItem(this, -1, -1,
+                                                  setit.key() == 0 ? label :
+                                                  tr("%1 %2", "total label and total set").arg(label).arg(setit.key()));
+      last->setData(0, Qt::UserRole, totalrole);
+      QMapIterator<int, double> it(setit.value());
+      while (it.hasNext())
+      {
+        it.next();
+        last->setData(it.key(), Qt::DisplayRole,
+                      _locale.toString(it.value(), 'f',
                                        scales.value(it.key())));
+      }
     }
   }
+  _calculating = false;
+}
+
+/* Rows were added or removed outside populate(), so running values and
+   totals no longer match the list. Recalculate once control returns to
+   the event loop, however many rows changed in the meantime.
+ */
+void XTreeWidget::sRowsChanged()
+{
+  if (_calculating || _calcPending || ! _workingParams.isEmpty())
+    return;
+
+  bool calculated = false;
+  for (int col = 0; col < columnCount() && ! calculated; col++)
+  {
+    QString role = headerItem()->data(col, Qt::UserRole).toString();
+    calculated = (role == "xtrunningrole" || role == "xttotalrole");
+  }
+  if (! calculated)
+    return;
+
+  _calcPending = true;
+  QMetaObject::invokeMethod(this, "sRecalculate", Qt::QueuedConnection);
+}
+
+// skipped if populate() has recalculated since the call was queued
+void XTreeWidget::sRecalculate()
+{
+  if (_calcPending)
+    populateCalculatedColumns();
 }
 
 int XTreeWidget::id() const
@@ -1421,19 +1762,15 @@ void XTreeWidget::clear()
     qDebug("%s::clear()", qPrintable(objectName()));
   if (! _workingTimer.isActive())
     _workingParams.clear();
-  if (_subtotals)
-  {
-    for (int i = 0; i < _subtotals->size(); i++)
-    {
-      delete (*_subtotals)[i];
-      _subtotals->replace(i, 0);
-    }
-    delete _subtotals;
-    _subtotals = 0;
-  }
+  if (_cursor && ! _cursor->isFetching())
+    _cursor->close();
+  _calcSlot.clear();
+  _calcValues.clear();
   emit valid(false);
   _savedId = false; // was -1;
 
+  // before the rows go, so listeners can drop pointers to them
+  emit cleared();
   QTreeWidget::clear();
 }
 
@@ -1580,13 +1917,24 @@ void XTreeWidget::sExport()
 
   if (!fi.filePath().isEmpty())
   {
-    QTextDocument       *doc = new QTextDocument();
-    QTextDocumentWriter writer;
     if (fi.suffix().isEmpty())
       fi.setFile(fi.filePath() += defaultSuffix);
     xtsettingsSetValue(_settingsName + "/exportPath", fi.path());
+
+    if (_cursor && _cursor->isWindowed() && fi.suffix() != "vcf")
+    {
+      exportCursor(fi);
+      return;
+    }
+
+    QTextDocument       *doc = new QTextDocument();
+    QTextDocumentWriter writer;
     writer.setFileName(fi.filePath());
 
+    // export everything the query returned, not just the rows read so far
+    if (fi.suffix() != "vcf")
+      fetchAll();
+
     if (fi.suffix() == "txt")
     {
       doc->setPlainText(toTxt());
@@ -1897,8 +2245,10 @@ XTreeWidgetItem::XTreeWidgetItem( XTreeWidgetItem *pParent, XTreeWidgetItem *itm
 
 void XTreeWidgetItem::constructor(int pId, int pAltId, QVariant v0,QVariant v1, QVariant v2,QVariant v3, QVariant v4,QVariant v5, QVariant v6,QVariant v7, QVariant v8,QVariant v9, QVariant v10 )
 {
-  _id    = pId;
-  _altId = pAltId;
+  _id      = pId;
+  _altId   = pAltId;
+  _calcRow  = -1;
+  _calcTree = 0;
 
   if (!v0.isNull())
     setText(0,  v0);
@@ -2007,20 +2357,27 @@ bool XTreeWidgetItem::setNumericRole(int pColIdx, const QString pRole)
   return canConvert;
 }
 
-/* Calculate the total for a particular XTreeWidgetItem, including any children.
-   pcol is the column for which we want the total.
-   prole is the value of xttotalrole for which we want the total.
-   See elsewhere for the meaning of xttotalrole values.
-*/
-double XTreeWidgetItem::totalForItem(const int pcol, const int pset) const
+/* Running and subtotal values are calculated by the tree in bulk and only
+   formatted here, when the view or a caller actually asks for the text.
+   The tree that calculated them is remembered so this need not find it
+   again for every cell; an item since moved to another tree is ignored.
+ */
+QVariant XTreeWidgetItem::data(int colidx, int role) const
 {
-  double total = 0.0;
-
-  if (pset == data(pcol, Xt::TotalSetRole).toInt())
-    total += data(pcol, Xt::RawRole).toDouble();
-  for (int i = 0; i < childCount(); i++)
-    total += child(i)->totalForItem(pcol, pset);
-  return total;
+  if (role == Qt::DisplayRole && _calcRow >= 0 && _calcTree &&
+      treeWidget() == _calcTree)
+  {
+    const XTreeWidget *tree = _calcTree;
+    if (colidx >= 0 && colidx < tree->_calcSlot.size() &&
+        tree->_calcSlot.at(colidx) >= 0)
+    {
+      const QVector<double> &values = tree->_calcValues.at(tree->_calcSlot.at(colidx));
+      if (_calcRow < values.size() && values.at(_calcRow) == values.at(_calcRow)) // not NaN
+        return tree->_locale.toString(values.at(_calcRow), 'f',
+                                      QTreeWidgetItem::data(colidx, Xt::ScaleRole).toInt());
+    }
+  }
+  return QTreeWidgetItem::data(colidx, role);
 }
 
 // script exposure of xtreewidgetitem /////////////////////////////////////////
@@ -2325,36 +2682,112 @@ void XTreeWidget::sCopyColumnToClipboard()
 }
 
 void XTreeWidget::sSearch(const QString &pTarget)
+{
+  // Historically this only looks at the first column
+  sSearchColumn(pTarget, 0, SearchSubstring);
+}
+
+/** Select the first row, in display order, that matches the target.
+
+    @param pTarget The text to look for, compared case-insensitively
+    @param pColumn The column to search or -1 to search all visible columns
+    @param pMode   Whether the target has to match the start of the cell
+ */
+void XTreeWidget::sSearchColumn(const QString &pTarget, int pColumn, SearchMode pMode)
 {
   clearSelection();
-  int i;
-  for (i = 0; i < topLevelItemCount(); i++)
+
+  QList<XTreeWidgetItem *> matches = search(pTarget, pColumn, pMode);
+  if (matches.size() > 0)
   {
-    // Currently this only looks at the first column
-    if (topLevelItem(i)->text(0).contains(pTarget, Qt::CaseInsensitive))
-      break;
+    setCurrentItem(matches.at(0));
+    scrollToItem(matches.at(0));
   }
+}
 
-  if (i < topLevelItemCount())
+/** Select the next row that matched the last search, wrapping at the end.
+ */
+void XTreeWidget::sFindNext()
+{
+  XTreeWidgetItem *item = findNext();
+  if (item)
   {
-    setCurrentItem(topLevelItem(i));
-    scrollToItem(topLevelItem(i));
+    clearSelection();
+    setCurrentItem(item);
+    scrollToItem(item);
   }
 }
 
-QString XTreeWidget::toTxt() const
+/** Find the top-level rows that match the target, in display order.
+
+    The search runs against an in-memory index of the loaded rows that is
+    built the first time a column is searched. Edited cells are updated in
+    the index; adding, removing or sorting rows discards it. Hidden rows
+    never match. A search that extends the previous target only re-examines
+    the rows that matched last time.
+
+    @param target The text to look for, compared case-insensitively
+    @param column The column to search or -1 to search all visible columns
+    @param mode   Whether the target has to match the start of the cell
+ */
+QList<XTreeWidgetItem *> XTreeWidget::search(const QString &target, int column, SearchMode mode)
 {
-  QString line;
-  QString opText;
-  int     counter;
+  QList<XTreeWidgetItem *> result;
+  if (target.isEmpty())
+    return result;
 
-  QTreeWidgetItem *header = headerItem();
-  for (counter = 0; counter < header->columnCount(); counter++)
+  if (_cursor && _cursor->isOpen() && ! _cursor->isWindowed())
+    fetchAll();
+
+  // move a cursor's window along until it holds a match
+  QVector<int> rows = _search->search(target, column, mode);
+  if (rows.isEmpty() && _cursor && _cursor->isWindowed())
   {
-    if (!QTreeWidget::isColumnHidden(counter))
-      line = line + header->text(counter).replace("\r\n"," ") + "\t";
+    int start = _cursor->firstRow();
+    while (rows.isEmpty() &&
+           _cursor->moveTo(_cursor->firstRow() + _cursor->windowRows()))
+      rows = _search->search(target, column, mode);
+    if (rows.isEmpty())
+      _cursor->moveTo(start);
   }
-  opText = line + "\r\n";
+
+  for (int i = 0; i < rows.size(); i++)
+  {
+    XTreeWidgetItem *item = _search->item(rows.at(i));
+    if (item)
+      result.append(item);
+  }
+  return result;
+}
+
+XTreeWidgetItem *XTreeWidget::findNext()
+{
+  return _search->next();
+}
+
+void XTreeWidget::sInvalidateSearch()
+{
+  if (_search)
+    _search->invalidate();
+}
+
+void XTreeWidget::sUpdateSearch(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+  if (! _search)
+    return;
+
+  // only top-level rows are indexed
+  if (topLeft.parent().isValid())
+    return;
+
+  _search->update(topLeft.row(), bottomRight.row(),
+                  topLeft.column(), bottomRight.column());
+}
+
+QString XTreeWidget::toTxt() const
+{
+  QString line;
+  QString opText = txtLine(headerItem()) + "\r\n";
 
   XTreeWidgetItem *item = topLevelItem(0);
   if (item)
@@ -2363,71 +2796,173 @@ QString XTreeWidget::toTxt() const
     {
       item = (XTreeWidgetItem *)itemFromIndex(idx);
       if (item)
-      {
-        line = "";
-        for (counter = 0; counter < item->columnCount(); counter++)
-        {
-          if (!QTreeWidget::isColumnHidden(counter))
-            line = line + item->text(counter) + "\t";
-        }
-      }
+        line = txtLine(item);
       opText = opText + line + "\r\n";
     }
   }
   return opText;
 }
 
-QString XTreeWidget::toCsv() const
+// one line of toTxt() for the header or a row
+QString XTreeWidget::txtLine(QTreeWidgetItem *item) const
 {
   QString line;
-  QString opText;
-  int     counter;
-  int     colcount         = 0;
-
-  QTreeWidgetItem *header  = headerItem();
-  for (counter = 0; counter < header->columnCount(); counter++)
+  bool    header = (item == headerItem());
+  for (int counter = 0; counter < item->columnCount(); counter++)
   {
     if (!QTreeWidget::isColumnHidden(counter))
     {
-      if (colcount)
-        line = line + ",";
-      line = line + header->text(counter).replace("\"","\"\"").replace("\r\n"," ").replace("\n"," ");
-      colcount++;
+      if (header)
+        line = line + item->text(counter).replace("\r\n"," ") + "\t";
+      else
+        line = line + item->text(counter) + "\t";
     }
   }
-  opText = line + "\r\n";
+  return line;
+}
+
+QString XTreeWidget::toCsv() const
+{
+  QString line;
+  QString opText = csvLine(headerItem()) + "\r\n";
 
   XTreeWidgetItem *item = topLevelItem(0);
   if (item)
   {
     for (QModelIndex idx = indexFromItem(item); idx.isValid(); idx = indexBelow(idx))
     {
-      colcount = 0;
-      item     = (XTreeWidgetItem *)itemFromIndex(idx);
+      item = (XTreeWidgetItem *)itemFromIndex(idx);
       if (item)
-      {
-        line = "";
-        for (counter = 0; counter < item->columnCount(); counter++)
-        {
-          if (!QTreeWidget::isColumnHidden(counter))
-          {
-            if (colcount)
-              line = line + ",";
-            if (item->data(counter,Qt::DisplayRole).type() == QVariant::String)
-              line = line + "\"";
-            line = line + item->text(counter).replace("\"","\"\"");
-            if (item->data(counter,Qt::DisplayRole).type() == QVariant::String)
-              line = line + "\"";
-            colcount++;
-          }
-        }
-      }
+        line = csvLine(item);
       opText = opText + line + "\r\n";
     }
   }
   return opText;
 }
 
+// one line of toCsv() for the header or a row
+QString XTreeWidget::csvLine(QTreeWidgetItem *item) const
+{
+  QString line;
+  int     colcount = 0;
+  bool    header   = (item == headerItem());
+  for (int counter = 0; counter < item->columnCount(); counter++)
+  {
+    if (!QTreeWidget::isColumnHidden(counter))
+    {
+      if (colcount)
+        line = line + ",";
+      if (header)
+        line = line + item->text(counter).replace("\"","\"\"").replace("\r\n"," ").replace("\n"," ");
+      else
+      {
+        bool quote = (item->data(counter,Qt::DisplayRole).type() == QVariant::String);
+        if (quote)
+          line = line + "\"";
+        line = line + item->text(counter).replace("\"","\"\"");
+        if (quote)
+          line = line + "\"";
+      }
+      colcount++;
+    }
+  }
+  return line;
+}
+
+// one row of exportCursor()'s HTML table for the header or a row
+QString XTreeWidget::htmlLine(QTreeWidgetItem *item) const
+{
+  bool    header = (item == headerItem());
+  QString line("<tr>");
+  for (int counter = 0; counter < item->columnCount(); counter++)
+  {
+    if (QTreeWidget::isColumnHidden(counter))
+      continue;
+
+    QString style;
+    if (header)
+      style = "background-color:lightgray;";
+    else
+    {
+      if (item->data(counter, Qt::BackgroundRole).isValid())
+        style += "background-color:" + item->data(counter, Qt::BackgroundRole).value<QColor>().name() + ";";
+      if (item->data(counter, Qt::ForegroundRole).isValid())
+        style += "color:" + item->data(counter, Qt::ForegroundRole).value<QColor>().name() + ";";
+    }
+    line += QString("<td%1>%2</td>")
+              .arg(style.isEmpty() ? QString() : " style=\"" + style + "\"",
+                   item->text(counter).toHtmlEscaped());
+  }
+  return line + "</tr>";
+}
+
+/* Export a list fed by a server-side cursor a window at a time, so the
+   whole result never has to be in the list. Text, CSV and HTML are written
+   to the file as they go; an ODF document is built in memory from the
+   same HTML. The rows the list showed before are fetched again after.
+ */
+void XTreeWidget::exportCursor(const QFileInfo &fi)
+{
+  QString suffix = fi.suffix();
+  QFile   file(fi.filePath());
+  QString html;
+  QTextStream out;
+  if (suffix == "odt")
+    out.setString(&html);
+  else if (file.open(QIODevice::WriteOnly))
+  {
+    out.setDevice(&file);
+    out.setCodec("UTF-8");
+  }
+  else
+  {
+    QMessageBox::critical(this, tr("Export Error"),
+                          tr("Could not write %1: %2")
+                            .arg(fi.filePath(), file.errorString()));
+    return;
+  }
+
+  bool markup = (suffix == "html" || suffix == "odt");
+  if (markup)
+    out << "<html><body><table border=\"1\" cellspacing=\"0\">"
+        << htmlLine(headerItem()) << "\r\n";
+  else if (suffix == "csv")
+    out << csvLine(headerItem()) << "\r\n";
+  else
+    out << txtLine(headerItem()) << "\r\n";
+
+  qApp->setOverrideCursor(Qt::WaitCursor);
+  int start = _cursor->firstRow();
+  for (bool more = _cursor->moveTo(0); more;
+       more = _cursor->moveTo(_cursor->firstRow() + _cursor->windowRows()))
+  {
+    for (QModelIndex idx = indexFromItem(QTreeWidget::topLevelItem(0)); idx.isValid(); idx = indexBelow(idx))
+    {
+      QTreeWidgetItem *item = itemFromIndex(idx);
+      if (markup)
+        out << htmlLine(item) << "\r\n";
+      else if (suffix == "csv")
+        out << csvLine(item) << "\r\n";
+      else
+        out << txtLine(item) << "\r\n";
+    }
+  }
+  _cursor->moveTo(start);
+  qApp->restoreOverrideCursor();
+
+  if (markup)
+    out << "</table></body></html>";
+  out.flush();
+
+  if (suffix == "odt")
+  {
+    QTextDocument       doc;
+    QTextDocumentWriter writer(fi.filePath(), "odf");
+    doc.setHtml(html);
+    writer.write(&doc);
+  }
+}
+
 QString XTreeWidget::toVcf() const
 {
   XSqlQuery qry;
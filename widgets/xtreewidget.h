@@ -11,6 +11,9 @@
 #ifndef __XTREEWIDGET_H__
 #define __XTREEWIDGET_H__
 
+#include <QLocale>
+#include <QScopedPointer>
+#include <QSqlError>
 #include <QTreeWidget>
 #include <QTreeWidgetItem>
 #include <QVariant>
@@ -54,10 +57,12 @@
 #include "xsqlquery.h"
 
 class QAction;
+class QFileInfo;
 class QMenu;
 class QScriptEngine;
 class XTreeWidget;
 class XTreeWidgetProgress;
+class XTreeWidgetSearch;
 
 class XTUPLEWIDGETS_EXPORT XTreeWidgetItem : public QObject, public QTreeWidgetItem
 {
@@ -126,7 +131,7 @@ class XTUPLEWIDGETS_EXPORT XTreeWidgetItem : public QObject, public QTreeWidgetI
     Q_INVOKABLE inline void             setId(int pId)    { _id = pId;     }
     Q_INVOKABLE inline void             setAltId(int pId) { _altId = pId;  }
 
-    Q_INVOKABLE inline QVariant         data(int colidx,    int role) const { return QTreeWidgetItem::data(colidx, role); }
+    Q_INVOKABLE virtual QVariant        data(int colidx,    int role) const;
     Q_INVOKABLE inline void             setData(int colidx, int role, const QVariant &val) { QTreeWidgetItem::setData(colidx, role, val); }
     Q_INVOKABLE virtual QVariant        rawValue(const QString colname);
     Q_INVOKABLE virtual int             id(const QString);
@@ -146,9 +151,6 @@ class XTUPLEWIDGETS_EXPORT XTreeWidgetItem : public QObject, public QTreeWidgetI
 
     virtual QString toString() const;
 
-  protected:
-    virtual double totalForItem(const int, const int) const;
-
   private:
     void constructor( int, int, QVariant, QVariant, QVariant,
                       QVariant, QVariant, QVariant, QVariant,
@@ -156,9 +158,13 @@ class XTUPLEWIDGETS_EXPORT XTreeWidgetItem : public QObject, public QTreeWidgetI
 
     int _id;
     int _altId;
+    int _calcRow;   // index into XTreeWidget::_calcValues, -1 if none
+    XTreeWidget *_calcTree; // the tree that set _calcRow
 };
 
 class XTreeWidgetPopulateParams;
+class XTreeWidgetCursor;
+class XTreeWidgetFormatPlan;
 
 class XTUPLEWIDGETS_EXPORT XTreeWidget : public QTreeWidget
 {
@@ -166,9 +172,13 @@ class XTUPLEWIDGETS_EXPORT XTreeWidget : public QTreeWidget
   Q_PROPERTY( QString altDragString READ altDragString WRITE setAltDragString)
   Q_PROPERTY( bool populateLinear READ populateLinear WRITE setPopulateLinear)
 
+  friend class XTreeWidgetItem;
+
   public :
     enum PopulateStyle { Replace, Append };
     Q_ENUM(PopulateStyle)
+    enum SearchMode { SearchPrefix, SearchSubstring };
+    Q_ENUM(SearchMode)
 
     XTreeWidget(QWidget *);
     ~XTreeWidget();
@@ -177,6 +187,11 @@ class XTUPLEWIDGETS_EXPORT XTreeWidget : public QTreeWidget
     Q_INVOKABLE void  populate(XSqlQuery, int, bool = false, PopulateStyle = Replace);
     void    populate(const QString&, bool = false);
     void    populate(const QString&, int, bool = false);
+    Q_INVOKABLE bool      populateCursor(XSqlQuery, int, bool = false, int pageSize = 500);
+    Q_INVOKABLE bool      cursorOpen()        const;
+    Q_INVOKABLE int       estimatedRowCount() const;
+    Q_INVOKABLE QSqlError cursorError()       const;
+    Q_INVOKABLE void      fetchAll();
 
     QString dragString() const;
     void    setDragString(QString);
@@ -202,6 +217,9 @@ class XTUPLEWIDGETS_EXPORT XTreeWidget : public QTreeWidget
     Q_INVOKABLE XTreeWidgetItem         *findXTreeWidgetItemWithId(const XTreeWidget *ptree, const int pid);
     Q_INVOKABLE XTreeWidgetItem         *findXTreeWidgetItemWithId(const XTreeWidgetItem *ptreeitem, const int pid);
 
+    Q_INVOKABLE QList<XTreeWidgetItem *> search(const QString &target, int column = 0, SearchMode mode = SearchSubstring);
+    Q_INVOKABLE XTreeWidgetItem         *findNext();
+
     Q_INVOKABLE QString toTxt() const;
     Q_INVOKABLE QString toCsv() const;
     Q_INVOKABLE QString toVcf() const;
@@ -255,12 +273,15 @@ class XTUPLEWIDGETS_EXPORT XTreeWidget : public QTreeWidget
     void  hideColumn(const QString&);
     void  showColumn(int colnum)  { QTreeWidget::showColumn(colnum); };
     void  showColumn(const QString&);
+    void  populateCalculatedColumns();
     void  sExport();
     void  sCopyVisibleToClipboard();
     void  sCopyRowToClipboard();
     void  sCopyCellToClipboard();
     void  sCopyColumnToClipboard();
     void  sSearch(const QString&);
+    void  sSearchColumn(const QString&, int, SearchMode);
+    void  sFindNext();
 
   signals:
     void  valid(bool);
@@ -281,10 +302,10 @@ class XTUPLEWIDGETS_EXPORT XTreeWidget : public QTreeWidget
     void  populateMenu(QMenu *, XTreeWidgetItem *, int);
     void  resorted();
     void  populated();
+    void  cleared();
 
   protected slots:
     void  sHeaderClicked(int);
-    void  populateCalculatedColumns();
     void  sCurrentItemChanged(QTreeWidgetItem *current, QTreeWidgetItem *previous);
     void  sItemActivated(QTreeWidgetItem *item, int column);
     void  sItemChanged(QTreeWidgetItem *item, int column);
@@ -334,8 +355,20 @@ class XTUPLEWIDGETS_EXPORT XTreeWidget : public QTreeWidget
     XTreeWidgetItem *_last;
     int              _rowRole[ROWROLE_COUNT];
     void             cleanupAfterPopulate();
+    QString          cursorSortField(int column) const;
+    void             exportCursor(const QFileInfo &fi);
+    QString          txtLine(QTreeWidgetItem *item) const;
+    QString          csvLine(QTreeWidgetItem *item) const;
+    QString          htmlLine(QTreeWidgetItem *item) const;
     XTreeWidgetProgress *_progress;
-    QList<QMap<int, double> *> *_subtotals;
+    QScopedPointer<XTreeWidgetFormatPlan> _plan;
+    QVector<int>               _calcSlot;    // column -> index into _calcValues or -1
+    QVector<QVector<double> >  _calcValues;  // [slot][XTreeWidgetItem::_calcRow], NaN = not calculated
+    bool                       _calcPending; // a recalculation has been queued
+    bool                       _calculating; // populateCalculatedColumns() is adding total rows
+    QLocale                    _locale;
+    XTreeWidgetSearch *_search;
+    XTreeWidgetCursor *_cursor;
 
   private slots:
     void  sSelectionChanged();
@@ -351,6 +384,10 @@ class XTUPLEWIDGETS_EXPORT XTreeWidget : public QTreeWidget
     void  sToggleForgetfulness();
     void  sToggleForgetfulnessOrder();
     void  popupMenuActionTriggered(QAction *);
+    void  sInvalidateSearch();
+    void  sUpdateSearch(const QModelIndex &, const QModelIndex &);
+    void  sRowsChanged();
+    void  sRecalculate();
 };
 
 class XTreeWidgetPopulateParams
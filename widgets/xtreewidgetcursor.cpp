@@ -0,0 +1,545 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#include "xtreewidgetcursor.h"
+
+#include <QEvent>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QScrollBar>
+#include <QSqlDatabase>
+#include <QSqlDriver>
+#include <QSqlField>
+#include <QTimer>
+
+#include "sqltext.h"
+#include "xtreewidget.h"
+
+#define DEBUG false
+
+// pages the list holds at once; the rest of the result stays on the server
+#define WINDOW_PAGES 3
+
+int XTreeWidgetCursor::_counter = 0;
+
+XTreeWidgetCursor::XTreeWidgetCursor(XTreeWidget *tree)
+  : QObject(tree),
+    _tree(tree),
+    _policy(Qt::ScrollBarAsNeeded),
+    _sortOrder(Qt::AscendingOrder),
+    _open(false),
+    _fetching(false),
+    _keepAll(false),
+    _checkQueued(false),
+    _useAltId(false),
+    _index(-1),
+    _pageSize(500),
+    _first(0),
+    _rows(0),
+    _total(-1),
+    _position(0),
+    _estimate(-1)
+{
+  // drawn over the list's own scroll bar, which only spans the window
+  QWidget *container = _tree->verticalScrollBar()->parentWidget();
+  _bar = new QScrollBar(Qt::Vertical, container ? container : _tree);
+  _bar->hide();
+  if (container)
+    container->installEventFilter(this);
+  _tree->viewport()->installEventFilter(this);
+
+  connect(_tree->verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(sViewScrolled()));
+  connect(_bar, SIGNAL(valueChanged(int)), this, SLOT(sBarMoved(int)));
+  connect(_bar, SIGNAL(sliderReleased()),  this, SLOT(sBarReleased()));
+}
+
+XTreeWidgetCursor::~XTreeWidgetCursor()
+{
+  close();
+}
+
+/* Copy the SQL of @a prepared with its bound values written in as
+   literals. A cursor cannot be declared with parameters outside a
+   prepared statement, so the values are formatted by the connection's
+   driver, the same way it sends them when it executes a prepared query.
+   Quoted text, comments and :: casts are left alone.
+ */
+void XTreeWidgetCursor::setQuery(const XSqlQuery &prepared)
+{
+  QString     sql    = prepared.lastQuery();
+  QSqlDriver *driver = QSqlDatabase::database().driver();
+  QMap<QString, QVariant> binds = prepared.boundValues();
+
+  _sql.clear();
+  _sql.reserve(sql.length());
+  int positional = 0;
+  int i          = 0;
+  while (i < sql.length())
+  {
+    int skip = skipSqlQuoted(sql, i);
+    if (skip > i)
+    {
+      _sql.append(sql.mid(i, skip - i));
+      i = skip;
+      continue;
+    }
+
+    QChar    c   = sql.at(i);
+    int      end = i + 1;
+    bool     bound = false;
+    QVariant value;
+    if (c == '?')
+    {
+      value = prepared.boundValue(positional++);
+      bound = true;
+    }
+    else if (c == ':' &&
+             ! (i > 0 && sql.at(i - 1) == ':') &&
+             ! (end < sql.length() && sql.at(end) == ':'))
+    {
+      while (end < sql.length() && (sql.at(end).isLetterOrNumber() || sql.at(end) == '_'))
+        end++;
+      if (binds.contains(sql.mid(i, end - i)))
+      {
+        value = binds.value(sql.mid(i, end - i));
+        bound = true;
+      }
+    }
+
+    if (bound)
+    {
+      QSqlField field(QString(), value.type());
+      field.setValue(value);
+      _sql.append(driver ? driver->formatValue(field) : value.toString());
+    }
+    else
+      _sql.append(sql.mid(i, end - i));
+    i = end;
+  }
+
+  _sql = _sql.trimmed();
+  while (_sql.endsWith(';'))
+    _sql = _sql.left(_sql.length() - 1).trimmed();
+}
+
+/* Declare a cursor for @a prepared, which must be prepared and bound but
+   not executed, and fill the list with the first page of rows. If
+   @a sortField is given the server returns the rows ordered by it.
+ */
+bool XTreeWidgetCursor::open(const XSqlQuery &prepared, int index, bool useAltId, int pageSize,
+                             const QString &sortField, Qt::SortOrder sortOrder)
+{
+  close();
+
+  _index     = index;
+  _useAltId  = useAltId;
+  _pageSize  = qMax(50, pageSize);
+  setQuery(prepared);
+  _sortField = sortField;
+  _sortOrder = sortOrder;
+
+  return declare();
+}
+
+/* Start over with the rows ordered by @a sortField. The list is replaced
+   by the first page in the new order. Returns false if the cursor is not
+   open or could not be declared again.
+ */
+bool XTreeWidgetCursor::sort(const QString &sortField, Qt::SortOrder sortOrder)
+{
+  if (! _open || _fetching)
+    return false;
+
+  close();
+  _index     = _tree->id();
+  _sortField = sortField;
+  _sortOrder = sortOrder;
+
+  return declare();
+}
+
+bool XTreeWidgetCursor::declare()
+{
+  _error    = QSqlError();
+  _first    = 0;
+  _rows     = 0;
+  _total    = -1;
+  _position = 0;
+  _estimate = -1;
+  _keepAll  = false;
+  _name     = QString("_xtcursor%1").arg(++_counter);
+
+  QString sql = _sql;
+  if (! _sortField.isEmpty())
+    sql = QString("SELECT * FROM (%1) AS _xtcursorsort ORDER BY %2 %3")
+            .arg(sql,
+                 QSqlDatabase::database().driver()->escapeIdentifier(_sortField, QSqlDriver::FieldName),
+                 _sortOrder == Qt::AscendingOrder ? "ASC" : "DESC");
+
+  XSqlQuery explain;
+  if (explain.exec("EXPLAIN (FORMAT JSON) " + sql) && explain.first())
+  {
+    QJsonDocument plan = QJsonDocument::fromJson(explain.value(0).toByteArray());
+    if (plan.isArray() && ! plan.array().isEmpty())
+      _estimate = int(plan.array().at(0).toObject().value("Plan").toObject()
+                      .value("Plan Rows").toDouble(-1));
+  }
+
+  // WITH HOLD outlives the statement's transaction, so none is left open
+  XSqlQuery declareq;
+  if (! declareq.exec("DECLARE " + _name + " SCROLL CURSOR WITH HOLD FOR " + sql + ";"))
+  {
+    _error = declareq.lastError();
+    return false;
+  }
+  _open = true;
+
+  if (DEBUG)
+    qDebug("%s opened cursor %s, about %d rows",
+           qPrintable(_tree->objectName()), qPrintable(_name), _estimate);
+
+  if (! load(0, _pageSize, Replace, _index))
+    return false;
+
+  // these need every row before the ones shown, so nothing can be dropped
+  for (int i = 0; i < _tree->topLevelItemCount() && ! _keepAll; i++)
+    if (_tree->QTreeWidget::topLevelItem(i)->childCount() > 0)
+      _keepAll = true;
+  for (int col = 0; col < _tree->columnCount() && ! _keepAll; col++)
+  {
+    QString role = _tree->headerItem()->data(col, Qt::UserRole).toString();
+    if (role == "xtrunningrole" || role == "xttotalrole")
+      _keepAll = true;
+  }
+
+  updateBar();
+  queueCheck();
+  return true;
+}
+
+void XTreeWidgetCursor::close()
+{
+  if (_open)
+  {
+    _open = false;
+    XSqlQuery closeq;
+    closeq.exec("CLOSE " + _name + ";");
+
+    if (DEBUG)
+      qDebug("%s closed cursor %s at rows %d to %d",
+             qPrintable(_tree->objectName()), qPrintable(_name), _first, _first + _rows);
+  }
+  updateBar();
+}
+
+/* Fetch @a count rows starting at result row @a start, counting from 0,
+   and put them in the list. Append and Prepend add them next to the rows
+   already there and then drop rows from the other end of the window.
+ */
+bool XTreeWidgetCursor::load(int start, int count, Placement placement, int index)
+{
+  if (! _open || _fetching || count <= 0)
+    return true;
+
+  XSqlQuery page;
+  if (_position != start &&
+      ! page.exec(QString("MOVE ABSOLUTE %1 IN %2;").arg(start).arg(_name)))
+  {
+    _error = page.lastError();
+    close();
+    return false;
+  }
+  if (! page.exec(QString("FETCH FORWARD %1 FROM %2;").arg(count).arg(_name)))
+  {
+    _error = page.lastError();
+    close();
+    return false;
+  }
+
+  int rows = qMax(0, page.size());
+  if (rows < count)
+  {
+    _total    = start + rows;
+    _position = -1;     // past the end, so the next fetch has to move back
+  }
+  else
+    _position = start + rows;
+
+  // past the end of the result; keep the rows the list already has
+  if (rows == 0 && (placement != Replace || start > 0))
+    return true;
+
+  int anchor = _first + topRow();
+  int before = dataRows();
+
+  bool linear = _tree->populateLinear();
+  _fetching = true;
+  _tree->setPopulateLinear(true);
+  _tree->populate(page, index, _useAltId,
+                  placement == Replace ? XTreeWidget::Replace : XTreeWidget::Append);
+  _tree->setPopulateLinear(linear);
+  _fetching = false;
+
+  if (placement == Replace)
+  {
+    _first = start;
+    _rows  = rows;
+  }
+  else if (placement == Append)
+    _rows += rows;
+  else
+  {
+    // populate() can only append, so move the new rows to the top
+    QList<QTreeWidgetItem *> added;
+    for (int i = 0; i < rows; i++)
+      added.append(_tree->QTreeWidget::takeTopLevelItem(before));
+    _tree->QTreeWidget::insertTopLevelItems(0, added);
+    _first = start;
+    _rows += rows;
+  }
+
+  if (! _keepAll && _rows > maxRows())
+    evict(_rows - maxRows(), placement != Prepend);
+
+  if (placement != Replace && anchor >= _first && anchor < _first + _rows)
+    _tree->scrollToItem(_tree->QTreeWidget::topLevelItem(anchor - _first),
+                        QAbstractItemView::PositionAtTop);
+
+  // the whole result is in the list, so the server can let it go
+  if (_first == 0 && atEnd())
+    close();
+
+  updateBar();
+  return true;
+}
+
+/* Delete @a count rows from the top or the bottom of the window. The
+   total rows populate() adds after the data are left for it to redo.
+ */
+void XTreeWidgetCursor::evict(int count, bool fromTop)
+{
+  int last = dataRows() - 1;
+  for (int i = 0; i < count && last >= 0; i++, last--)
+    delete _tree->QTreeWidget::takeTopLevelItem(fromTop ? 0 : last);
+
+  if (fromTop)
+    _first += count;
+  _rows -= count;
+
+  if (DEBUG)
+    qDebug("%s dropped %d rows, now holding rows %d to %d",
+           qPrintable(_tree->objectName()), count, _first, _first + _rows);
+}
+
+/* Replace the window with the rows starting at result row @a row. Returns
+   false if there are no rows there or they could not be fetched.
+ */
+bool XTreeWidgetCursor::moveTo(int row)
+{
+  if (! _open || _keepAll || row < 0 || (_total >= 0 && row >= _total))
+    return false;
+
+  if (! load(row, maxRows(), Replace))
+    return false;
+  return _total < 0 || row < _total;
+}
+
+/* Read every remaining row into the list and stop dropping any, for
+   callers that need the whole result at once.
+ */
+void XTreeWidgetCursor::fetchAll()
+{
+  if (! _open)
+    return;
+
+  _keepAll = true;
+  if (_first > 0 && ! load(0, _pageSize, Replace))
+    return;
+  while (_open && ! atEnd())
+  {
+    if (! load(_first + _rows, _pageSize, Append))
+      break;
+  }
+  updateBar();
+}
+
+/* The number of rows in the whole result: exact once the last row has
+   been fetched, the planner's estimate before that.
+ */
+int XTreeWidgetCursor::rowCount() const
+{
+  if (_total >= 0)
+    return _total;
+  return qMax(_estimate, _first + _rows + 1);
+}
+
+bool XTreeWidgetCursor::atEnd() const
+{
+  return _total >= 0 && _first + _rows >= _total;
+}
+
+int XTreeWidgetCursor::maxRows() const
+{
+  return _pageSize * WINDOW_PAGES;
+}
+
+// top-level rows before the totals populate() adds at the bottom
+int XTreeWidgetCursor::dataRows() const
+{
+  int rows = _tree->topLevelItemCount();
+  while (rows > 0 &&
+         _tree->QTreeWidget::topLevelItem(rows - 1)->data(0, Qt::UserRole).toString() == "totalrole")
+    rows--;
+  return rows;
+}
+
+// the window row at the top of the viewport
+int XTreeWidgetCursor::topRow() const
+{
+  QModelIndex top = _tree->indexAt(QPoint(0, 0));
+  return top.isValid() ? top.row() : 0;
+}
+
+int XTreeWidgetCursor::visibleRows() const
+{
+  QModelIndex top    = _tree->indexAt(QPoint(0, 0));
+  int         height = top.isValid() ? _tree->visualRect(top).height() : 0;
+  return height > 0 ? qMax(1, _tree->viewport()->height() / height) : 1;
+}
+
+void XTreeWidgetCursor::scrollToRow(int row)
+{
+  if (! _open || _fetching)
+    return;
+
+  if (row < _first || (row + visibleRows() > _first + _rows && ! atEnd()))
+  {
+    // the estimate can run past the real end, which moveTo() then finds
+    if (! moveTo(qMax(0, row - _pageSize)) &&
+        ! (_open && _total >= 0 && moveTo(qMax(0, _total - maxRows()))))
+      return;
+  }
+
+  QTreeWidgetItem *item = _tree->QTreeWidget::topLevelItem(qMin(row - _first, dataRows() - 1));
+  if (item)
+    _tree->scrollToItem(item, QAbstractItemView::PositionAtTop);
+  updateBar();
+}
+
+void XTreeWidgetCursor::queueCheck()
+{
+  if (_checkQueued)
+    return;
+  _checkQueued = true;
+  QTimer::singleShot(0, this, SLOT(sCheckViewport()));
+}
+
+/* Fetch the next or previous page once the viewport nears either end of
+   the window, and check again until it no longer does.
+ */
+void XTreeWidgetCursor::sCheckViewport()
+{
+  _checkQueued = false;
+  if (! _open || _fetching)
+    return;
+
+  int top     = topRow();
+  int visible = visibleRows();
+  int margin  = qMax(visible, _pageSize / 4);
+  bool loaded = false;
+  if (top + visible + margin >= _rows && ! atEnd())
+    loaded = load(_first + _rows, _pageSize, Append);
+  else if (_first > 0 && top < margin && ! _keepAll)
+  {
+    int start = qMax(0, _first - _pageSize);
+    loaded = load(start, _first - start, Prepend);
+  }
+
+  if (loaded)
+    queueCheck();
+}
+
+void XTreeWidgetCursor::sViewScrolled()
+{
+  if (! _open || _fetching)
+    return;
+
+  updateBar();
+  queueCheck();
+}
+
+void XTreeWidgetCursor::sBarMoved(int value)
+{
+  // fetch once the user lets go rather than at every step of a drag
+  if (! _bar->isSliderDown())
+    scrollToRow(value);
+}
+
+void XTreeWidgetCursor::sBarReleased()
+{
+  scrollToRow(_bar->value());
+}
+
+void XTreeWidgetCursor::updateBar()
+{
+  QScrollBar *own = _tree->verticalScrollBar();
+  if (! _open || _keepAll)
+  {
+    if (_bar->isVisible())
+    {
+      _bar->hide();
+      _tree->setVerticalScrollBarPolicy(_policy);
+    }
+    own->setToolTip(_open && _estimate > _first + _rows
+                    ? tr("%1 of about %2 rows shown; scroll down for more")
+                        .arg(_first + _rows).arg(_estimate)
+                    : QString());
+    return;
+  }
+
+  if (! _bar->isVisible())
+  {
+    _policy = _tree->verticalScrollBarPolicy();
+    _tree->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
+    _bar->setGeometry(_bar->parentWidget()->rect());
+    _bar->show();
+    _bar->raise();
+  }
+
+  int visible = visibleRows();
+  _bar->blockSignals(true);
+  _bar->setRange(0, qMax(0, rowCount() - visible));
+  _bar->setPageStep(visible);
+  _bar->setSingleStep(1);
+  if (! _bar->isSliderDown())
+    _bar->setValue(_first + topRow());
+  _bar->blockSignals(false);
+
+  _bar->setToolTip((_total >= 0 ? tr("Rows %1 to %2 of %3")
+                                : tr("Rows %1 to %2 of about %3"))
+                   .arg(_first + 1).arg(_first + _rows).arg(rowCount()));
+}
+
+bool XTreeWidgetCursor::eventFilter(QObject *watched, QEvent *event)
+{
+  if (event->type() == QEvent::Resize)
+  {
+    if (watched == _bar->parentWidget())
+      _bar->setGeometry(_bar->parentWidget()->rect());
+    else if (watched == _tree->viewport() && _open)
+    {
+      updateBar();
+      queueCheck();
+    }
+  }
+  return QObject::eventFilter(watched, event);
+}
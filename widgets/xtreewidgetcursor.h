@@ -0,0 +1,115 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#ifndef XTREEWIDGETCURSOR_H
+#define XTREEWIDGETCURSOR_H
+
+#include <QObject>
+#include <QSqlError>
+#include <QString>
+
+#include "xsqlquery.h"
+
+class QScrollBar;
+class XTreeWidget;
+
+/* Feeds an XTreeWidget from a server-side cursor, keeping only a window
+   of the result in the list.
+
+   The query is declared as a SCROLL cursor WITH HOLD on the application's
+   connection, so no transaction stays open between fetches. The server
+   keeps the result; the list holds at most a few pages of it. Scrolling
+   near either end of the window fetches the neighbouring page and drops
+   the page furthest away. A scroll bar of its own spans the whole result,
+   sized from the planner's row estimate until the real count is known, and
+   dragging it fetches the window around the new position.
+
+   Rows are sorted by the server. Changing the sort column re-declares the
+   cursor with a new ORDER BY and starts again from the first row.
+
+   Lists with indented rows, running values or totals need every row
+   before the ones shown, so they keep each page they fetch instead.
+ */
+class XTreeWidgetCursor : public QObject
+{
+  Q_OBJECT
+
+  public:
+    XTreeWidgetCursor(XTreeWidget *tree);
+    ~XTreeWidgetCursor();
+
+    bool      open(const XSqlQuery &prepared, int index, bool useAltId, int pageSize,
+                   const QString &sortField = QString(),
+                   Qt::SortOrder sortOrder = Qt::AscendingOrder);
+    bool      sort(const QString &sortField, Qt::SortOrder sortOrder);
+    void      close();
+    bool      moveTo(int row);
+    bool      isOpen()        const { return _open;     }
+    bool      isFetching()    const { return _fetching; }
+    bool      isWindowed()    const { return _open && ! _keepAll; }
+    int       estimatedRows() const { return _estimate; }
+    int       rowCount()      const;
+    int       firstRow()      const { return _first;    }
+    int       windowRows()    const { return _rows;     }
+    QSqlError lastError()     const { return _error;    }
+
+  public slots:
+    void fetchAll();
+
+  protected:
+    bool eventFilter(QObject *watched, QEvent *event);
+
+  private slots:
+    void sCheckViewport();
+    void sViewScrolled();
+    void sBarMoved(int value);
+    void sBarReleased();
+
+  private:
+    enum Placement { Replace, Append, Prepend };
+
+    void setQuery(const XSqlQuery &prepared);
+    bool declare();
+    bool load(int start, int count, Placement placement, int index = -1);
+    void evict(int count, bool fromTop);
+    bool atEnd()       const;
+    int  dataRows()    const;
+    int  topRow()      const;
+    int  visibleRows() const;
+    int  maxRows()     const;
+    void scrollToRow(int row);
+    void queueCheck();
+    void updateBar();
+
+    XTreeWidget   *_tree;
+    QScrollBar    *_bar;
+    Qt::ScrollBarPolicy _policy;
+    QString        _name;
+    QString        _sql;
+    QString        _sortField;
+    Qt::SortOrder  _sortOrder;
+    bool           _open;
+    bool           _fetching;
+    bool           _keepAll;
+    bool           _checkQueued;
+    bool           _useAltId;
+    int            _index;
+    int            _pageSize;
+    int            _first;
+    int            _rows;
+    int            _total;
+    int            _position;
+    int            _estimate;
+    QSqlError      _error;
+
+    static int     _counter;
+};
+
+#endif
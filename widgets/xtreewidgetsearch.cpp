@@ -0,0 +1,181 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#include "xtreewidgetsearch.h"
+
+#define DEBUG false
+
+XTreeWidgetSearch::XTreeWidgetSearch(XTreeWidget *tree)
+  : _tree(tree),
+    _valid(false),
+    _lastColumn(0),
+    _lastMode(XTreeWidget::SearchSubstring),
+    _current(-1)
+{
+}
+
+/* Forget everything. The index is rebuilt lazily by the next search.
+ */
+void XTreeWidgetSearch::invalidate()
+{
+  _valid = false;
+  _rows.clear();
+  _text.clear();
+  _lastTarget.clear();
+  _matches.clear();
+  _current = -1;
+}
+
+/* Refresh the cached text of the given cells of top-level rows. Rows that
+   were already matched or skipped by the last search may now match, so
+   the next search starts from scratch instead of narrowing.
+ */
+void XTreeWidgetSearch::update(int firstRow, int lastRow,
+                               int firstColumn, int lastColumn)
+{
+  if (! _valid)
+    return;
+
+  if (lastRow >= _rows.size() || lastColumn >= _text.size())
+  {
+    invalidate();
+    return;
+  }
+
+  for (int col = firstColumn; col <= lastColumn; col++)
+  {
+    QVector<QString> &text = _text[col];
+    if (text.isEmpty())
+      continue;
+    for (int row = firstRow; row <= lastRow; row++)
+      text[row] = _rows.at(row)->text(col).toCaseFolded();
+  }
+  _lastTarget.clear();
+}
+
+void XTreeWidgetSearch::buildRows()
+{
+  int count = _tree->topLevelItemCount();
+  _rows.clear();
+  _rows.reserve(count);
+  for (int i = 0; i < count; i++)
+    _rows.append(_tree->topLevelItem(i));
+  _text = QVector<QVector<QString> >(_tree->columnCount());
+  _valid = true;
+
+  if (DEBUG)
+    qDebug("%s search index rebuilt with %d rows",
+           qPrintable(_tree->objectName()), _rows.size());
+}
+
+const QVector<QString> &XTreeWidgetSearch::columnText(int column)
+{
+  QVector<QString> &text = _text[column];
+  if (text.isEmpty() && ! _rows.isEmpty())
+  {
+    text.reserve(_rows.size());
+    for (int i = 0; i < _rows.size(); i++)
+      text.append(_rows.at(i)->text(column).toCaseFolded());
+  }
+  return text;
+}
+
+bool XTreeWidgetSearch::matches(int row, const QString &target, int column,
+                                XTreeWidget::SearchMode mode)
+{
+  int first = column < 0 ? 0                 : column;
+  int last  = column < 0 ? _text.size() - 1  : column;
+  for (int col = first; col <= last; col++)
+  {
+    if (_tree->isColumnHidden(col) && column < 0)
+      continue;
+    const QString &text = columnText(col).at(row);
+    if (mode == XTreeWidget::SearchPrefix ? text.startsWith(target)
+                                          : text.contains(target))
+      return true;
+  }
+  return false;
+}
+
+/* Return the row numbers in the index that match target, in row order.
+   Hidden rows are included so that narrowing stays correct when rows are
+   shown or hidden between searches; item() returns 0 for them.
+ */
+const QVector<int> &XTreeWidgetSearch::search(const QString &target,
+                                              int column,
+                                              XTreeWidget::SearchMode mode)
+{
+  if (! _valid)
+    buildRows();
+
+  if (column >= _text.size())
+  {
+    _matches.clear();
+    _current = -1;
+    return _matches;
+  }
+
+  QString folded = target.toCaseFolded();
+
+  // typing another character can only shrink the set of matches
+  bool narrow = ! _lastTarget.isEmpty() &&
+                column == _lastColumn && mode == _lastMode &&
+                (mode == XTreeWidget::SearchPrefix ? folded.startsWith(_lastTarget)
+                                                   : folded.contains(_lastTarget));
+
+  QVector<int> result;
+  if (narrow)
+  {
+    for (int i = 0; i < _matches.size(); i++)
+      if (matches(_matches.at(i), folded, column, mode))
+        result.append(_matches.at(i));
+  }
+  else
+  {
+    for (int row = 0; row < _rows.size(); row++)
+      if (matches(row, folded, column, mode))
+        result.append(row);
+  }
+
+  _matches    = result;
+  _lastTarget = folded;
+  _lastColumn = column;
+  _lastMode   = mode;
+  _current    = -1;
+  for (int i = 0; i < _matches.size() && _current < 0; i++)
+    if (item(_matches.at(i)))
+      _current = i;
+
+  return _matches;
+}
+
+XTreeWidgetItem *XTreeWidgetSearch::item(int row) const
+{
+  if (row < 0 || row >= _rows.size() || _rows.at(row)->isHidden())
+    return 0;
+  return _rows.at(row);
+}
+
+/* Step to the next match of the last search, wrapping to the first.
+ */
+XTreeWidgetItem *XTreeWidgetSearch::next()
+{
+  if (! _valid || _matches.isEmpty())
+    return 0;
+
+  for (int i = 0; i < _matches.size(); i++)
+  {
+    _current = (_current + 1) % _matches.size();
+    XTreeWidgetItem *result = item(_matches.at(_current));
+    if (result)
+      return result;
+  }
+  return 0;
+}
@@ -0,0 +1,58 @@
+/*
+ * This file is part of the xTuple ERP: PostBooks Edition, a free and
+ * open source Enterprise Resource Planning software suite,
+ * Copyright (c) 1999-2017 by OpenMFG LLC, d/b/a xTuple.
+ * It is licensed to you under the Common Public Attribution License
+ * version 1.0, the full text of which (including xTuple-specific Exhibits)
+ * is available at www.xtuple.com/CPAL.  By using this software, you agree
+ * to be bound by its terms.
+ */
+
+#ifndef XTREEWIDGETSEARCH_H
+#define XTREEWIDGETSEARCH_H
+
+#include <QString>
+#include <QVector>
+
+#include "xtreewidget.h"
+
+/* In-memory search index over the top-level rows of an XTreeWidget.
+
+   The case-folded text of each column is captured the first time that
+   column is searched. Edited cells are updated in place; inserting,
+   removing or reordering rows discards the index. Hidden rows stay in the
+   index but are never returned. A search that extends the previous one (more
+   characters typed into a search field) only re-examines the previous
+   matches.
+ */
+class XTreeWidgetSearch
+{
+  public:
+    XTreeWidgetSearch(XTreeWidget *tree);
+
+    void  invalidate();
+    void  update(int firstRow, int lastRow, int firstColumn, int lastColumn);
+    const QVector<int> &search(const QString &target, int column,
+                               XTreeWidget::SearchMode mode);
+    XTreeWidgetItem *item(int row) const;
+    XTreeWidgetItem *next();
+
+  private:
+    void  buildRows();
+    const QVector<QString> &columnText(int column);
+    bool  matches(int row, const QString &target, int column,
+                  XTreeWidget::SearchMode mode);
+
+    XTreeWidget                *_tree;
+    bool                        _valid;
+    QVector<XTreeWidgetItem *>  _rows;
+    QVector<QVector<QString> >  _text;   // [column][row], empty until needed
+
+    QString                     _lastTarget;
+    int                         _lastColumn;
+    XTreeWidget::SearchMode     _lastMode;
+    QVector<int>                _matches;
+    int                         _current;
+};
+
+#endif